@@ -42,14 +42,70 @@
 
 
 /******************************************************************************
-** These will be in a spec file and the toolchain will create these
-** definitions.
+** Buffer Sizes
+**
+** Every fixed size gateway buffer is sized from these definitions so a
+** platform can trade capacity for RAM. app_cfg.h derives each object's
+** buffer sizes from them and documents their constraints. Invalid
+** combinations are compile errors. The resulting memory budget of each
+** subsystem is reported in an event at startup and in housekeeping
+** telemetry.
+*/
+
+/*
+** MQTT packets. The largest message payload is a little less than the
+** buffer length because the buffer also holds the packet header and topic.
+*/
+#define MQTT_GW_MQTT_READ_BUF_LEN     1000
+#define MQTT_GW_MQTT_SEND_BUF_LEN     1000
+
+/*
+** Topic table. MQTT_GW_MAX_TOPICS must be a power of two and the topic
+** length includes the null terminator. The topic length matches the
+** OS_MAX_PATH_LEN topic names the table accepted before topic names were
+** moved to the string arena and must match the EDS MQTT_TOPIC_LEN.
+*/
+#define MQTT_GW_MAX_TOPICS             512
+#define MQTT_GW_TOPIC_LEN               64
+#define MQTT_GW_TOPIC_STR_ARENA_LEN  16384
+#define MQTT_GW_TOPIC_MID_INDEX_LEN  0x2000
+#define MQTT_GW_TOPIC_LOAD_BUF_LEN    4096
+#define MQTT_GW_TOPIC_NAME_CACHE_LEN   256
+#define MQTT_GW_MAX_MUX_TOPICS          16
+#define MQTT_GW_MAX_MUX_TAGS            64
+#define MQTT_GW_RATE_CODEC_CNT          64
+
+/*
+** Inbound decode worker queues, one per worker
+*/
+#define MQTT_GW_DECODE_MAX_WORKERS       4
+#define MQTT_GW_DECODE_QUEUE_LEN        16
+
+/*
+** Last value cache slot per topic
+*/
+#define MQTT_GW_LAST_VALUE_PAYLOAD_LEN  512
+#define MQTT_GW_LAST_VALUE_SB_MSG_LEN   256
+
+/*
+** Shared memory ring (only mapped when SHM_RING_NAME is defined)
+*/
+#define MQTT_GW_SHM_RING_SLOT_CNT     1024
+#define MQTT_GW_SHM_RING_SLOT_LEN     1024
+
+/*
+** Embedded local broker clients
 */
+#define MQTT_GW_LOCAL_BROKER_CLIENTS     8
+#define MQTT_GW_LOCAL_BROKER_FILTERS    16
 
 /*
-** mqtt topic string length
+** Diagnostics
 */
-#define MQTT_GW_TOPIC_LEN          100
+#define MQTT_GW_TRACE_RING_DEPTH       512
+#define MQTT_GW_LOAD_GEN_MSG_LEN      1024
+#define MQTT_GW_PERF_BENCH_SB_MSG_LEN  512
+#define MQTT_GW_LAT_PROBE_WINDOW_LEN   128
 
 
 #endif /* _mqtt_gw_platform_cfg_ */
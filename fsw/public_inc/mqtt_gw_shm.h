@@ -0,0 +1,104 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Define the layout of MQTT_GW's shared memory message ring
+**
+** Notes:
+**   1. The ring is written by MQTT_GW's SHM_RING object and read by local
+**      processes with mqtt_gw_shm_reader.h. This header only uses C99
+**      fixed width types so it can be used outside of cFS.
+**   2. The shared memory object starts with a header followed by SlotCnt
+**      slots of SlotLen bytes. Message n (starting at 1) is written to
+**      slot n % SlotCnt so the ring holds the last SlotCnt messages.
+**   3. Each slot is a sequence lock. The writer sets the slot's Seq to 0,
+**      writes the message, and then sets Seq to the message's sequence
+**      number followed by the header's WriteSeq. A reader copies a slot
+**      and accepts the copy if Seq held the expected sequence number
+**      before and after the copy.
+**   4. The writer increments Epoch each time it initializes the ring so
+**      readers of a reused shared memory object detect a restart.
+**   5. A slot's data is the null terminated topic name followed by the
+**      null terminated JSON payload. TopicLen and PayloadLen don't include
+**      the terminators.
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+#ifndef _mqtt_gw_shm_
+#define _mqtt_gw_shm_
+
+/*
+** Includes
+*/
+
+#include <stdint.h>
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define MQTT_GW_SHM_MAGIC    0x4D514757u   /* "MQGW" */
+#define MQTT_GW_SHM_VERSION  1
+
+/*
+** Address of the slot that holds message sequence number 'Seq'
+*/
+#define MQTT_GW_SHM_SLOT(Hdr, Seq) \
+   ((MQTT_GW_SHM_Slot_t *)((uint8_t *)(Hdr) + sizeof(MQTT_GW_SHM_Hdr_t) + \
+                           ((Seq) % (Hdr)->SlotCnt) * (Hdr)->SlotLen))
+
+/*
+** Total size of a shared memory object with SlotCnt slots of SlotLen bytes
+*/
+#define MQTT_GW_SHM_SIZE(SlotCnt, SlotLen) \
+   (sizeof(MQTT_GW_SHM_Hdr_t) + (size_t)(SlotCnt) * (size_t)(SlotLen))
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+typedef struct
+{
+
+   uint32_t  Magic;      /* MQTT_GW_SHM_MAGIC once the ring is initialized */
+   uint32_t  Version;    /* MQTT_GW_SHM_VERSION */
+   uint32_t  SlotCnt;
+   uint32_t  SlotLen;    /* Bytes per slot including the slot header, multiple of 8 */
+   uint32_t  Epoch;      /* Incremented each time the writer initializes the ring */
+   uint32_t  Spare;
+   uint64_t  WriteSeq;   /* Sequence number of the last completed message, 0 = None */
+   uint8_t   Pad[32];    /* Slots start on a 64 byte boundary */
+
+} MQTT_GW_SHM_Hdr_t;
+
+
+typedef struct
+{
+
+   uint64_t  Seq;          /* Message sequence number when complete, 0 while it is written */
+   uint16_t  TopicId;      /* MQTT_GW topic table ID */
+   uint16_t  TopicLen;
+   uint32_t  PayloadLen;
+
+   /* Followed by the topic name and payload */
+
+} MQTT_GW_SHM_Slot_t;
+
+
+#endif /* _mqtt_gw_shm_ */
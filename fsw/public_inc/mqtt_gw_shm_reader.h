@@ -0,0 +1,295 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Read MQTT_GW's shared memory message ring from a local process
+**
+** Notes:
+**   1. Header only reader library for POSIX hosts. Include it in a
+**      consumer process that runs on the same host as cFS and link with
+**      -lrt if the C library requires it for shm_open().
+**   2. MQTT_GW_SHM_Read() only reads shared memory so a reader that polls
+**      the ring makes no system calls. Messages are copied to a caller
+**      buffer because the writer never waits for readers.
+**   3. A reader starts with the next message written after it opens the
+**      ring. A reader that falls more than the ring's slot count behind
+**      skips to the oldest message still in the ring and counts the
+**      skipped messages in LostCnt. A writer restart is detected with the
+**      ring's epoch and the reader continues with the new ring.
+**   4. Example:
+**         MQTT_GW_SHM_Reader_t Reader;
+**         MQTT_GW_SHM_Msg_t    Msg;
+**         static char          Buf[4096];
+**
+**         if (MQTT_GW_SHM_Open(&Reader, "/mqtt_gw") == 0)
+**         {
+**            for (;;)
+**            {
+**               if (MQTT_GW_SHM_Read(&Reader, Buf, sizeof(Buf), &Msg))
+**               {
+**                  printf("%s: %s\n", Msg.Topic, Msg.Payload);
+**               }
+**            }
+**         }
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+#ifndef _mqtt_gw_shm_reader_
+#define _mqtt_gw_shm_reader_
+
+/*
+** Includes
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mqtt_gw_shm.h"
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+typedef struct
+{
+
+   const MQTT_GW_SHM_Hdr_t *Hdr;
+   size_t    MapLen;
+   uint32_t  Epoch;
+   uint64_t  NextSeq;    /* Sequence number of the next message to read */
+   uint64_t  LostCnt;    /* Messages overwritten before they were read */
+
+} MQTT_GW_SHM_Reader_t;
+
+
+/*
+** A message read from the ring. Topic and Payload point into the buffer
+** passed to MQTT_GW_SHM_Read().
+*/
+typedef struct
+{
+
+   uint64_t    Seq;
+   uint16_t    TopicId;
+   uint16_t    TopicLen;
+   uint32_t    PayloadLen;
+   const char *Topic;
+   const char *Payload;
+
+} MQTT_GW_SHM_Msg_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: MQTT_GW_SHM_Close
+**
+** Unmap the ring.
+**
+*/
+static inline void MQTT_GW_SHM_Close(MQTT_GW_SHM_Reader_t *Reader)
+{
+
+   if (Reader->Hdr != NULL)
+   {
+      munmap((void *)Reader->Hdr, Reader->MapLen);
+      Reader->Hdr = NULL;
+   }
+
+} /* End MQTT_GW_SHM_Close() */
+
+
+/******************************************************************************
+** Function: MQTT_GW_SHM_Open
+**
+** Map the ring named 'Name', the MQTT_GW SHM_RING_NAME INI value. Returns 0
+** on success and -1 with errno set on failure.
+**
+** Notes:
+**   1. EAGAIN is returned if the writer hasn't initialized the ring and
+**      EPROTO if the ring has a different layout version.
+**
+*/
+static inline int MQTT_GW_SHM_Open(MQTT_GW_SHM_Reader_t *Reader, const char *Name)
+{
+
+   int  RetStatus = -1;
+   int  Fd;
+   int  Err = 0;
+   struct stat FileStat;
+   const MQTT_GW_SHM_Hdr_t *Hdr;
+
+   memset(Reader, 0, sizeof(MQTT_GW_SHM_Reader_t));
+
+   Fd = shm_open(Name, O_RDONLY, 0);
+   if (Fd >= 0)
+   {
+
+      if (fstat(Fd, &FileStat) == 0 && (size_t)FileStat.st_size >= sizeof(MQTT_GW_SHM_Hdr_t))
+      {
+
+         Hdr = (const MQTT_GW_SHM_Hdr_t *)mmap(NULL, FileStat.st_size, PROT_READ, MAP_SHARED, Fd, 0);
+         if (Hdr != MAP_FAILED)
+         {
+
+            Reader->Hdr    = Hdr;
+            Reader->MapLen = FileStat.st_size;
+
+            if (__atomic_load_n(&Hdr->Magic, __ATOMIC_ACQUIRE) != MQTT_GW_SHM_MAGIC)
+            {
+               Err = EAGAIN;
+            }
+            else if (Hdr->Version != MQTT_GW_SHM_VERSION ||
+                     MQTT_GW_SHM_SIZE(Hdr->SlotCnt, Hdr->SlotLen) > Reader->MapLen)
+            {
+               Err = EPROTO;
+            }
+            else
+            {
+               Reader->Epoch   = __atomic_load_n(&Hdr->Epoch, __ATOMIC_ACQUIRE);
+               Reader->NextSeq = __atomic_load_n(&Hdr->WriteSeq, __ATOMIC_ACQUIRE) + 1;
+               RetStatus = 0;
+            }
+
+            if (RetStatus != 0)
+            {
+               MQTT_GW_SHM_Close(Reader);
+            }
+         }
+         else
+         {
+            Err = errno;
+         }
+      }
+      else
+      {
+         Err = (errno != 0) ? errno : EAGAIN;
+      }
+
+      close(Fd);   /* The mapping stays valid */
+      if (Err != 0)
+      {
+         errno = Err;
+      }
+   }
+
+   return RetStatus;
+
+} /* End MQTT_GW_SHM_Open() */
+
+
+/******************************************************************************
+** Function: MQTT_GW_SHM_Read
+**
+** Copy the next message into 'Buf' and return 1, or return 0 if there isn't
+** a new message.
+**
+** Notes:
+**   1. BufLen must be at least the ring's SlotLen.
+**   2. Messages overwritten before they could be copied are counted in the
+**      reader's LostCnt and skipped.
+**
+*/
+static inline int MQTT_GW_SHM_Read(MQTT_GW_SHM_Reader_t *Reader, void *Buf, size_t BufLen,
+                                   MQTT_GW_SHM_Msg_t *Msg)
+{
+
+   int       RetStatus = 0;
+   bool      Done = false;
+   uint64_t  WriteSeq;
+   uint64_t  Seq;
+   uint32_t  DataLen;
+   const MQTT_GW_SHM_Hdr_t  *Hdr = Reader->Hdr;
+   const MQTT_GW_SHM_Slot_t *Slot;
+   MQTT_GW_SHM_Slot_t       *Copy = (MQTT_GW_SHM_Slot_t *)Buf;
+
+   if (Hdr == NULL || BufLen < Hdr->SlotLen)
+   {
+      Done = true;
+   }
+
+   while (!Done)
+   {
+
+      WriteSeq = __atomic_load_n(&Hdr->WriteSeq, __ATOMIC_ACQUIRE);
+
+      if (__atomic_load_n(&Hdr->Epoch, __ATOMIC_ACQUIRE) != Reader->Epoch)
+      {
+         /* Writer restarted, continue with the new ring's messages */
+         Reader->Epoch   = __atomic_load_n(&Hdr->Epoch, __ATOMIC_ACQUIRE);
+         Reader->NextSeq = 1;
+         continue;
+      }
+
+      if (Reader->NextSeq > WriteSeq)
+      {
+         Done = true;
+         continue;
+      }
+
+      if ((WriteSeq - Reader->NextSeq) >= Hdr->SlotCnt)
+      {
+         Reader->LostCnt += WriteSeq - Hdr->SlotCnt + 1 - Reader->NextSeq;
+         Reader->NextSeq  = WriteSeq - Hdr->SlotCnt + 1;
+      }
+
+      Slot = MQTT_GW_SHM_SLOT(Hdr, Reader->NextSeq);
+      Seq  = __atomic_load_n(&Slot->Seq, __ATOMIC_ACQUIRE);
+      if (Seq == Reader->NextSeq)
+      {
+         memcpy(Copy, Slot, Hdr->SlotLen);
+         __atomic_thread_fence(__ATOMIC_ACQUIRE);
+         Seq = __atomic_load_n(&Slot->Seq, __ATOMIC_RELAXED);
+      }
+
+      DataLen = Hdr->SlotLen - sizeof(MQTT_GW_SHM_Slot_t);
+      if (Seq == Reader->NextSeq && ((uint32_t)Copy->TopicLen + Copy->PayloadLen + 2) <= DataLen)
+      {
+         Msg->Seq        = Seq;
+         Msg->TopicId    = Copy->TopicId;
+         Msg->TopicLen   = Copy->TopicLen;
+         Msg->PayloadLen = Copy->PayloadLen;
+         Msg->Topic      = (const char *)(Copy + 1);
+         Msg->Payload    = Msg->Topic + Copy->TopicLen + 1;
+         RetStatus = 1;
+         Done      = true;
+      }
+      else
+      {
+         /* The slot was overwritten by a newer message */
+         ++Reader->LostCnt;
+      }
+
+      ++Reader->NextSeq;
+
+   } /* End while not done */
+
+   return RetStatus;
+
+} /* End MQTT_GW_SHM_Read() */
+
+
+#endif /* _mqtt_gw_shm_reader_ */
@@ -83,15 +83,18 @@
 
 #define CFG_APP_MAIN_PERF_ID         APP_MAIN_PERF_ID
 #define CFG_CHILD_TASK_PERF_ID       CHILD_TASK_PERF_ID
+#define CFG_LOAD_GEN_CHILD_PERF_ID   LOAD_GEN_CHILD_PERF_ID
+#define CFG_DECODE_POOL_CHILD_PERF_ID  DECODE_POOL_CHILD_PERF_ID
+#define CFG_LAST_VALUE_CHILD_PERF_ID   LAST_VALUE_CHILD_PERF_ID
 
 #define CFG_MQTT_GW_CMD_TOPICID      MQTT_GW_CMD_TOPICID
 #define CFG_MQTT_GW_SEND_HK_TOPICID  MQTT_GW_SEND_HK_TOPICID
  
 #define CFG_MQTT_GW_HK_TLM_TOPICID      MQTT_GW_HK_TLM_TOPICID
+#define CFG_MQTT_GW_LATENCY_TLM_TOPICID MQTT_GW_LATENCY_TLM_TOPICID
+#define CFG_MQTT_GW_TOPIC_STATS_TLM_TOPICID MQTT_GW_TOPIC_STATS_TLM_TOPICID
 #define CFG_MQTT_GW_TOPIC_1_TLM_TOPICID MQTT_GW_TOPIC_1_TLM_TOPICID
-
-#define CFG_CMD_PIPE_NAME            CMD_PIPE_NAME
-#define CFG_CMD_PIPE_DEPTH           CMD_PIPE_DEPTH
+#define CFG_MQTT_GW_LAT_PROBE_TLM_TOPICID MQTT_GW_LAT_PROBE_TLM_TOPICID
 
 #define CFG_TOPIC_PIPE_NAME          TOPIC_PIPE_NAME
 #define CFG_TOPIC_PIPE_DEPTH         TOPIC_PIPE_DEPTH
@@ -103,23 +106,60 @@
 #define CFG_MQTT_BROKER_PASSWORD     MQTT_BROKER_PASSWORD
 #define CFG_MQTT_CLIENT_NAME         MQTT_CLIENT_NAME
 #define CFG_MQTT_CLIENT_YIELD_TIME   MQTT_CLIENT_YIELD_TIME
+#define CFG_MQTT_CLIENT_SUB_QOS      MQTT_CLIENT_SUB_QOS
 #define CFG_MQTT_TOPIC_TBL_DEF_FILE  MQTT_TOPIC_TBL_DEF_FILE
 
 #define CFG_CHILD_NAME               CHILD_NAME
 #define CFG_CHILD_STACK_SIZE         CHILD_STACK_SIZE
 #define CFG_CHILD_PRIORITY           CHILD_PRIORITY
 
+#define CFG_LOAD_GEN_CHILD_NAME        LOAD_GEN_CHILD_NAME
+#define CFG_LOAD_GEN_CHILD_STACK_SIZE  LOAD_GEN_CHILD_STACK_SIZE
+#define CFG_LOAD_GEN_CHILD_PRIORITY    LOAD_GEN_CHILD_PRIORITY
+
+#define CFG_DECODE_POOL_WORKER_CNT        DECODE_POOL_WORKER_CNT
+#define CFG_DECODE_POOL_CHILD_NAME        DECODE_POOL_CHILD_NAME
+#define CFG_DECODE_POOL_CHILD_STACK_SIZE  DECODE_POOL_CHILD_STACK_SIZE
+#define CFG_DECODE_POOL_CHILD_PRIORITY    DECODE_POOL_CHILD_PRIORITY
+
+#define CFG_BUSY_POLL_ENABLE         BUSY_POLL_ENABLE
+#define CFG_BUSY_POLL_SPIN_TIME      BUSY_POLL_SPIN_TIME
+#define CFG_APP_MAIN_PRIORITY        APP_MAIN_PRIORITY
+#define CFG_APP_MAIN_CPU_MASK        APP_MAIN_CPU_MASK
+#define CFG_CHILD_CPU_MASK           CHILD_CPU_MASK
+
+#define CFG_LAST_VALUE_REQ_TOPIC     LAST_VALUE_REQ_TOPIC
+#define CFG_LAST_VALUE_SAVE_FILE     LAST_VALUE_SAVE_FILE
+#define CFG_LAST_VALUE_SAVE_PERIOD   LAST_VALUE_SAVE_PERIOD
+#define CFG_LAST_VALUE_CHILD_NAME        LAST_VALUE_CHILD_NAME
+#define CFG_LAST_VALUE_CHILD_STACK_SIZE  LAST_VALUE_CHILD_STACK_SIZE
+#define CFG_LAST_VALUE_CHILD_PRIORITY    LAST_VALUE_CHILD_PRIORITY
+
+#define CFG_SHM_RING_NAME            SHM_RING_NAME
+
+#define CFG_LOCAL_BROKER_ADDRESS     LOCAL_BROKER_ADDRESS
+#define CFG_LOCAL_BROKER_PORT        LOCAL_BROKER_PORT
+
+#define CFG_LAT_PROBE_PERIOD         LAT_PROBE_PERIOD
+
+#define CFG_STATS_TLM_HK_PERIOD      STATS_TLM_HK_PERIOD
+#define CFG_TRACE_DEF_LEVEL          TRACE_DEF_LEVEL
+
 
 #define APP_CONFIG(XX) \
    XX(APP_CFE_NAME,char*) \
    XX(APP_MAIN_PERF_ID,uint32) \
    XX(CHILD_TASK_PERF_ID,uint32) \
+   XX(LOAD_GEN_CHILD_PERF_ID,uint32) \
+   XX(DECODE_POOL_CHILD_PERF_ID,uint32) \
+   XX(LAST_VALUE_CHILD_PERF_ID,uint32) \
    XX(MQTT_GW_CMD_TOPICID,uint32) \
    XX(MQTT_GW_SEND_HK_TOPICID,uint32) \
    XX(MQTT_GW_HK_TLM_TOPICID,uint32) \
+   XX(MQTT_GW_LATENCY_TLM_TOPICID,uint32) \
+   XX(MQTT_GW_TOPIC_STATS_TLM_TOPICID,uint32) \
    XX(MQTT_GW_TOPIC_1_TLM_TOPICID,uint32) \
-   XX(CMD_PIPE_NAME,char*) \
-   XX(CMD_PIPE_DEPTH,uint32) \
+   XX(MQTT_GW_LAT_PROBE_TLM_TOPICID,uint32) \
    XX(TOPIC_PIPE_NAME,char*) \
    XX(TOPIC_PIPE_DEPTH,uint32) \
    XX(TOPIC_PIPE_PEND_TIME,uint32) \
@@ -129,10 +169,35 @@
    XX(MQTT_BROKER_PASSWORD,char*) \
    XX(MQTT_CLIENT_NAME,char*) \
    XX(MQTT_CLIENT_YIELD_TIME,uint32) \
+   XX(MQTT_CLIENT_SUB_QOS,uint32) \
    XX(MQTT_TOPIC_TBL_DEF_FILE,char*) \
    XX(CHILD_NAME,char*) \
    XX(CHILD_STACK_SIZE,uint32) \
-   XX(CHILD_PRIORITY,uint32)
+   XX(CHILD_PRIORITY,uint32) \
+   XX(LOAD_GEN_CHILD_NAME,char*) \
+   XX(LOAD_GEN_CHILD_STACK_SIZE,uint32) \
+   XX(LOAD_GEN_CHILD_PRIORITY,uint32) \
+   XX(DECODE_POOL_WORKER_CNT,uint32) \
+   XX(DECODE_POOL_CHILD_NAME,char*) \
+   XX(DECODE_POOL_CHILD_STACK_SIZE,uint32) \
+   XX(DECODE_POOL_CHILD_PRIORITY,uint32) \
+   XX(BUSY_POLL_ENABLE,uint32) \
+   XX(BUSY_POLL_SPIN_TIME,uint32) \
+   XX(APP_MAIN_PRIORITY,uint32) \
+   XX(APP_MAIN_CPU_MASK,uint32) \
+   XX(CHILD_CPU_MASK,uint32) \
+   XX(LAST_VALUE_REQ_TOPIC,char*) \
+   XX(LAST_VALUE_SAVE_FILE,char*) \
+   XX(LAST_VALUE_SAVE_PERIOD,uint32) \
+   XX(LAST_VALUE_CHILD_NAME,char*) \
+   XX(LAST_VALUE_CHILD_STACK_SIZE,uint32) \
+   XX(LAST_VALUE_CHILD_PRIORITY,uint32) \
+   XX(SHM_RING_NAME,char*) \
+   XX(LOCAL_BROKER_ADDRESS,char*) \
+   XX(LOCAL_BROKER_PORT,uint32) \
+   XX(LAT_PROBE_PERIOD,uint32) \
+   XX(STATS_TLM_HK_PERIOD,uint32) \
+   XX(TRACE_DEF_LEVEL,uint32)
 
 DECLARE_ENUM(Config,APP_CONFIG)
 
@@ -161,6 +226,15 @@ DECLARE_ENUM(Config,APP_CONFIG)
 #define MSG_TRANS_BASE_EID        (OSK_C_FW_APP_BASE_EID + 60)
 #define MQTT_TOPIC_TBL_BASE_EID   (OSK_C_FW_APP_BASE_EID + 80)
 #define MQTT_TOPIC_RATE_BASE_EID  (OSK_C_FW_APP_BASE_EID + 90)
+#define TRACE_RING_BASE_EID       (OSK_C_FW_APP_BASE_EID + 100)
+#define PERF_BENCH_BASE_EID       (OSK_C_FW_APP_BASE_EID + 110)
+#define LOAD_GEN_BASE_EID         (OSK_C_FW_APP_BASE_EID + 120)
+#define DECODE_POOL_BASE_EID      (OSK_C_FW_APP_BASE_EID + 130)
+#define RT_LOOP_BASE_EID          (OSK_C_FW_APP_BASE_EID + 140)
+#define LAST_VALUE_BASE_EID       (OSK_C_FW_APP_BASE_EID + 150)
+#define SHM_RING_BASE_EID         (OSK_C_FW_APP_BASE_EID + 160)
+#define LOCAL_BROKER_BASE_EID     (OSK_C_FW_APP_BASE_EID + 170)
+#define LAT_PROBE_BASE_EID        (OSK_C_FW_APP_BASE_EID + 180)
 
 
 /******************************************************************************
@@ -168,18 +242,235 @@ DECLARE_ENUM(Config,APP_CONFIG)
 **
 */
 
-#define MQTT_CLIENT_READ_BUF_LEN  1000 
-#define MQTT_CLIENT_SEND_BUF_LEN  1000 
+#define MQTT_CLIENT_READ_BUF_LEN  MQTT_GW_MQTT_READ_BUF_LEN
+#define MQTT_CLIENT_SEND_BUF_LEN  MQTT_GW_MQTT_SEND_BUF_LEN
 #define MQTT_CLIENT_TIMEOUT_MS    2000 
 
 /******************************************************************************
 ** MQTT Topic Table
 **
+** MQTT_TOPIC_TBL_MAX_TOPICS must be a power of two that is less than
+** MQTT_TOPIC_TBL_UNUSED_ID. Each topic costs 48 bytes in the table plus its
+** MSG_STATS counters and histograms. MQTT_TOPIC_TBL_STR_ARENA_LEN holds all
+** of the topic names including their null terminators. Topic names must be
+** shorter than MQTT_TOPIC_TBL_MAX_TOPIC_LEN.
+**
+** The table file is streamed through a MQTT_TOPIC_TBL_LOAD_BUF_LEN read
+** buffer so the file size is not limited. Each topic object must fit in
+** MQTT_TOPIC_TBL_OBJ_MAX_CHAR characters.
+**
+** Topic SB message ID values must be less than MQTT_TOPIC_TBL_MID_INDEX_LEN.
+** It should cover CFE_PLATFORM_SB_HIGHEST_VALID_MSGID so any app's messages
+** can be bridged. The direct MID index costs two bytes per message ID value
+** in each table buffer.
+**
+** MQTT_TOPIC_TBL_NAME_CACHE_LEN is the number of rendered SB topic names
+** for templates with a per-message key and must be a power of two.
+**
+** MQTT_TOPIC_TBL_GRACE_TIMEOUT_MS must be longer than the MQTT client yield
+** time because the MQTT child task reports one quiescent point per yield.
+**
+** A table can define MQTT_TOPIC_TBL_MAX_MUX_TOPICS multiplexed topics with
+** tags less than MQTT_TOPIC_TBL_MAX_MUX_TAGS. Each multiplexed topic's jump
+** table costs two bytes per tag in each table buffer and MSG_TRANS keeps a
+** MQTT_TOPIC_TBL_MUX_PAYLOAD_LEN envelope buffer for each one. Tags must fit
+** in a uint8.
+*/
+
+#define MQTT_TOPIC_TBL_MAX_TOPICS        MQTT_GW_MAX_TOPICS
+#define MQTT_TOPIC_TBL_MAX_TOPIC_LEN     MQTT_GW_TOPIC_LEN
+#define MQTT_TOPIC_TBL_STR_ARENA_LEN     MQTT_GW_TOPIC_STR_ARENA_LEN
+#define MQTT_TOPIC_TBL_LOAD_BUF_LEN      MQTT_GW_TOPIC_LOAD_BUF_LEN
+#define MQTT_TOPIC_TBL_OBJ_MAX_CHAR         512
+#define MQTT_TOPIC_TBL_MID_INDEX_LEN     MQTT_GW_TOPIC_MID_INDEX_LEN
+#define MQTT_TOPIC_TBL_NAME_CACHE_LEN    MQTT_GW_TOPIC_NAME_CACHE_LEN
+#define MQTT_TOPIC_TBL_GRACE_TIMEOUT_MS    3000
+#define MQTT_TOPIC_TBL_GRACE_POLL_MS         20
+#define MQTT_TOPIC_TBL_MAX_MUX_TOPICS    MQTT_GW_MAX_MUX_TOPICS
+#define MQTT_TOPIC_TBL_MAX_MUX_TAGS      MQTT_GW_MAX_MUX_TAGS
+#define MQTT_TOPIC_TBL_MUX_PAYLOAD_LEN   MQTT_CLIENT_SEND_BUF_LEN
+
+#if (MQTT_TOPIC_TBL_MAX_TOPICS & (MQTT_TOPIC_TBL_MAX_TOPICS - 1)) != 0
+   #error MQTT_GW_MAX_TOPICS must be a power of 2
+#endif
+#if (MQTT_TOPIC_TBL_NAME_CACHE_LEN & (MQTT_TOPIC_TBL_NAME_CACHE_LEN - 1)) != 0
+   #error MQTT_GW_TOPIC_NAME_CACHE_LEN must be a power of 2
+#endif
+#if MQTT_TOPIC_TBL_MAX_MUX_TAGS > 255
+   #error MQTT_GW_MAX_MUX_TAGS must fit in a uint8
+#endif
+#if MQTT_TOPIC_TBL_LOAD_BUF_LEN <= MQTT_TOPIC_TBL_OBJ_MAX_CHAR
+   #error MQTT_GW_TOPIC_LOAD_BUF_LEN must hold a topic object
+#endif
+
+
+/******************************************************************************
+** MQTT Topic Codecs
+**
+** Each topic that uses a codec type is given its own codec instance when the
+** table is loaded. These define the number of instances of each type that
+** one table can use. Each topic table snapshot buffer has its own instances
+** so twice as many are allocated.
+*/
+
+#define MQTT_TOPIC_RATE_INST_CNT   MQTT_GW_RATE_CODEC_CNT
+#define MQTT_TOPIC_PROBE_INST_CNT  1   /* LAT_PROBE has one topic */
+
+
+/******************************************************************************
+** Message Statistics
+**
+** MSG_STATS_TLM_TOPIC_CNT must match the EDS STATS_TOPIC_CNT definition
+*/
+
+#define MSG_STATS_HIST_BUCKETS    20   /* Log2 microsecond buckets, last is >= ~0.5 sec */
+#define MSG_STATS_TLM_TOPIC_CNT    5
+
+
+/******************************************************************************
+** Trace Ring
+**
+** TRACE_RING_DEPTH must be a power of 2 so the ring index wraps cleanly
+*/
+
+#define TRACE_RING_DEPTH      MQTT_GW_TRACE_RING_DEPTH
+#define TRACE_RING_TEXT_LEN    32
+
+#if (TRACE_RING_DEPTH & (TRACE_RING_DEPTH - 1)) != 0
+   #error MQTT_GW_TRACE_RING_DEPTH must be a power of 2
+#endif
+
+
+/******************************************************************************
+** Performance Benchmark
+**
+** PERF_BENCH_PAYLOAD_LEN leaves room for the topic name and packet header in
+** MQTT_CLIENT_SEND_BUF_LEN. PERF_BENCH_BATCH_LEN gateway benchmark messages
+** are run between the main task's SB messages.
+*/
+
+#define PERF_BENCH_MAX_MSG_CNT   100000
+#define PERF_BENCH_MAX_ITER_CNT 1000000
+#define PERF_BENCH_BATCH_LEN        100
+#define PERF_BENCH_PAYLOAD_LEN   (MQTT_CLIENT_SEND_BUF_LEN - 100)
+#define PERF_BENCH_SB_MSG_LEN    MQTT_GW_PERF_BENCH_SB_MSG_LEN
+
+
+/******************************************************************************
+** Load Generator
+**
+** LOAD_GEN_MAX_MSG_LEN must not exceed the cFE SB maximum message size
+*/
+
+#define LOAD_GEN_MAX_MSG_LEN  MQTT_GW_LOAD_GEN_MSG_LEN
+
+
+/******************************************************************************
+** Decode Pool
+**
+** DECODE_POOL_MAX_WORKERS is the maximum DECODE_POOL_WORKER_CNT INI value
+** and the number of MSG_TRANS decode mutex stripes. It must be a power of 2.
+** Each worker has a DECODE_POOL_QUEUE_LEN message queue that must also be a
+** power of 2. Each queue entry holds a DECODE_POOL_PAYLOAD_LEN byte payload
+** which must cover the largest payload in MQTT_CLIENT_READ_BUF_LEN.
+*/
+
+#define DECODE_POOL_MAX_WORKERS    MQTT_GW_DECODE_MAX_WORKERS
+#define DECODE_POOL_QUEUE_LEN      MQTT_GW_DECODE_QUEUE_LEN
+#define DECODE_POOL_PAYLOAD_LEN    MQTT_CLIENT_READ_BUF_LEN
+
+#if (DECODE_POOL_MAX_WORKERS & (DECODE_POOL_MAX_WORKERS - 1)) != 0 || \
+    (DECODE_POOL_QUEUE_LEN & (DECODE_POOL_QUEUE_LEN - 1)) != 0
+   #error MQTT_GW_DECODE_MAX_WORKERS and MQTT_GW_DECODE_QUEUE_LEN must be powers of 2
+#endif
+
+
+/******************************************************************************
+** Real-time Loops
+**
+** RT_LOOP_MQTT_SPIN_YIELD_MS is the MQTT yield time used while the MQTT I/O
+** loop busy-polls. One millisecond is the MQTT library's timer resolution.
+*/
+
+#define RT_LOOP_MQTT_SPIN_YIELD_MS  1
+
+
+/******************************************************************************
+** Last Value Cache
+**
+** Each topic ID has a slot so the cache costs MQTT_TOPIC_TBL_MAX_TOPICS
+** times about LAST_VALUE_PAYLOAD_LEN + LAST_VALUE_SB_MSG_LEN + 64 bytes.
+** A value is only cached if its payload is shorter than
+** LAST_VALUE_PAYLOAD_LEN and its SB message fits in LAST_VALUE_SB_MSG_LEN
+** which must be a multiple of 4. A snapshot reader skips a slot that is
+** being written after LAST_VALUE_READ_RETRY attempts.
+** LAST_VALUE_FILE_LINE_LEN is the longest saved value line that is read by
+** a warm start. Saved topic names and payloads are JSON strings so it covers
+** a payload and topic name that are twice as long once escaped, and the
+** line's fields. A payload that escapes to a longer line isn't restored.
+*/
+
+#define LAST_VALUE_PAYLOAD_LEN   MQTT_GW_LAST_VALUE_PAYLOAD_LEN
+#define LAST_VALUE_SB_MSG_LEN    MQTT_GW_LAST_VALUE_SB_MSG_LEN
+#define LAST_VALUE_READ_RETRY      4
+#define LAST_VALUE_FILE_LINE_LEN (2*(LAST_VALUE_PAYLOAD_LEN + MQTT_TOPIC_TBL_MAX_TOPIC_LEN) + 192)
+
+#if (LAST_VALUE_SB_MSG_LEN % 4) != 0
+   #error MQTT_GW_LAST_VALUE_SB_MSG_LEN must be a multiple of 4
+#endif
+
+
+/******************************************************************************
+** Shared Memory Ring
+**
+** The ring holds the last SHM_RING_SLOT_CNT SB-to-MQTT messages and costs
+** SHM_RING_SLOT_CNT times SHM_RING_SLOT_LEN bytes of shared memory. A slot
+** holds a 16 byte header, the topic name, and the JSON payload with their
+** null terminators. Longer messages are not written to the ring.
+** SHM_RING_SLOT_LEN must be a multiple of 8.
+*/
+
+#define SHM_RING_SLOT_CNT  MQTT_GW_SHM_RING_SLOT_CNT
+#define SHM_RING_SLOT_LEN  MQTT_GW_SHM_RING_SLOT_LEN
+
+#if (SHM_RING_SLOT_LEN % 8) != 0
+   #error MQTT_GW_SHM_RING_SLOT_LEN must be a multiple of 8
+#endif
+
+
+/******************************************************************************
+** Local Broker
+**
+** Each client has receive and send buffers and room for
+** LOCAL_BROKER_MAX_FILTERS topic filters. A client's subscriptions are held
+** in one bit of the topic index so LOCAL_BROKER_MAX_CLIENTS can't exceed 32.
+** A client that doesn't send CONNECT within LOCAL_BROKER_CONNECT_TIMEOUT
+** seconds is disconnected.
+*/
+
+#define LOCAL_BROKER_MAX_CLIENTS     MQTT_GW_LOCAL_BROKER_CLIENTS
+#define LOCAL_BROKER_MAX_FILTERS     MQTT_GW_LOCAL_BROKER_FILTERS
+#define LOCAL_BROKER_RX_BUF_LEN      MQTT_CLIENT_READ_BUF_LEN
+#define LOCAL_BROKER_TX_BUF_LEN      (4*MQTT_CLIENT_SEND_BUF_LEN)
+#define LOCAL_BROKER_CONNECT_TIMEOUT 10
+
+#if LOCAL_BROKER_MAX_CLIENTS > 32
+   #error MQTT_GW_LOCAL_BROKER_CLIENTS must not exceed 32
+#endif
+
+
+/******************************************************************************
+** Latency Probe
+**
+** Percentiles are computed from the last LAT_PROBE_WINDOW_LEN round trips.
+** A probe that hasn't returned after LAT_PROBE_PENDING_CNT more probes have
+** been sent is counted as lost. Probe periods are in milliseconds.
 */
 
-#define MQTT_TOPIC_TBL_MAX_TOPICS             5
-#define MQTT_TOPIC_TBL_MAX_TOPIC_LEN         32
-#define MQTT_TOPIC_TBL_JSON_FILE_MAX_CHAR  2048
+#define LAT_PROBE_WINDOW_LEN   MQTT_GW_LAT_PROBE_WINDOW_LEN
+#define LAT_PROBE_PENDING_CNT   16
+#define LAT_PROBE_MIN_PERIOD    10
+#define LAT_PROBE_MAX_PERIOD   60000
 
 
 #endif /* _app_cfg_ */
@@ -0,0 +1,350 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Decode inbound MQTT messages in a pool of worker child tasks
+**
+** Notes:
+**   1. See decode_pool.h
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+
+#include "decode_pool.h"
+
+
+/************************************/
+/** Local File Function Prototypes **/
+/************************************/
+
+static bool Enqueue(DECODE_POOL_Worker_t *Worker, uint16 TopicId, uint32 Generation,
+                    const MQTTMessage *MqttMsg, uint32 RcvTime);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static DECODE_POOL_Class_t *DecodePool = NULL;
+
+
+/******************************************************************************
+** Function: DECODE_POOL_Constructor
+**
+** Notes:
+**   1. Worker i uses the INI PERF_ID plus i and a task name with i appended.
+**
+*/
+void DECODE_POOL_Constructor(DECODE_POOL_Class_t *DecodePoolPtr,
+                             const INITBL_Class_t *IniTbl)
+{
+
+   uint16  i;
+   uint16  WorkerCnt;
+   int32   SysStatus = CFE_SUCCESS;
+   DECODE_POOL_Worker_t *Worker;
+   CHILDMGR_TaskInit_t   ChildTaskInit;
+
+   DecodePool = DecodePoolPtr;
+
+   CFE_PSP_MemSet((void*)DecodePool, 0, sizeof(DECODE_POOL_Class_t));
+
+   WorkerCnt = INITBL_GetIntConfig(IniTbl, CFG_DECODE_POOL_WORKER_CNT);
+   if (WorkerCnt > DECODE_POOL_MAX_WORKERS)
+   {
+      CFE_EVS_SendEvent(DECODE_POOL_CONSTRUCT_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Decode pool worker count %d exceeds the maximum %d",
+                        WorkerCnt, DECODE_POOL_MAX_WORKERS);
+      WorkerCnt = DECODE_POOL_MAX_WORKERS;
+   }
+
+   for (i=0; i < WorkerCnt && SysStatus == CFE_SUCCESS; i++)
+   {
+
+      Worker = &DecodePool->Worker[i];
+      snprintf(Worker->TaskName, OS_MAX_API_NAME, "%s_%d",
+               INITBL_GetStrConfig(IniTbl, CFG_DECODE_POOL_CHILD_NAME), i);
+
+      SysStatus = OS_CountSemCreate(&Worker->WakeSem, Worker->TaskName, 0, 0);
+
+      if (SysStatus == OS_SUCCESS)
+      {
+         /* Child Manager constructor sends error events */
+         ChildTaskInit.TaskName  = Worker->TaskName;
+         ChildTaskInit.StackSize = INITBL_GetIntConfig(IniTbl, CFG_DECODE_POOL_CHILD_STACK_SIZE);
+         ChildTaskInit.Priority  = INITBL_GetIntConfig(IniTbl, CFG_DECODE_POOL_CHILD_PRIORITY);
+         ChildTaskInit.PerfId    = INITBL_GetIntConfig(IniTbl, CFG_DECODE_POOL_CHILD_PERF_ID) + i;
+         SysStatus = CHILDMGR_Constructor(&Worker->ChildMgr, ChildMgr_TaskMainCallback,
+                                          DECODE_POOL_WorkerTask, &ChildTaskInit);
+      }
+      else
+      {
+         CFE_EVS_SendEvent(DECODE_POOL_CONSTRUCT_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Error creating decode worker %d semaphore %s, status=%d",
+                           i, Worker->TaskName, (int)SysStatus);
+      }
+
+      if (SysStatus == CFE_SUCCESS)
+      {
+         DecodePool->WorkerCnt++;
+      }
+
+   } /* End worker loop */
+
+   CFE_EVS_SendEvent(DECODE_POOL_CONSTRUCT_EID, CFE_EVS_EventType_INFORMATION,
+                     "Decode pool created %d of %d workers", DecodePool->WorkerCnt, WorkerCnt);
+
+} /* End DECODE_POOL_Constructor() */
+
+
+/******************************************************************************
+** Function: DECODE_POOL_GetDropCnt
+**
+*/
+uint32 DECODE_POOL_GetDropCnt(void)
+{
+
+   uint16 i;
+   uint32 DropCnt = 0;
+
+   for (i=0; i < DecodePool->WorkerCnt; i++)
+   {
+      DropCnt += DecodePool->Worker[i].DropCnt;
+   }
+
+   return DropCnt;
+
+} /* End DECODE_POOL_GetDropCnt() */
+
+
+/******************************************************************************
+** Function: DECODE_POOL_GetMaxDepth
+**
+*/
+uint16 DECODE_POOL_GetMaxDepth(void)
+{
+
+   uint16 i;
+   uint16 MaxDepth = 0;
+
+   for (i=0; i < DecodePool->WorkerCnt; i++)
+   {
+      if (DecodePool->Worker[i].MaxDepth > MaxDepth)
+      {
+         MaxDepth = DecodePool->Worker[i].MaxDepth;
+      }
+   }
+
+   return MaxDepth;
+
+} /* End DECODE_POOL_GetMaxDepth() */
+
+
+/******************************************************************************
+** Function: DECODE_POOL_GetStaleCnt
+**
+*/
+uint32 DECODE_POOL_GetStaleCnt(void)
+{
+
+   uint16 i;
+   uint32 StaleCnt = 0;
+
+   for (i=0; i < DecodePool->WorkerCnt; i++)
+   {
+      StaleCnt += DecodePool->Worker[i].StaleCnt;
+   }
+
+   return StaleCnt;
+
+} /* End DECODE_POOL_GetStaleCnt() */
+
+
+/******************************************************************************
+** Function: DECODE_POOL_ProcessMqttMsg
+**
+** Notes:
+**   1. The receive time is taken before the topic lookup so the MQTT-to-SB
+**      translate latency includes the time spent in the queue.
+**   2. The generation is read before the topic lookup. A table load between
+**      the two can only cause a current topic to be dropped as stale, never
+**      a topic ID to be decoded with another topic's codec.
+**
+*/
+void DECODE_POOL_ProcessMqttMsg(MessageData* MsgData)
+{
+
+   uint32 RcvTime;
+   uint32 Generation;
+   uint16 TopicId;
+   DECODE_POOL_Worker_t *Worker;
+
+   if (DecodePool->WorkerCnt > 0)
+   {
+
+      RcvTime    = MSG_STATS_GetTime();
+      Generation = MQTT_TOPIC_TBL_GetData()->Generation;
+      TopicId    = MSG_TRANS_FindMqttTopic(MsgData);
+
+      if (TopicId != MQTT_TOPIC_TBL_UNUSED_ID)
+      {
+
+         Worker = &DecodePool->Worker[MSG_TRANS_DECODE_STRIPE(TopicId) % DecodePool->WorkerCnt];
+
+         if (Enqueue(Worker, TopicId, Generation, MsgData->message, RcvTime))
+         {
+            OS_CountSemGive(Worker->WakeSem);
+         }
+         else
+         {
+            ++Worker->DropCnt;
+         }
+      }
+   }
+   else
+   {
+      MSG_TRANS_ProcessMqttMsg(MsgData);
+   }
+
+} /* End DECODE_POOL_ProcessMqttMsg() */
+
+
+/******************************************************************************
+** Function: DECODE_POOL_ResetStatus
+**
+*/
+void DECODE_POOL_ResetStatus(void)
+{
+
+   uint16 i;
+
+   for (i=0; i < DecodePool->WorkerCnt; i++)
+   {
+      DecodePool->Worker[i].QueuedCnt = 0;
+      DecodePool->Worker[i].DropCnt   = 0;
+      DecodePool->Worker[i].MaxDepth  = 0;
+      DecodePool->Worker[i].StaleCnt  = 0;
+   }
+
+} /* End DECODE_POOL_ResetStatus() */
+
+
+/******************************************************************************
+** Function: DECODE_POOL_WorkerTask
+**
+** Notes:
+**   1. The message is decoded in place and its queue entry is released
+**      after the decode so the payload is not copied twice.
+**   2. The worker stays online from the generation check through the
+**      decode so the snapshot can't be retired while it is used.
+**
+*/
+bool DECODE_POOL_WorkerTask(CHILDMGR_Class_t *ChildMgr)
+{
+
+   uint16 i;
+   uint32 Tail;
+   DECODE_POOL_Worker_t *Worker = NULL;
+   DECODE_POOL_Msg_t    *Msg;
+
+   for (i=0; i < DECODE_POOL_MAX_WORKERS; i++)
+   {
+      if (&DecodePool->Worker[i].ChildMgr == ChildMgr)
+      {
+         Worker = &DecodePool->Worker[i];
+         break;
+      }
+   }
+
+   if (Worker != NULL)
+   {
+
+      MQTT_TOPIC_TBL_ReaderOffline(MQTT_TOPIC_TBL_READER_DECODE + i);
+      OS_CountSemTake(Worker->WakeSem);
+      MQTT_TOPIC_TBL_ReaderQuiescent(MQTT_TOPIC_TBL_READER_DECODE + i);
+
+      Tail = Worker->Tail;
+      if (Tail != __atomic_load_n(&Worker->Head, __ATOMIC_ACQUIRE))
+      {
+
+         Msg = &Worker->Queue[Tail % DECODE_POOL_QUEUE_LEN];
+         if (!MSG_TRANS_DecodeMqttMsg(Msg->TopicId, Msg->Generation, Msg->Payload,
+                                      Msg->PayloadLen, Msg->RcvTime))
+         {
+            ++Worker->StaleCnt;
+         }
+
+         __atomic_store_n(&Worker->Tail, Tail + 1, __ATOMIC_RELEASE);
+
+      }
+   }
+   else
+   {
+      OS_TaskDelay(1000);
+   }
+
+   return true;
+
+} /* End DECODE_POOL_WorkerTask() */
+
+
+/******************************************************************************
+** Function: Enqueue
+**
+** Copy a message to a worker's queue. Returns false if the queue is full or
+** the payload is too long.
+**
+*/
+static bool Enqueue(DECODE_POOL_Worker_t *Worker, uint16 TopicId, uint32 Generation,
+                    const MQTTMessage *MqttMsg, uint32 RcvTime)
+{
+
+   bool   RetStatus = false;
+   uint32 Head  = Worker->Head;
+   uint32 Depth = Head - __atomic_load_n(&Worker->Tail, __ATOMIC_ACQUIRE);
+   DECODE_POOL_Msg_t *Msg;
+
+   if (Depth < DECODE_POOL_QUEUE_LEN && MqttMsg->payloadlen <= DECODE_POOL_PAYLOAD_LEN)
+   {
+
+      Msg = &Worker->Queue[Head % DECODE_POOL_QUEUE_LEN];
+      Msg->TopicId    = TopicId;
+      Msg->Generation = Generation;
+      Msg->PayloadLen = (uint16)MqttMsg->payloadlen;
+      Msg->RcvTime    = RcvTime;
+      memcpy(Msg->Payload, MqttMsg->payload, MqttMsg->payloadlen);
+
+      __atomic_store_n(&Worker->Head, Head + 1, __ATOMIC_RELEASE);
+
+      ++Worker->QueuedCnt;
+      if (Depth + 1 > Worker->MaxDepth)
+      {
+         Worker->MaxDepth = Depth + 1;
+      }
+      RetStatus = true;
+
+   }
+
+   return RetStatus;
+
+} /* End Enqueue() */
@@ -0,0 +1,205 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Decode inbound MQTT messages in a pool of worker child tasks
+**
+** Notes:
+**   1. The MQTT child task only looks up a received message's topic and
+**      copies the payload to a worker queue so a slow decode can't delay
+**      socket reads and keep-alives. The workers decode the payload and
+**      send the SB message.
+**   2. A topic is always queued to the same worker so the messages of a
+**      topic are decoded in the order they were received. Topics are
+**      assigned by their MSG_TRANS decode stripe so two workers never
+**      contend for a decode mutex.
+**   3. Each queue has one producer (the MQTT child task) and one consumer
+**      (its worker) so the queue indices are updated with the GCC __atomic
+**      builtins and no lock is needed. A counting semaphore wakes the
+**      worker for each queued message.
+**   4. A message is dropped and counted when its worker's queue is full.
+**      The MQTT child task never waits for a worker.
+**   5. Each worker is a topic table reader that is offline while it waits
+**      for a message. A message is queued with the generation of the topic
+**      table snapshot its topic ID was found in. If a table load has made
+**      a different snapshot active by the time it is decoded the topic ID
+**      may name another topic so the message is dropped and counted.
+**   6. A zero DECODE_POOL_WORKER_CNT decodes messages in the MQTT child
+**      task.
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+#ifndef _decode_pool_
+#define _decode_pool_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "msg_trans.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/*
+** Event Message IDs
+*/
+
+#define DECODE_POOL_CONSTRUCT_EID      (DECODE_POOL_BASE_EID + 0)
+#define DECODE_POOL_CONSTRUCT_ERR_EID  (DECODE_POOL_BASE_EID + 1)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+typedef struct
+{
+
+   uint16  TopicId;
+   uint16  PayloadLen;
+   uint32  Generation;   /* Topic table snapshot TopicId was found in */
+   uint32  RcvTime;
+   char    Payload[DECODE_POOL_PAYLOAD_LEN];
+
+} DECODE_POOL_Msg_t;
+
+
+typedef struct
+{
+
+   CHILDMGR_Class_t  ChildMgr;
+   osal_id_t         WakeSem;
+   char              TaskName[OS_MAX_API_NAME];
+
+   uint32  Head;   /* Written by the MQTT child task */
+   uint32  Tail;   /* Written by the worker */
+
+   /*
+   ** Status, written by the MQTT child task
+   */
+
+   uint32  QueuedCnt;
+   uint32  DropCnt;
+   uint16  MaxDepth;
+
+   uint32  StaleCnt;   /* Written by the worker */
+
+   DECODE_POOL_Msg_t  Queue[DECODE_POOL_QUEUE_LEN];
+
+} DECODE_POOL_Worker_t;
+
+
+/*
+** Class Definition
+*/
+
+typedef struct
+{
+
+   uint16  WorkerCnt;
+
+   DECODE_POOL_Worker_t  Worker[DECODE_POOL_MAX_WORKERS];
+
+} DECODE_POOL_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: DECODE_POOL_Constructor
+**
+** Notes:
+**    1. This function must be called prior to any other functions being
+**       called using the same DECODE_POOL instance.
+**    2. The worker child tasks are created by the constructor. If a worker
+**       can't be created the pool is reduced to the workers that were
+**       created.
+*/
+void DECODE_POOL_Constructor(DECODE_POOL_Class_t *DecodePoolPtr,
+                             const INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: DECODE_POOL_GetDropCnt
+**
+** Return the total number of messages dropped because a queue was full.
+**
+*/
+uint32 DECODE_POOL_GetDropCnt(void);
+
+
+/******************************************************************************
+** Function: DECODE_POOL_GetMaxDepth
+**
+** Return the deepest queue depth seen by any worker.
+**
+*/
+uint16 DECODE_POOL_GetMaxDepth(void);
+
+
+/******************************************************************************
+** Function: DECODE_POOL_GetStaleCnt
+**
+** Return the total number of queued messages dropped because a table load
+** replaced the topic table snapshot they were looked up in.
+**
+*/
+uint32 DECODE_POOL_GetStaleCnt(void);
+
+
+/******************************************************************************
+** Function: DECODE_POOL_ProcessMqttMsg
+**
+** Queue a received MQTT message to its topic's decode worker.
+**
+** Notes:
+**   1. Signature must match MQTT_CLIENT_MsgCallback_t
+**   2. Must only be called by the MQTT child task because it is the only
+**      queue producer.
+**
+*/
+void DECODE_POOL_ProcessMqttMsg(MessageData* MsgData);
+
+
+/******************************************************************************
+** Function: DECODE_POOL_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+*/
+void DECODE_POOL_ResetStatus(void);
+
+
+/******************************************************************************
+** Function: DECODE_POOL_WorkerTask
+**
+** Notes:
+**   1. Signature must match CHILDMGR_TaskCallback_t
+**   2. Pends on the worker's semaphore and decodes one message per call.
+**
+*/
+bool DECODE_POOL_WorkerTask(CHILDMGR_Class_t *ChildMgr);
+
+
+#endif /* _decode_pool_ */
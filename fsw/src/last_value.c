@@ -0,0 +1,945 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Cache the last value of each topic
+**
+** Notes:
+**   1. See last_value.h
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <ctype.h>
+#include <string.h>
+
+#include "last_value.h"
+#include "local_broker.h"
+#include "mqtt_client.h"
+#include "mqtt_topic_tbl.h"
+#include "msg_trans.h"
+
+
+/************************************/
+/** Local File Function Prototypes **/
+/************************************/
+
+static bool CurrentSlot(uint16 TopicId, LAST_VALUE_Slot_t *Slot);
+static void PublishSnapshot(bool ToMqtt, bool ToSb, uint16 *MqttCnt, uint16 *SbCnt);
+static bool ReadSlot(uint16 TopicId, LAST_VALUE_Slot_t *Slot);
+static bool SendSavedValue(const char *ValueObj, size_t ValueObjLen);
+static bool UnescapeJsonStr(const char *Str, size_t StrLen, char *Buf, size_t BufLen, size_t *Len);
+static bool ValueLine(const char *Line, size_t LineLen, const char **ValueObj, size_t *ValueObjLen);
+static int32 WriteFile(const char *Filename, const char *Action, uint16 *ValueCnt);
+static void WriteJsonStr(osal_id_t FileHandle, const char *Str, size_t StrLen);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static LAST_VALUE_Class_t *LastValue = NULL;
+
+static const char *DirStr[MSG_STATS_DIR_CNT] = { "SB_TO_MQTT", "MQTT_TO_SB" };
+
+static const char HexDigit[] = "0123456789ABCDEF";
+
+
+/******************************************************************************
+** Function: LAST_VALUE_Constructor
+**
+** Notes:
+**   1. A LAST_VALUE_REQ_TOPIC of "UNDEF" disables snapshot requests.
+**   2. A LAST_VALUE_SAVE_FILE of "UNDEF" disables saves and warm starts.
+**   3. Without the save child task saves are only made when the app exits.
+**
+*/
+void LAST_VALUE_Constructor(LAST_VALUE_Class_t *LastValuePtr,
+                            const INITBL_Class_t *IniTbl)
+{
+
+   const char *ReqTopic = INITBL_GetStrConfig(IniTbl, CFG_LAST_VALUE_REQ_TOPIC);
+   const char *SaveFile = INITBL_GetStrConfig(IniTbl, CFG_LAST_VALUE_SAVE_FILE);
+   int32  SysStatus;
+   CHILDMGR_TaskInit_t ChildTaskInit;
+
+   LastValue = LastValuePtr;
+
+   CFE_PSP_MemSet((void*)LastValue, 0, sizeof(LAST_VALUE_Class_t));
+
+   if (strcmp(ReqTopic, "UNDEF") != 0)
+   {
+      strncpy(LastValue->ReqTopic, ReqTopic, MQTT_TOPIC_TBL_MAX_TOPIC_LEN-1);
+   }
+
+   if (strcmp(SaveFile, "UNDEF") != 0)
+   {
+      if ((strlen(SaveFile) + 4) < OS_MAX_PATH_LEN)
+      {
+         strcpy(LastValue->SaveFile, SaveFile);
+         sprintf(LastValue->SaveTmpFile, "%s.tmp", SaveFile);
+      }
+      else
+      {
+         CFE_EVS_SendEvent(LAST_VALUE_SAVE_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Last value saves disabled, save file %s is longer than %d characters",
+                           SaveFile, (OS_MAX_PATH_LEN-5));
+      }
+   }
+   LastValue->SavePeriod = INITBL_GetIntConfig(IniTbl, CFG_LAST_VALUE_SAVE_PERIOD);
+
+   OS_MutSemCreate(&LastValue->SaveMutex, "MQTT_LV_SAVE", 0);
+
+   if (LastValue->SaveFile[0] != '\0' && LastValue->SavePeriod > 0)
+   {
+
+      SysStatus = OS_BinSemCreate(&LastValue->SaveSem, "MQTT_LV_WAKE", OS_SEM_EMPTY, 0);
+
+      if (SysStatus == OS_SUCCESS)
+      {
+         /* Child Manager constructor sends error events */
+         ChildTaskInit.TaskName  = INITBL_GetStrConfig(IniTbl, CFG_LAST_VALUE_CHILD_NAME);
+         ChildTaskInit.StackSize = INITBL_GetIntConfig(IniTbl, CFG_LAST_VALUE_CHILD_STACK_SIZE);
+         ChildTaskInit.Priority  = INITBL_GetIntConfig(IniTbl, CFG_LAST_VALUE_CHILD_PRIORITY);
+         ChildTaskInit.PerfId    = INITBL_GetIntConfig(IniTbl, CFG_LAST_VALUE_CHILD_PERF_ID);
+         SysStatus = CHILDMGR_Constructor(&LastValue->ChildMgr, ChildMgr_TaskMainCallback,
+                                          LAST_VALUE_ChildTask, &ChildTaskInit);
+         LastValue->SaveChild = (SysStatus == CFE_SUCCESS);
+      }
+      else
+      {
+         CFE_EVS_SendEvent(LAST_VALUE_SAVE_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Periodic last value saves disabled, error creating save semaphore, status=%d",
+                           (int)SysStatus);
+      }
+   }
+
+} /* End LAST_VALUE_Constructor() */
+
+
+/******************************************************************************
+** Function: LAST_VALUE_ChildTask
+**
+*/
+bool LAST_VALUE_ChildTask(CHILDMGR_Class_t *ChildMgr)
+{
+
+   MQTT_TOPIC_TBL_ReaderOffline(MQTT_TOPIC_TBL_READER_LAST_VALUE);
+   OS_BinSemTake(LastValue->SaveSem);
+
+   MQTT_TOPIC_TBL_ReaderQuiescent(MQTT_TOPIC_TBL_READER_LAST_VALUE);
+   LAST_VALUE_Save();
+
+   return true;
+
+} /* End LAST_VALUE_ChildTask() */
+
+
+/******************************************************************************
+** Function: LAST_VALUE_DumpCmd
+**
+** Notes:
+**  1. See WriteFile() for the file format.
+**
+*/
+bool LAST_VALUE_DumpCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const MQTT_GW_DumpLastValues_Payload_t *DumpCmd = CMDMGR_PAYLOAD_PTR(MsgPtr, MQTT_GW_DumpLastValues_t);
+   bool       RetStatus = false;
+   int32      SysStatus;
+   os_err_name_t OsErrStr;
+   uint16     ValueCnt;
+
+
+   SysStatus = WriteFile(DumpCmd->Filename, "dumped", &ValueCnt);
+
+   if (SysStatus == OS_SUCCESS)
+   {
+
+      RetStatus = true;
+
+      CFE_EVS_SendEvent(LAST_VALUE_DUMP_EID, CFE_EVS_EventType_INFORMATION,
+                        "Dumped %u last values to %s", ValueCnt, DumpCmd->Filename);
+
+   } /* End if file create */
+   else
+   {
+      OS_GetErrorName(SysStatus, &OsErrStr);
+      CFE_EVS_SendEvent(LAST_VALUE_DUMP_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating last value dump file '%s', status=%s",
+                        DumpCmd->Filename, OsErrStr);
+
+   } /* End if file create error */
+
+   return RetStatus;
+
+} /* End LAST_VALUE_DumpCmd() */
+
+
+/******************************************************************************
+** Function: LAST_VALUE_GetTopicCnt
+**
+*/
+uint16 LAST_VALUE_GetTopicCnt(void)
+{
+
+   uint16 TopicId;
+   uint16 TopicCnt = 0;
+
+   for (TopicId=0; TopicId < MQTT_TOPIC_TBL_MAX_TOPICS; TopicId++)
+   {
+      if (__atomic_load_n(&LastValue->Slot[TopicId].Seq, __ATOMIC_RELAXED) != 0)
+      {
+         ++TopicCnt;
+      }
+   }
+
+   return TopicCnt;
+
+} /* End LAST_VALUE_GetTopicCnt() */
+
+
+/******************************************************************************
+** Function: LAST_VALUE_IsReqTopic
+**
+*/
+bool LAST_VALUE_IsReqTopic(const char *Topic, uint16 TopicLen)
+{
+
+   return (LastValue->ReqTopic[0] != '\0' && TopicLen < MQTT_TOPIC_TBL_MAX_TOPIC_LEN &&
+           strncmp(LastValue->ReqTopic, Topic, TopicLen) == 0 &&
+           LastValue->ReqTopic[TopicLen] == '\0');
+
+} /* End LAST_VALUE_IsReqTopic() */
+
+
+/******************************************************************************
+** Function: LAST_VALUE_PeriodicSave
+**
+*/
+void LAST_VALUE_PeriodicSave(void)
+{
+
+   if (LastValue->SaveChild)
+   {
+      if (++LastValue->SaveHkCnt >= LastValue->SavePeriod)
+      {
+         LastValue->SaveHkCnt = 0;
+         OS_BinSemGive(LastValue->SaveSem);
+      }
+   }
+
+} /* End LAST_VALUE_PeriodicSave() */
+
+
+/******************************************************************************
+** Function: LAST_VALUE_PublishCmd
+**
+*/
+bool LAST_VALUE_PublishCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   bool   Connected = MQTT_CLIENT_IsConnected();
+   uint16 MqttCnt;
+   uint16 SbCnt;
+
+   PublishSnapshot(Connected, true, &MqttCnt, &SbCnt);
+
+   CFE_EVS_SendEvent(LAST_VALUE_PUBLISH_EID, CFE_EVS_EventType_INFORMATION,
+                     "Published last values: %u MQTT topics, %u SB messages%s",
+                     MqttCnt, SbCnt, (Connected ? "" : ". MQTT client is not connected"));
+
+   return true;
+
+} /* End LAST_VALUE_PublishCmd() */
+
+
+/******************************************************************************
+** Function: LAST_VALUE_Request
+**
+*/
+void LAST_VALUE_Request(void)
+{
+
+   __atomic_store_n(&LastValue->PublishReq, true, __ATOMIC_RELEASE);
+
+} /* End LAST_VALUE_Request() */
+
+
+/******************************************************************************
+** Function: LAST_VALUE_ResetStatus
+**
+*/
+void LAST_VALUE_ResetStatus(void)
+{
+
+   LastValue->SkipCnt    = 0;
+   LastValue->PublishCnt = 0;
+
+} /* End LAST_VALUE_ResetStatus() */
+
+
+/******************************************************************************
+** Function: LAST_VALUE_Save
+**
+** Notes:
+**   1. Successful saves are counted, only errors generate events.
+**
+*/
+void LAST_VALUE_Save(void)
+{
+
+   int32  SysStatus;
+   uint16 ValueCnt;
+   os_err_name_t OsErrStr;
+
+   if (LastValue->SaveFile[0] != '\0' && LAST_VALUE_GetTopicCnt() > 0)
+   {
+
+      OS_MutSemTake(LastValue->SaveMutex);
+      SysStatus = WriteFile(LastValue->SaveTmpFile, "saved", &ValueCnt);
+      if (SysStatus == OS_SUCCESS)
+      {
+         SysStatus = OS_rename(LastValue->SaveTmpFile, LastValue->SaveFile);
+      }
+      OS_MutSemGive(LastValue->SaveMutex);
+
+      if (SysStatus == OS_SUCCESS)
+      {
+         __atomic_fetch_add(&LastValue->SaveCnt, 1, __ATOMIC_RELAXED);
+      }
+      else
+      {
+         OS_GetErrorName(SysStatus, &OsErrStr);
+         CFE_EVS_SendEvent(LAST_VALUE_SAVE_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Error saving last values to %s, status=%s",
+                           LastValue->SaveFile, OsErrStr);
+      }
+   }
+
+} /* End LAST_VALUE_Save() */
+
+
+/******************************************************************************
+** Function: LAST_VALUE_ServiceRequest
+**
+** Notes:
+**   1. Each request only publishes one snapshot no matter how many request
+**      messages were received since the last call.
+**
+*/
+void LAST_VALUE_ServiceRequest(void)
+{
+
+   uint16 MqttCnt;
+   uint16 SbCnt;
+
+   if (__atomic_exchange_n(&LastValue->PublishReq, false, __ATOMIC_ACQUIRE))
+   {
+      PublishSnapshot(true, false, &MqttCnt, &SbCnt);
+      CFE_EVS_SendEvent(LAST_VALUE_PUBLISH_EID, CFE_EVS_EventType_INFORMATION,
+                        "Published %u last value MQTT topics for a %s request",
+                        MqttCnt, LastValue->ReqTopic);
+   }
+
+} /* End LAST_VALUE_ServiceRequest() */
+
+
+/******************************************************************************
+** Function: LAST_VALUE_Update
+**
+** Notes:
+**   1. The sequence lock is taken with a compare and swap so concurrent
+**      writers of the same slot never write it at the same time.
+**
+*/
+void LAST_VALUE_Update(uint16 TopicId, MSG_STATS_Dir_t Dir, const char *Topic,
+                       const char *Payload, uint16 PayloadLen,
+                       const CFE_MSG_Message_t *SbMsg)
+{
+
+   const MQTT_TOPIC_TBL_Entry_t *Entry = MQTT_TOPIC_TBL_GetEntry(TopicId);
+   CFE_MSG_Size_t     SbMsgLen = 0;
+   LAST_VALUE_Slot_t *Slot;
+   uint32 Seq;
+
+   CFE_MSG_GetSize(SbMsg, &SbMsgLen);
+
+   if (Entry == NULL || PayloadLen >= LAST_VALUE_PAYLOAD_LEN || SbMsgLen > LAST_VALUE_SB_MSG_LEN)
+   {
+      __atomic_fetch_add(&LastValue->SkipCnt, 1, __ATOMIC_RELAXED);
+   }
+   else
+   {
+
+      Slot = &LastValue->Slot[TopicId];
+      Seq  = __atomic_load_n(&Slot->Seq, __ATOMIC_RELAXED);
+
+      if ((Seq & 1) == 0 &&
+          __atomic_compare_exchange_n(&Slot->Seq, &Seq, Seq + 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+      {
+
+         Slot->Dir        = Dir;
+         Slot->SbMid      = Entry->SbMid;
+         Slot->Time       = CFE_TIME_GetTime();
+         Slot->PayloadLen = PayloadLen;
+         Slot->SbMsgLen   = SbMsgLen;
+
+         strncpy(Slot->Topic, Topic, MQTT_TOPIC_TBL_MAX_TOPIC_LEN-1);
+         Slot->Topic[MQTT_TOPIC_TBL_MAX_TOPIC_LEN-1] = '\0';
+         memcpy(Slot->Payload, Payload, PayloadLen);
+         Slot->Payload[PayloadLen] = '\0';
+         memcpy(Slot->SbMsg, SbMsg, SbMsgLen);
+
+         __atomic_store_n(&Slot->Seq, Seq + 2, __ATOMIC_RELEASE);
+
+      }
+      else
+      {
+         __atomic_fetch_add(&LastValue->SkipCnt, 1, __ATOMIC_RELAXED);
+      }
+   }
+
+} /* End LAST_VALUE_Update() */
+
+
+/******************************************************************************
+** Function: LAST_VALUE_WarmStart
+**
+** Notes:
+**   1. A missing file is a normal cold start.
+**   2. The file is read in blocks and split into lines so its size isn't
+**      limited by a buffer. A value line that doesn't fit in the line
+**      buffer is skipped.
+**
+*/
+void LAST_VALUE_WarmStart(void)
+{
+
+   int32      SysStatus;
+   osal_id_t  FileHandle;
+   int32      ReadLen;
+   int32      i;
+   size_t     LineLen = 0;
+   bool       LineOverflow = false;
+   uint16     ValueCnt = 0;
+   const char *ValueObj;
+   size_t     ValueObjLen;
+   char       ReadBuf[256];
+   char       Line[LAST_VALUE_FILE_LINE_LEN];
+
+   if (LastValue->SaveFile[0] != '\0')
+   {
+
+      SysStatus = OS_OpenCreate(&FileHandle, LastValue->SaveFile, OS_FILE_FLAG_NONE, OS_READ_ONLY);
+
+      if (SysStatus == OS_SUCCESS)
+      {
+
+         while ((ReadLen = OS_read(FileHandle, ReadBuf, sizeof(ReadBuf))) > 0)
+         {
+            for (i=0; i < ReadLen; i++)
+            {
+               if (ReadBuf[i] == '\n')
+               {
+                  if (ValueLine(Line, LineLen, &ValueObj, &ValueObjLen))
+                  {
+                     ++ValueCnt;
+                     if (!LineOverflow && SendSavedValue(ValueObj, ValueObjLen))
+                     {
+                        ++LastValue->WarmStartCnt;
+                     }
+                  }
+                  LineLen = 0;
+                  LineOverflow = false;
+               }
+               else if (LineLen < sizeof(Line))
+               {
+                  Line[LineLen++] = ReadBuf[i];
+               }
+               else
+               {
+                  LineOverflow = true;
+               }
+            }
+         } /* End read loop */
+
+         OS_close(FileHandle);
+
+         CFE_EVS_SendEvent(LAST_VALUE_WARM_START_EID, CFE_EVS_EventType_INFORMATION,
+                           "Warm start sent %u of %u saved values from %s on the SB",
+                           LastValue->WarmStartCnt, ValueCnt, LastValue->SaveFile);
+
+      } /* End if file open */
+      else
+      {
+         CFE_EVS_SendEvent(LAST_VALUE_WARM_START_EID, CFE_EVS_EventType_INFORMATION,
+                           "Cold start, no saved last values in %s", LastValue->SaveFile);
+      }
+   }
+
+} /* End LAST_VALUE_WarmStart() */
+
+
+/******************************************************************************
+** Function: CurrentSlot
+**
+** Copy topic 'TopicId's slot and return true if it holds a value for the
+** topic's current table definition.
+**
+*/
+static bool CurrentSlot(uint16 TopicId, LAST_VALUE_Slot_t *Slot)
+{
+
+   const MQTT_TOPIC_TBL_Entry_t *Entry;
+   bool RetStatus = false;
+
+   if (ReadSlot(TopicId, Slot))
+   {
+
+      Entry = MQTT_TOPIC_TBL_GetEntry(TopicId);
+      if (Entry != NULL && Entry->SbMid == Slot->SbMid)
+      {
+         RetStatus = (Slot->Dir == MSG_STATS_DIR_SB_TO_MQTT) ?
+                     (Entry->SbRole == MQTT_TOPIC_TBL_SB_ROLE_SUB) :
+                     (Entry->SbRole == MQTT_TOPIC_TBL_SB_ROLE_PUB);
+      }
+   }
+
+   return RetStatus;
+
+} /* End CurrentSlot() */
+
+
+/******************************************************************************
+** Function: PublishSnapshot
+**
+** Publish each current SB-to-MQTT value to MQTT if ToMqtt is true and send
+** each current MQTT-to-SB message on the SB if ToSb is true.
+**
+** Notes:
+**   1. Values are published with their topic's retain flag so a snapshot
+**      doesn't change what the broker retains.
+**
+*/
+static void PublishSnapshot(bool ToMqtt, bool ToSb, uint16 *MqttCnt, uint16 *SbCnt)
+{
+
+   uint16 TopicId;
+   const MQTT_TOPIC_TBL_Entry_t *Entry;
+   LAST_VALUE_Slot_t Slot;
+
+   *MqttCnt = 0;
+   *SbCnt   = 0;
+
+   for (TopicId=0; TopicId < MQTT_TOPIC_TBL_GetTopicCnt(); TopicId++)
+   {
+
+      if (CurrentSlot(TopicId, &Slot))
+      {
+         if (Slot.Dir == MSG_STATS_DIR_SB_TO_MQTT)
+         {
+            Entry = MQTT_TOPIC_TBL_GetEntry(TopicId);
+            if (ToMqtt)
+            {
+               LOCAL_BROKER_Publish(TopicId, Slot.Topic, Slot.Payload, Slot.PayloadLen);
+            }
+            if (ToMqtt && MQTT_CLIENT_Publish(Slot.Topic, Slot.Payload, (Entry != NULL && Entry->Retain)))
+            {
+               ++(*MqttCnt);
+            }
+         }
+         else
+         {
+            if (ToSb && CFE_SB_TransmitMsg((CFE_MSG_Message_t *)Slot.SbMsg, false) == CFE_SUCCESS)
+            {
+               ++(*SbCnt);
+            }
+         }
+      }
+
+   } /* End topic loop */
+
+   ++LastValue->PublishCnt;
+
+} /* End PublishSnapshot() */
+
+
+/******************************************************************************
+** Function: ReadSlot
+**
+** Copy topic 'TopicId's slot and return true if it holds a value.
+**
+** Notes:
+**   1. The copy is retried if a writer changes the slot while it is copied.
+**      The slot is skipped if it keeps changing.
+**
+*/
+static bool ReadSlot(uint16 TopicId, LAST_VALUE_Slot_t *Slot)
+{
+
+   const LAST_VALUE_Slot_t *CacheSlot = &LastValue->Slot[TopicId];
+   bool   RetStatus = false;
+   uint16 Retry;
+   uint32 Seq;
+
+   for (Retry=0; Retry < LAST_VALUE_READ_RETRY && !RetStatus; Retry++)
+   {
+
+      Seq = __atomic_load_n(&CacheSlot->Seq, __ATOMIC_ACQUIRE);
+      if (Seq == 0)
+      {
+         break;
+      }
+
+      if ((Seq & 1) == 0)
+      {
+         memcpy(Slot, CacheSlot, sizeof(LAST_VALUE_Slot_t));
+         __atomic_thread_fence(__ATOMIC_ACQUIRE);
+         RetStatus = (__atomic_load_n(&CacheSlot->Seq, __ATOMIC_RELAXED) == Seq);
+      }
+
+   } /* End retry loop */
+
+   return RetStatus;
+
+} /* End ReadSlot() */
+
+
+/******************************************************************************
+** Function: SendSavedValue
+**
+** Decode a saved value's payload and send it on the SB. Returns true if the
+** value is an MQTT-to-SB value of a current MQTT-to-SB topic.
+**
+** Notes:
+**   1. The decode sends an error event if the payload can't be translated.
+**   2. The topic name and payload are unescaped JSON strings. A payload that
+**      isn't a string is passed as written.
+**   3. A multiplexed topic's value is found by name and sent to the topic
+**      selected by its envelope tag.
+**
+*/
+static bool SendSavedValue(const char *ValueObj, size_t ValueObjLen)
+{
+
+   bool        RetStatus = false;
+   const char *Value;
+   size_t      ValueLen;
+   JSONTypes_t ValueType;
+   uint16      TopicId = MQTT_TOPIC_TBL_UNUSED_ID;
+   const MQTT_TOPIC_TBL_Entry_t *Entry;
+   const char *Dir = DirStr[MSG_STATS_DIR_MQTT_TO_SB];
+   char        Topic[MQTT_TOPIC_TBL_MAX_TOPIC_LEN];
+   char        Payload[LAST_VALUE_PAYLOAD_LEN];
+   size_t      Len;
+
+   if (JSON_SearchConst(ValueObj, ValueObjLen, "dir", 3, &Value, &ValueLen, &ValueType) == JSONValid &&
+       ValueType == JSONString && ValueLen == strlen(Dir) && strncmp(Value, Dir, ValueLen) == 0)
+   {
+      if (JSON_SearchConst(ValueObj, ValueObjLen, "topic", 5, &Value, &ValueLen, &ValueType) == JSONValid &&
+          ValueType == JSONString && UnescapeJsonStr(Value, ValueLen, Topic, sizeof(Topic), &Len))
+      {
+         TopicId = MQTT_TOPIC_TBL_FindName(Topic, (uint16)Len);
+      }
+   }
+
+   Entry = MQTT_TOPIC_TBL_GetEntry(TopicId);
+   if (Entry != NULL && Entry->SbRole == MQTT_TOPIC_TBL_SB_ROLE_PUB &&
+       JSON_SearchConst(ValueObj, ValueObjLen, "payload", 7, &Value, &ValueLen, &ValueType) == JSONValid)
+   {
+      if (ValueType == JSONString)
+      {
+         if (!UnescapeJsonStr(Value, ValueLen, Payload, sizeof(Payload), &ValueLen))
+         {
+            ValueLen = LAST_VALUE_PAYLOAD_LEN;
+         }
+         Value = Payload;
+      }
+      if (ValueLen < LAST_VALUE_PAYLOAD_LEN)
+      {
+         TopicId = MSG_TRANS_DemuxMqttMsg(TopicId, Value, (uint16)ValueLen);
+         if (TopicId != MQTT_TOPIC_TBL_UNUSED_ID)
+         {
+            MSG_TRANS_DecodeMqttMsg(TopicId, 0, Value, (uint16)ValueLen, MSG_STATS_GetTime());
+            RetStatus = true;
+         }
+      }
+   }
+
+   return RetStatus;
+
+} /* End SendSavedValue() */
+
+
+/******************************************************************************
+** Function: UnescapeJsonStr
+**
+** Unescape a JSON string's contents into a null terminated buffer. Returns
+** false if the string has an invalid escape or doesn't fit.
+**
+** Notes:
+**   1. Only the escapes written by WriteJsonStr() and the JSON single
+**      character escapes are accepted. \u escapes must be less than 0x100.
+**
+*/
+static bool UnescapeJsonStr(const char *Str, size_t StrLen, char *Buf, size_t BufLen, size_t *Len)
+{
+
+   bool   RetStatus = true;
+   size_t i = 0;
+   const char *Hex;
+   uint16 Digit;
+   uint16 Byte;
+
+   *Len = 0;
+
+   while (i < StrLen && RetStatus)
+   {
+
+      if ((*Len + 1) >= BufLen)
+      {
+         RetStatus = false;
+      }
+      else if (Str[i] != '\\')
+      {
+         Buf[(*Len)++] = Str[i++];
+      }
+      else if ((i + 1) < StrLen)
+      {
+         switch (Str[i+1])
+         {
+            case '"':  Buf[(*Len)++] = '"';  break;
+            case '\\': Buf[(*Len)++] = '\\'; break;
+            case '/':  Buf[(*Len)++] = '/';  break;
+            case 'b':  Buf[(*Len)++] = '\b'; break;
+            case 'f':  Buf[(*Len)++] = '\f'; break;
+            case 'n':  Buf[(*Len)++] = '\n'; break;
+            case 'r':  Buf[(*Len)++] = '\r'; break;
+            case 't':  Buf[(*Len)++] = '\t'; break;
+            case 'u':
+               Byte = 0;
+               for (Digit=0; Digit < 4 && RetStatus; Digit++)
+               {
+                  Hex = ((i + 2 + Digit) < StrLen) ? strchr(HexDigit, toupper((unsigned char)Str[i+2+Digit])) : NULL;
+                  if (Hex == NULL || *Hex == '\0')
+                  {
+                     RetStatus = false;
+                  }
+                  else
+                  {
+                     Byte = (Byte << 4) | (uint16)(Hex - HexDigit);
+                  }
+               }
+               if (RetStatus && Byte < 0x100)
+               {
+                  Buf[(*Len)++] = (char)Byte;
+                  i += 4;
+               }
+               else
+               {
+                  RetStatus = false;
+               }
+               break;
+            default:
+               RetStatus = false;
+               break;
+         } /* End escape switch */
+         i += 2;
+      }
+      else
+      {
+         RetStatus = false;
+      }
+
+   } /* End string loop */
+
+   Buf[*Len] = '\0';
+
+   return RetStatus;
+
+} /* End UnescapeJsonStr() */
+
+
+/******************************************************************************
+** Function: ValueLine
+**
+** Return true if a file line is a value and return the value's JSON object.
+**
+** Notes:
+**   1. Value lines start with {"id" after the indent and may end with the
+**      array's separating comma.
+**
+*/
+static bool ValueLine(const char *Line, size_t LineLen, const char **ValueObj, size_t *ValueObjLen)
+{
+
+   bool   RetStatus = false;
+   size_t Start = 0;
+
+   while (Start < LineLen && Line[Start] == ' ')
+   {
+      ++Start;
+   }
+   while (LineLen > Start && (Line[LineLen-1] == ',' || Line[LineLen-1] == ' ' || Line[LineLen-1] == '\r'))
+   {
+      --LineLen;
+   }
+
+   if ((LineLen - Start) > 5 && strncmp(&Line[Start], "{\"id\"", 5) == 0)
+   {
+      *ValueObj    = &Line[Start];
+      *ValueObjLen = LineLen - Start;
+      RetStatus    = true;
+   }
+
+   return RetStatus;
+
+} /* End ValueLine() */
+
+
+/******************************************************************************
+** Function: WriteFile
+**
+** Write every current cached value to a JSON file and return the OSAL file
+** create status.
+**
+** Notes:
+**  1. File is formatted as a JSON object with a value array in topic ID
+**     order. Each value is on its own line and its topic name and payload
+**     are written as JSON strings. See WriteJsonStr().
+**  2. Creates a new file, overwriting anything that may have existed
+**     previously
+**
+*/
+static int32 WriteFile(const char *Filename, const char *Action, uint16 *ValueCnt)
+{
+
+   int32      SysStatus;
+   osal_id_t  FileHandle;
+   uint16     TopicId;
+   LAST_VALUE_Slot_t Slot;
+   char DumpRecord[256];
+   char SysTimeStr[128];
+
+   *ValueCnt = 0;
+
+   SysStatus = OS_OpenCreate(&FileHandle, Filename, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_READ_WRITE);
+
+   if (SysStatus == OS_SUCCESS)
+   {
+
+      CFE_TIME_Print(SysTimeStr, CFE_TIME_GetTime());
+      sprintf(DumpRecord,"{\n   \"description\": \"Last values %s at %s\",\n   \"values\": [\n",Action,SysTimeStr);
+      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+      for (TopicId=0; TopicId < MQTT_TOPIC_TBL_GetTopicCnt(); TopicId++)
+      {
+
+         if (!CurrentSlot(TopicId, &Slot))
+         {
+            continue;
+         }
+
+         CFE_TIME_Print(SysTimeStr, Slot.Time);
+         sprintf(DumpRecord,"%s      {\"id\": %u, \"topic\": ", (*ValueCnt > 0) ? ",\n" : "", TopicId);
+         OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+         WriteJsonStr(FileHandle, Slot.Topic, strlen(Slot.Topic));
+         sprintf(DumpRecord,", \"dir\": \"%s\", \"sb-mid\": %u, \"sb-len\": %u, \"time\": \"%s\", \"payload\": ",
+                 DirStr[Slot.Dir], (unsigned int)Slot.SbMid, (unsigned int)Slot.SbMsgLen, SysTimeStr);
+         OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+         WriteJsonStr(FileHandle, Slot.Payload, Slot.PayloadLen);
+         OS_write(FileHandle,"}",1);
+         ++(*ValueCnt);
+
+      } /* End topic loop */
+
+      sprintf(DumpRecord,"\n   ]\n}\n");
+      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+      OS_close(FileHandle);
+
+   } /* End if file create */
+
+   return SysStatus;
+
+} /* End WriteFile() */
+
+
+/******************************************************************************
+** Function: WriteJsonStr
+**
+** Write a string as a quoted and escaped JSON string.
+**
+** Notes:
+**   1. Quotes, backslashes, and bytes outside printable ASCII are escaped.
+**      Control characters and bytes above 0x7E are written as \u00XX so
+**      the file is valid JSON and UnescapeJsonStr() restores every byte.
+**   2. The string is escaped through a small buffer so its length isn't
+**      limited.
+**
+*/
+static void WriteJsonStr(osal_id_t FileHandle, const char *Str, size_t StrLen)
+{
+
+   char   Buf[128];
+   size_t BufLen = 0;
+   size_t i;
+   uint8  Byte;
+
+   Buf[BufLen++] = '"';
+
+   for (i=0; i < StrLen; i++)
+   {
+
+      if (BufLen > (sizeof(Buf) - 8))
+      {
+         OS_write(FileHandle, Buf, BufLen);
+         BufLen = 0;
+      }
+
+      Byte = (uint8)Str[i];
+      if (Byte == '"' || Byte == '\\')
+      {
+         Buf[BufLen++] = '\\';
+         Buf[BufLen++] = (char)Byte;
+      }
+      else if (Byte < 0x20 || Byte > 0x7E)
+      {
+         Buf[BufLen++] = '\\';
+         Buf[BufLen++] = 'u';
+         Buf[BufLen++] = '0';
+         Buf[BufLen++] = '0';
+         Buf[BufLen++] = HexDigit[Byte >> 4];
+         Buf[BufLen++] = HexDigit[Byte & 0x0F];
+      }
+      else
+      {
+         Buf[BufLen++] = (char)Byte;
+      }
+
+   } /* End string loop */
+
+   Buf[BufLen++] = '"';
+   OS_write(FileHandle, Buf, BufLen);
+
+} /* End WriteJsonStr() */
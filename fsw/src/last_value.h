@@ -0,0 +1,302 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Cache the last value of each topic
+**
+** Notes:
+**   1. Each topic ID has a preallocated slot that holds the topic's last
+**      JSON payload, SB message, and cFE receive time. MSG_TRANS updates
+**      a slot each time it translates a message in either direction.
+**   2. A snapshot of every cached value can be published or dumped to a
+**      file by command. A snapshot publish sends the SB-to-MQTT values to
+**      the broker and the MQTT-to-SB messages on the SB so late joining
+**      dashboards and apps get the current state without waiting for the
+**      next sample of slow topics.
+**   3. A message received on the LAST_VALUE_REQ_TOPIC MQTT topic requests
+**      a publish of the SB-to-MQTT values. The request is recorded by the
+**      MQTT message callback and serviced by the main task so the publishes
+**      aren't made from inside the MQTT library and the MQTT client is only
+**      published to by one task. Requests are event filtered so a flood of
+**      requests can't flood EVS.
+**   4. Slots are written by the main task, the decode workers, and the
+**      child tasks so each slot is protected by a sequence lock. A writer
+**      that finds a slot being written skips its update because the other
+**      writer's value is just as current. Readers retry a slot that
+**      changes while it is copied.
+**   5. A slot records its topic's SB message ID and direction. A cached
+**      value is ignored if the topic was changed by a table load.
+**   6. The cache is saved to LAST_VALUE_SAVE_FILE every
+**      LAST_VALUE_SAVE_PERIOD housekeeping requests and when the app exits.
+**      Periodic saves are made by a low priority child task that the
+**      housekeeping request wakes so file writes never delay the main
+**      task. The file has the dump format with one value per line. It is
+**      written to a temporary file that is renamed so a crash never leaves
+**      a partial file. An empty cache isn't saved so a short run doesn't
+**      erase the previous state.
+**   7. Warm start: at startup each saved MQTT-to-SB value whose topic is
+**      still an MQTT-to-SB topic is decoded and sent on the SB in one
+**      burst. This also fills the cache. SB-to-MQTT values are restored by
+**      the broker's retained messages.
+**   8. Topic names and payloads are written as escaped JSON strings so a
+**      file is valid JSON whatever bytes a payload holds. Bytes outside
+**      printable ASCII are written as \u00XX escapes so a warm start
+**      restores a payload byte for byte.
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+#ifndef _last_value_
+#define _last_value_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "msg_stats.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/*
+** Event Message IDs
+*/
+
+#define LAST_VALUE_PUBLISH_EID    (LAST_VALUE_BASE_EID + 0)
+#define LAST_VALUE_DUMP_EID       (LAST_VALUE_BASE_EID + 1)
+#define LAST_VALUE_DUMP_ERR_EID   (LAST_VALUE_BASE_EID + 2)
+#define LAST_VALUE_SAVE_ERR_EID   (LAST_VALUE_BASE_EID + 3)
+#define LAST_VALUE_WARM_START_EID (LAST_VALUE_BASE_EID + 4)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+typedef struct
+{
+
+   uint32  Seq;          /* Odd while the slot is written, zero if it has never been written */
+   uint8   Dir;          /* MSG_STATS_Dir_t */
+   uint8   Spare;
+   uint16  PayloadLen;
+   uint32  SbMid;        /* Topic's SB message ID value when the value was cached */
+   uint32  SbMsgLen;
+
+   CFE_TIME_SysTime_t  Time;
+
+   char    Topic[MQTT_TOPIC_TBL_MAX_TOPIC_LEN];
+   char    Payload[LAST_VALUE_PAYLOAD_LEN];            /* Null terminated */
+   uint32  SbMsg[LAST_VALUE_SB_MSG_LEN/sizeof(uint32)];  /* uint32 for CFE_MSG_Message_t alignment */
+
+} LAST_VALUE_Slot_t;
+
+
+/*
+** Class Definition
+*/
+
+typedef struct
+{
+
+   bool    PublishReq;   /* Set by the MQTT callback, cleared by the main task */
+   char    ReqTopic[MQTT_TOPIC_TBL_MAX_TOPIC_LEN];   /* Empty if requests are disabled */
+
+   char    SaveFile[OS_MAX_PATH_LEN];      /* Empty if saves are disabled */
+   char    SaveTmpFile[OS_MAX_PATH_LEN];
+   uint16  SavePeriod;   /* Housekeeping requests between saves, 0 = Only save on exit */
+   uint16  SaveHkCnt;
+   bool    SaveChild;    /* Periodic save child task created */
+   osal_id_t  SaveSem;   /* Wakes the save child task */
+   osal_id_t  SaveMutex; /* Serializes periodic and exit saves */
+   CHILDMGR_Class_t  ChildMgr;
+
+   uint32  SkipCnt;      /* Updates not cached because they were too long or the slot was busy */
+   uint32  PublishCnt;   /* Snapshots published */
+   uint32  SaveCnt;      /* Files saved */
+   uint16  WarmStartCnt; /* Saved values sent on the SB at startup */
+
+   LAST_VALUE_Slot_t  Slot[MQTT_TOPIC_TBL_MAX_TOPICS];
+
+} LAST_VALUE_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: LAST_VALUE_Constructor
+**
+** Notes:
+**    1. This function must be called prior to any other functions being
+**       called using the same LAST_VALUE instance.
+**    2. The periodic save child task is only created if periodic saves are
+**       enabled.
+**
+*/
+void LAST_VALUE_Constructor(LAST_VALUE_Class_t *LastValuePtr,
+                            const INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: LAST_VALUE_ChildTask
+**
+** Make a periodic save each time LAST_VALUE_PeriodicSave() wakes the task.
+**
+** Notes:
+**   1. Signature must match CHILDMGR_TaskCallback_t
+**   2. The task is an offline topic table reader while it waits.
+**
+*/
+bool LAST_VALUE_ChildTask(CHILDMGR_Class_t *ChildMgr);
+
+
+/******************************************************************************
+** Function: LAST_VALUE_DumpCmd
+**
+** Write every cached value to a JSON file.
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**
+*/
+bool LAST_VALUE_DumpCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: LAST_VALUE_GetTopicCnt
+**
+** Return the number of topics that have a cached value.
+**
+*/
+uint16 LAST_VALUE_GetTopicCnt(void);
+
+
+/******************************************************************************
+** Function: LAST_VALUE_IsReqTopic
+**
+** Return true if an MQTT topic name is the snapshot request topic.
+**
+** Notes:
+**   1. The MQTT topic name is a length string that is not null terminated
+**
+*/
+bool LAST_VALUE_IsReqTopic(const char *Topic, uint16 TopicLen);
+
+
+/******************************************************************************
+** Function: LAST_VALUE_PeriodicSave
+**
+** Wake the save child task every LAST_VALUE_SAVE_PERIOD calls.
+**
+** Notes:
+**   1. Called for each housekeeping request.
+**
+*/
+void LAST_VALUE_PeriodicSave(void);
+
+
+/******************************************************************************
+** Function: LAST_VALUE_PublishCmd
+**
+** Publish a snapshot of every cached value.
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**
+*/
+bool LAST_VALUE_PublishCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: LAST_VALUE_Request
+**
+** Request a publish of the SB-to-MQTT values by the main task.
+**
+*/
+void LAST_VALUE_Request(void);
+
+
+/******************************************************************************
+** Function: LAST_VALUE_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+** Notes:
+**   1. Cached values are not cleared.
+**
+*/
+void LAST_VALUE_ResetStatus(void);
+
+
+/******************************************************************************
+** Function: LAST_VALUE_Save
+**
+** Save the cache to LAST_VALUE_SAVE_FILE if saves are enabled.
+**
+** Notes:
+**   1. Called by the save child task and by the main task when the app
+**      exits. Saves are serialized so they never share the temporary file.
+**
+*/
+void LAST_VALUE_Save(void);
+
+
+/******************************************************************************
+** Function: LAST_VALUE_ServiceRequest
+**
+** Publish the SB-to-MQTT values if a request has been received.
+**
+** Notes:
+**   1. Must only be called by the main task.
+**
+*/
+void LAST_VALUE_ServiceRequest(void);
+
+
+/******************************************************************************
+** Function: LAST_VALUE_Update
+**
+** Cache the last value of topic 'TopicId'.
+**
+** Notes:
+**   1. Payload is not null terminated. Values with a payload or SB message
+**      that doesn't fit in a slot are not cached.
+**
+*/
+void LAST_VALUE_Update(uint16 TopicId, MSG_STATS_Dir_t Dir, const char *Topic,
+                       const char *Payload, uint16 PayloadLen,
+                       const CFE_MSG_Message_t *SbMsg);
+
+
+/******************************************************************************
+** Function: LAST_VALUE_WarmStart
+**
+** Send the saved MQTT-to-SB values on the SB.
+**
+** Notes:
+**   1. Must be called after the topic table and MSG_TRANS are constructed.
+**
+*/
+void LAST_VALUE_WarmStart(void);
+
+
+#endif /* _last_value_ */
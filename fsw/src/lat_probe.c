@@ -0,0 +1,367 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Measure the gateway's round trip latency through the MQTT broker
+**
+** Notes:
+**   1. See lat_probe.h
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+
+#include "lat_probe.h"
+#include "mqtt_topic_tbl.h"
+#include "msg_stats.h"
+#include "msg_trans.h"
+
+
+/************************************/
+/** Local File Function Prototypes **/
+/************************************/
+
+static uint16 ProbeTopic(void);
+static void PublishProbe(const MQTT_TOPIC_PROBE_Pkt_t *Pkt);
+static void RecordProbe(const MQTT_TOPIC_PROBE_Pkt_t *Pkt);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static LAT_PROBE_Class_t *LatProbe = NULL;
+
+
+/******************************************************************************
+** Function: LAT_PROBE_Constructor
+**
+** Notes:
+**   1. The probe runs while the topic table defines a probe topic. A
+**      startup period is kept when the table doesn't define one so a
+**      later table load can start the probe.
+**   2. The instance number is the startup time so a restarted gateway
+**      ignores the probes of its previous run.
+**
+*/
+void LAT_PROBE_Constructor(LAT_PROBE_Class_t *LatProbePtr,
+                           const INITBL_Class_t *IniTbl,
+                           CFE_SB_PipeId_t PipeId)
+{
+
+   uint32 Period = INITBL_GetIntConfig(IniTbl, CFG_LAT_PROBE_PERIOD);
+
+   LatProbe = LatProbePtr;
+
+   CFE_PSP_MemSet((void*)LatProbe, 0, sizeof(LAT_PROBE_Class_t));
+
+   LatProbe->Mid      = CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_MQTT_GW_LAT_PROBE_TLM_TOPICID));
+   LatProbe->Instance = MSG_STATS_GetTime();
+   LatProbe->NextSeq  = 1;
+
+   CFE_MSG_Init(CFE_MSG_PTR(LatProbe->OutPkt.TelemetryHeader), LatProbe->Mid, sizeof(MQTT_TOPIC_PROBE_Pkt_t));
+   CFE_SB_Subscribe(LatProbe->Mid, PipeId);
+
+   if (Period != 0 && (Period < LAT_PROBE_MIN_PERIOD || Period > LAT_PROBE_MAX_PERIOD))
+   {
+      CFE_EVS_SendEvent(LAT_PROBE_CONSTRUCT_EID, CFE_EVS_EventType_ERROR,
+                        "Invalid latency probe period %d ms, probe stopped. Valid range is %d to %d",
+                        (int)Period, LAT_PROBE_MIN_PERIOD, LAT_PROBE_MAX_PERIOD);
+      Period = 0;
+   }
+   LatProbe->Period = Period;
+
+} /* End LAT_PROBE_Constructor() */
+
+
+/******************************************************************************
+** Function: LAT_PROBE_Execute
+**
+*/
+void LAT_PROBE_Execute(void)
+{
+
+   uint32 Now;
+
+   if (LatProbe->Period > 0 && MQTT_CLIENT_IsConnected() &&
+       ProbeTopic() != MQTT_TOPIC_TBL_UNUSED_ID)
+   {
+
+      Now = MSG_STATS_GetTime();
+      if ((Now - LatProbe->LastSendTime) >= (LatProbe->Period * 1000))
+      {
+
+         LatProbe->LastSendTime = Now;
+
+         LatProbe->OutPkt.Phase       = MQTT_TOPIC_PROBE_PHASE_OUT;
+         LatProbe->OutPkt.Instance    = LatProbe->Instance;
+         LatProbe->OutPkt.Seq         = LatProbe->NextSeq++;
+         LatProbe->OutPkt.SendTime    = Now;
+         LatProbe->OutPkt.MqttRcvTime = 0;
+
+         if (CFE_SB_TransmitMsg(CFE_MSG_PTR(LatProbe->OutPkt.TelemetryHeader), true) != CFE_SUCCESS)
+         {
+            ++LatProbe->LostCnt;
+         }
+      }
+   }
+
+} /* End LAT_PROBE_Execute() */
+
+
+/******************************************************************************
+** Function: LAT_PROBE_GetStage
+**
+** Notes:
+**   1. The window is small so a sorted copy is made for each call. The
+**      percentiles are sample values rather than histogram bucket bounds.
+**
+*/
+void LAT_PROBE_GetStage(LAT_PROBE_Stage_t Stage, MQTT_GW_ProbeLatency_t *StageTlm)
+{
+
+   uint32 Sorted[LAT_PROBE_WINDOW_LEN];
+   uint32 Sample;
+   uint16 Cnt = LatProbe->WindowCnt;
+   uint16 i, j;
+
+   for (i=0; i < Cnt; i++)
+   {
+      Sample = LatProbe->Window[Stage].Sample[i];
+      for (j=i; j > 0 && Sorted[j-1] > Sample; j--)
+      {
+         Sorted[j] = Sorted[j-1];
+      }
+      Sorted[j] = Sample;
+   }
+
+   StageTlm->Count = Cnt;
+   if (Cnt > 0)
+   {
+      StageTlm->P50 = Sorted[(Cnt*50)/100];
+      StageTlm->P90 = Sorted[(Cnt*90)/100];
+      StageTlm->P99 = Sorted[(Cnt*99)/100];
+      StageTlm->Max = Sorted[Cnt-1];
+   }
+   else
+   {
+      StageTlm->P50 = 0;
+      StageTlm->P90 = 0;
+      StageTlm->P99 = 0;
+      StageTlm->Max = 0;
+   }
+
+} /* End LAT_PROBE_GetStage() */
+
+
+/******************************************************************************
+** Function: LAT_PROBE_ProcessSbMsg
+**
+*/
+void LAT_PROBE_ProcessSbMsg(const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const MQTT_TOPIC_PROBE_Pkt_t *Pkt = (const MQTT_TOPIC_PROBE_Pkt_t *)MsgPtr;
+   CFE_MSG_Size_t MsgSize = 0;
+
+   CFE_MSG_GetSize(MsgPtr, &MsgSize);
+   if (MsgSize == sizeof(MQTT_TOPIC_PROBE_Pkt_t))
+   {
+      if (Pkt->Phase == MQTT_TOPIC_PROBE_PHASE_OUT)
+      {
+         PublishProbe(Pkt);
+      }
+      else if (Pkt->Phase == MQTT_TOPIC_PROBE_PHASE_RETURN)
+      {
+         RecordProbe(Pkt);
+      }
+   }
+
+} /* End LAT_PROBE_ProcessSbMsg() */
+
+
+/******************************************************************************
+** Function: LAT_PROBE_ResetStatus
+**
+*/
+void LAT_PROBE_ResetStatus(void)
+{
+
+   LatProbe->SentCnt   = 0;
+   LatProbe->RcvCnt    = 0;
+   LatProbe->LostCnt   = 0;
+   LatProbe->WindowIdx = 0;
+   LatProbe->WindowCnt = 0;
+
+} /* End LAT_PROBE_ResetStatus() */
+
+
+/******************************************************************************
+** Function: LAT_PROBE_SetPeriodCmd
+**
+*/
+bool LAT_PROBE_SetPeriodCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const MQTT_GW_SetLatProbe_Payload_t *SetCmd = CMDMGR_PAYLOAD_PTR(MsgPtr, MQTT_GW_SetLatProbe_t);
+   bool   RetStatus = false;
+   uint16 TopicId   = ProbeTopic();
+
+   if (TopicId == MQTT_TOPIC_TBL_UNUSED_ID)
+   {
+      CFE_EVS_SendEvent(LAT_PROBE_CMD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Set latency probe rejected, the topic table doesn't define a probe codec topic");
+   }
+   else if (SetCmd->Period != 0 &&
+            (SetCmd->Period < LAT_PROBE_MIN_PERIOD || SetCmd->Period > LAT_PROBE_MAX_PERIOD))
+   {
+      CFE_EVS_SendEvent(LAT_PROBE_CMD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Set latency probe rejected, period %d ms is not 0 or %d to %d",
+                        (int)SetCmd->Period, LAT_PROBE_MIN_PERIOD, LAT_PROBE_MAX_PERIOD);
+   }
+   else
+   {
+      LatProbe->Period = SetCmd->Period;
+      if (LatProbe->Period > 0)
+      {
+         CFE_EVS_SendEvent(LAT_PROBE_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                           "Latency probe started on %s every %d ms",
+                           MQTT_TOPIC_TBL_GetName(TopicId), (int)LatProbe->Period);
+      }
+      else
+      {
+         CFE_EVS_SendEvent(LAT_PROBE_CMD_EID, CFE_EVS_EventType_INFORMATION,
+                           "Latency probe stopped");
+      }
+      RetStatus = true;
+   }
+
+   return RetStatus;
+
+} /* End LAT_PROBE_SetPeriodCmd() */
+
+
+/******************************************************************************
+** Function: ProbeTopic
+**
+** Return the topic ID of the probe topic or MQTT_TOPIC_TBL_UNUSED_ID if the
+** topic table doesn't define one.
+**
+** Notes:
+**   1. Table loads only accept the probe's message ID for a probe codec
+**      topic.
+**
+*/
+static uint16 ProbeTopic(void)
+{
+
+   return MQTT_TOPIC_TBL_FindMid(CFE_SB_MsgIdToValue(LatProbe->Mid));
+
+} /* End ProbeTopic() */
+
+
+/******************************************************************************
+** Function: PublishProbe
+**
+** Encode an outgoing probe with the probe topic's codec and publish it.
+**
+** Notes:
+**   1. A probe's pending slot is reused LAT_PROBE_PENDING_CNT probes later.
+**      A probe that is still outstanding when its slot is reused is lost.
+**   2. The probe is encoded by the main task like any other SB-to-MQTT
+**      message but isn't counted in the topic's statistics.
+**
+*/
+static void PublishProbe(const MQTT_TOPIC_PROBE_Pkt_t *Pkt)
+{
+
+   LAT_PROBE_Pending_t *Pending = &LatProbe->Pending[Pkt->Seq % LAT_PROBE_PENDING_CNT];
+   const char *Topic;
+   const char *Payload;
+
+   if (Pending->Outstanding)
+   {
+      ++LatProbe->LostCnt;
+   }
+
+   Pending->Seq      = Pkt->Seq;
+   Pending->SendTime = Pkt->SendTime;
+   Pending->PubTime  = MSG_STATS_GetTime();
+
+   if (MSG_TRANS_TranslateSbMsg(ProbeTopic(), (const CFE_MSG_Message_t *)Pkt, &Topic, &Payload) &&
+       MQTT_CLIENT_Publish(Topic, Payload, false))
+   {
+      Pending->Outstanding = true;
+      ++LatProbe->SentCnt;
+   }
+   else
+   {
+      Pending->Outstanding = false;
+      ++LatProbe->LostCnt;
+   }
+
+} /* End PublishProbe() */
+
+
+/******************************************************************************
+** Function: RecordProbe
+**
+** Add a returned probe's stage latencies to the window.
+**
+** Notes:
+**   1. Returns whose probe is no longer outstanding, such as a duplicate
+**      delivery, and probes from other gateway instances are ignored.
+**
+*/
+static void RecordProbe(const MQTT_TOPIC_PROBE_Pkt_t *Pkt)
+{
+
+   LAT_PROBE_Pending_t *Pending = &LatProbe->Pending[Pkt->Seq % LAT_PROBE_PENDING_CNT];
+   uint32 Total;
+   uint32 Broker;
+
+   if (Pkt->Instance == LatProbe->Instance && Pending->Outstanding && Pending->Seq == Pkt->Seq)
+   {
+
+      Pending->Outstanding = false;
+
+      Total  = MSG_STATS_GetTime() - Pending->SendTime;
+      Broker = Pkt->MqttRcvTime - Pending->PubTime;
+      if (Broker > Total)
+      {
+         Broker = Total;
+      }
+
+      LatProbe->Window[LAT_PROBE_STAGE_TOTAL].Sample[LatProbe->WindowIdx]    = Total;
+      LatProbe->Window[LAT_PROBE_STAGE_BROKER].Sample[LatProbe->WindowIdx]   = Broker;
+      LatProbe->Window[LAT_PROBE_STAGE_INTERNAL].Sample[LatProbe->WindowIdx] = Total - Broker;
+
+      LatProbe->WindowIdx = (LatProbe->WindowIdx + 1) % LAT_PROBE_WINDOW_LEN;
+      if (LatProbe->WindowCnt < LAT_PROBE_WINDOW_LEN)
+      {
+         ++LatProbe->WindowCnt;
+      }
+      ++LatProbe->RcvCnt;
+
+   }
+
+} /* End RecordProbe() */
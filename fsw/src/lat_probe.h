@@ -0,0 +1,221 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Measure the gateway's round trip latency through the MQTT broker
+**
+** Notes:
+**   1. The probe topic is the topic table's 'pub' topic that uses the
+**      probe codec and is bridged to MQTT_GW_LAT_PROBE_TLM_TOPICID. Every
+**      LAT_PROBE_PERIOD milliseconds the main task sends a probe packet on
+**      the SB. When the packet is received from the app's pipe it is
+**      encoded by MSG_TRANS with the topic's codec and published to the
+**      topic. The gateway subscribes to the topic like any other 'pub'
+**      topic so the returned message is decoded by DECODE_POOL and sent
+**      back on the SB. The round trip ends when the main task receives the
+**      returned packet so the probe covers the SB, encode, broker, decode
+**      queue, decode, SB path of a topic message.
+**   2. Each probe is split into the broker time, from just before the
+**      publish to the returned message's decode, and the gateway's internal
+**      time which is the rest of the round trip. Percentiles of the last
+**      LAT_PROBE_WINDOW_LEN probes are reported in housekeeping telemetry.
+**   3. The probe packet is internal so it isn't defined in the EDS. See
+**      mqtt_topic_probe.h. Probes carry a gateway instance number so
+**      probes published by another gateway on the same topic are ignored.
+**   4. Probes are only sent while the MQTT client is connected to a broker
+**      and the topic table defines a probe topic. The main task checks for
+**      a due probe each loop iteration so an idle pipe's pend time limits
+**      the period's resolution.
+**   5. Probes are sent, published, and completed by the main task so the
+**      statistics have a single writer.
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+#ifndef _lat_probe_
+#define _lat_probe_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "mqtt_client.h"
+#include "mqtt_topic_probe.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/*
+** Event Message IDs
+*/
+
+#define LAT_PROBE_CONSTRUCT_EID  (LAT_PROBE_BASE_EID + 0)
+#define LAT_PROBE_CMD_EID        (LAT_PROBE_BASE_EID + 1)
+#define LAT_PROBE_CMD_ERR_EID    (LAT_PROBE_BASE_EID + 2)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+typedef enum
+{
+
+   LAT_PROBE_STAGE_TOTAL    = 0,
+   LAT_PROBE_STAGE_BROKER   = 1,
+   LAT_PROBE_STAGE_INTERNAL = 2,
+   LAT_PROBE_STAGE_CNT      = 3
+
+} LAT_PROBE_Stage_t;
+
+
+/*
+** A published probe waiting for its return
+*/
+
+typedef struct
+{
+
+   bool    Outstanding;
+   uint32  Seq;
+   uint32  SendTime;
+   uint32  PubTime;
+
+} LAT_PROBE_Pending_t;
+
+
+/*
+** Last LAT_PROBE_WINDOW_LEN samples of one stage in microseconds
+*/
+
+typedef struct
+{
+
+   uint32  Sample[LAT_PROBE_WINDOW_LEN];
+
+} LAT_PROBE_Window_t;
+
+
+/*
+** Class Definition
+*/
+
+typedef struct
+{
+
+   CFE_SB_MsgId_t  Mid;      /* Probe topic's SB message ID */
+   uint32  Instance;         /* Identifies this gateway's probes */
+
+   uint32  Period;           /* Milliseconds, 0 = Stopped */
+   uint32  LastSendTime;
+   uint32  NextSeq;
+
+   uint32  SentCnt;          /* Probes published */
+   uint32  RcvCnt;           /* Probes that completed the round trip */
+   uint32  LostCnt;          /* Probes that failed to publish or didn't return */
+
+   uint16  WindowIdx;        /* Next sample to write */
+   uint16  WindowCnt;        /* Valid samples */
+   LAT_PROBE_Window_t   Window[LAT_PROBE_STAGE_CNT];
+   LAT_PROBE_Pending_t  Pending[LAT_PROBE_PENDING_CNT];
+
+   MQTT_TOPIC_PROBE_Pkt_t  OutPkt;
+
+} LAT_PROBE_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: LAT_PROBE_Constructor
+**
+** Notes:
+**    1. This function must be called prior to any other functions being
+**       called using the same LAT_PROBE instance.
+**    2. The probe packet is subscribed on PipeId.
+**
+*/
+void LAT_PROBE_Constructor(LAT_PROBE_Class_t *LatProbePtr,
+                           const INITBL_Class_t *IniTbl,
+                           CFE_SB_PipeId_t PipeId);
+
+
+/******************************************************************************
+** Function: LAT_PROBE_Execute
+**
+** Send a probe on the SB if one is due.
+**
+** Notes:
+**   1. Must only be called by the main task.
+**
+*/
+void LAT_PROBE_Execute(void);
+
+
+/******************************************************************************
+** Function: LAT_PROBE_GetStage
+**
+** Load a stage's latency summary of the probes in the window.
+**
+*/
+void LAT_PROBE_GetStage(LAT_PROBE_Stage_t Stage, MQTT_GW_ProbeLatency_t *StageTlm);
+
+
+/******************************************************************************
+** Function: LAT_PROBE_ProcessSbMsg
+**
+** Publish an outgoing probe or record a returned probe's latency.
+**
+** Notes:
+**   1. Must only be called by the main task for messages with the probe's
+**      message ID.
+**
+*/
+void LAT_PROBE_ProcessSbMsg(const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: LAT_PROBE_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+** Notes:
+**   1. The latency window is cleared. Outstanding probes are still
+**      recorded when they return.
+**
+*/
+void LAT_PROBE_ResetStatus(void);
+
+
+/******************************************************************************
+** Function: LAT_PROBE_SetPeriodCmd
+**
+** Set the probe period. A period of 0 stops the probe.
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**
+*/
+bool LAT_PROBE_SetPeriodCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+#endif /* _lat_probe_ */
@@ -0,0 +1,614 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Generate SB and MQTT topic message traffic for load testing
+**
+** Notes:
+**   1. The start and stop commands run in the main task and the generator
+**      runs in its own child task. The Active flag is written last by the
+**      start commands and read first by the child task so the commanded
+**      parameters are visible before the generator runs.
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+
+#include "load_gen.h"
+#include "msg_stats.h"
+#include "msg_trans.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define USEC_PER_SEC  1000000
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static uint16 BurstSize(void);
+static void   InjectMqttBurst(void);
+static uint16 NextMsgSize(void);
+static bool   ReadPayloadFile(const char *Filename);
+static void   SendSbBurst(void);
+static void   Start(LOAD_GEN_Target_t Target, uint16 TopicId, uint16 BurstSize,
+                    uint32 MsgRate, uint32 MsgCnt);
+static void   Stop(void);
+static bool   ValidStartParams(uint16 TopicId, uint16 BurstSize, uint32 MsgRate);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static LOAD_GEN_Class_t *LoadGen = NULL;
+
+
+/******************************************************************************
+** Function: LOAD_GEN_Constructor
+**
+*/
+void LOAD_GEN_Constructor(LOAD_GEN_Class_t *LoadGenPtr,
+                          const INITBL_Class_t *IniTbl)
+{
+
+   LoadGen = LoadGenPtr;
+
+   CFE_PSP_MemSet((void*)LoadGen, 0, sizeof(LOAD_GEN_Class_t));
+
+   LoadGen->MqttMsgData.topicName = &LoadGen->MqttTopic;
+   LoadGen->MqttMsgData.message   = &LoadGen->MqttMsg;
+
+   OS_BinSemCreate(&LoadGen->WakeSem, "MQTT_LOAD_GEN", OS_SEM_EMPTY, 0);
+
+} /* End LOAD_GEN_Constructor() */
+
+
+/******************************************************************************
+** Function: LOAD_GEN_ChildTask
+**
+** Notes:
+**   1. A burst is sent when the number of messages generated is less than
+**      or equal to the number due at the requested rate. Otherwise the task
+**      delays until the next burst is due with a minimum of 1ms.
+**
+*/
+bool LOAD_GEN_ChildTask(CHILDMGR_Class_t *ChildMgr)
+{
+
+   uint32 Now;
+   uint64 MsgDue;
+   uint64 BurstTime;
+
+   if (__atomic_load_n(&LoadGen->Active, __ATOMIC_ACQUIRE))
+   {
+
+      MQTT_TOPIC_TBL_ReaderQuiescent(MQTT_TOPIC_TBL_READER_LOAD_GEN);
+
+      Now = MSG_STATS_GetTime();
+      LoadGen->ElapsedTime += (uint32)(Now - LoadGen->LastTime);
+      LoadGen->LastTime = Now;
+
+      MsgDue = (LoadGen->ElapsedTime * LoadGen->MsgRate) / USEC_PER_SEC;
+
+      if (LoadGen->TxCnt <= MsgDue)
+      {
+         if (LoadGen->Target == LOAD_GEN_TARGET_MQTT)
+         {
+            InjectMqttBurst();
+         }
+         else
+         {
+            SendSbBurst();
+         }
+      }
+      else
+      {
+         BurstTime = ((uint64)LoadGen->TxCnt * USEC_PER_SEC) / LoadGen->MsgRate;
+         OS_TaskDelay((BurstTime > LoadGen->ElapsedTime + 1000) ?
+                      (uint32)((BurstTime - LoadGen->ElapsedTime) / 1000) : 1);
+      }
+
+      if (LoadGen->ElapsedTime > 0)
+      {
+         LoadGen->AchievedRate = (uint32)(((uint64)LoadGen->SentCnt * USEC_PER_SEC) / LoadGen->ElapsedTime);
+      }
+      if (LoadGen->TxCnt > 0)
+      {
+         LoadGen->NsPerMsg = (uint32)((LoadGen->ProcTime * 1000) / LoadGen->TxCnt);
+      }
+
+      if (LoadGen->StopReq || (LoadGen->MsgLim > 0 && LoadGen->TxCnt >= LoadGen->MsgLim))
+      {
+         Stop();
+      }
+
+   } /* End if active */
+   else
+   {
+      MQTT_TOPIC_TBL_ReaderOffline(MQTT_TOPIC_TBL_READER_LOAD_GEN);
+      OS_BinSemTake(LoadGen->WakeSem);
+   }
+
+   return true;
+
+} /* End LOAD_GEN_ChildTask() */
+
+
+/******************************************************************************
+** Function: LOAD_GEN_ResetStatus
+**
+*/
+void LOAD_GEN_ResetStatus(void)
+{
+
+   if (!LoadGen->Active)
+   {
+      LoadGen->TxCnt          = 0;
+      LoadGen->SentCnt        = 0;
+      LoadGen->TransmitErrCnt = 0;
+      LoadGen->DecodeErrCnt   = 0;
+      LoadGen->ElapsedTime    = 0;
+      LoadGen->ProcTime       = 0;
+      LoadGen->AchievedRate   = 0;
+      LoadGen->NsPerMsg       = 0;
+   }
+
+} /* End LOAD_GEN_ResetStatus() */
+
+
+/******************************************************************************
+** Function: LOAD_GEN_StartCmd
+**
+*/
+bool LOAD_GEN_StartCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const MQTT_GW_StartLoadGen_Payload_t *StartCmd = CMDMGR_PAYLOAD_PTR(MsgPtr, MQTT_GW_StartLoadGen_t);
+   bool   RetStatus = false;
+   uint16 SizeMin = StartCmd->SizeMin;
+   uint16 SizeMax;
+   const MQTT_TOPIC_TBL_Codec_t *Codec;
+
+   SizeMax = (StartCmd->SizeProfile == LOAD_GEN_SIZE_FIXED) ? StartCmd->SizeMin : StartCmd->SizeMax;
+
+   /* Clamp a valid range so every message holds the codec's packet */
+   if (MQTT_TOPIC_TBL_ValidId(StartCmd->TopicId) && SizeMin <= SizeMax)
+   {
+      Codec = MQTT_TOPIC_TBL_GetCodec(StartCmd->TopicId);
+      if (Codec->Func != NULL && SizeMin < Codec->Func->SbMsgLen)
+      {
+         SizeMin = (uint16)Codec->Func->SbMsgLen;
+         if (SizeMax < SizeMin)
+         {
+            SizeMax = SizeMin;
+         }
+      }
+   }
+
+   if (!ValidStartParams(StartCmd->TopicId, StartCmd->BurstSize, StartCmd->MsgRate))
+   {
+      RetStatus = false;
+   }
+   else if (StartCmd->SizeProfile < LOAD_GEN_SIZE_FIXED || StartCmd->SizeProfile > LOAD_GEN_SIZE_RANDOM)
+   {
+      CFE_EVS_SendEvent(LOAD_GEN_START_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Start load generator rejected. Invalid size profile %d",
+                        StartCmd->SizeProfile);
+   }
+   else if (SizeMin < sizeof(CFE_MSG_TelemetryHeader_t) || SizeMin > SizeMax ||
+            SizeMax > LOAD_GEN_MAX_MSG_LEN)
+   {
+      CFE_EVS_SendEvent(LOAD_GEN_START_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Start load generator rejected. Invalid message size range %u to %u, must be within %u to %u",
+                        SizeMin, SizeMax, (unsigned int)sizeof(CFE_MSG_TelemetryHeader_t),
+                        LOAD_GEN_MAX_MSG_LEN);
+   }
+   else
+   {
+
+      LoadGen->Param       = StartCmd->Param;
+      LoadGen->SizeProfile = StartCmd->SizeProfile;
+      LoadGen->SizeMin     = SizeMin;
+      LoadGen->SizeMax     = SizeMax;
+      LoadGen->NextSize    = SizeMin;
+      LoadGen->RandState   = 1;
+      LoadGen->SbCodec     = *MQTT_TOPIC_TBL_GetCodec(StartCmd->TopicId);
+
+      memset(LoadGen->SbMsg.Byte, 0, sizeof(LoadGen->SbMsg));
+      CFE_MSG_Init(&LoadGen->SbMsg.Msg, CFE_SB_ValueToMsgId(MQTT_TOPIC_TBL_GetEntry(StartCmd->TopicId)->SbMid),
+                   SizeMin);
+
+      Start(LOAD_GEN_TARGET_SB, StartCmd->TopicId, StartCmd->BurstSize,
+            StartCmd->MsgRate, StartCmd->MsgCnt);
+
+      RetStatus = true;
+      CFE_EVS_SendEvent(LOAD_GEN_START_EID, CFE_EVS_EventType_INFORMATION,
+                        "SB load generator started for topic %d: %u msg/s in bursts of %u, size profile %d from %u to %u bytes, %u messages",
+                        LoadGen->TopicId, (unsigned int)LoadGen->MsgRate, LoadGen->BurstSize,
+                        LoadGen->SizeProfile, LoadGen->SizeMin, LoadGen->SizeMax,
+                        (unsigned int)LoadGen->MsgLim);
+
+   } /* End if valid command */
+
+   return RetStatus;
+
+} /* End LOAD_GEN_StartCmd() */
+
+
+/******************************************************************************
+** Function: LOAD_GEN_StartMqttCmd
+**
+*/
+bool LOAD_GEN_StartMqttCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const MQTT_GW_StartMqttLoadGen_Payload_t *StartCmd = CMDMGR_PAYLOAD_PTR(MsgPtr, MQTT_GW_StartMqttLoadGen_t);
+   bool RetStatus = false;
+
+   if (ValidStartParams(StartCmd->TopicId, StartCmd->BurstSize, StartCmd->MsgRate))
+   {
+      if (ReadPayloadFile(StartCmd->PayloadFile))
+      {
+
+         strncpy(LoadGen->TopicName, MQTT_TOPIC_TBL_GetName(StartCmd->TopicId), MQTT_TOPIC_TBL_MAX_TOPIC_LEN);
+         LoadGen->TopicName[MQTT_TOPIC_TBL_MAX_TOPIC_LEN-1] = '\0';
+
+         LoadGen->MqttTopic.cstring       = NULL;
+         LoadGen->MqttTopic.lenstring.data = LoadGen->TopicName;
+         LoadGen->MqttTopic.lenstring.len  = strlen(LoadGen->TopicName);
+
+         Start(LOAD_GEN_TARGET_MQTT, StartCmd->TopicId, StartCmd->BurstSize,
+               StartCmd->MsgRate, StartCmd->MsgCnt);
+
+         RetStatus = true;
+         CFE_EVS_SendEvent(LOAD_GEN_START_EID, CFE_EVS_EventType_INFORMATION,
+                           "MQTT load generator started for topic %s: %u msg/s in bursts of %u, %u byte payload, %u messages",
+                           LoadGen->TopicName, (unsigned int)LoadGen->MsgRate, LoadGen->BurstSize,
+                           (unsigned int)LoadGen->MqttMsg.payloadlen, (unsigned int)LoadGen->MsgLim);
+
+      } /* End if payload loaded */
+   } /* End if valid command */
+
+   return RetStatus;
+
+} /* End LOAD_GEN_StartMqttCmd() */
+
+
+/******************************************************************************
+** Function: LOAD_GEN_StopCmd
+**
+*/
+bool LOAD_GEN_StopCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   bool RetStatus = false;
+
+   if (LoadGen->Active)
+   {
+      LoadGen->StopReq = true;
+      RetStatus = true;
+   }
+   else
+   {
+      CFE_EVS_SendEvent(LOAD_GEN_STOP_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Stop load generator rejected. Generator is not active");
+   }
+
+   return RetStatus;
+
+} /* End LOAD_GEN_StopCmd() */
+
+
+/******************************************************************************
+** Function: BurstSize
+**
+** Return the number of messages in the next burst.
+**
+*/
+static uint16 BurstSize(void)
+{
+
+   uint16 MsgCnt = LoadGen->BurstSize;
+
+   if (LoadGen->MsgLim > 0 && (LoadGen->MsgLim - LoadGen->TxCnt) < MsgCnt)
+   {
+      MsgCnt = LoadGen->MsgLim - LoadGen->TxCnt;
+   }
+
+   return MsgCnt;
+
+} /* End BurstSize() */
+
+
+/******************************************************************************
+** Function: InjectMqttBurst
+**
+** Notes:
+**   1. The topic's MSG_STATS counters are sampled before and after each
+**      burst rather than once per run so a statistics reset during a run
+**      only affects one burst.
+**
+*/
+static void InjectMqttBurst(void)
+{
+
+   uint16 i;
+   uint16 MsgCnt = BurstSize();
+   uint32 StartTime;
+   MSG_STATS_Cnt_t StartStats;
+   const MSG_STATS_Cnt_t *Stats = &MSG_STATS_GetTopic(LoadGen->TopicId)->Cnt[MSG_STATS_DIR_MQTT_TO_SB];
+
+   StartStats = *Stats;
+
+   StartTime = MSG_STATS_GetTime();
+   for (i=0; i < MsgCnt; i++)
+   {
+      MSG_TRANS_ProcessMqttMsg(&LoadGen->MqttMsgData);
+   }
+   LoadGen->ProcTime += (uint32)(MSG_STATS_GetTime() - StartTime);
+
+   LoadGen->TxCnt          += MsgCnt;
+   LoadGen->SentCnt        += Stats->MsgOutCnt   - StartStats.MsgOutCnt;
+   LoadGen->TransmitErrCnt += Stats->DropCnt     - StartStats.DropCnt;
+   LoadGen->DecodeErrCnt   += Stats->XlateErrCnt - StartStats.XlateErrCnt;
+
+} /* End InjectMqttBurst() */
+
+
+/******************************************************************************
+** Function: NextMsgSize
+**
+** Notes:
+**   1. The random profile uses a linear congruential generator with a fixed
+**      seed so runs are repeatable.
+**
+*/
+static uint16 NextMsgSize(void)
+{
+
+   uint16 MsgSize = LoadGen->SizeMin;
+
+   switch (LoadGen->SizeProfile)
+   {
+
+      case LOAD_GEN_SIZE_RAMP:
+         MsgSize = LoadGen->NextSize;
+         LoadGen->NextSize = (MsgSize < LoadGen->SizeMax) ? (MsgSize + 1) : LoadGen->SizeMin;
+         break;
+
+      case LOAD_GEN_SIZE_RANDOM:
+         LoadGen->RandState = LoadGen->RandState * 1664525 + 1013904223;
+         MsgSize = LoadGen->SizeMin + (uint16)((LoadGen->RandState >> 16) % (LoadGen->SizeMax - LoadGen->SizeMin + 1));
+         break;
+
+      default:
+         break;
+
+   } /* End SizeProfile switch */
+
+   return MsgSize;
+
+} /* End NextMsgSize() */
+
+
+/******************************************************************************
+** Function: ReadPayloadFile
+**
+*/
+static bool ReadPayloadFile(const char *Filename)
+{
+
+   bool       RetStatus = false;
+   int32      SysStatus;
+   int32      ReadLen;
+   osal_id_t  FileHandle;
+   os_err_name_t OsErrStr;
+
+   SysStatus = OS_OpenCreate(&FileHandle, Filename, OS_FILE_FLAG_NONE, OS_READ_ONLY);
+
+   if (SysStatus == OS_SUCCESS)
+   {
+
+      ReadLen = OS_read(FileHandle, LoadGen->Payload, LOAD_GEN_MAX_MSG_LEN);
+      OS_close(FileHandle);
+
+      if (ReadLen > 0 && ReadLen < LOAD_GEN_MAX_MSG_LEN)
+      {
+         LoadGen->Payload[ReadLen] = '\0';
+         LoadGen->MqttMsg.payload    = LoadGen->Payload;
+         LoadGen->MqttMsg.payloadlen = ReadLen;
+         RetStatus = true;
+      }
+      else
+      {
+         CFE_EVS_SendEvent(LOAD_GEN_START_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Start load generator rejected. Payload file %s length must be in the range 1..%d",
+                           Filename, (LOAD_GEN_MAX_MSG_LEN-1));
+      }
+
+   } /* End if file open */
+   else
+   {
+      OS_GetErrorName(SysStatus, &OsErrStr);
+      CFE_EVS_SendEvent(LOAD_GEN_START_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Start load generator rejected. Error opening payload file '%s', status=%s",
+                        Filename, OsErrStr);
+   }
+
+   return RetStatus;
+
+} /* End ReadPayloadFile() */
+
+
+/******************************************************************************
+** Function: SendSbBurst
+**
+** Notes:
+**   1. The number of messages generated prior to each message is used as the
+**      sequence number passed to the topic's fill function.
+**
+*/
+static void SendSbBurst(void)
+{
+
+   uint16 i;
+   uint16 MsgSize;
+   uint16 MsgCnt = BurstSize();
+
+   for (i=0; i < MsgCnt; i++)
+   {
+
+      MsgSize = NextMsgSize();
+      CFE_MSG_SetSize(&LoadGen->SbMsg.Msg, MsgSize);
+
+      if (LoadGen->SbCodec.Func != NULL)
+      {
+         LoadGen->SbCodec.Func->SbMsgFill(LoadGen->SbCodec.Inst, &LoadGen->SbMsg.Msg, MsgSize,
+                                          LoadGen->TxCnt, LoadGen->Param);
+      }
+
+      CFE_SB_TimeStampMsg(&LoadGen->SbMsg.Msg);
+      if (CFE_SB_TransmitMsg(&LoadGen->SbMsg.Msg, true) == CFE_SUCCESS)
+      {
+         ++LoadGen->SentCnt;
+      }
+      else
+      {
+         ++LoadGen->TransmitErrCnt;
+      }
+      ++LoadGen->TxCnt;
+
+   } /* End burst loop */
+
+} /* End SendSbBurst() */
+
+
+/******************************************************************************
+** Function: Start
+**
+** Set the parameters common to all targets, clear the status and wake the
+** child task.
+**
+*/
+static void Start(LOAD_GEN_Target_t Target, uint16 TopicId, uint16 BurstSize,
+                  uint32 MsgRate, uint32 MsgCnt)
+{
+
+   LoadGen->Target    = Target;
+   LoadGen->TopicId   = TopicId;
+   LoadGen->BurstSize = BurstSize;
+   LoadGen->MsgRate   = MsgRate;
+   LoadGen->MsgLim    = MsgCnt;
+   LoadGen->StopReq   = false;
+
+   LoadGen->TxCnt          = 0;
+   LoadGen->SentCnt        = 0;
+   LoadGen->TransmitErrCnt = 0;
+   LoadGen->DecodeErrCnt   = 0;
+   LoadGen->ElapsedTime    = 0;
+   LoadGen->ProcTime       = 0;
+   LoadGen->AchievedRate   = 0;
+   LoadGen->NsPerMsg       = 0;
+
+   LoadGen->LastTime = MSG_STATS_GetTime();
+   __atomic_store_n(&LoadGen->Active, true, __ATOMIC_RELEASE);
+   OS_BinSemGive(LoadGen->WakeSem);
+
+} /* End Start() */
+
+
+/******************************************************************************
+** Function: Stop
+**
+*/
+static void Stop(void)
+{
+
+   __atomic_store_n(&LoadGen->Active, false, __ATOMIC_RELEASE);
+   LoadGen->StopReq = false;
+
+   if (LoadGen->Target == LOAD_GEN_TARGET_MQTT)
+   {
+      CFE_EVS_SendEvent(LOAD_GEN_STOP_EID, CFE_EVS_EventType_INFORMATION,
+                        "MQTT load generator stopped for topic %d. Injected %u messages in %u ms, requested %u msg/s, "
+                        "decoded %u msg/s, %u ns/msg, %u decode errors, %u SB transmit errors",
+                        LoadGen->TopicId, (unsigned int)LoadGen->TxCnt,
+                        (unsigned int)(LoadGen->ElapsedTime / 1000), (unsigned int)LoadGen->MsgRate,
+                        (unsigned int)LoadGen->AchievedRate, (unsigned int)LoadGen->NsPerMsg,
+                        (unsigned int)LoadGen->DecodeErrCnt, (unsigned int)LoadGen->TransmitErrCnt);
+   }
+   else
+   {
+      CFE_EVS_SendEvent(LOAD_GEN_STOP_EID, CFE_EVS_EventType_INFORMATION,
+                        "SB load generator stopped for topic %d. Sent %u messages in %u ms, requested %u msg/s, "
+                        "achieved %u msg/s, %u transmit errors",
+                        LoadGen->TopicId, (unsigned int)LoadGen->SentCnt,
+                        (unsigned int)(LoadGen->ElapsedTime / 1000), (unsigned int)LoadGen->MsgRate,
+                        (unsigned int)LoadGen->AchievedRate, (unsigned int)LoadGen->TransmitErrCnt);
+   }
+
+} /* End Stop() */
+
+
+/******************************************************************************
+** Function: ValidStartParams
+**
+** Validate the start parameters common to all targets and send an error
+** event if one is invalid.
+**
+*/
+static bool ValidStartParams(uint16 TopicId, uint16 BurstSize, uint32 MsgRate)
+{
+
+   bool RetStatus = false;
+
+   if (LoadGen->Active)
+   {
+      CFE_EVS_SendEvent(LOAD_GEN_START_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Start load generator rejected. Generator is active for topic %d",
+                        LoadGen->TopicId);
+   }
+   else if (!MQTT_TOPIC_TBL_ValidId(TopicId))
+   {
+      CFE_EVS_SendEvent(LOAD_GEN_START_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Start load generator rejected. Topic %d is not defined in the topic table",
+                        TopicId);
+   }
+   else if (MsgRate == 0 || BurstSize == 0)
+   {
+      CFE_EVS_SendEvent(LOAD_GEN_START_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Start load generator rejected. Message rate %u and burst size %u must be greater than 0",
+                        (unsigned int)MsgRate, BurstSize);
+   }
+   else
+   {
+      RetStatus = true;
+   }
+
+   return RetStatus;
+
+} /* End ValidStartParams() */
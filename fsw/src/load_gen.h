@@ -0,0 +1,243 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Generate SB and MQTT topic message traffic for load testing
+**
+** Notes:
+**   1. The load generator has two targets:
+**      - SB: Send SB messages for a topic at a commanded rate. When the
+**        topic's SB role is 'sub' the messages are received by MQTT_GW
+**        which exercises the SB-to-MQTT path.
+**      - MQTT: Inject a canned JSON payload for a topic into
+**        MSG_TRANS_ProcessMqttMsg() at a commanded rate. This exercises the
+**        MQTT-to-SB path without a broker. The payload is read from a file
+**        when the generator is started.
+**   2. Messages are sent in bursts of BurstSize messages. The burst start
+**      times are computed from a microsecond clock so the achieved rate does
+**      not depend on the topic pipe pend time. If the generator falls behind
+**      it sends bursts back to back until it catches up so the achieved rate
+**      shows when the SB or the gateway has saturated.
+**   3. The message size follows a size profile between SizeMin and SizeMax.
+**      SizeMin is raised to the topic codec's SB packet size so every
+**      message can be translated. The payload is zero filled and then passed to the topic codec's
+**      SbMsgFill function which may populate topic specific content. The
+**      codec is copied when the generator starts. Codec instances exist for
+**      the life of the app and fill functions only read their instance's
+**      configuration so the copy remains usable after a table load.
+**   4. The generator runs in its own child task that pends on a semaphore
+**      when the generator is idle. The task is a topic table reader that is
+**      offline while it is idle.
+**   5. MQTT injection results are derived from the topic's MQTT-to-SB
+**      MSG_STATS counters so they include any broker messages received for
+**      the topic during the run. The processing time is the elapsed time
+**      spent in MSG_TRANS_ProcessMqttMsg() so it includes any time the task
+**      is preempted.
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+#ifndef _load_gen_
+#define _load_gen_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "mqtt_topic_tbl.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/*
+** Event Message IDs
+*/
+
+#define LOAD_GEN_START_EID      (LOAD_GEN_BASE_EID + 0)
+#define LOAD_GEN_START_ERR_EID  (LOAD_GEN_BASE_EID + 1)
+#define LOAD_GEN_STOP_EID       (LOAD_GEN_BASE_EID + 2)
+#define LOAD_GEN_STOP_ERR_EID   (LOAD_GEN_BASE_EID + 3)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+typedef enum
+{
+
+   LOAD_GEN_SIZE_FIXED  = 1,   /* Every message is SizeMin bytes */
+   LOAD_GEN_SIZE_RAMP   = 2,   /* SizeMin to SizeMax in one byte steps, then repeat */
+   LOAD_GEN_SIZE_RANDOM = 3    /* Uniformly distributed between SizeMin and SizeMax */
+
+} LOAD_GEN_SizeProfile_t;
+
+
+typedef enum
+{
+
+   LOAD_GEN_TARGET_SB   = 1,
+   LOAD_GEN_TARGET_MQTT = 2
+
+} LOAD_GEN_Target_t;
+
+
+/*
+** Class Definition
+*/
+
+typedef struct
+{
+
+   osal_id_t  WakeSem;
+
+   bool       Active;
+   bool       StopReq;
+
+   /*
+   ** Commanded parameters
+   */
+
+   LOAD_GEN_Target_t  Target;
+   uint16  TopicId;
+   int16   Param;
+   uint8   SizeProfile;
+   uint16  BurstSize;
+   uint16  SizeMin;
+   uint16  SizeMax;
+   uint32  MsgRate;    /* Messages per second */
+   uint32  MsgLim;     /* Zero runs until stopped */
+
+   /*
+   ** Status
+   */
+
+   uint32  TxCnt;            /* Messages generated */
+   uint32  SentCnt;          /* Messages successfully sent on the SB */
+   uint32  TransmitErrCnt;   /* SB transmit errors */
+   uint32  DecodeErrCnt;     /* MQTT target JsonToCfe errors */
+   uint64  ElapsedTime;      /* Microseconds since start */
+   uint64  ProcTime;         /* MQTT target microseconds in MSG_TRANS */
+   uint32  AchievedRate;     /* SentCnt per second, updated every burst */
+   uint32  NsPerMsg;         /* MQTT target processing time per message */
+
+   uint32  LastTime;
+   uint16  NextSize;
+   uint32  RandState;
+   MQTT_TOPIC_TBL_Codec_t  SbCodec;
+
+   union
+   {
+      CFE_MSG_Message_t  Msg;
+      uint8              Byte[LOAD_GEN_MAX_MSG_LEN];
+   } SbMsg;
+
+   /*
+   ** Canned inbound MQTT message
+   */
+
+   char         TopicName[MQTT_TOPIC_TBL_MAX_TOPIC_LEN];
+   char         Payload[LOAD_GEN_MAX_MSG_LEN];
+   MQTTString   MqttTopic;
+   MQTTMessage  MqttMsg;
+   MessageData  MqttMsgData;
+
+} LOAD_GEN_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: LOAD_GEN_Constructor
+**
+** Notes:
+**    1. This function must be called prior to any other functions being
+**       called using the same LOAD_GEN instance.
+*/
+void LOAD_GEN_Constructor(LOAD_GEN_Class_t *LoadGenPtr,
+                          const INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: LOAD_GEN_ChildTask
+**
+** Notes:
+**   1. Signature must match CHILDMGR_TaskCallback_t
+**   2. Pends on the wake semaphore while the generator is idle
+**
+*/
+bool LOAD_GEN_ChildTask(CHILDMGR_Class_t *ChildMgr);
+
+
+/******************************************************************************
+** Function: LOAD_GEN_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+** Notes:
+**   1. Counters of an active generator are not reset.
+**
+*/
+void LOAD_GEN_ResetStatus(void);
+
+
+/******************************************************************************
+** Function: LOAD_GEN_StartCmd
+**
+** Start sending SB messages for a topic.
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**
+*/
+bool LOAD_GEN_StartCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: LOAD_GEN_StartMqttCmd
+**
+** Start injecting a canned MQTT message for a topic.
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**   2. The payload file is read by the command so file errors are reported
+**      with the command's status.
+**
+*/
+bool LOAD_GEN_StartMqttCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: LOAD_GEN_StopCmd
+**
+** Stop an active load generator.
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**   2. The generator stops after its current burst and reports its
+**      achieved rate.
+**
+*/
+bool LOAD_GEN_StopCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+#endif /* _load_gen_ */
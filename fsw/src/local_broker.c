@@ -0,0 +1,1127 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Accept MQTT client connections from local tools
+**
+** Notes:
+**   1. See local_broker.h
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+
+#include "local_broker.h"
+#include "last_value.h"
+#include "mqtt_topic_tbl.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define CTRL_PACKET_LEN  (MQTT_CLIENT_FIXED_HDR_MAX_LEN + MQTT_CLIENT_PACKET_ID_LEN + LOCAL_BROKER_MAX_FILTERS)
+
+
+/************************************/
+/** Local File Function Prototypes **/
+/************************************/
+
+static void AcceptClient(void);
+static void CloseClient(LOCAL_BROKER_Client_t *Client, const char *Reason);
+static uint16 FindFilter(const LOCAL_BROKER_Client_t *Client, const MQTTString *Filter);
+static void FlushClient(LOCAL_BROKER_Client_t *Client);
+static uint32 MatchClients(const char *Topic);
+static int PacketLen(const unsigned char *Buf, uint16 BufLen, uint16 *Len);
+static void ProcessPacket(LOCAL_BROKER_Client_t *Client, unsigned char *Buf, uint16 Len);
+static bool QueuePacket(LOCAL_BROKER_Client_t *Client, const unsigned char *Packet, int Len);
+static void RcvConnect(LOCAL_BROKER_Client_t *Client, unsigned char *Buf, uint16 Len);
+static void RcvPublish(LOCAL_BROKER_Client_t *Client, unsigned char *Buf, uint16 Len);
+static void RcvSubscribe(LOCAL_BROKER_Client_t *Client, unsigned char *Buf, uint16 Len);
+static void RcvUnsubscribe(LOCAL_BROKER_Client_t *Client, unsigned char *Buf, uint16 Len);
+static void ReadClient(LOCAL_BROKER_Client_t *Client);
+static bool SendPacket(LOCAL_BROKER_Client_t *Client, const unsigned char *Packet, int Len);
+static void SendPublish(uint32 ClientMask, const char *Topic, const char *Payload, uint32 PayloadLen);
+static uint32 TopicMask(uint16 TopicId, const char *Topic);
+static bool TopicMatch(const char *Filter, const char *Topic);
+static bool ValidFilter(const MQTTString *Filter);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static LOCAL_BROKER_Class_t *LocalBroker = NULL;
+
+
+/******************************************************************************
+** Function: LOCAL_BROKER_Constructor
+**
+** Notes:
+**   1. OSAL stream sockets listen when they are bound.
+**
+*/
+void LOCAL_BROKER_Constructor(LOCAL_BROKER_Class_t *LocalBrokerPtr,
+                              const INITBL_Class_t *IniTbl,
+                              MQTT_CLIENT_MsgCallback_t MsgCallback)
+{
+
+   const char *Address = INITBL_GetStrConfig(IniTbl, CFG_LOCAL_BROKER_ADDRESS);
+   uint32     Port     = INITBL_GetIntConfig(IniTbl, CFG_LOCAL_BROKER_PORT);
+   int32      SysStatus;
+   osal_id_t  Sock = OS_OBJECT_ID_UNDEFINED;
+   OS_SockAddr_t Addr;
+
+   LocalBroker = LocalBrokerPtr;
+
+   CFE_PSP_MemSet((void*)LocalBroker, 0, sizeof(LOCAL_BROKER_Class_t));
+
+   LocalBroker->ListenSock  = OS_OBJECT_ID_UNDEFINED;
+   LocalBroker->MsgCallback = MsgCallback;
+   LocalBroker->IndexGen    = 1;
+
+   if (Port != 0)
+   {
+
+      OS_MutSemCreate(&LocalBroker->Mutex, "LOCAL_BROKER", 0);
+
+      OS_SocketAddrInit(&Addr, OS_SocketDomain_INET);
+      SysStatus = OS_SocketAddrFromString(&Addr, Address);
+      if (SysStatus == OS_SUCCESS)
+      {
+         OS_SocketAddrSetPort(&Addr, (uint16)Port);
+         SysStatus = OS_SocketOpen(&Sock, OS_SocketDomain_INET, OS_SocketType_STREAM);
+      }
+      if (SysStatus == OS_SUCCESS)
+      {
+         SysStatus = OS_SocketBind(Sock, &Addr);
+         if (SysStatus != OS_SUCCESS)
+         {
+            OS_close(Sock);
+         }
+      }
+
+      if (SysStatus == OS_SUCCESS)
+      {
+         LocalBroker->ListenSock = Sock;
+         CFE_EVS_SendEvent(LOCAL_BROKER_CONSTRUCT_EID, CFE_EVS_EventType_INFORMATION,
+                           "Local MQTT broker listening on %s:%d for up to %d clients",
+                           Address, (int)Port, LOCAL_BROKER_MAX_CLIENTS);
+      }
+      else
+      {
+         CFE_EVS_SendEvent(LOCAL_BROKER_CONSTRUCT_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Error starting local MQTT broker on %s:%d, status=%d",
+                           Address, (int)Port, (int)SysStatus);
+      }
+
+   } /* End if enabled */
+
+} /* End LOCAL_BROKER_Constructor() */
+
+
+/******************************************************************************
+** Function: LOCAL_BROKER_Enabled
+**
+*/
+bool LOCAL_BROKER_Enabled(void)
+{
+
+   return OS_ObjectIdDefined(LocalBroker->ListenSock);
+
+} /* End LOCAL_BROKER_Enabled() */
+
+
+/******************************************************************************
+** Function: LOCAL_BROKER_Publish
+**
+** Notes:
+**   1. The subscription count is checked without the mutex so publishes
+**      cost nothing while no client has a subscription.
+**
+*/
+void LOCAL_BROKER_Publish(uint16 TopicId, const char *Topic, const char *Payload,
+                          uint32 PayloadLen)
+{
+
+   uint32 ClientMask;
+
+   if (LocalBroker->FilterCnt > 0)
+   {
+
+      OS_MutSemTake(LocalBroker->Mutex);
+
+      ClientMask = TopicMask(TopicId, Topic);
+      if (ClientMask != 0)
+      {
+         SendPublish(ClientMask, Topic, Payload, PayloadLen);
+      }
+
+      OS_MutSemGive(LocalBroker->Mutex);
+
+   }
+
+} /* End LOCAL_BROKER_Publish() */
+
+
+/******************************************************************************
+** Function: LOCAL_BROKER_ResetStatus
+**
+*/
+void LOCAL_BROKER_ResetStatus(void)
+{
+
+   LocalBroker->RcvCnt  = 0;
+   LocalBroker->SendCnt = 0;
+   LocalBroker->DropCnt = 0;
+
+} /* End LOCAL_BROKER_ResetStatus() */
+
+
+/******************************************************************************
+** Function: LOCAL_BROKER_Service
+**
+** Notes:
+**   1. A client that doesn't send a packet within one and a half keep alive
+**      periods is disconnected as required by MQTT.
+**
+*/
+void LOCAL_BROKER_Service(uint32 WaitTime)
+{
+
+   uint16    i;
+   uint32    Now;
+   uint32    Timeout;
+   OS_FdSet  ReadSet;
+   OS_FdSet  WriteSet;
+   LOCAL_BROKER_Client_t *Client;
+
+   if (OS_ObjectIdDefined(LocalBroker->ListenSock))
+   {
+
+      OS_SelectFdZero(&ReadSet);
+      OS_SelectFdZero(&WriteSet);
+      OS_SelectFdAdd(&ReadSet, LocalBroker->ListenSock);
+
+      OS_MutSemTake(LocalBroker->Mutex);
+      for (i=0; i < LOCAL_BROKER_MAX_CLIENTS; i++)
+      {
+         Client = &LocalBroker->Client[i];
+         if (Client->InUse)
+         {
+            OS_SelectFdAdd(&ReadSet, Client->Sock);
+            if (Client->TxLen > 0)
+            {
+               OS_SelectFdAdd(&WriteSet, Client->Sock);
+            }
+         }
+      }
+      OS_MutSemGive(LocalBroker->Mutex);
+
+      if (OS_SelectMultiple(&ReadSet, &WriteSet, WaitTime) == OS_SUCCESS)
+      {
+
+         for (i=0; i < LOCAL_BROKER_MAX_CLIENTS; i++)
+         {
+            Client = &LocalBroker->Client[i];
+            if (Client->InUse && OS_SelectFdIsSet(&WriteSet, Client->Sock))
+            {
+               OS_MutSemTake(LocalBroker->Mutex);
+               FlushClient(Client);
+               OS_MutSemGive(LocalBroker->Mutex);
+            }
+            if (Client->InUse && OS_SelectFdIsSet(&ReadSet, Client->Sock))
+            {
+               ReadClient(Client);
+            }
+         }
+
+         if (OS_SelectFdIsSet(&ReadSet, LocalBroker->ListenSock))
+         {
+            AcceptClient();
+         }
+
+      } /* End if select */
+
+      Now = CFE_TIME_GetTime().Seconds;
+      for (i=0; i < LOCAL_BROKER_MAX_CLIENTS; i++)
+      {
+         Client = &LocalBroker->Client[i];
+         if (Client->InUse)
+         {
+            Timeout = Client->Connected ? (Client->KeepAlive + Client->KeepAlive/2) : LOCAL_BROKER_CONNECT_TIMEOUT;
+            if (Client->CloseReq)
+            {
+               CloseClient(Client, "socket write error");
+            }
+            else if (Timeout > 0 && (Now - Client->LastRcvTime) > Timeout)
+            {
+               CloseClient(Client, "keep alive timeout");
+            }
+         }
+      } /* End client loop */
+
+   } /* End if enabled */
+   else if (WaitTime > 0)
+   {
+      OS_TaskDelay(WaitTime);
+   }
+
+} /* End LOCAL_BROKER_Service() */
+
+
+/******************************************************************************
+** Function: AcceptClient
+**
+** Accept a client connection if a client slot is free.
+**
+*/
+static void AcceptClient(void)
+{
+
+   uint16     i;
+   osal_id_t  Sock;
+   OS_SockAddr_t Addr;
+   LOCAL_BROKER_Client_t *Client;
+
+   if (OS_SocketAccept(LocalBroker->ListenSock, &Sock, &Addr, OS_CHECK) == OS_SUCCESS)
+   {
+
+      for (i=0; i < LOCAL_BROKER_MAX_CLIENTS && LocalBroker->Client[i].InUse; i++);
+
+      if (i < LOCAL_BROKER_MAX_CLIENTS)
+      {
+
+         Client = &LocalBroker->Client[i];
+         Client->Sock        = Sock;
+         Client->Connected   = false;
+         Client->CloseReq    = false;
+         Client->KeepAlive   = 0;
+         Client->LastRcvTime = CFE_TIME_GetTime().Seconds;
+         Client->Name[0]     = '\0';
+         Client->FilterCnt   = 0;
+         Client->RxLen       = 0;
+         Client->TxLen       = 0;
+
+         OS_MutSemTake(LocalBroker->Mutex);
+         Client->InUse = true;
+         ++LocalBroker->ClientCnt;
+         OS_MutSemGive(LocalBroker->Mutex);
+
+      }
+      else
+      {
+         OS_close(Sock);
+         CFE_EVS_SendEvent(LOCAL_BROKER_CLIENT_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Local MQTT client rejected, %d clients are connected",
+                           LOCAL_BROKER_MAX_CLIENTS);
+      }
+
+   } /* End if accept */
+
+} /* End AcceptClient() */
+
+
+/******************************************************************************
+** Function: CloseClient
+**
+** Notes:
+**   1. Must not be called with the mutex held.
+**
+*/
+static void CloseClient(LOCAL_BROKER_Client_t *Client, const char *Reason)
+{
+
+   OS_MutSemTake(LocalBroker->Mutex);
+
+   OS_close(Client->Sock);
+   Client->InUse = false;
+   --LocalBroker->ClientCnt;
+   LocalBroker->FilterCnt -= Client->FilterCnt;
+   Client->FilterCnt = 0;
+   ++LocalBroker->IndexGen;
+
+   OS_MutSemGive(LocalBroker->Mutex);
+
+   CFE_EVS_SendEvent(LOCAL_BROKER_DISCONNECT_EID, CFE_EVS_EventType_INFORMATION,
+                     "Local MQTT client %d (%s) disconnected, %s",
+                     (int)(Client - LocalBroker->Client), Client->Name, Reason);
+
+} /* End CloseClient() */
+
+
+/******************************************************************************
+** Function: FindFilter
+**
+** Return the index of a client's topic filter or LOCAL_BROKER_MAX_FILTERS if
+** the client doesn't have the filter.
+**
+*/
+static uint16 FindFilter(const LOCAL_BROKER_Client_t *Client, const MQTTString *Filter)
+{
+
+   uint16 i;
+
+   for (i=0; i < Client->FilterCnt; i++)
+   {
+      if (strncmp(Client->Filter[i], Filter->lenstring.data, Filter->lenstring.len) == 0 &&
+          Client->Filter[i][Filter->lenstring.len] == '\0')
+      {
+         break;
+      }
+   }
+
+   return (i < Client->FilterCnt) ? i : LOCAL_BROKER_MAX_FILTERS;
+
+} /* End FindFilter() */
+
+
+/******************************************************************************
+** Function: FlushClient
+**
+** Write as much of a client's send buffer as the socket accepts.
+**
+** Notes:
+**   1. Must be called with the mutex held. A socket error is recorded and
+**      the client is closed by the MQTT child task.
+**
+*/
+static void FlushClient(LOCAL_BROKER_Client_t *Client)
+{
+
+   int32 SysStatus;
+
+   if (Client->TxLen > 0 && !Client->CloseReq)
+   {
+
+      SysStatus = OS_TimedWrite(Client->Sock, Client->TxBuf, Client->TxLen, OS_CHECK);
+      if (SysStatus > 0)
+      {
+         Client->TxLen -= SysStatus;
+         memmove(Client->TxBuf, &Client->TxBuf[SysStatus], Client->TxLen);
+      }
+      else if (SysStatus != OS_ERROR_TIMEOUT)
+      {
+         Client->CloseReq = true;
+      }
+
+   }
+
+} /* End FlushClient() */
+
+
+/******************************************************************************
+** Function: MatchClients
+**
+** Return the mask of connected clients with a filter that matches Topic.
+**
+** Notes:
+**   1. Must be called with the mutex held.
+**
+*/
+static uint32 MatchClients(const char *Topic)
+{
+
+   uint16 i;
+   uint16 f;
+   uint32 ClientMask = 0;
+   const LOCAL_BROKER_Client_t *Client;
+
+   for (i=0; i < LOCAL_BROKER_MAX_CLIENTS; i++)
+   {
+      Client = &LocalBroker->Client[i];
+      if (Client->InUse && Client->Connected)
+      {
+         for (f=0; f < Client->FilterCnt; f++)
+         {
+            if (TopicMatch(Client->Filter[f], Topic))
+            {
+               ClientMask |= (1u << i);
+               break;
+            }
+         }
+      }
+   } /* End client loop */
+
+   return ClientMask;
+
+} /* End MatchClients() */
+
+
+/******************************************************************************
+** Function: PacketLen
+**
+** Return 1 and the packet length in Len if Buf starts with a complete MQTT
+** packet, 0 if more data is needed, and -1 if the packet is invalid or too
+** long for the receive buffer.
+**
+*/
+static int PacketLen(const unsigned char *Buf, uint16 BufLen, uint16 *Len)
+{
+
+   int     RetStatus = 0;
+   uint16  i = 1;
+   uint32  Multiplier = 1;
+   uint32  RemainingLen = 0;
+   unsigned char Byte = 0x80;
+
+   while (i < BufLen && i <= 4 && (Byte & 0x80))
+   {
+      Byte = Buf[i++];
+      RemainingLen += (Byte & 0x7F) * Multiplier;
+      Multiplier *= 128;
+   }
+
+   if (!(Byte & 0x80))
+   {
+      if ((i + RemainingLen) > LOCAL_BROKER_RX_BUF_LEN)
+      {
+         RetStatus = -1;
+      }
+      else if ((i + RemainingLen) <= BufLen)
+      {
+         *Len = i + RemainingLen;
+         RetStatus = 1;
+      }
+   }
+   else if (i > 4)
+   {
+      RetStatus = -1;
+   }
+
+   return RetStatus;
+
+} /* End PacketLen() */
+
+
+/******************************************************************************
+** Function: ProcessPacket
+**
+** Notes:
+**   1. A client's first packet must be CONNECT. Packets that a client never
+**      sends to a QoS 0 only broker close the connection.
+**
+*/
+static void ProcessPacket(LOCAL_BROKER_Client_t *Client, unsigned char *Buf, uint16 Len)
+{
+
+   unsigned char  Type = Buf[0] >> 4;
+   unsigned char  Ack[CTRL_PACKET_LEN];
+   unsigned char  AckType;
+   unsigned char  Dup;
+   unsigned short PacketId;
+
+   if (Type == CONNECT)
+   {
+      RcvConnect(Client, Buf, Len);
+   }
+   else if (!Client->Connected)
+   {
+      CloseClient(Client, "first packet isn't CONNECT");
+   }
+   else
+   {
+
+      switch (Type)
+      {
+
+         case PUBLISH:
+            RcvPublish(Client, Buf, Len);
+            break;
+
+         case PUBREL:
+            if (MQTTDeserialize_ack(&AckType, &Dup, &PacketId, Buf, Len) == 1)
+            {
+               SendPacket(Client, Ack, MQTTSerialize_ack(Ack, sizeof(Ack), PUBCOMP, 0, PacketId));
+            }
+            break;
+
+         case SUBSCRIBE:
+            RcvSubscribe(Client, Buf, Len);
+            break;
+
+         case UNSUBSCRIBE:
+            RcvUnsubscribe(Client, Buf, Len);
+            break;
+
+         case PINGREQ:
+            Ack[0] = PINGRESP << 4;
+            Ack[1] = 0;
+            SendPacket(Client, Ack, 2);
+            break;
+
+         case DISCONNECT:
+            CloseClient(Client, "client request");
+            break;
+
+         default:
+            CloseClient(Client, "unexpected packet type");
+            break;
+
+      } /* End packet switch */
+
+   }
+
+} /* End ProcessPacket() */
+
+
+/******************************************************************************
+** Function: QueuePacket
+**
+** Append a packet to a client's send buffer and start sending it. Return
+** false if the packet doesn't fit.
+**
+** Notes:
+**   1. Must be called with the mutex held.
+**
+*/
+static bool QueuePacket(LOCAL_BROKER_Client_t *Client, const unsigned char *Packet, int Len)
+{
+
+   bool RetStatus = false;
+
+   if (Len > 0 && (Client->TxLen + Len) <= LOCAL_BROKER_TX_BUF_LEN)
+   {
+      memcpy(&Client->TxBuf[Client->TxLen], Packet, Len);
+      Client->TxLen += Len;
+      FlushClient(Client);
+      RetStatus = true;
+   }
+
+   return RetStatus;
+
+} /* End QueuePacket() */
+
+
+/******************************************************************************
+** Function: RcvConnect
+**
+** Notes:
+**   1. MQTT 3.1 and 3.1.1 clients are accepted.
+**   2. A client ID longer than the name buffer is truncated. It is only used
+**      in event messages.
+**
+*/
+static void RcvConnect(LOCAL_BROKER_Client_t *Client, unsigned char *Buf, uint16 Len)
+{
+
+   unsigned char  Ack[CTRL_PACKET_LEN];
+   unsigned char  ConnackRc;
+   size_t         NameLen;
+
+   /* Initial to a local variable to avoid a compiler error */
+   MQTTPacket_connectData ConnectData = MQTTPacket_connectData_initializer;
+
+   if (Client->Connected)
+   {
+      CloseClient(Client, "second CONNECT");
+   }
+   else if (MQTTDeserialize_connect(&ConnectData, Buf, Len) != 1)
+   {
+      CloseClient(Client, "invalid CONNECT");
+   }
+   else
+   {
+
+      ConnackRc = (ConnectData.MQTTVersion == 3 || ConnectData.MQTTVersion == 4) ? 0 : 1;
+
+      if (SendPacket(Client, Ack, MQTTSerialize_connack(Ack, sizeof(Ack), ConnackRc, 0)))
+      {
+         if (ConnackRc == 0)
+         {
+
+            NameLen = ConnectData.clientID.lenstring.len;
+            if (NameLen >= MQTT_TOPIC_TBL_MAX_TOPIC_LEN)
+            {
+               NameLen = MQTT_TOPIC_TBL_MAX_TOPIC_LEN-1;
+            }
+            memcpy(Client->Name, ConnectData.clientID.lenstring.data, NameLen);
+            Client->Name[NameLen] = '\0';
+            Client->KeepAlive = ConnectData.keepAliveInterval;
+
+            OS_MutSemTake(LocalBroker->Mutex);
+            Client->Connected = true;
+            OS_MutSemGive(LocalBroker->Mutex);
+
+            CFE_EVS_SendEvent(LOCAL_BROKER_CONNECT_EID, CFE_EVS_EventType_INFORMATION,
+                              "Local MQTT client %d (%s) connected, keep alive %d seconds",
+                              (int)(Client - LocalBroker->Client), Client->Name, Client->KeepAlive);
+         }
+         else
+         {
+            CloseClient(Client, "unsupported MQTT version");
+         }
+      }
+
+   }
+
+} /* End RcvConnect() */
+
+
+/******************************************************************************
+** Function: RcvPublish
+**
+** Notes:
+**   1. QoS 1 and 2 publishes are acknowledged when they are received. A QoS
+**      2 publish is processed when PUBLISH arrives so the PUBREL exchange
+**      only completes the client's protocol.
+**   2. Only messages for MQTT-to-SB topics and the LAST_VALUE request topic
+**      are passed to the message callback so messages between local tools
+**      aren't reported as unmatched topics.
+**   3. The retain flag is cleared because the message is delivered as a new
+**      message, not a broker's retained value.
+**
+*/
+static void RcvPublish(LOCAL_BROKER_Client_t *Client, unsigned char *Buf, uint16 Len)
+{
+
+   unsigned char  Ack[CTRL_PACKET_LEN];
+   unsigned char  Dup;
+   unsigned char  Retained;
+   unsigned short PacketId;
+   int            Qos;
+   int            PayloadLen;
+   unsigned char *Payload;
+   MQTTString     TopicName;
+   uint16         TopicLen;
+   uint32         ClientMask;
+   char           Topic[MQTT_TOPIC_TBL_MAX_TOPIC_LEN];
+   const MQTT_TOPIC_TBL_Entry_t *Entry;
+   MQTTMessage    Msg;
+   MessageData    MsgData;
+
+   if (MQTTDeserialize_publish(&Dup, &Qos, &Retained, &PacketId, &TopicName,
+                               &Payload, &PayloadLen, Buf, Len) == 1)
+   {
+
+      ++LocalBroker->RcvCnt;
+
+      if (Qos > 0)
+      {
+         SendPacket(Client, Ack, MQTTSerialize_ack(Ack, sizeof(Ack), (Qos == 1) ? PUBACK : PUBREC, 0, PacketId));
+      }
+
+      TopicLen = TopicName.lenstring.len;
+      if (TopicLen < MQTT_TOPIC_TBL_MAX_TOPIC_LEN)
+      {
+
+         memcpy(Topic, TopicName.lenstring.data, TopicLen);
+         Topic[TopicLen] = '\0';
+
+         OS_MutSemTake(LocalBroker->Mutex);
+         ClientMask = MatchClients(Topic);
+         if (ClientMask != 0)
+         {
+            SendPublish(ClientMask, Topic, (const char *)Payload, PayloadLen);
+         }
+         OS_MutSemGive(LocalBroker->Mutex);
+
+         Entry = MQTT_TOPIC_TBL_GetEntry(MQTT_TOPIC_TBL_FindName(Topic, TopicLen));
+         if ((Entry != NULL && Entry->SbRole == MQTT_TOPIC_TBL_SB_ROLE_PUB) ||
+             LAST_VALUE_IsReqTopic(Topic, TopicLen))
+         {
+
+            Msg.qos        = (enum QoS)Qos;
+            Msg.retained   = 0;
+            Msg.dup        = Dup;
+            Msg.id         = PacketId;
+            Msg.payload    = Payload;
+            Msg.payloadlen = PayloadLen;
+
+            MsgData.message   = &Msg;
+            MsgData.topicName = &TopicName;
+
+            (LocalBroker->MsgCallback)(&MsgData);
+
+         }
+      } /* End if topic length */
+
+   }
+   else
+   {
+      CloseClient(Client, "invalid PUBLISH");
+   }
+
+} /* End RcvPublish() */
+
+
+/******************************************************************************
+** Function: RcvSubscribe
+**
+** Notes:
+**   1. Every valid filter is granted QoS 0. Invalid filters and filters
+**      that exceed the client's LOCAL_BROKER_MAX_FILTERS are refused.
+**
+*/
+static void RcvSubscribe(LOCAL_BROKER_Client_t *Client, unsigned char *Buf, uint16 Len)
+{
+
+   int            i;
+   int            FilterCnt;
+   int            ReqQos[LOCAL_BROKER_MAX_FILTERS];
+   int            GrantedQos[LOCAL_BROKER_MAX_FILTERS];
+   unsigned char  Dup;
+   unsigned short PacketId;
+   unsigned char  Ack[CTRL_PACKET_LEN];
+   MQTTString     Filter[LOCAL_BROKER_MAX_FILTERS];
+
+   if (MQTTDeserialize_subscribe(&Dup, &PacketId, LOCAL_BROKER_MAX_FILTERS, &FilterCnt,
+                                 Filter, ReqQos, Buf, Len) == 1)
+   {
+
+      OS_MutSemTake(LocalBroker->Mutex);
+
+      for (i=0; i < FilterCnt; i++)
+      {
+
+         GrantedQos[i] = SUBFAIL;
+
+         if (ValidFilter(&Filter[i]))
+         {
+            if (FindFilter(Client, &Filter[i]) < LOCAL_BROKER_MAX_FILTERS)
+            {
+               GrantedQos[i] = QOS0;
+            }
+            else if (Client->FilterCnt < LOCAL_BROKER_MAX_FILTERS)
+            {
+               memcpy(Client->Filter[Client->FilterCnt], Filter[i].lenstring.data, Filter[i].lenstring.len);
+               Client->Filter[Client->FilterCnt][Filter[i].lenstring.len] = '\0';
+               ++Client->FilterCnt;
+               ++LocalBroker->FilterCnt;
+               GrantedQos[i] = QOS0;
+            }
+         }
+
+      } /* End filter loop */
+
+      ++LocalBroker->IndexGen;
+
+      OS_MutSemGive(LocalBroker->Mutex);
+
+      SendPacket(Client, Ack, MQTTSerialize_suback(Ack, sizeof(Ack), PacketId, FilterCnt, GrantedQos));
+
+   }
+   else
+   {
+      CloseClient(Client, "invalid SUBSCRIBE");
+   }
+
+} /* End RcvSubscribe() */
+
+
+/******************************************************************************
+** Function: RcvUnsubscribe
+**
+*/
+static void RcvUnsubscribe(LOCAL_BROKER_Client_t *Client, unsigned char *Buf, uint16 Len)
+{
+
+   int            i;
+   int            FilterCnt;
+   uint16         f;
+   unsigned char  Dup;
+   unsigned short PacketId;
+   unsigned char  Ack[CTRL_PACKET_LEN];
+   MQTTString     Filter[LOCAL_BROKER_MAX_FILTERS];
+
+   if (MQTTDeserialize_unsubscribe(&Dup, &PacketId, LOCAL_BROKER_MAX_FILTERS, &FilterCnt,
+                                   Filter, Buf, Len) == 1)
+   {
+
+      OS_MutSemTake(LocalBroker->Mutex);
+
+      for (i=0; i < FilterCnt; i++)
+      {
+         f = FindFilter(Client, &Filter[i]);
+         if (f < LOCAL_BROKER_MAX_FILTERS)
+         {
+            --Client->FilterCnt;
+            --LocalBroker->FilterCnt;
+            strcpy(Client->Filter[f], Client->Filter[Client->FilterCnt]);
+         }
+      }
+
+      ++LocalBroker->IndexGen;
+
+      OS_MutSemGive(LocalBroker->Mutex);
+
+      SendPacket(Client, Ack, MQTTSerialize_unsuback(Ack, sizeof(Ack), PacketId));
+
+   }
+   else
+   {
+      CloseClient(Client, "invalid UNSUBSCRIBE");
+   }
+
+} /* End RcvUnsubscribe() */
+
+
+/******************************************************************************
+** Function: ReadClient
+**
+** Read the data a client has sent and process each complete packet.
+**
+*/
+static void ReadClient(LOCAL_BROKER_Client_t *Client)
+{
+
+   int32  SysStatus;
+   int    Status = 1;
+   uint16 Len;
+
+   SysStatus = OS_TimedRead(Client->Sock, &Client->RxBuf[Client->RxLen],
+                            LOCAL_BROKER_RX_BUF_LEN - Client->RxLen, OS_CHECK);
+
+   if (SysStatus > 0)
+   {
+
+      Client->RxLen += SysStatus;
+      Client->LastRcvTime = CFE_TIME_GetTime().Seconds;
+
+      while (Client->InUse && Status > 0)
+      {
+         Status = PacketLen(Client->RxBuf, Client->RxLen, &Len);
+         if (Status > 0)
+         {
+            ProcessPacket(Client, Client->RxBuf, Len);
+            Client->RxLen -= Len;
+            memmove(Client->RxBuf, &Client->RxBuf[Len], Client->RxLen);
+         }
+         else if (Status < 0)
+         {
+            CloseClient(Client, "invalid packet length");
+         }
+      }
+
+   }
+   else if (SysStatus != OS_ERROR_TIMEOUT)
+   {
+      CloseClient(Client, "connection closed");
+   }
+
+} /* End ReadClient() */
+
+
+/******************************************************************************
+** Function: SendPacket
+**
+** Send a control packet to a client. The client is closed if its send
+** buffer is full.
+**
+** Notes:
+**   1. Must not be called with the mutex held.
+**
+*/
+static bool SendPacket(LOCAL_BROKER_Client_t *Client, const unsigned char *Packet, int Len)
+{
+
+   bool RetStatus;
+
+   OS_MutSemTake(LocalBroker->Mutex);
+   RetStatus = QueuePacket(Client, Packet, Len);
+   OS_MutSemGive(LocalBroker->Mutex);
+
+   if (!RetStatus)
+   {
+      CloseClient(Client, "send buffer full");
+   }
+
+   return RetStatus;
+
+} /* End SendPacket() */
+
+
+/******************************************************************************
+** Function: SendPublish
+**
+** Serialize a QoS 0 PUBLISH once and queue it to each client in ClientMask.
+**
+** Notes:
+**   1. Must be called with the mutex held.
+**
+*/
+static void SendPublish(uint32 ClientMask, const char *Topic, const char *Payload, uint32 PayloadLen)
+{
+
+   uint16 i;
+   int    PacketLen;
+   MQTTString TopicName = MQTTString_initializer;
+   LOCAL_BROKER_Client_t *Client;
+
+   TopicName.cstring = (char *)Topic;
+   PacketLen = MQTTSerialize_publish(LocalBroker->PubBuf, LOCAL_BROKER_TX_BUF_LEN, 0, QOS0, 0, 0,
+                                     TopicName, (unsigned char *)Payload, PayloadLen);
+
+   for (i=0; i < LOCAL_BROKER_MAX_CLIENTS; i++)
+   {
+      if (ClientMask & (1u << i))
+      {
+         Client = &LocalBroker->Client[i];
+         if (Client->InUse && !Client->CloseReq && QueuePacket(Client, LocalBroker->PubBuf, PacketLen))
+         {
+            ++LocalBroker->SendCnt;
+         }
+         else
+         {
+            ++LocalBroker->DropCnt;
+         }
+      }
+   } /* End client loop */
+
+} /* End SendPublish() */
+
+
+/******************************************************************************
+** Function: TopicMask
+**
+** Return the mask of clients subscribed to topic 'TopicId'.
+**
+** Notes:
+**   1. Must be called with the mutex held.
+**   2. The index is only used for topics whose name is the same for every
+**      message. Template topics are matched with the rendered name.
+**
+*/
+static uint32 TopicMask(uint16 TopicId, const char *Topic)
+{
+
+   uint32 ClientMask;
+   uint32 TblGen = MQTT_TOPIC_TBL_GetData()->Generation;
+   const  MQTT_TOPIC_TBL_Entry_t *Entry = MQTT_TOPIC_TBL_GetEntry(TopicId);
+   LOCAL_BROKER_Index_t *Index;
+
+   if (Entry == NULL || Entry->NameKey != MQTT_TOPIC_TBL_NAME_KEY_NONE)
+   {
+      ClientMask = MatchClients(Topic);
+   }
+   else
+   {
+
+      if (TblGen != LocalBroker->IndexTblGen)
+      {
+         LocalBroker->IndexTblGen = TblGen;
+         ++LocalBroker->IndexGen;
+      }
+
+      Index = &LocalBroker->Index[TopicId];
+      if (Index->Gen != LocalBroker->IndexGen)
+      {
+         Index->ClientMask = MatchClients(Topic);
+         Index->Gen = LocalBroker->IndexGen;
+      }
+      ClientMask = Index->ClientMask;
+
+   }
+
+   return ClientMask;
+
+} /* End TopicMask() */
+
+
+/******************************************************************************
+** Function: TopicMatch
+**
+** Return true if topic filter 'Filter' matches topic name 'Topic'.
+**
+** Notes:
+**   1. '+' matches one level and '#' matches the remaining levels including
+**      the parent level. Wildcards don't match topics that start with '$'.
+**
+*/
+static bool TopicMatch(const char *Filter, const char *Topic)
+{
+
+   bool Match = false;
+   bool Done  = (Topic[0] == '$' && (Filter[0] == '+' || Filter[0] == '#'));
+
+   while (!Done)
+   {
+
+      if (*Filter == '#')
+      {
+         Match = true;
+         Done  = true;
+      }
+      else if (*Filter == '+')
+      {
+         while (*Topic != '\0' && *Topic != '/')
+         {
+            Topic++;
+         }
+         Filter++;
+      }
+      else if (*Topic == '\0')
+      {
+         Match = (*Filter == '\0' || strcmp(Filter, "/#") == 0);
+         Done  = true;
+      }
+      else if (*Filter == *Topic)
+      {
+         Filter++;
+         Topic++;
+      }
+      else
+      {
+         Done = true;
+      }
+
+   } /* End while not done */
+
+   return Match;
+
+} /* End TopicMatch() */
+
+
+/******************************************************************************
+** Function: ValidFilter
+**
+** Return true if a SUBSCRIBE topic filter is valid and fits in a client's
+** filter buffer.
+**
+*/
+static bool ValidFilter(const MQTTString *Filter)
+{
+
+   int   i;
+   int   Len = Filter->lenstring.len;
+   const char *Str = Filter->lenstring.data;
+   bool  RetStatus = (Len > 0 && Len < MQTT_TOPIC_TBL_MAX_TOPIC_LEN);
+
+   for (i=0; i < Len && RetStatus; i++)
+   {
+      if (Str[i] == '#')
+      {
+         RetStatus = (i == Len-1) && (i == 0 || Str[i-1] == '/');
+      }
+      else if (Str[i] == '+')
+      {
+         RetStatus = (i == 0 || Str[i-1] == '/') && (i == Len-1 || Str[i+1] == '/');
+      }
+      else if (Str[i] == '\0')
+      {
+         RetStatus = false;
+      }
+   }
+
+   return RetStatus;
+
+} /* End ValidFilter() */
@@ -0,0 +1,213 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Accept MQTT client connections from local tools
+**
+** Notes:
+**   1. An embedded MQTT 3.1.1 broker for testbeds that don't have a broker.
+**      Local tools connect to LOCAL_BROKER_ADDRESS:LOCAL_BROKER_PORT and
+**      exchange messages with the gateway without an external broker hop.
+**      A LOCAL_BROKER_PORT of 0 disables the broker.
+**   2. A client PUBLISH to an MQTT-to-SB topic or the LAST_VALUE request
+**      topic is passed to the same message callback as the MQTT client's
+**      messages. Every PUBLISH is also relayed to the local clients with a
+**      matching subscription.
+**   3. SB-to-MQTT messages are sent to subscribed clients by
+**      LOCAL_BROKER_Publish(). The topic index holds a client bit mask for
+**      each topic ID so a message's subscribers are found with one lookup.
+**      An index entry is rebuilt the first time its topic is published
+**      after a subscription change or a topic table load. Topics with
+**      per-message name templates are matched each time.
+**   4. Lightweight broker limits:
+**      - Sessions are clean. Will messages, user names and passwords are
+**        ignored so the broker should only listen on a local address.
+**      - Messages are sent to clients with QoS 0 and subscriptions are
+**        granted QoS 0. Client QoS 1 and 2 publishes are acknowledged.
+**      - Retained messages aren't stored. Clients can request the current
+**        values with the LAST_VALUE request topic.
+**   5. Sockets are serviced by the MQTT child task. Messages are published
+**      by the main task and the PERF_BENCH child task so client send
+**      buffers and subscriptions are protected by a mutex. Each send is
+**      written to the socket right away and data that doesn't fit in the
+**      socket is sent by the MQTT child task. A message that doesn't fit in
+**      a client's send buffer is dropped for that client.
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+#ifndef _local_broker_
+#define _local_broker_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "mqtt_client.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/*
+** Event Message IDs
+*/
+
+#define LOCAL_BROKER_CONSTRUCT_EID      (LOCAL_BROKER_BASE_EID + 0)
+#define LOCAL_BROKER_CONSTRUCT_ERR_EID  (LOCAL_BROKER_BASE_EID + 1)
+#define LOCAL_BROKER_CONNECT_EID        (LOCAL_BROKER_BASE_EID + 2)
+#define LOCAL_BROKER_DISCONNECT_EID     (LOCAL_BROKER_BASE_EID + 3)
+#define LOCAL_BROKER_CLIENT_ERR_EID     (LOCAL_BROKER_BASE_EID + 4)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+typedef struct
+{
+
+   bool       InUse;
+   bool       Connected;     /* CONNECT received */
+   bool       CloseReq;      /* Socket write error, closed by the MQTT child task */
+   osal_id_t  Sock;
+   uint16     KeepAlive;     /* Seconds, 0 = No timeout */
+   uint32     LastRcvTime;   /* Seconds */
+   char       Name[MQTT_TOPIC_TBL_MAX_TOPIC_LEN];   /* Client ID, truncated */
+
+   uint16     FilterCnt;
+   char       Filter[LOCAL_BROKER_MAX_FILTERS][MQTT_TOPIC_TBL_MAX_TOPIC_LEN];
+
+   uint16         RxLen;
+   uint16         TxLen;
+   unsigned char  RxBuf[LOCAL_BROKER_RX_BUF_LEN];
+   unsigned char  TxBuf[LOCAL_BROKER_TX_BUF_LEN];
+
+} LOCAL_BROKER_Client_t;
+
+
+/*
+** A topic's subscribers. ClientMask is valid while Gen matches the class
+** IndexGen.
+*/
+
+typedef struct
+{
+
+   uint32  Gen;
+   uint32  ClientMask;
+
+} LOCAL_BROKER_Index_t;
+
+
+/*
+** Class Definition
+*/
+
+typedef struct
+{
+
+   osal_id_t  ListenSock;   /* Undefined if the broker is disabled */
+   osal_id_t  Mutex;
+
+   MQTT_CLIENT_MsgCallback_t  MsgCallback;
+
+   uint16  ClientCnt;    /* Connected sockets */
+   uint16  FilterCnt;    /* Subscriptions of all clients */
+
+   uint32  RcvCnt;       /* PUBLISH packets received from clients */
+   uint32  SendCnt;      /* PUBLISH packets queued to clients */
+   uint32  DropCnt;      /* PUBLISH packets dropped because a client's send buffer was full */
+
+   uint32  IndexGen;     /* Incremented when a subscription changes */
+   uint32  IndexTblGen;  /* Topic table generation the index was built for */
+   LOCAL_BROKER_Index_t  Index[MQTT_TOPIC_TBL_MAX_TOPICS];
+
+   unsigned char  PubBuf[LOCAL_BROKER_TX_BUF_LEN];   /* Serialized PUBLISH that is copied to each subscriber */
+
+   LOCAL_BROKER_Client_t  Client[LOCAL_BROKER_MAX_CLIENTS];
+
+} LOCAL_BROKER_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: LOCAL_BROKER_Constructor
+**
+** Notes:
+**    1. This function must be called prior to any other functions being
+**       called using the same LOCAL_BROKER instance.
+**    2. MsgCallback receives the client messages that are processed by the
+**       gateway.
+**
+*/
+void LOCAL_BROKER_Constructor(LOCAL_BROKER_Class_t *LocalBrokerPtr,
+                              const INITBL_Class_t *IniTbl,
+                              MQTT_CLIENT_MsgCallback_t MsgCallback);
+
+
+/******************************************************************************
+** Function: LOCAL_BROKER_Enabled
+**
+** Return true if the broker is listening for clients.
+**
+*/
+bool LOCAL_BROKER_Enabled(void);
+
+
+/******************************************************************************
+** Function: LOCAL_BROKER_Publish
+**
+** Send an SB-to-MQTT message to the clients subscribed to its topic.
+**
+** Notes:
+**   1. Topic is the rendered topic name of topic table ID 'TopicId'.
+**
+*/
+void LOCAL_BROKER_Publish(uint16 TopicId, const char *Topic, const char *Payload,
+                          uint32 PayloadLen);
+
+
+/******************************************************************************
+** Function: LOCAL_BROKER_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+*/
+void LOCAL_BROKER_ResetStatus(void);
+
+
+/******************************************************************************
+** Function: LOCAL_BROKER_Service
+**
+** Accept new clients and process the packets received from clients. Waits up
+** to WaitTime milliseconds for client activity.
+**
+** Notes:
+**   1. Must only be called by the MQTT child task.
+**   2. Delays for WaitTime if the broker is disabled.
+**
+*/
+void LOCAL_BROKER_Service(uint32 WaitTime);
+
+
+#endif /* _local_broker_ */
@@ -33,17 +33,27 @@
 ** Include Files:
 */
 
+#include <poll.h>
 #include <string.h>
 
 #include "mqtt_client.h"
 
 
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static void   ProcessPacket(int Len);
+static uint16 ReadListAcks(uint8 PacketType, const char *Topic[]);
+static int    ReadPacket(Timer *ReadTimer);
+static uint16 SendTopicList(uint8 PacketType, const char *Topic[], uint16 TopicCnt, int Qos);
+
+
 /*****************/
 /** Global Data **/
 /*****************/
 
 static MQTT_CLIENT_Class_t* MqttClient;
-static char TestPayload[] = "Test Payload";
 
 /******************************************************************************
 ** Function: MQTT_CLIENT_Constructor
@@ -51,6 +61,8 @@ static char TestPayload[] = "Test Payload";
 ** Notes:
 **    1. This function must be called prior to any other functions being
 **       called using the same MQTT_CLIENT instance.
+**    2. The mutex is created before the first connect because every
+**       connect holds it.
 */
 void MQTT_CLIENT_Constructor(MQTT_CLIENT_Class_t *MqttClientPtr,
                              const INITBL_Class_t *IniTbl)
@@ -67,9 +79,9 @@ void MQTT_CLIENT_Constructor(MQTT_CLIENT_Class_t *MqttClientPtr,
    MqttClient->PubMsg.retained = 0;
    MqttClient->PubMsg.dup = 0;
    MqttClient->PubMsg.id = 0;
-   MqttClient->PubMsg.payload = TestPayload;
-   MqttClient->PubMsg.id = strlen(TestPayload);
-
+   
+   OS_MutSemCreate(&MqttClient->Mutex, "MQTT_CLIENT", 0);
+   
    MQTT_CLIENT_Connect(ClientName, BrokerAddress, BrokerPort);
 
 } /* End MQTT_CLIENT_Constructor() */
@@ -97,6 +109,8 @@ bool MQTT_CLIENT_Connect(const char *ClientName, const char *BrokerAddress,
    ** Init and connect to network
    */
    
+   OS_MutSemTake(MqttClient->Mutex);
+   
    NetworkInit(&MqttClient->Network);
    RetCode = NetworkConnect(&MqttClient->Network, (char *)BrokerAddress, BrokerPort);
    if (RetCode == 0) 
@@ -131,6 +145,7 @@ bool MQTT_CLIENT_Connect(const char *ClientName, const char *BrokerAddress,
          CFE_EVS_SendEvent(MQTT_CLIENT_CONNECT_EID, CFE_EVS_EventType_INFORMATION, 
                            "Successfully connected to MQTT broker %s:%d as client %s", BrokerAddress, BrokerPort, ClientName);
          MqttClient->Connected = true;
+         __atomic_add_fetch(&MqttClient->ConnectCnt, 1, __ATOMIC_RELEASE);
          RetStatus = true;
          
       }
@@ -149,6 +164,8 @@ bool MQTT_CLIENT_Connect(const char *ClientName, const char *BrokerAddress,
                         BrokerAddress, BrokerPort, RetCode);
    }
    
+   OS_MutSemGive(MqttClient->Mutex);
+   
    return RetStatus;
 
 } /* End MQTT_CLIENT_Connect() */
@@ -164,39 +181,138 @@ bool MQTT_CLIENT_Connect(const char *ClientName, const char *BrokerAddress,
 void MQTT_CLIENT_Disconnect(void)
 {
    
+   OS_MutSemTake(MqttClient->Mutex);
    MQTTDisconnect(&MqttClient->Client);
    NetworkDisconnect(&MqttClient->Network);
+   OS_MutSemGive(MqttClient->Mutex);
 
 } /* End MQTT_CLIENT_Disconnect() */
 
 
+/******************************************************************************
+** Function: MQTT_CLIENT_GetConnectCnt
+**
+** Notes:
+**    1. Called by the child task while connections are made by the main task
+**
+*/
+uint32 MQTT_CLIENT_GetConnectCnt(void)
+{
+
+   return __atomic_load_n(&MqttClient->ConnectCnt, __ATOMIC_ACQUIRE);
+
+} /* End MQTT_CLIENT_GetConnectCnt() */
+
+
+/******************************************************************************
+** Function: MQTT_CLIENT_IsConnected
+**
+*/
+bool MQTT_CLIENT_IsConnected(void)
+{
+
+   return MqttClient->Connected;
+
+} /* End MQTT_CLIENT_IsConnected() */
+
+
+/******************************************************************************
+** Function: MQTT_CLIENT_LoopbackPublish
+**
+** Notes:
+**    1. Performs the same PUBLISH packet serialization as MQTTPublish() and
+**       the same deserialization as the MQTT library's receive path so the
+**       packet encoding cost is included in benchmark measurements.
+*/
+bool MQTT_CLIENT_LoopbackPublish(unsigned char *PacketBuf, uint16 PacketBufLen,
+                                 const char *Topic, const char *Payload,
+                                 MQTT_CLIENT_MsgCallback_t Callback)
+{
+
+   bool RetStatus = false;
+   int  PacketLen;
+   int  PayloadLen;
+   int  Qos;
+   unsigned char   Dup;
+   unsigned char   Retained;
+   unsigned short  PacketId;
+   MQTTString      TopicName = MQTTString_initializer;
+   MQTTString      RcvTopicName;
+   MQTTMessage     RcvMsg;
+   MessageData     MsgData;
+   
+   TopicName.cstring = (char *)Topic;
+   PacketLen = MQTTSerialize_publish(PacketBuf, PacketBufLen, 0, MQTT_CLIENT_QOS0, 0, 0,
+                                     TopicName, (unsigned char *)Payload, strlen(Payload));
+   
+   if (PacketLen > 0 &&
+       MQTTDeserialize_publish(&Dup, &Qos, &Retained, &PacketId, &RcvTopicName,
+                               (unsigned char **)&RcvMsg.payload, &PayloadLen,
+                               PacketBuf, PacketLen) == 1)
+   {
+      
+      RcvMsg.payloadlen = PayloadLen;
+      RcvMsg.qos      = (enum QoS)Qos;
+      RcvMsg.retained = Retained;
+      RcvMsg.dup      = Dup;
+      RcvMsg.id       = PacketId;
+      
+      MsgData.message   = &RcvMsg;
+      MsgData.topicName = &RcvTopicName;
+      
+      if (Callback != NULL)
+      {
+         (Callback)(&MsgData);
+      }
+      RetStatus = true;
+      
+   }
+   else
+   {
+      CFE_EVS_SendEvent(MQTT_CLIENT_PUBLISH_ERR_EID, CFE_EVS_EventType_ERROR, 
+                       "Error publishing topic %s in loopback mode, packet length %d",
+                       Topic, PacketLen);   
+   }
+   
+   return RetStatus;
+
+} /* End MQTT_CLIENT_LoopbackPublish() */
+
+
 /******************************************************************************
 ** Function: MQTT_CLIENT_Publish
 **
 ** Notes:
 **    1. QOS needs to be converted to MQTT library constants
+**    2. Successful publishes are traced, only errors generate events. Like
+**       the trace the event reports the payload length, not the payload.
 */
-bool MQTT_CLIENT_Publish(const char *Topic, const char *Payload)
+bool MQTT_CLIENT_Publish(const char *Topic, const char *Payload, bool Retain)
 {
    
    bool RetStatus = false;
+   int  PubStatus;
    
-
+   OS_MutSemTake(MqttClient->Mutex);
+   
+   MqttClient->PubMsg.retained = Retain;
    MqttClient->PubMsg.payload = (void *)Payload;
    MqttClient->PubMsg.payloadlen = strlen(Payload);
+   PubStatus = MQTTPublish(&MqttClient->Client, Topic, &MqttClient->PubMsg);
    
-   if (MQTTPublish(&MqttClient->Client, Topic, &MqttClient->PubMsg) == SUCCESS)
+   OS_MutSemGive(MqttClient->Mutex);
+
+   if (PubStatus == SUCCESS)
    {
       RetStatus = true;
-      CFE_EVS_SendEvent(MQTT_CLIENT_PUBLISH_EID, CFE_EVS_EventType_INFORMATION, 
-                       "Successfully published topic %s with payload %s",
-                       Topic, Payload);
+      TRACE_RING_Write(TRACE_RING_MODULE_MQTT_CLIENT, TRACE_RING_LEVEL_DEBUG, MQTT_CLIENT_PUBLISH_TID,
+                       MqttClient->PubMsg.payloadlen, 0, Topic, MQTT_TOPIC_TBL_MAX_TOPIC_LEN);
    }
    else
    {
       CFE_EVS_SendEvent(MQTT_CLIENT_PUBLISH_ERR_EID, CFE_EVS_EventType_ERROR, 
-                       "Error publishing topic %s with payload %s",
-                       Topic, Payload);   
+                       "Error publishing topic %s with a %d byte payload",
+                       Topic, (int)MqttClient->PubMsg.payloadlen);   
    }
 
    return RetStatus;
@@ -213,7 +329,7 @@ bool MQTT_CLIENT_Publish(const char *Topic, const char *Payload)
 void MQTT_CLIENT_ResetStatus(void)
 {
 
-   /* Nothing to do */
+   MqttClient->SubRefusedCnt = 0;
 
 } /* End MQTT_CLIENT_ResetStatus() */
 
@@ -231,31 +347,76 @@ bool MQTT_CLIENT_Subscribe(const char *Topic, int Qos,
    
    bool RetStatus = false;
    
+   OS_MutSemTake(MqttClient->Mutex);
    RetStatus = (MQTTSubscribe(&MqttClient->Client, Topic, Qos, MsgCallbackFunc) == SUCCESS);
+   OS_MutSemGive(MqttClient->Mutex);
 
    return RetStatus;
    
 } /* End MQTT_CLIENT_Subscribe() */
 
 
+/******************************************************************************
+** Function: MQTT_CLIENT_SubscribeList
+**
+*/
+uint16 MQTT_CLIENT_SubscribeList(const char *Topic[], uint16 TopicCnt, int Qos,
+                                 MQTT_CLIENT_MsgCallback_t MsgCallbackFunc)
+{
+   
+   MqttClient->Client.defaultMessageHandler = MsgCallbackFunc;
+
+   return SendTopicList(SUBSCRIBE, Topic, TopicCnt, Qos);
+   
+} /* End MQTT_CLIENT_SubscribeList() */
+
+
+/******************************************************************************
+** Function: MQTT_CLIENT_UnsubscribeList
+**
+*/
+uint16 MQTT_CLIENT_UnsubscribeList(const char *Topic[], uint16 TopicCnt)
+{
+   
+   return SendTopicList(UNSUBSCRIBE, Topic, TopicCnt, 0);
+   
+} /* End MQTT_CLIENT_UnsubscribeList() */
+
+
 
 /******************************************************************************
 ** Function: MQTT_CLIENT_Yield
 **
 ** Notes:
 **    1. If yield fails, enforce a timeout to avoid CPU hogging
+**    2. The socket is polled without the mutex. The MQTT library's yield
+**       runs after data arrives or YieldTime passes so it also sends keep
+**       alive pings. Without received data the library only makes one
+**       pass so the mutex is held briefly.
 **
 */
 bool MQTT_CLIENT_Yield(uint32 YieldTime)
 {
    
    bool RetStatus = false;
+   int  YieldStatus;
+   int  SliceTime;
+   struct pollfd Socket;
 
    if (MqttClient->Connected)
    {
       
+      Socket.fd      = MqttClient->Network.my_socket;
+      Socket.events  = POLLIN;
+      Socket.revents = 0;
+      SliceTime = (poll(&Socket, 1, YieldTime) > 0) ? MQTT_CLIENT_YIELD_SLICE_MS : 0;
+      
+      OS_MutSemTake(MqttClient->Mutex);
+      YieldStatus = MQTTYield(&MqttClient->Client, SliceTime);
+      OS_MutSemGive(MqttClient->Mutex);
+      
       /* Return code doesn't have additional information, only returns SUCCESS/FAILURE */ 
-      if (MQTTYield(&MqttClient->Client, YieldTime) == SUCCESS)
+      if (YieldStatus == SUCCESS)
       {
          RetStatus = true;
       }
@@ -278,3 +439,386 @@ bool MQTT_CLIENT_Yield(uint32 YieldTime)
 } /* End MQTT_CLIENT_Yield() */
 
 
+/******************************************************************************
+** Function: ProcessPacket
+**
+** Process a packet that was read while waiting for topic list
+** acknowledgements the way the MQTT library's yield processes it.
+**
+** Notes:
+**   1. PUBLISH messages go to the MQTT library's default message handler
+**      which is the topic list callback.
+**
+*/
+static void ProcessPacket(int Len)
+{
+
+   unsigned char  *Buf = MqttClient->ReadBuf;
+   unsigned char  Ack[MQTT_CLIENT_FIXED_HDR_MAX_LEN + MQTT_CLIENT_PACKET_ID_LEN];
+   unsigned char  AckType;
+   unsigned char  Dup;
+   unsigned char  Retained;
+   unsigned short PacketId;
+   int            Qos;
+   int            PayloadLen;
+   int            AckLen = 0;
+   MQTTString     TopicName;
+   MQTTMessage    Msg;
+   MessageData    MsgData;
+
+   switch (Buf[0] >> 4)
+   {
+
+      case PUBLISH:
+         if (MQTTDeserialize_publish(&Dup, &Qos, &Retained, &PacketId, &TopicName,
+                                     (unsigned char **)&Msg.payload, &PayloadLen, Buf, Len) == 1)
+         {
+            Msg.payloadlen = PayloadLen;
+            Msg.qos      = (enum QoS)Qos;
+            Msg.retained = Retained;
+            Msg.dup      = Dup;
+            Msg.id       = PacketId;
+
+            MsgData.message   = &Msg;
+            MsgData.topicName = &TopicName;
+
+            if (MqttClient->Client.defaultMessageHandler != NULL)
+            {
+               (MqttClient->Client.defaultMessageHandler)(&MsgData);
+            }
+            if (Qos == MQTT_CLIENT_QOS1)
+            {
+               AckLen = MQTTSerialize_ack(Ack, sizeof(Ack), PUBACK, 0, PacketId);
+            }
+            else if (Qos == MQTT_CLIENT_QOS2)
+            {
+               AckLen = MQTTSerialize_ack(Ack, sizeof(Ack), PUBREC, 0, PacketId);
+            }
+         }
+         break;
+
+      case PUBREL:
+         if (MQTTDeserialize_ack(&AckType, &Dup, &PacketId, Buf, Len) == 1)
+         {
+            AckLen = MQTTSerialize_ack(Ack, sizeof(Ack), PUBCOMP, 0, PacketId);
+         }
+         break;
+
+      case PINGRESP:
+         MqttClient->Client.ping_outstanding = 0;
+         break;
+
+      default:
+         break;
+
+   } /* End packet switch */
+
+   if (AckLen > 0)
+   {
+      MqttClient->Network.mqttwrite(&MqttClient->Network, Ack, AckLen, MQTT_CLIENT_TIMEOUT_MS);
+   }
+
+} /* End ProcessPacket() */
+
+
+/******************************************************************************
+** Function: ReadListAcks
+**
+** Read the acknowledgements of the topic list packets in ListPacket[] and
+** return the number of topics the broker accepted.
+**
+** Notes:
+**   1. Called with the client mutex held. Other packets that arrive before
+**      the acknowledgements are processed by ProcessPacket().
+**   2. A SUBACK return code of MQTT_CLIENT_SUBACK_FAILURE is a refused
+**      topic filter. One event is sent for each SUBACK with refusals.
+**      UNSUBACKs don't have return codes.
+**   3. Reading stops when every packet is acknowledged, the client timeout
+**      expires, or a read fails. Topics of unacknowledged packets aren't
+**      counted.
+**
+*/
+static uint16 ReadListAcks(uint8 PacketType, const char *Topic[])
+{
+
+   uint16  AcceptCnt = 0;
+   uint16  AckCnt    = 0;
+   uint16  i;
+   uint16  f;
+   uint16  RefusedCnt;
+   uint16  FirstRefused = 0;
+   int     Len = 0;
+   int     GrantedCnt;
+   unsigned char   AckType = (PacketType == SUBSCRIBE) ? SUBACK : UNSUBACK;
+   unsigned short  PacketId;
+   MQTT_CLIENT_ListPacket_t *Packet;
+   Timer   AckTimer;
+
+   TimerInit(&AckTimer);
+   TimerCountdownMS(&AckTimer, MQTT_CLIENT_TIMEOUT_MS);
+
+   while (Len >= 0 && AckCnt < MqttClient->ListPacketCnt && !TimerIsExpired(&AckTimer))
+   {
+
+      Len = ReadPacket(&AckTimer);
+      if (Len > 0 && (MqttClient->ReadBuf[0] >> 4) == AckType)
+      {
+
+         GrantedCnt = 0;
+         if (AckType == SUBACK)
+         {
+            if (MQTTDeserialize_suback(&PacketId, MQTT_CLIENT_MAX_PACKET_TOPICS, &GrantedCnt,
+                                       MqttClient->ListGrantedQos, MqttClient->ReadBuf, Len) != 1)
+            {
+               continue;
+            }
+         }
+         else if (MQTTDeserialize_unsuback(&PacketId, MqttClient->ReadBuf, Len) != 1)
+         {
+            continue;
+         }
+
+         for (i=0; i < MqttClient->ListPacketCnt; i++)
+         {
+
+            Packet = &MqttClient->ListPacket[i];
+            if (Packet->Acked || Packet->Id != PacketId)
+            {
+               continue;
+            }
+
+            Packet->Acked = true;
+            AckCnt++;
+            if (AckType == UNSUBACK)
+            {
+               AcceptCnt += Packet->FilterCnt;
+            }
+            else
+            {
+               RefusedCnt = 0;
+               for (f=0; f < Packet->FilterCnt && f < GrantedCnt; f++)
+               {
+                  if (MqttClient->ListGrantedQos[f] == MQTT_CLIENT_SUBACK_FAILURE)
+                  {
+                     if (RefusedCnt++ == 0)
+                     {
+                        FirstRefused = Packet->FirstTopic + f;
+                     }
+                  }
+                  else
+                  {
+                     AcceptCnt++;
+                  }
+               }
+               if (RefusedCnt > 0)
+               {
+                  MqttClient->SubRefusedCnt += RefusedCnt;
+                  CFE_EVS_SendEvent(MQTT_CLIENT_SUBSCRIBE_ERR_EID, CFE_EVS_EventType_ERROR, 
+                                    "Broker refused %d of %d topic subscriptions starting with %s",
+                                    RefusedCnt, Packet->FilterCnt, Topic[FirstRefused]);
+               }
+            }
+            break;
+
+         } /* End packet loop */
+
+      }
+      else if (Len > 0)
+      {
+         ProcessPacket(Len);
+      }
+
+   } /* End read loop */
+
+   if (AckCnt < MqttClient->ListPacketCnt)
+   {
+      CFE_EVS_SendEvent(MQTT_CLIENT_SUBSCRIBE_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "%d of %d MQTT %s packets were not acknowledged",
+                        MqttClient->ListPacketCnt - AckCnt, MqttClient->ListPacketCnt,
+                        (PacketType == SUBSCRIBE) ? "SUBSCRIBE" : "UNSUBSCRIBE");
+   }
+
+   return AcceptCnt;
+
+} /* End ReadListAcks() */
+
+
+/******************************************************************************
+** Function: ReadPacket
+**
+** Read one MQTT packet into the read buffer and return its length, 0 if no
+** packet started before ReadTimer expired, or -1 if the read failed or the
+** packet doesn't fit in the read buffer.
+**
+** Notes:
+**   1. Follows the MQTT library's receive path. Once the packet's first byte
+**      is read the rest of the packet is read with the client timeout.
+**
+*/
+static int ReadPacket(Timer *ReadTimer)
+{
+
+   int      RetStatus = -1;
+   int      Len = 1;
+   int      RemainingLen = 0;
+   int      Multiplier = 1;
+   int      ReadLen;
+   Network *Net = &MqttClient->Network;
+   unsigned char *Buf = MqttClient->ReadBuf;
+
+   ReadLen = Net->mqttread(Net, Buf, 1, TimerLeftMS(ReadTimer));
+   if (ReadLen == 0)
+   {
+      RetStatus = 0;
+   }
+   else if (ReadLen == 1)
+   {
+
+      do
+      {
+         ReadLen = Net->mqttread(Net, &Buf[Len], 1, MQTT_CLIENT_TIMEOUT_MS);
+         if (ReadLen == 1)
+         {
+            RemainingLen += (Buf[Len] & 0x7F) * Multiplier;
+            Multiplier *= 128;
+            Len++;
+         }
+      } while (ReadLen == 1 && (Buf[Len-1] & 0x80) && Len <= 4);
+
+      if (ReadLen == 1 && !(Buf[Len-1] & 0x80) &&
+          (Len + RemainingLen) <= MQTT_CLIENT_READ_BUF_LEN &&
+          (RemainingLen == 0 ||
+           Net->mqttread(Net, &Buf[Len], RemainingLen, MQTT_CLIENT_TIMEOUT_MS) == RemainingLen))
+      {
+         RetStatus = Len + RemainingLen;
+      }
+
+   } /* End if first byte */
+
+   return RetStatus;
+
+} /* End ReadPacket() */
+
+
+/******************************************************************************
+** Function: SendTopicList
+**
+** Send SUBSCRIBE or UNSUBSCRIBE packets for a list of topics and return the
+** number of topics the broker accepted.
+**
+** Notes:
+**   1. Each packet holds as many topic filters as fit in the list buffer.
+**      A SUBSCRIBE filter has one more byte than an UNSUBSCRIBE filter for
+**      its requested QoS.
+**   2. Packets are written directly to the network so the MQTT library does
+**      not wait for each acknowledgement. The acknowledgements are read
+**      after the last packet is written because the library's receive path
+**      discards SUBACK and UNSUBACK packets.
+**   3. Topic list packet IDs are independent of the MQTT library's packet
+**      IDs. The client mutex is held for the whole list so the library
+**      doesn't send or read packets in between.
+*/
+static uint16 SendTopicList(uint8 PacketType, const char *Topic[], uint16 TopicCnt, int Qos)
+{
+
+   uint16  AcceptCnt = 0;
+   uint16  TopicIdx  = 0;
+   uint16  FilterCnt;
+   int     FilterLen;
+   int     RemainingLen;
+   int     PacketLen;
+   int     QosLen = (PacketType == SUBSCRIBE) ? 1 : 0;
+   MQTT_CLIENT_ListPacket_t *Packet;
+   
+   OS_MutSemTake(MqttClient->Mutex);
+   
+   MqttClient->ListPacketCnt = 0;
+   while (MqttClient->Connected && TopicIdx < TopicCnt &&
+          MqttClient->ListPacketCnt < MQTT_CLIENT_MAX_LIST_PACKETS)
+   {
+   
+      FilterCnt    = 0;
+      RemainingLen = MQTT_CLIENT_PACKET_ID_LEN;
+      while (TopicIdx < TopicCnt && FilterCnt < MQTT_CLIENT_MAX_PACKET_TOPICS)
+      {
+         
+         FilterLen = 2 + strlen(Topic[TopicIdx]) + QosLen;
+         if ((MQTT_CLIENT_FIXED_HDR_MAX_LEN + RemainingLen + FilterLen) > MQTT_CLIENT_SEND_BUF_LEN)
+         {
+            break;
+         }
+         
+         MqttClient->ListFilter[FilterCnt].cstring = (char *)Topic[TopicIdx];
+         MqttClient->ListFilter[FilterCnt].lenstring.len  = 0;
+         MqttClient->ListFilter[FilterCnt].lenstring.data = NULL;
+         MqttClient->ListQos[FilterCnt] = Qos;
+         RemainingLen += FilterLen;
+         FilterCnt++;
+         TopicIdx++;
+         
+      } /* End filter loop */
+      
+      if (FilterCnt == 0)
+      {
+         
+         CFE_EVS_SendEvent(MQTT_CLIENT_SUBSCRIBE_ERR_EID, CFE_EVS_EventType_ERROR, 
+                           "Topic %s exceeds the %d byte MQTT client send buffer",
+                           Topic[TopicIdx], MQTT_CLIENT_SEND_BUF_LEN);
+         TopicIdx++;
+      
+      }
+      else
+      {
+         
+         if (++MqttClient->ListPacketId == 0)
+         {
+            MqttClient->ListPacketId = 1;
+         }
+         
+         if (PacketType == SUBSCRIBE)
+         {
+            PacketLen = MQTTSerialize_subscribe(MqttClient->ListBuf, MQTT_CLIENT_SEND_BUF_LEN, 0,
+                                                MqttClient->ListPacketId, FilterCnt,
+                                                MqttClient->ListFilter, MqttClient->ListQos);
+         }
+         else
+         {
+            PacketLen = MQTTSerialize_unsubscribe(MqttClient->ListBuf, MQTT_CLIENT_SEND_BUF_LEN, 0,
+                                                  MqttClient->ListPacketId, FilterCnt,
+                                                  MqttClient->ListFilter);
+         }
+
+         if (PacketLen > 0 &&
+             MqttClient->Network.mqttwrite(&MqttClient->Network, MqttClient->ListBuf,
+                                           PacketLen, MQTT_CLIENT_TIMEOUT_MS) == PacketLen)
+         {
+            Packet = &MqttClient->ListPacket[MqttClient->ListPacketCnt++];
+            Packet->Id         = MqttClient->ListPacketId;
+            Packet->FirstTopic = TopicIdx - FilterCnt;
+            Packet->FilterCnt  = FilterCnt;
+            Packet->Acked      = false;
+            TRACE_RING_Write(TRACE_RING_MODULE_MQTT_CLIENT, TRACE_RING_LEVEL_DEBUG, MQTT_CLIENT_TOPIC_LIST_TID,
+                             PacketType, FilterCnt, MqttClient->ListFilter[0].cstring, MQTT_TOPIC_TBL_MAX_TOPIC_LEN);
+         }
+         else
+         {
+            CFE_EVS_SendEvent(MQTT_CLIENT_SUBSCRIBE_ERR_EID, CFE_EVS_EventType_ERROR, 
+                              "Error sending MQTT %s packet with %d topics starting with %s. Packet length %d",
+                              (PacketType == SUBSCRIBE) ? "SUBSCRIBE" : "UNSUBSCRIBE",
+                              FilterCnt, MqttClient->ListFilter[0].cstring, PacketLen);
+         }
+         
+      } /* End if FilterCnt > 0 */
+   
+   } /* End packet loop */
+   
+   if (MqttClient->ListPacketCnt > 0)
+   {
+      AcceptCnt = ReadListAcks(PacketType, Topic);
+   }
+   
+   OS_MutSemGive(MqttClient->Mutex);
+   
+   return AcceptCnt;
+
+} /* End SendTopicList() */
@@ -16,7 +16,23 @@
 **   Manage the MQTT client interface using the MQTT Library
 **
 ** Notes:
-**   None
+**   1. Loopback publishes are a stand-in for a broker that is used for
+**      performance benchmarks. A message is serialized into an MQTT PUBLISH
+**      packet, deserialized as if it had been received from a broker, and
+**      passed to the caller's callback. The network and the client's
+**      connection state are not used so loopback traffic never mixes with
+**      the gateway's broker traffic.
+**   2. Topic lists are subscribed and unsubscribed with as many topic
+**      filters per SUBSCRIBE/UNSUBSCRIBE packet as fit in the send buffer.
+**      The packets are written back to back and then their acknowledgements
+**      are read so a topic filter the broker refuses is counted. Received
+**      messages for every list subscription are routed to one callback so
+**      the MQTT library's message handler table isn't used.
+**   3. The MQTT library isn't built with MQTT_TASK so it doesn't serialize
+**      its callers. The main task publishes while the MQTT child task
+**      yields and sends topic lists so every function that uses the broker
+**      connection holds the client mutex. A yield waits for received data
+**      without the mutex so an idle yield doesn't delay publishes.
 **
 ** References:
 **   1. OpenSatKit Object-based Application Developer's Guide
@@ -24,7 +40,7 @@
 **
 */
 #ifndef _mqtt_client_
-#define _mqtt_client
+#define _mqtt_client_
 
 
 /*
@@ -32,6 +48,7 @@
 */
 
 #include "app_cfg.h"
+#include "trace_ring.h"
 
 
 /***********************/
@@ -47,10 +64,42 @@
 #define MQTT_CLIENT_CONSTRUCT_ERR_EID  (MQTT_CLIENT_BASE_EID + 1)
 #define MQTT_CLIENT_CONNECT_EID        (MQTT_CLIENT_BASE_EID + 2)
 #define MQTT_CLIENT_CONNECT_ERR_EID    (MQTT_CLIENT_BASE_EID + 3)
-#define MQTT_CLIENT_PUBLISH_EID        (MQTT_CLIENT_BASE_EID + 4)
+#define MQTT_CLIENT_SUBSCRIBE_ERR_EID  (MQTT_CLIENT_BASE_EID + 4)
 #define MQTT_CLIENT_PUBLISH_ERR_EID    (MQTT_CLIENT_BASE_EID + 5)
 #define MQTT_CLIENT_YIELD_ERR_EID      (MQTT_CLIENT_BASE_EID + 6)
 
+/*
+** Trace Point IDs
+*/
+
+#define MQTT_CLIENT_PUBLISH_TID    1  /* Param: Payload length. Text: Topic */
+#define MQTT_CLIENT_TOPIC_LIST_TID 2  /* Param: Packet type, topic filter count. Text: First topic */
+
+/*
+** SUBSCRIBE/UNSUBSCRIBE packet limits. A fixed header is at most 5 bytes
+** and the smallest topic filter is encoded in 4 bytes.
+*/
+
+#define MQTT_CLIENT_FIXED_HDR_MAX_LEN   5
+#define MQTT_CLIENT_PACKET_ID_LEN       2
+#define MQTT_CLIENT_MAX_PACKET_TOPICS   (MQTT_CLIENT_SEND_BUF_LEN/4)
+
+/*
+** A topic list has at most one topic per topic table entry plus the
+** LAST_VALUE request topic and each packet holds at least one topic.
+*/
+
+#define MQTT_CLIENT_MAX_LIST_PACKETS    (MQTT_TOPIC_TBL_MAX_TOPICS+1)
+#define MQTT_CLIENT_SUBACK_FAILURE      0x80
+
+/*
+** Time the MQTT library yield processes received packets once the socket
+** is readable. The client mutex is held for this time so it bounds how
+** long received traffic can delay a publish.
+*/
+
+#define MQTT_CLIENT_YIELD_SLICE_MS      10
+
 
 /**********************/
 /** Type Definitions **/
@@ -79,6 +128,22 @@ typedef MessageData MQTT_CLIENT_MsgData_t; /* Redefined tio isolate/contain mqtt
 
 typedef void (*MQTT_CLIENT_MsgCallback_t) (MQTT_CLIENT_MsgData_t *MsgData);
 
+/*
+** A SUBSCRIBE or UNSUBSCRIBE packet of a topic list waiting for its
+** acknowledgement
+*/
+
+typedef struct
+{
+
+   uint16  Id;
+   uint16  FirstTopic;   /* Index of the packet's first topic in the caller's list */
+   uint16  FilterCnt;
+   bool    Acked;
+
+} MQTT_CLIENT_ListPacket_t;
+
+
 /*
 ** Class Definition
 */
@@ -86,10 +151,25 @@ typedef void (*MQTT_CLIENT_MsgCallback_t) (MQTT_CLIENT_MsgData_t *MsgData);
 typedef struct
 {
 
-   bool    Connected;
+   bool       Connected;
+   uint32     ConnectCnt;    /* Each successful connect starts a new broker session */
+   uint32     SubRefusedCnt; /* Topic filters refused in SUBACKs */
+   osal_id_t  Mutex;         /* Serializes the MQTT library calls of the main and child tasks */
    
    MQTTMessage PubMsg;
    
+   /*
+   ** Topic list packets
+   */
+   
+   uint16         ListPacketId;
+   uint16         ListPacketCnt;
+   MQTTString     ListFilter[MQTT_CLIENT_MAX_PACKET_TOPICS];
+   int            ListQos[MQTT_CLIENT_MAX_PACKET_TOPICS];
+   int            ListGrantedQos[MQTT_CLIENT_MAX_PACKET_TOPICS];
+   unsigned char  ListBuf[MQTT_CLIENT_SEND_BUF_LEN];
+   MQTT_CLIENT_ListPacket_t  ListPacket[MQTT_CLIENT_MAX_LIST_PACKETS];
+   
    /*
    ** MQTT Library
    */
@@ -140,13 +220,54 @@ bool MQTT_CLIENT_Connect(const char *ClientName,
 void MQTT_CLIENT_Disconnect(void);
 
 
+/******************************************************************************
+** Function: MQTT_CLIENT_GetConnectCnt
+**
+** Return the number of successful broker connections.
+**
+** Notes:
+**    1. Sessions are clean so a change in the count means the broker has
+**       no subscriptions for the client.
+**
+*/
+uint32 MQTT_CLIENT_GetConnectCnt(void);
+
+
+/******************************************************************************
+** Function: MQTT_CLIENT_IsConnected
+**
+** Return true if the client is connected to a broker.
+**
+*/
+bool MQTT_CLIENT_IsConnected(void);
+
+
+/******************************************************************************
+** Function: MQTT_CLIENT_LoopbackPublish
+**
+** Pass a message through an MQTT PUBLISH packet without a broker.
+**
+** Notes:
+**    1. The packet is serialized into PacketBuf, deserialized, and passed to
+**       Callback before the function returns. Callback may be NULL in which
+**       case the message is discarded after it is deserialized.
+**    2. Only the caller's buffer is used so any task may call this with a
+**       buffer it owns.
+*/
+bool MQTT_CLIENT_LoopbackPublish(unsigned char *PacketBuf, uint16 PacketBufLen,
+                                 const char *Topic, const char *Payload,
+                                 MQTT_CLIENT_MsgCallback_t Callback);
+
+
 /******************************************************************************
 ** Function: MQTT_CLIENT_Publish
 **
 ** Notes:
 **    1. QOS needs to be converted to MQTT library constants
+**    2. A retained message replaces the broker's retained value for the
+**       topic and is sent to each new subscriber.
 */
-bool MQTT_CLIENT_Publish(const char *Topic, const char *Payload);
+bool MQTT_CLIENT_Publish(const char *Topic, const char *Payload, bool Retain);
 
 
 /******************************************************************************
@@ -168,12 +289,44 @@ bool MQTT_CLIENT_Subscribe(const char *Topic, int Qos,
                            MQTT_CLIENT_MsgCallback_t MsgCallbackFunc);
 
 
+/******************************************************************************
+** Function: MQTT_CLIENT_SubscribeList
+**
+** Subscribe to TopicCnt topics and return the number of topics the broker
+** accepted.
+**
+** Notes:
+**    1. Returns after the SUBACKs are read or the client timeout expires.
+**       A topic that is refused or not acknowledged isn't counted and
+**       refused topics send an error event.
+**    2. MsgCallbackFunc becomes the MQTT library's default message handler
+**       so it receives messages for all list subscriptions.
+**    3. The topic strings are only referenced during the call.
+*/
+uint16 MQTT_CLIENT_SubscribeList(const char *Topic[], uint16 TopicCnt, int Qos,
+                                 MQTT_CLIENT_MsgCallback_t MsgCallbackFunc);
+
+
+/******************************************************************************
+** Function: MQTT_CLIENT_UnsubscribeList
+**
+** Unsubscribe from TopicCnt topics and return the number of topics the
+** broker acknowledged.
+**
+** Notes:
+**    1. Returns after the UNSUBACKs are read or the client timeout expires.
+*/
+uint16 MQTT_CLIENT_UnsubscribeList(const char *Topic[], uint16 TopicCnt);
+
+
 /******************************************************************************
 ** Function: MQTT_CLIENT_Yield
 **
 ** Notes:
 **    1. A task delay will always occur regardless of MQTT interface behavior
 **       to avoid CPU hogging
+**    2. Waits up to YieldTime for received data and then lets the MQTT
+**       library process packets for up to MQTT_CLIENT_YIELD_SLICE_MS.
 **
 */
 bool MQTT_CLIENT_Yield(uint32 YieldTime);
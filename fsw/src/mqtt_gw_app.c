@@ -44,14 +44,21 @@
 #define  CMDMGR_OBJ      (&(MqttGw.CmdMgr))
 #define  TBLMGR_OBJ      (&(MqttGw.TblMgr))    
 #define  CHILDMGR_OBJ    (&(MqttGw.ChildMgr))
+#define  LOAD_GEN_CHILDMGR_OBJ (&(MqttGw.LoadGenChildMgr))
 #define  MQTT_MGR_OBJ    (&(MqttGw.MqttMgr))
+#define  TRACE_RING_OBJ  (&(MqttGw.TraceRing))
+#define  PERF_BENCH_OBJ  (&(MqttGw.MqttMgr.PerfBench))
+#define  LAST_VALUE_OBJ  (&(MqttGw.MqttMgr.LastValue))
+#define  LAT_PROBE_OBJ   (&(MqttGw.MqttMgr.LatProbe))
+#define  LOAD_GEN_OBJ    (&(MqttGw.LoadGen))
 
 /*******************************/
 /** Local Function Prototypes **/
 /*******************************/
 
 static int32 InitApp(void);
-static int32 ProcessCommands(void);
+static int32 ProcessSbMsgs(void);
+static void ReportMemBudget(void);
 static void SendHousekeepingPkt(void);
 
 
@@ -65,10 +72,20 @@ static void SendHousekeepingPkt(void);
 */
 DEFINE_ENUM(Config,APP_CONFIG)  
 
+/*
+** Errors that can occur on every message are filtered to prevent them from
+** flooding EVS. The reset command re-enables the filtered events.
+*/
 static CFE_EVS_BinFilter_t  EventFilters[] =
 {  
-   /* Event ID                 Mask */
-   {MQTT_CLIENT_YIELD_ERR_EID, CFE_EVS_FIRST_4_STOP}
+   /* Event ID                             Mask */
+   {MQTT_CLIENT_YIELD_ERR_EID,             CFE_EVS_FIRST_4_STOP},
+   {MQTT_CLIENT_PUBLISH_ERR_EID,           CFE_EVS_FIRST_8_STOP},
+   {MSG_TRANS_PROCESS_MQTT_MSG_EID,        CFE_EVS_FIRST_8_STOP},
+   {MSG_TRANS_PROCESS_SB_MSG_EID,          CFE_EVS_FIRST_8_STOP},
+   {MQTT_TOPIC_RATE_JSON_TO_CCSDS_ERR_EID, CFE_EVS_FIRST_8_STOP},
+   {LAST_VALUE_PUBLISH_EID,                CFE_EVS_FIRST_8_STOP},
+   {MSG_TRANS_DEMUX_ERR_EID,               CFE_EVS_FIRST_8_STOP}
 
 };
 
@@ -102,19 +119,13 @@ void MQTT_GW_AppMain(void)
    while (CFE_ES_RunLoop(&RunStatus))
    {
       
-      /*
-      ** Since the app is data driven MQTT_MGR_Execute() pends on SB for topic messages
-      ** and the command pipe is polled below at a lower rate
-      */ 
-      MQTT_MGR_Execute(MqttGw.PerfId);
-      if (++MqttGw.PollCmdCnt > MqttGw.PollCmdInterval)
-      {
-          MqttGw.PollCmdCnt = 0;
-          RunStatus = ProcessCommands();
-      } 
+      RunStatus = ProcessSbMsgs();
       
    } /* End CFE_ES_RunLoop */
 
+   /* The next instance warm starts from the final values */
+   LAST_VALUE_Save();
+
    CFE_ES_WriteToSysLog("MQTT Gateway App terminating, run status = 0x%08X\n", RunStatus);   /* Use SysLog, events may not be working */
 
    CFE_EVS_SendEvent(MQTT_GW_EXIT_EID, CFE_EVS_EventType_CRITICAL, "MQTT Gateway App terminating, run status = 0x%08X", RunStatus);
@@ -155,8 +166,12 @@ bool MQTT_GW_ResetAppCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
    CMDMGR_ResetStatus(CMDMGR_OBJ);
    TBLMGR_ResetStatus(TBLMGR_OBJ);
    CHILDMGR_ResetStatus(CHILDMGR_OBJ);
+   CHILDMGR_ResetStatus(LOAD_GEN_CHILDMGR_OBJ);
    
    MQTT_MGR_ResetStatus();
+   LOAD_GEN_ResetStatus();
+   
+   CFE_EVS_ResetAllFilters();
 	  
    return true;
 
@@ -182,9 +197,6 @@ static int32 InitApp(void)
    if (INITBL_Constructor(INITBL_OBJ, MQTT_GW_INI_FILENAME, &IniCfgEnum))
    {
    
-      /* Pool for a command every 2 seconds */
-      MqttGw.PollCmdInterval = 2000 / INITBL_GetIntConfig(INITBL_OBJ, CFG_TOPIC_PIPE_PEND_TIME);
-      MqttGw.PollCmdCnt = 0;
       MqttGw.PerfId  = INITBL_GetIntConfig(INITBL_OBJ, CFG_APP_MAIN_PERF_ID);
       CFE_ES_PerfLogEntry(MqttGw.PerfId);
 
@@ -198,6 +210,7 @@ static int32 InitApp(void)
    if (RetStatus == CFE_SUCCESS)
    {
 
+      TRACE_RING_Constructor(TRACE_RING_OBJ, INITBL_OBJ);
       TBLMGR_Constructor(TBLMGR_OBJ);
       MQTT_MGR_Constructor(MQTT_MGR_OBJ, INITBL_OBJ, TBLMGR_OBJ);
 
@@ -210,13 +223,25 @@ static int32 InitApp(void)
       RetStatus = CHILDMGR_Constructor(CHILDMGR_OBJ, ChildMgr_TaskMainCallback,
                                        MQTT_MGR_ChildTaskCallback, &ChildTaskInit); 
 
+      if (RetStatus == CFE_SUCCESS)
+      {
+         LOAD_GEN_Constructor(LOAD_GEN_OBJ, INITBL_OBJ);
+
+         ChildTaskInit.TaskName  = INITBL_GetStrConfig(INITBL_OBJ, CFG_LOAD_GEN_CHILD_NAME);
+         ChildTaskInit.StackSize = INITBL_GetIntConfig(INITBL_OBJ, CFG_LOAD_GEN_CHILD_STACK_SIZE);
+         ChildTaskInit.Priority  = INITBL_GetIntConfig(INITBL_OBJ, CFG_LOAD_GEN_CHILD_PRIORITY);
+         ChildTaskInit.PerfId    = INITBL_GetIntConfig(INITBL_OBJ, CFG_LOAD_GEN_CHILD_PERF_ID);
+         RetStatus = CHILDMGR_Constructor(LOAD_GEN_CHILDMGR_OBJ, ChildMgr_TaskMainCallback,
+                                          LOAD_GEN_ChildTask, &ChildTaskInit);
+      }
+
       /*
       ** Initialize app level interfaces
       */
  
-      CFE_SB_CreatePipe(&MqttGw.CmdPipe, INITBL_GetIntConfig(INITBL_OBJ, CFG_CMD_PIPE_DEPTH), INITBL_GetStrConfig(INITBL_OBJ, CFG_CMD_PIPE_NAME));  
-      CFE_SB_Subscribe(MqttGw.CmdMid,    MqttGw.CmdPipe);
-      CFE_SB_Subscribe(MqttGw.SendHkMid, MqttGw.CmdPipe);
+      /* Commands share MQTT_MGR's topic pipe so the main task has one wake source */
+      CFE_SB_Subscribe(MqttGw.CmdMid,    MqttGw.MqttMgr.TopicPipe);
+      CFE_SB_Subscribe(MqttGw.SendHkMid, MqttGw.MqttMgr.TopicPipe);
 
       CMDMGR_Constructor(CMDMGR_OBJ);
       CMDMGR_RegisterFunc(CMDMGR_OBJ, MQTT_GW_NOOP_CC,   NULL, MQTT_GW_NoOpCmd,     0);
@@ -226,10 +251,26 @@ static int32 InitApp(void)
       CMDMGR_RegisterFunc(CMDMGR_OBJ, MQTT_GW_DUMP_TBL_CC, TBLMGR_OBJ, TBLMGR_DumpTblCmd, TBLMGR_DUMP_TBL_CMD_DATA_LEN);
  
       CMDMGR_RegisterFunc(CMDMGR_OBJ, MQTT_GW_CONNECT_TO_MQTT_BROKER_CC, MQTT_MGR_OBJ, MQTT_MGR_ConnectToMqttBrokerCmd, sizeof(MQTT_GW_ConnectToMqttBroker_Payload_t));
-      CMDMGR_RegisterFunc(CMDMGR_OBJ, MQTT_GW_CONFIG_SB_TOPIC_TEST_CC,   MQTT_MGR_OBJ, MQTT_MGR_ConfigSbTopicTestCmd,   sizeof(MQTT_GW_ConfigSbTopicTest_Payload_t));
+
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, MQTT_GW_START_LOAD_GEN_CC, LOAD_GEN_OBJ, LOAD_GEN_StartCmd, sizeof(MQTT_GW_StartLoadGen_Payload_t));
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, MQTT_GW_STOP_LOAD_GEN_CC,  LOAD_GEN_OBJ, LOAD_GEN_StopCmd,  0);
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, MQTT_GW_START_MQTT_LOAD_GEN_CC, LOAD_GEN_OBJ, LOAD_GEN_StartMqttCmd, sizeof(MQTT_GW_StartMqttLoadGen_Payload_t));
+
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, MQTT_GW_CONFIG_TRACE_CC, TRACE_RING_OBJ, TRACE_RING_ConfigCmd, sizeof(MQTT_GW_ConfigTrace_Payload_t));
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, MQTT_GW_DUMP_TRACE_CC,   TRACE_RING_OBJ, TRACE_RING_DumpCmd,   sizeof(MQTT_GW_DumpTrace_Payload_t));
+
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, MQTT_GW_RUN_PERF_BENCH_CC,  PERF_BENCH_OBJ, PERF_BENCH_RunCmd,      sizeof(MQTT_GW_RunPerfBench_Payload_t));
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, MQTT_GW_RUN_CODEC_BENCH_CC, PERF_BENCH_OBJ, PERF_BENCH_RunCodecCmd, sizeof(MQTT_GW_RunCodecBench_Payload_t));
+
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, MQTT_GW_PUBLISH_LAST_VALUES_CC, LAST_VALUE_OBJ, LAST_VALUE_PublishCmd, 0);
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, MQTT_GW_DUMP_LAST_VALUES_CC,    LAST_VALUE_OBJ, LAST_VALUE_DumpCmd,    sizeof(MQTT_GW_DumpLastValues_Payload_t));
+
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, MQTT_GW_SET_LAT_PROBE_CC, LAT_PROBE_OBJ, LAT_PROBE_SetPeriodCmd, sizeof(MQTT_GW_SetLatProbe_Payload_t));
          
       CFE_MSG_Init(CFE_MSG_PTR(MqttGw.HkTlm.TelemetryHeader), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(INITBL_OBJ, CFG_MQTT_GW_HK_TLM_TOPICID)), sizeof(MQTT_GW_HkTlm_t));
 
+      ReportMemBudget();
+
       /*
       ** Application startup event message
       */
@@ -245,11 +286,28 @@ static int32 InitApp(void)
 
 
 /******************************************************************************
-** Function: ProcessCommands
+** Function: ProcessSbMsgs
 **
+** Notes:
+**   1. Commands and topic messages are received from the same pipe and
+**      dispatched by message ID so each message is processed as soon as it
+**      arrives. Any message ID that isn't a command is a topic message.
+**   2. The pend timeout only bounds how long the loop waits when the SB is
+**      idle. It does not delay message processing.
+**   3. Each call is one RT_LOOP SB drain loop iteration. The pipe is polled
+**      while RT_LOOP says to spin and only a blocking pend is logged as a
+**      performance monitor exit.
+**   4. LAT_PROBE packets share the pipe with topic messages. A due probe is
+**      sent after each iteration's message. A last value request received
+**      by the MQTT child task is also serviced here so every MQTT publish
+**      is made by the main task. The de-duplication clock is advanced each
+**      iteration so it can't miss a MSG_STATS_GetTime() wrap.
+**   5. A gateway benchmark runs one batch per iteration before the pipe is
+**      read. The pipe is polled while the benchmark runs so commands and
+**      topic messages are still processed.
 ** 
 */
-static int32 ProcessCommands(void)
+static int32 ProcessSbMsgs(void)
 {
    
    int32  RetStatus = CFE_ES_RunStatus_APP_RUN;
@@ -257,14 +315,24 @@ static int32 ProcessCommands(void)
 
    CFE_SB_Buffer_t  *SbBufPtr;
    CFE_SB_MsgId_t   MsgId = CFE_SB_INVALID_MSG_ID;
+   bool             BenchRunning = PERF_BENCH_Execute();
 
 
-   CFE_ES_PerfLogExit(MqttGw.PerfId);
-   SysStatus = CFE_SB_ReceiveBuffer(&SbBufPtr, MqttGw.CmdPipe, CFE_SB_POLL);
-   CFE_ES_PerfLogEntry(MqttGw.PerfId);
+   if (RT_LOOP_Spin(RT_LOOP_SB_DRAIN) || BenchRunning)
+   {
+      SysStatus = CFE_SB_ReceiveBuffer(&SbBufPtr, MqttGw.MqttMgr.TopicPipe, CFE_SB_POLL);
+   }
+   else
+   {
+      CFE_ES_PerfLogExit(MqttGw.PerfId);
+      SysStatus = CFE_SB_ReceiveBuffer(&SbBufPtr, MqttGw.MqttMgr.TopicPipe, MqttGw.MqttMgr.SbPendTime);
+      CFE_ES_PerfLogEntry(MqttGw.PerfId);
+   }
 
    if (SysStatus == CFE_SUCCESS)
    {
+      RT_LOOP_Activity(RT_LOOP_SB_DRAIN);
+      
       SysStatus = CFE_MSG_GetMsgId(&SbBufPtr->Msg, &MsgId);
 
       if (SysStatus == CFE_SUCCESS)
@@ -278,26 +346,115 @@ static int32 ProcessCommands(void)
          {   
             SendHousekeepingPkt();
          }
+         else if (CFE_SB_MsgId_Equal(MsgId, MqttGw.MqttMgr.LatProbe.Mid))
+         {
+            LAT_PROBE_ProcessSbMsg(&SbBufPtr->Msg);
+         }
          else
          {   
-            CFE_EVS_SendEvent(MQTT_GW_INVALID_MID_EID, CFE_EVS_EventType_ERROR,
-                              "Received invalid command packet, MID = 0x%08X", 
-                              CFE_SB_MsgIdToValue(MsgId));
+            MQTT_MGR_PublishSbMsg(&SbBufPtr->Msg);
          }
 
       } /* End if got message ID */
    } /* End if received buffer */
    else
    {
-      if (SysStatus != CFE_SB_NO_MESSAGE)
+      if (SysStatus != CFE_SB_TIME_OUT && SysStatus != CFE_SB_NO_MESSAGE)
       {
          RetStatus = CFE_ES_RunStatus_APP_ERROR;
       }
    } 
 
+   LAT_PROBE_Execute();
+   LAST_VALUE_ServiceRequest();
+   MSG_TRANS_UpdateDedupClock();
+
    return RetStatus;
    
-} /* End ProcessCommands() */
+} /* End ProcessSbMsgs() */
+
+
+/******************************************************************************
+** Function: ReportMemBudget
+**
+** Load the memory budget of each subsystem into the housekeeping packet and
+** report it in events.
+**
+** Notes:
+**   1. Static memory is the size of a subsystem's object which is part of the
+**      app's global data. The sizes follow the platform configuration's
+**      buffer sizes. A container object's static memory doesn't include the
+**      objects it contains.
+**   2. Dynamic memory is allocated by OSAL and the OS at startup: the child
+**      task stacks and the shared memory ring mapping. The app doesn't use
+**      heap memory so the budget doesn't change after initialization.
+**   3. The main task's stack and the SB pipe are allocated by cFE and aren't
+**      included.
+**
+*/
+static void ReportMemBudget(void)
+{
+
+   static const char *SubsysStr[MQTT_GW_MEM_SUBSYS_CNT] = 
+   {
+      "FRAMEWORK", "MQTT_MGR", "MQTT_CLIENT", "MSG_TRANS", "TOPIC_TBL",
+      "MSG_STATS", "DECODE_POOL", "LAST_VALUE", "SHM_RING", "LOCAL_BROKER",
+      "LAT_PROBE", "PERF_BENCH", "LOAD_GEN", "TRACE_RING"
+   };
+
+   MQTT_GW_HkTlm_Payload_t *Payload = &MqttGw.HkTlm.Payload;
+   MQTT_GW_MemBudget_t     *Budget  = Payload->MemBudget;
+   uint16 i;
+   
+   memset(Budget, 0, sizeof(Payload->MemBudget));
+   
+   Budget[MQTT_GW_MEM_MQTT_CLIENT].Static  = sizeof(MQTT_CLIENT_Class_t);
+   Budget[MQTT_GW_MEM_TOPIC_TBL].Static    = sizeof(MQTT_TOPIC_TBL_Class_t);
+   Budget[MQTT_GW_MEM_MSG_TRANS].Static    = sizeof(MSG_TRANS_Class_t) - sizeof(MQTT_TOPIC_TBL_Class_t);
+   Budget[MQTT_GW_MEM_MSG_STATS].Static    = sizeof(MSG_STATS_Class_t);
+   Budget[MQTT_GW_MEM_DECODE_POOL].Static  = sizeof(DECODE_POOL_Class_t);
+   Budget[MQTT_GW_MEM_LAST_VALUE].Static   = sizeof(LAST_VALUE_Class_t);
+   Budget[MQTT_GW_MEM_SHM_RING].Static     = sizeof(SHM_RING_Class_t);
+   Budget[MQTT_GW_MEM_LOCAL_BROKER].Static = sizeof(LOCAL_BROKER_Class_t);
+   Budget[MQTT_GW_MEM_LAT_PROBE].Static    = sizeof(LAT_PROBE_Class_t);
+   Budget[MQTT_GW_MEM_PERF_BENCH].Static   = sizeof(PERF_BENCH_Class_t);
+   Budget[MQTT_GW_MEM_LOAD_GEN].Static     = sizeof(LOAD_GEN_Class_t);
+   Budget[MQTT_GW_MEM_TRACE_RING].Static   = sizeof(TRACE_RING_Class_t);
+   
+   /* RT_LOOP is the MQTT manager's loop state so it is counted with it */
+   Budget[MQTT_GW_MEM_MQTT_MGR].Static = sizeof(MQTT_MGR_Class_t) - 
+      (sizeof(MQTT_CLIENT_Class_t) + sizeof(MSG_TRANS_Class_t)    + sizeof(MSG_STATS_Class_t) +
+       sizeof(PERF_BENCH_Class_t)  + sizeof(DECODE_POOL_Class_t)  + sizeof(LAST_VALUE_Class_t) +
+       sizeof(SHM_RING_Class_t)    + sizeof(LOCAL_BROKER_Class_t) + sizeof(LAT_PROBE_Class_t));
+   Budget[MQTT_GW_MEM_FRAMEWORK].Static = sizeof(MQTT_GW_Class_t) - 
+      (sizeof(TRACE_RING_Class_t) + sizeof(MQTT_MGR_Class_t) + sizeof(LOAD_GEN_Class_t));
+   
+   Budget[MQTT_GW_MEM_MQTT_MGR].Dynamic    = INITBL_GetIntConfig(INITBL_OBJ, CFG_CHILD_STACK_SIZE);
+   Budget[MQTT_GW_MEM_DECODE_POOL].Dynamic = MqttGw.MqttMgr.DecodePool.WorkerCnt *
+                                             INITBL_GetIntConfig(INITBL_OBJ, CFG_DECODE_POOL_CHILD_STACK_SIZE);
+   Budget[MQTT_GW_MEM_SHM_RING].Dynamic    = MqttGw.MqttMgr.ShmRing.MapLen;
+   Budget[MQTT_GW_MEM_LOAD_GEN].Dynamic    = INITBL_GetIntConfig(INITBL_OBJ, CFG_LOAD_GEN_CHILD_STACK_SIZE);
+   if (MqttGw.MqttMgr.LastValue.SaveChild)
+   {
+      Budget[MQTT_GW_MEM_LAST_VALUE].Dynamic = INITBL_GetIntConfig(INITBL_OBJ, CFG_LAST_VALUE_CHILD_STACK_SIZE);
+   }
+   
+   Payload->MemStaticTotal  = 0;
+   Payload->MemDynamicTotal = 0;
+   for (i=0; i < MQTT_GW_MEM_SUBSYS_CNT; i++)
+   {
+      Payload->MemStaticTotal  += Budget[i].Static;
+      Payload->MemDynamicTotal += Budget[i].Dynamic;
+      CFE_EVS_SendEvent(MQTT_GW_MEM_BUDGET_EID, CFE_EVS_EventType_INFORMATION,
+                        "Memory budget %s: Static %u, Dynamic %u bytes", SubsysStr[i],
+                        (unsigned int)Budget[i].Static, (unsigned int)Budget[i].Dynamic);
+   }
+   
+   CFE_EVS_SendEvent(MQTT_GW_MEM_BUDGET_EID, CFE_EVS_EventType_INFORMATION,
+                     "Memory budget total: Static %u, Dynamic %u bytes",
+                     (unsigned int)Payload->MemStaticTotal, (unsigned int)Payload->MemDynamicTotal);
+
+} /* End ReportMemBudget() */
 
 
 /******************************************************************************
@@ -335,17 +492,89 @@ void SendHousekeepingPkt(void)
    ** MQTT Data
    */
 
-   Payload->MqttYieldTime     = MqttGw.MqttMgr.MqttYieldTime;
-   Payload->SbPendTime        = MqttGw.MqttMgr.SbPendTime;
-   Payload->SbTopicTestActive = MqttGw.MqttMgr.SbTopicTestActive;
-   Payload->SbTopicTestId     = MqttGw.MqttMgr.SbTopicTestId;
-   Payload->SbTopicTestParam  = MqttGw.MqttMgr.SbTopicTestParam;
-
+   Payload->MqttYieldTime = MqttGw.MqttMgr.MqttYieldTime;
+   Payload->SbPendTime    = MqttGw.MqttMgr.SbPendTime;
    Payload->MqttConnected = MqttGw.MqttMgr.MqttClient.Connected;
 
+   Payload->DecodeWorkerCnt    = MqttGw.MqttMgr.DecodePool.WorkerCnt;
+   Payload->DecodeQueueMax     = DECODE_POOL_GetMaxDepth();
+   Payload->DecodeQueueDropCnt = DECODE_POOL_GetDropCnt();
+   Payload->DecodeStaleCnt     = DECODE_POOL_GetStaleCnt();
+   Payload->DedupSuppressCnt   = MqttGw.MqttMgr.MsgTrans.DedupSuppressCnt;
+   Payload->MuxTopicCnt        = MQTT_TOPIC_TBL_GetMuxCnt();
+   Payload->DemuxErrCnt        = MqttGw.MqttMgr.MsgTrans.DemuxErrCnt;
+
+   /*
+   ** Real-time Loops
+   */
+
+   Payload->BusyPoll = MqttGw.MqttMgr.RtLoop.BusyPoll;
+   RT_LOOP_GetPeriod(RT_LOOP_MQTT_IO, &Payload->MqttLoopMinPeriod,
+                     &Payload->MqttLoopAvgPeriod, &Payload->MqttLoopMaxPeriod);
+   RT_LOOP_GetPeriod(RT_LOOP_SB_DRAIN, &Payload->SbLoopMinPeriod,
+                     &Payload->SbLoopAvgPeriod, &Payload->SbLoopMaxPeriod);
+
+   /*
+   ** Last Value Cache
+   */
+
+   Payload->LastValueTopicCnt = LAST_VALUE_GetTopicCnt();
+   Payload->LastValueSkipCnt  = MqttGw.MqttMgr.LastValue.SkipCnt;
+   Payload->LastValueSaveCnt  = MqttGw.MqttMgr.LastValue.SaveCnt;
+   Payload->LastValueWarmStartCnt = MqttGw.MqttMgr.LastValue.WarmStartCnt;
+   Payload->MqttRetainedRcvCnt    = MqttGw.MqttMgr.RetainedRcvCnt;
+   Payload->MqttSubRefusedCnt     = MqttGw.MqttMgr.MqttClient.SubRefusedCnt;
+
+   /*
+   ** Shared Memory Ring
+   */
+
+   Payload->ShmRingWriteCnt = MqttGw.MqttMgr.ShmRing.WriteCnt;
+   Payload->ShmRingSkipCnt  = MqttGw.MqttMgr.ShmRing.SkipCnt;
+
+   /*
+   ** Local Broker
+   */
+
+   Payload->LocalBrokerClientCnt = MqttGw.MqttMgr.LocalBroker.ClientCnt;
+   Payload->LocalBrokerRcvCnt    = MqttGw.MqttMgr.LocalBroker.RcvCnt;
+   Payload->LocalBrokerSendCnt   = MqttGw.MqttMgr.LocalBroker.SendCnt;
+   Payload->LocalBrokerDropCnt   = MqttGw.MqttMgr.LocalBroker.DropCnt;
+
+   /*
+   ** Latency Probe
+   */
+
+   Payload->LatProbePeriod  = MqttGw.MqttMgr.LatProbe.Period;
+   Payload->LatProbeSentCnt = MqttGw.MqttMgr.LatProbe.SentCnt;
+   Payload->LatProbeRcvCnt  = MqttGw.MqttMgr.LatProbe.RcvCnt;
+   Payload->LatProbeLostCnt = MqttGw.MqttMgr.LatProbe.LostCnt;
+   LAT_PROBE_GetStage(LAT_PROBE_STAGE_TOTAL,    &Payload->LatProbeTotal);
+   LAT_PROBE_GetStage(LAT_PROBE_STAGE_BROKER,   &Payload->LatProbeBroker);
+   LAT_PROBE_GetStage(LAT_PROBE_STAGE_INTERNAL, &Payload->LatProbeInternal);
+
+   /* The memory budget is loaded once by ReportMemBudget() */
+
+   /*
+   ** Load Generator
+   */
+
+   Payload->LoadGenActive       = MqttGw.LoadGen.Active;
+   Payload->LoadGenTarget       = MqttGw.LoadGen.Target;
+   Payload->LoadGenTopicId      = MqttGw.LoadGen.TopicId;
+   Payload->LoadGenReqRate      = MqttGw.LoadGen.MsgRate;
+   Payload->LoadGenAchievedRate = MqttGw.LoadGen.AchievedRate;
+   Payload->LoadGenSentCnt      = MqttGw.LoadGen.SentCnt;
+   Payload->LoadGenErrCnt       = MqttGw.LoadGen.TransmitErrCnt + MqttGw.LoadGen.DecodeErrCnt;
+   Payload->LoadGenNsPerMsg     = MqttGw.LoadGen.NsPerMsg;
+
 
    CFE_SB_TimeStampMsg(CFE_MSG_PTR(MqttGw.HkTlm.TelemetryHeader));
    CFE_SB_TransmitMsg(CFE_MSG_PTR(MqttGw.HkTlm.TelemetryHeader), true);
 
+   /* Statistics telemetry and last value saves run at a multiple of the housekeeping period */
+   MSG_STATS_SendTlm();
+   LAST_VALUE_PeriodicSave();
+
 } /* End SendHousekeepingPkt() */
 
@@ -36,7 +36,9 @@
 */
 
 #include "app_cfg.h"
+#include "load_gen.h"
 #include "mqtt_mgr.h"
+#include "trace_ring.h"
 
 /***********************/
 /** Macro Definitions **/
@@ -50,6 +52,7 @@
 #define MQTT_GW_NOOP_EID          (MQTT_GW_BASE_EID + 1)
 #define MQTT_GW_EXIT_EID          (MQTT_GW_BASE_EID + 2)
 #define MQTT_GW_INVALID_MID_EID   (MQTT_GW_BASE_EID + 3)
+#define MQTT_GW_MEM_BUDGET_EID    (MQTT_GW_BASE_EID + 4)
 
 
 /**********************/
@@ -57,6 +60,35 @@
 /**********************/
 
 
+/******************************************************************************
+** Memory budget subsystems
+**
+** Indices of the housekeeping MemBudget array. Must match the EDS MemSubsys
+** enumeration and MQTT_GW_MEM_SUBSYS_CNT must match MEM_BUDGET_CNT.
+*/
+
+typedef enum
+{
+
+   MQTT_GW_MEM_FRAMEWORK    =  0,
+   MQTT_GW_MEM_MQTT_MGR     =  1,
+   MQTT_GW_MEM_MQTT_CLIENT  =  2,
+   MQTT_GW_MEM_MSG_TRANS    =  3,
+   MQTT_GW_MEM_TOPIC_TBL    =  4,
+   MQTT_GW_MEM_MSG_STATS    =  5,
+   MQTT_GW_MEM_DECODE_POOL  =  6,
+   MQTT_GW_MEM_LAST_VALUE   =  7,
+   MQTT_GW_MEM_SHM_RING     =  8,
+   MQTT_GW_MEM_LOCAL_BROKER =  9,
+   MQTT_GW_MEM_LAT_PROBE    = 10,
+   MQTT_GW_MEM_PERF_BENCH   = 11,
+   MQTT_GW_MEM_LOAD_GEN     = 12,
+   MQTT_GW_MEM_TRACE_RING   = 13,
+   MQTT_GW_MEM_SUBSYS_CNT   = 14
+
+} MQTT_GW_MemSubsys_t;
+
+
 /******************************************************************************
 ** Command Packets
 */
@@ -78,10 +110,10 @@ typedef struct
    */ 
 
    INITBL_Class_t    IniTbl; 
-   CFE_SB_PipeId_t   CmdPipe;
    CMDMGR_Class_t    CmdMgr;
    TBLMGR_Class_t    TblMgr;
    CHILDMGR_Class_t  ChildMgr;
+   CHILDMGR_Class_t  LoadGenChildMgr;
       
    /*
    ** Telemetry Packets
@@ -94,15 +126,14 @@ typedef struct
    ** OSK_C_DEMO State & Contained Objects
    */ 
    
-   uint32 PollCmdInterval;
-   uint32 PollCmdCnt;
    uint32 PerfId;
    
    CFE_SB_MsgId_t  CmdMid;
-   CFE_SB_MsgId_t  ExecuteMid;
    CFE_SB_MsgId_t  SendHkMid;
        
-   MQTT_MGR_Class_t  MqttMgr;
+   TRACE_RING_Class_t  TraceRing;
+   MQTT_MGR_Class_t    MqttMgr;
+   LOAD_GEN_Class_t    LoadGen;
  
 } MQTT_GW_Class_t;
 
@@ -36,8 +36,11 @@
 /** Local Function Prototypes **/
 /*******************************/
 
-static void ProcessSbTopicMsgs(uint32 PerfId);
-static void SubscribeToMessages(uint32 TopicBaseMid);
+static bool MqttTopic(const MQTT_TOPIC_TBL_Data_t *Tbl, uint16 Idx);
+static void ProcessMqttMsg(MessageData* MsgData);
+static bool SbTopic(const MQTT_TOPIC_TBL_Data_t *Tbl, uint16 Idx);
+static void UpdateMqttSubscriptions(const MQTT_TOPIC_TBL_Data_t *OldTbl, const MQTT_TOPIC_TBL_Data_t *NewTbl);
+static void UpdateSbSubscriptions(const MQTT_TOPIC_TBL_Data_t *OldTbl, const MQTT_TOPIC_TBL_Data_t *NewTbl);
 
 
 /*****************/
@@ -65,87 +68,109 @@ void MQTT_MGR_Constructor(MQTT_MGR_Class_t *MqttMgrPtr,
    memset(MqttMgr, 0, sizeof( MQTT_MGR_Class_t));
    
    MqttMgr->IniTbl = IniTbl;
+   
+   RT_LOOP_Constructor(&MqttMgr->RtLoop, IniTbl);
+   LAST_VALUE_Constructor(&MqttMgr->LastValue, IniTbl);
+   
    MqttMgr->MqttYieldTime = INITBL_GetIntConfig(IniTbl, CFG_MQTT_CLIENT_YIELD_TIME);
    MqttMgr->SbPendTime    = INITBL_GetIntConfig(IniTbl, CFG_TOPIC_PIPE_PEND_TIME);
+   MqttMgr->SubscribeQos  = INITBL_GetIntConfig(IniTbl, CFG_MQTT_CLIENT_SUB_QOS);
+   
+   if (MqttMgr->SubscribeQos > MQTT_CLIENT_QOS2)
+   {
+      CFE_EVS_SendEvent(MQTT_MGR_CONSTRUCT_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "Invalid MQTT subscription QoS %d, using QoS %d",
+                        MqttMgr->SubscribeQos, MQTT_CLIENT_QOS2);
+      MqttMgr->SubscribeQos = MQTT_CLIENT_QOS2;
+   }
    
    CFE_SB_CreatePipe(&MqttMgr->TopicPipe, INITBL_GetIntConfig(IniTbl, CFG_TOPIC_PIPE_DEPTH),
                      INITBL_GetStrConfig(IniTbl, CFG_TOPIC_PIPE_NAME));
    
+   MSG_STATS_Constructor(&MqttMgr->MsgStats, IniTbl);
+
    MQTT_CLIENT_Constructor(&MqttMgr->MqttClient, IniTbl);
 
    MSG_TRANS_Constructor(&MqttMgr->MsgTrans, IniTbl, TblMgr);
 
-   SubscribeToMessages(INITBL_GetIntConfig(IniTbl, CFG_MQTT_GW_TOPIC_1_TLM_TOPICID));
-      
-} /* End MQTT_MGR_Constructor() */
+   PERF_BENCH_Constructor(&MqttMgr->PerfBench);
 
+   DECODE_POOL_Constructor(&MqttMgr->DecodePool, IniTbl);
 
+   SHM_RING_Constructor(&MqttMgr->ShmRing, IniTbl);
 
-/******************************************************************************
-** Function: MQTT_MGR_ChildTaskCallback
-**
-*/
-bool MQTT_MGR_ChildTaskCallback(CHILDMGR_Class_t *ChildMgr)
-{
+   LOCAL_BROKER_Constructor(&MqttMgr->LocalBroker, IniTbl, ProcessMqttMsg);
 
-   MQTT_CLIENT_Yield(MqttMgr->MqttYieldTime);
+   LAT_PROBE_Constructor(&MqttMgr->LatProbe, IniTbl, MqttMgr->TopicPipe);
 
-   return true;
+   /* MQTT subscriptions are made by the child task once it sees a broker session */
+   MqttMgr->SubscribedTbl = MQTT_TOPIC_TBL_GetData();
+   UpdateSbSubscriptions(NULL, MqttMgr->SubscribedTbl);
    
-} /* End MQTT_MGR_ChildTaskCallback() */
+   LAST_VALUE_WarmStart();
+      
+} /* End MQTT_MGR_Constructor() */
+
 
 
 /******************************************************************************
-** Function: MQTT_MGR_ConfigSbTopicTestCmd
+** Function: MQTT_MGR_ChildTaskCallback
 **
 ** Notes:
-**   None
+**   1. Each call is a topic table quiescent point. Subscriptions are moved
+**      to a new table snapshot before the quiescent point is reported.
+**   2. A change in the MQTT_CLIENT connect count means a new clean broker
+**      session that has no subscriptions.
+**   3. Each call is one RT_LOOP MQTT I/O loop iteration.
+**   4. Local broker clients are serviced after each MQTT yield. Without a
+**      broker connection the yield would only delay so the local broker
+**      waits on its clients for the yield time instead.
+**
 */
-bool MQTT_MGR_ConfigSbTopicTestCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+bool MQTT_MGR_ChildTaskCallback(CHILDMGR_Class_t *ChildMgr)
 {
 
-   const MQTT_GW_ConfigSbTopicTest_Payload_t *ConfigSbTopicTestCmd = CMDMGR_PAYLOAD_PTR(MsgPtr, MQTT_GW_ConfigSbTopicTest_t);
-   bool RetStatus = false;
+   const MQTT_TOPIC_TBL_Data_t *TopicTbl = MQTT_TOPIC_TBL_GetData();
+   uint32 ConnectCnt = MQTT_CLIENT_GetConnectCnt();
+   bool   Spin = RT_LOOP_Spin(RT_LOOP_MQTT_IO);
+   uint32 YieldTime = Spin ? RT_LOOP_MQTT_SPIN_YIELD_MS : MqttMgr->MqttYieldTime;
 
-   if (MQTT_TOPIC_TBL_ValidId(ConfigSbTopicTestCmd->Id))
+   if (TopicTbl != MqttMgr->SubscribedTbl)
    {
-      if (ConfigSbTopicTestCmd->Action == 1)
-      {
-         MqttMgr->SbTopicTestId     = ConfigSbTopicTestCmd->Id;
-         MqttMgr->SbTopicTestParam  = ConfigSbTopicTestCmd->Param;
-         MqttMgr->SbTopicTestActive = true;
-         RetStatus = true;
-         CFE_EVS_SendEvent(MQTT_MGR_CONFIG_TEST_EID, CFE_EVS_EventType_INFORMATION, 
-                           "Started SB test for topic ID %d", ConfigSbTopicTestCmd->Id);
-         MQTT_TOPIC_TBL_RunSbMsgTest(MqttMgr->SbTopicTestId, true, ConfigSbTopicTestCmd->Param);
-      }
-      else if (ConfigSbTopicTestCmd->Action == 2)
+      UpdateSbSubscriptions(MqttMgr->SubscribedTbl, TopicTbl);
+      MqttMgr->SubscribedTbl = TopicTbl;
+   }
+   
+   if (ConnectCnt != MqttMgr->MqttConnectCnt)
+   {
+      MqttMgr->MqttSubscribedTbl = NULL;
+      MqttMgr->MqttConnectCnt = ConnectCnt;
+   }
+   
+   if (ConnectCnt > 0 && TopicTbl != MqttMgr->MqttSubscribedTbl)
+   {
+      UpdateMqttSubscriptions(MqttMgr->MqttSubscribedTbl, TopicTbl);
+      MqttMgr->MqttSubscribedTbl = TopicTbl;
+   }
+   MQTT_TOPIC_TBL_ReaderQuiescent(MQTT_TOPIC_TBL_READER_MQTT_CHILD);
+
+   /* A codec benchmark replaces the MQTT yield for the duration of its run */
+   if (!PERF_BENCH_ChildExecute())
+   {
+      if (MQTT_CLIENT_IsConnected() || !LOCAL_BROKER_Enabled())
       {
-         MqttMgr->SbTopicTestId = ConfigSbTopicTestCmd->Id;
-         MqttMgr->SbTopicTestActive = false;
-         RetStatus = true;
-         CFE_EVS_SendEvent(MQTT_MGR_CONFIG_TEST_EID, CFE_EVS_EventType_INFORMATION, 
-                           "Stopped SB test for topic ID %d", ConfigSbTopicTestCmd->Id);
+         MQTT_CLIENT_Yield(YieldTime);
+         LOCAL_BROKER_Service(0);
       }
       else
       {
-         CFE_EVS_SendEvent(MQTT_MGR_CONFIG_TEST_ERR_EID, CFE_EVS_EventType_ERROR, 
-                           "Configured SB topic test command rejected. Invalid start/stop parameter %d", 
-                           ConfigSbTopicTestCmd->Action);
-      
+         LOCAL_BROKER_Service(YieldTime);
       }
    }
-   else
-   {
-      CFE_EVS_SendEvent(MQTT_MGR_CONFIG_TEST_ERR_EID, CFE_EVS_EventType_ERROR, 
-                        "Configured SB topic test command rejected. Id %d either invalid or not loaded", 
-                        ConfigSbTopicTestCmd->Id);
 
-   }
-  
-   return RetStatus;
+   return true;
    
-} /* End MQTT_MGR_ConfigSbTopicTest() */
+} /* End MQTT_MGR_ChildTaskCallback() */
 
 
 /******************************************************************************
@@ -196,22 +221,66 @@ bool MQTT_MGR_ConnectToMqttBrokerCmd(void* DataObjPtr, const CFE_MSG_Message_t *
 
 
 /******************************************************************************
-** Function: MQTT_MGR_Execute
-**
-** Perform management functions that need to be performed on a periodic basis.
+** Function: MQTT_MGR_PublishSbMsg
 **
+** Notes:
+**   1. MSG_TRANS_ProcessSbMsg() and MQTT_CLIENT_Publish() send error events
+**      so no need to send any events here.
+**   2. Latency is only recorded for successfully published messages
+**   3. The topic's table entry selects whether the broker retains the value
+**   4. A failed publish clears the topic's de-duplication state so the next
+**      message isn't suppressed as a duplicate of a message never published
+**   5. The encoded message is written to SHM_RING and sent to LOCAL_BROKER
+**      clients whether or not the broker publish succeeds
+**   6. The broker publish is skipped while the MQTT client isn't connected
+**      and the local broker is enabled. The message counts as published
+**      because the local broker is the only output.
 */
-void MQTT_MGR_Execute(uint32 PerfId)
+bool MQTT_MGR_PublishSbMsg(const CFE_MSG_Message_t *MsgPtr)
 {
 
-   ProcessSbTopicMsgs(PerfId);
-   
-   if (MqttMgr->SbTopicTestActive)
+   bool   RetStatus = false;
+   uint16 TopicId;
+   const MQTT_TOPIC_TBL_Entry_t *Entry;
+   const char *Topic;
+   const char *Payload;
+   uint32 RcvTime = MSG_STATS_GetTime();
+   uint32 EncodeTime;
+   uint32 PayloadLen;
+   bool   Published;
+
+   if (MSG_TRANS_ProcessSbMsg(MsgPtr, &TopicId, &Topic, &Payload))
    {
-      MQTT_TOPIC_TBL_RunSbMsgTest(MqttMgr->SbTopicTestId, false, MqttMgr->SbTopicTestParam);
+      EncodeTime = MSG_STATS_GetTime();
+      PayloadLen = strlen(Payload);
+      SHM_RING_Write(TopicId, Topic, Payload, PayloadLen);
+      LOCAL_BROKER_Publish(TopicId, Topic, Payload, PayloadLen);
+      if (!MQTT_CLIENT_IsConnected() && LOCAL_BROKER_Enabled())
+      {
+         Published = true;
+      }
+      else
+      {
+         Entry = MQTT_TOPIC_TBL_GetEntry(TopicId);
+         Published = MQTT_CLIENT_Publish(Topic, Payload, (Entry != NULL && Entry->Retain));
+      }
+      if (Published)
+      {
+         MSG_STATS_RecordLatency(TopicId, MSG_STATS_DIR_SB_TO_MQTT, RcvTime,
+                                 EncodeTime, MSG_STATS_GetTime());
+         MSG_STATS_CountMsgOut(TopicId, MSG_STATS_DIR_SB_TO_MQTT, PayloadLen);
+         RetStatus = true;
+      }
+      else
+      {
+         MSG_STATS_CountDrop(TopicId, MSG_STATS_DIR_SB_TO_MQTT);
+         MSG_TRANS_ClearDedup(TopicId);
+      }
    }
 
-} /* End MQTT_MGR_Execute() */
+   return RetStatus;
+   
+} /* End MQTT_MGR_PublishSbMsg() */
 
 
 /******************************************************************************
@@ -225,102 +294,238 @@ void MQTT_MGR_ResetStatus(void)
 
    MQTT_CLIENT_ResetStatus();
    MSG_TRANS_ResetStatus();
+   MSG_STATS_ResetStatus();
+   DECODE_POOL_ResetStatus();
+   RT_LOOP_ResetStatus();
+   LAST_VALUE_ResetStatus();
+   SHM_RING_ResetStatus();
+   LOCAL_BROKER_ResetStatus();
+   LAT_PROBE_ResetStatus();
+   
+   MqttMgr->RetainedRcvCnt = 0;
 
 } /* End MQTT_MGR_ResetStatus() */
 
 
 /******************************************************************************
-** Function: ProcessSbTopicMsgs
+** Function: MqttTopic
+**
+** Return true if topic 'Idx' is defined in 'Tbl' and is received from MQTT.
 **
-** Notes:
-**   1. MSG_TRANS_ProcessSbMsg() and MQTT_CLIENT_Publish() send error events
-**      so no need to send any events here.
 */
-static void ProcessSbTopicMsgs(uint32 PerfId)
+static bool MqttTopic(const MQTT_TOPIC_TBL_Data_t *Tbl, uint16 Idx)
 {
 
-   int32  SbStatus;
-   CFE_SB_Buffer_t  *SbBufPtr;
-   const char *Topic;
-   const char *Payload;
+   return (Idx < Tbl->TopicCnt && Tbl->Entry[Idx].Id != MQTT_TOPIC_TBL_UNUSED_ID &&
+           Tbl->Entry[Idx].SbRole == MQTT_TOPIC_TBL_SB_ROLE_PUB);
+
+} /* End MqttTopic() */
+
+
+/******************************************************************************
+** Function: ProcessMqttMsg
+**
+** Notes:
+**   1. Signature must match MQTT_CLIENT_MsgCallback_t
+**   2. Called by the MQTT library from the MQTT child task's yield so a
+**      received message restarts the MQTT I/O loop's spin window.
+**   3. The broker sends a topic's retained value when it is subscribed.
+**
+*/
+static void ProcessMqttMsg(MessageData* MsgData)
+{
 
-   do 
+   RT_LOOP_Activity(RT_LOOP_MQTT_IO);
+   
+   if (MsgData->message->retained)
    {
-      CFE_ES_PerfLogExit(PerfId);
-      SbStatus = CFE_SB_ReceiveBuffer(&SbBufPtr, MqttMgr->TopicPipe, MqttMgr->SbPendTime);
-      CFE_ES_PerfLogEntry(PerfId);
+      ++MqttMgr->RetainedRcvCnt;
+   }
+   
+   if (LAST_VALUE_IsReqTopic(MsgData->topicName->lenstring.data,
+                             (uint16)MsgData->topicName->lenstring.len))
+   {
+      LAST_VALUE_Request();
+   }
+   else
+   {
+      DECODE_POOL_ProcessMqttMsg(MsgData);
+   }
+
+} /* End ProcessMqttMsg() */
+
+
+/******************************************************************************
+** Function: SbTopic
+**
+** Return true if topic 'Idx' is defined in 'Tbl' and is received from the SB.
+**
+*/
+static bool SbTopic(const MQTT_TOPIC_TBL_Data_t *Tbl, uint16 Idx)
+{
+
+   return (Idx < Tbl->TopicCnt && Tbl->Entry[Idx].Id != MQTT_TOPIC_TBL_UNUSED_ID &&
+           Tbl->Entry[Idx].SbRole == MQTT_TOPIC_TBL_SB_ROLE_SUB);
+
+} /* End SbTopic() */
+
+
+/******************************************************************************
+** Function: UpdateMqttSubscriptions
+**
+** Move the broker session's topic subscriptions from the OldTbl topic table
+** snapshot to NewTbl.
+**
+** Notes:
+**   1. OldTbl is NULL when the session has no subscriptions.
+**   2. Topics are matched by name so an MQTT topic that keeps its name
+**      across a reload is left alone even if its ID changed.
+**   3. Subscribe and unsubscribe lists are each sent in as few packets as
+**      possible and then acknowledged. Topics the broker refuses aren't
+**      counted as subscribed. The name pointers are only used during the
+**      MQTT_CLIENT calls.
+**   4. The LAST_VALUE request topic isn't in the table so it is only
+**      subscribed with a new session's topics.
+**   5. The topics of a multiplexed topic share its name so only the topic
+**      that holds the name index slot is subscribed or unsubscribed.
+**
+*/
+static void UpdateMqttSubscriptions(const MQTT_TOPIC_TBL_Data_t *OldTbl, const MQTT_TOPIC_TBL_Data_t *NewTbl)
+{
+
+   uint16 i;
+   uint16 SubscribeCnt = 0;
+   uint16 UnsubscribeCnt = 0;
+   uint16 SubscribeSent = 0;
+   uint16 UnsubscribeSent = 0;
+   const char *TopicName;
    
-      if (SbStatus == CFE_SUCCESS)
+   for (i=0; i < NewTbl->TopicCnt; i++)
+   {
+      if (MqttTopic(NewTbl, i))
       {
-         if (MSG_TRANS_ProcessSbMsg(&SbBufPtr->Msg, &Topic, &Payload))
+         TopicName = MQTT_TOPIC_TBL_DATA_NAME(NewTbl, i);
+         if (NewTbl->Entry[i].MuxIdx != MQTT_TOPIC_TBL_MUX_NONE &&
+             MQTT_TOPIC_TBL_FindSnapshotName(NewTbl, TopicName, NewTbl->Dispatch[i].NameLen) != i)
+         {
+            continue;
+         }
+         if (OldTbl == NULL || 
+             !MqttTopic(OldTbl, MQTT_TOPIC_TBL_FindSnapshotName(OldTbl, TopicName, NewTbl->Dispatch[i].NameLen)))
          {
-            MQTT_CLIENT_Publish(Topic, Payload);
+            MqttMgr->SubscribeList[SubscribeCnt++] = TopicName;
          }
       }
-      
-   } while(SbStatus == CFE_SUCCESS);
+   } /* End new topic loop */
    
-} /* End ProcessSbTopicMsgs() */
+   if (OldTbl == NULL && MqttMgr->LastValue.ReqTopic[0] != '\0')
+   {
+      MqttMgr->SubscribeList[SubscribeCnt++] = MqttMgr->LastValue.ReqTopic;
+   }
+   
+   if (OldTbl != NULL)
+   {
+      for (i=0; i < OldTbl->TopicCnt; i++)
+      {
+         if (MqttTopic(OldTbl, i))
+         {
+            TopicName = MQTT_TOPIC_TBL_DATA_NAME(OldTbl, i);
+            if (OldTbl->Entry[i].MuxIdx != MQTT_TOPIC_TBL_MUX_NONE &&
+                MQTT_TOPIC_TBL_FindSnapshotName(OldTbl, TopicName, OldTbl->Dispatch[i].NameLen) != i)
+            {
+               continue;
+            }
+            if (!MqttTopic(NewTbl, MQTT_TOPIC_TBL_FindSnapshotName(NewTbl, TopicName, OldTbl->Dispatch[i].NameLen)))
+            {
+               MqttMgr->UnsubscribeList[UnsubscribeCnt++] = TopicName;
+            }
+         }
+      } /* End old topic loop */
+   } /* End if old table */
+   
+   if (SubscribeCnt > 0)
+   {
+      SubscribeSent = MQTT_CLIENT_SubscribeList(MqttMgr->SubscribeList, SubscribeCnt,
+                                                MqttMgr->SubscribeQos, ProcessMqttMsg);
+   }
+   if (UnsubscribeCnt > 0)
+   {
+      UnsubscribeSent = MQTT_CLIENT_UnsubscribeList(MqttMgr->UnsubscribeList, UnsubscribeCnt);
+   }
+   
+   if (SubscribeSent == SubscribeCnt && UnsubscribeSent == UnsubscribeCnt)
+   {
+      CFE_EVS_SendEvent(MQTT_MGR_SUBSCRIBE_EID, CFE_EVS_EventType_INFORMATION, 
+                        "MQTT topic subscriptions at QoS %d: Subscribed %d, Unsubscribed %d",
+                        MqttMgr->SubscribeQos, SubscribeCnt, UnsubscribeCnt);
+   }
+   else
+   {
+      CFE_EVS_SendEvent(MQTT_MGR_SUBSCRIBE_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "MQTT topic subscription errors: Subscribed %d of %d, Unsubscribed %d of %d",
+                        SubscribeSent, SubscribeCnt, UnsubscribeSent, UnsubscribeCnt);
+   }
+ 
+} /* End UpdateMqttSubscriptions() */
 
 
 /******************************************************************************
-** Function: SubscribeToMessages
+** Function: UpdateSbSubscriptions
 **
-** Subscribe to topic messages on the SB and MQTT_CLIENT based on a topics
-** defition in the topic table.
+** Move the SB topic subscriptions from the OldTbl topic table snapshot to
+** NewTbl.
+**
+** Notes:
+**   1. OldTbl is NULL for the initial subscriptions.
+**   2. SB subscriptions are by message ID so topics are matched by their
+**      message ID. A message ID that is subscribed in both tables is left
+**      alone even if it moved to a different topic.
+**   3. The app's own messages share the topic pipe. Table loads reject
+**      topics with a reserved message ID but they are also skipped here so
+**      the app can never lose its command or housekeeping subscriptions.
 **
 */
-static void SubscribeToMessages(uint32 TopicBaseMid)
+static void UpdateSbSubscriptions(const MQTT_TOPIC_TBL_Data_t *OldTbl, const MQTT_TOPIC_TBL_Data_t *NewTbl)
 {
 
    uint16 i;
-   uint16 SbSubscribeCnt = 0;
-   uint16 MqttSubscribeCnt = 0;
-   uint16 SubscribeErr = 0;
+   uint16 SubscribeCnt = 0;
+   uint16 UnsubscribeCnt = 0;
+   uint32 SbMid;
    
-   const MQTT_TOPIC_TBL_Entry_t *TopicTblEntry;
+   for (i=0; i < NewTbl->TopicCnt; i++)
+   {
+      if (SbTopic(NewTbl, i))
+      {
+         SbMid = NewTbl->Entry[i].SbMid;
+         if (OldTbl == NULL || !SbTopic(OldTbl, MQTT_TOPIC_TBL_FindSnapshotMid(OldTbl, SbMid)))
+         {
+            ++SubscribeCnt;
+            CFE_SB_Subscribe(CFE_SB_ValueToMsgId(SbMid), MqttMgr->TopicPipe);
+         }
+      }
+   } /* End new topic loop */
    
-   for (i=0; i < MQTT_TOPIC_TBL_MAX_TOPICS; i++)
+   if (OldTbl != NULL)
    {
-
-      TopicTblEntry = MQTT_TOPIC_TBL_GetEntry(i);
-      if (TopicTblEntry != NULL)   
+      for (i=0; i < OldTbl->TopicCnt; i++)
       {
-         if (TopicTblEntry->Id != MQTT_TOPIC_TBL_UNUSED_ID)
+         if (SbTopic(OldTbl, i))
          {
-
-            if (strcmp(TopicTblEntry->SbRole,"sub") == 0)
+            SbMid = OldTbl->Entry[i].SbMid;
+            if (!SbTopic(NewTbl, MQTT_TOPIC_TBL_FindSnapshotMid(NewTbl, SbMid)) &&
+                !MQTT_TOPIC_TBL_ReservedMid(SbMid))
             {
-
-               ++SbSubscribeCnt;
-               CFE_SB_Subscribe(CFE_SB_ValueToMsgId(TopicBaseMid+i),
-                                MqttMgr->TopicPipe);
+               ++UnsubscribeCnt;
+               CFE_SB_Unsubscribe(CFE_SB_ValueToMsgId(SbMid), MqttMgr->TopicPipe);
             }
-            else
-            {
-               /* MQTTlib does not store a copy of topic so it must be in persistent memory */
-               if (MQTT_CLIENT_Subscribe(TopicTblEntry->Name, MQTT_CLIENT_QOS2, 
-                                         MSG_TRANS_ProcessMqttMsg))
-               {
-                  ++MqttSubscribeCnt;
-                  CFE_EVS_SendEvent(MQTT_MGR_SUBSCRIBE_EID, CFE_EVS_EventType_INFORMATION, 
-                          "Subscribed to MQTT client for topic %s", TopicTblEntry->Name);
-               }
-               else
-               {
-                  ++SubscribeErr;
-                  CFE_EVS_SendEvent(MQTT_MGR_SUBSCRIBE_ERR_EID, CFE_EVS_EventType_ERROR, 
-                          "Error subscribing to MQTT client for topic %s", TopicTblEntry->Name);
-               }
-            }
-         } /* End if not NULL */
-      } /* End if topic in use */
-  
-   } /* End topic loop */
-    
+         }
+      } /* End old topic loop */
+   } /* End if old table */
+   
    CFE_EVS_SendEvent(MQTT_MGR_SUBSCRIBE_EID, CFE_EVS_EventType_INFORMATION, 
-                     "Topic subscriptions: SB %d, MQTT %d, Errors %d",
-                     SbSubscribeCnt, MqttSubscribeCnt, SubscribeErr);
+                     "SB topic subscriptions: Subscribed %d, Unsubscribed %d",
+                     SubscribeCnt, UnsubscribeCnt);
  
-} /* End SubscribeToMessages() */
+} /* End UpdateSbSubscriptions() */
 
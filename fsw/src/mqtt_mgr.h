@@ -22,6 +22,33 @@
 **      the table. Since MQTT manager has very little functionality beyond
 **      processing the table, a single object is used for management functions
 **      and table processing.
+**   3. Topic subscriptions are updated by the MQTT child task when it sees
+**      a new topic table snapshot. The update runs before the child task's
+**      quiescent point so the previous snapshot is still valid.
+**   4. Only the difference between the subscribed snapshot and the new one
+**      is sent to the broker. MQTT subscriptions are tracked per broker
+**      session and a new session subscribes to every MQTT topic. All MQTT
+**      subscriptions are sent as topic lists so a table with hundreds of
+**      topics is subscribed with a few packets in one round trip.
+**   5. Received MQTT messages are passed to DECODE_POOL so the MQTT child
+**      task only reads the socket and queues payloads.
+**   6. The MQTT child task is RT_LOOP's MQTT I/O loop. It yields for
+**      RT_LOOP_MQTT_SPIN_YIELD_MS while RT_LOOP says to spin.
+**   7. The LAST_VALUE request topic is subscribed with each new broker
+**      session's topics. Its messages are not passed to DECODE_POOL.
+**   8. Warm startup: the constructor sends the values saved by LAST_VALUE
+**      on the SB and the broker's retained values follow when the child
+**      task subscribes. Retained values are translated like any other
+**      message so they replace the saved values with the broker's state.
+**   9. Each encoded SB message is written to SHM_RING before it is
+**      published so local consumers receive it without the broker.
+**  10. LOCAL_BROKER clients receive the same messages as the broker and
+**      their messages are processed like the broker's. While the MQTT
+**      client isn't connected to a broker the MQTT child task waits on the
+**      local clients instead of idling for the MQTT yield time and the
+**      local broker is the only SB-to-MQTT output.
+**  11. LAT_PROBE's topic is a topic table topic so its returned probes
+**      are decoded by DECODE_POOL like any other message.
 **
 ** References:
 **   1. OpenSatKit Object-based Application Developer's Guide
@@ -37,8 +64,16 @@
 */
 
 #include "app_cfg.h"
+#include "decode_pool.h"
+#include "lat_probe.h"
+#include "last_value.h"
+#include "local_broker.h"
 #include "msg_trans.h"
+#include "msg_stats.h"
 #include "mqtt_client.h"
+#include "perf_bench.h"
+#include "rt_loop.h"
+#include "shm_ring.h"
 
 
 /***********************/
@@ -52,8 +87,7 @@
 
 #define MQTT_MGR_SUBSCRIBE_EID        (MQTT_MGR_BASE_EID + 0)
 #define MQTT_MGR_SUBSCRIBE_ERR_EID    (MQTT_MGR_BASE_EID + 1)
-#define MQTT_MGR_CONFIG_TEST_EID      (MQTT_MGR_BASE_EID + 2)
-#define MQTT_MGR_CONFIG_TEST_ERR_EID  (MQTT_MGR_BASE_EID + 3)
+#define MQTT_MGR_CONSTRUCT_ERR_EID    (MQTT_MGR_BASE_EID + 2)
 
 
 /**********************/
@@ -68,12 +102,17 @@ typedef struct
 
    uint32  MqttYieldTime;
    uint32  SbPendTime;
+   uint32  SubscribeQos;
    
-   CFE_SB_PipeId_t TopicPipe;
+   CFE_SB_PipeId_t TopicPipe;   /* App's only pipe, also receives the app's commands */
    
-   bool    SbTopicTestActive;
-   uint16  SbTopicTestId;
-   int16   SbTopicTestParam;
+   const MQTT_TOPIC_TBL_Data_t *SubscribedTbl;      /* Topic table snapshot used for the SB subscriptions */
+   const MQTT_TOPIC_TBL_Data_t *MqttSubscribedTbl;  /* Snapshot used for the broker session's subscriptions, NULL if none */
+   uint32  MqttConnectCnt;                          /* MQTT_CLIENT connect count of the subscribed session */
+   uint32  RetainedRcvCnt;                          /* Broker retained messages received */
+   
+   const char *SubscribeList[MQTT_TOPIC_TBL_MAX_TOPICS+1];   /* Plus the last value request topic */
+   const char *UnsubscribeList[MQTT_TOPIC_TBL_MAX_TOPICS];
    
    /*
    ** Contained Objects
@@ -81,6 +120,14 @@ typedef struct
    
    MQTT_CLIENT_Class_t  MqttClient;
    MSG_TRANS_Class_t    MsgTrans;  
+   MSG_STATS_Class_t    MsgStats;
+   PERF_BENCH_Class_t   PerfBench;
+   DECODE_POOL_Class_t  DecodePool;
+   RT_LOOP_Class_t      RtLoop;
+   LAST_VALUE_Class_t   LastValue;
+   SHM_RING_Class_t     ShmRing;
+   LOCAL_BROKER_Class_t LocalBroker;
+   LAT_PROBE_Class_t    LatProbe;
    
 } MQTT_MGR_Class_t;
 
@@ -110,24 +157,6 @@ void MQTT_MGR_Constructor(MQTT_MGR_Class_t *MqttMgrPtr,
 bool MQTT_MGR_ChildTaskCallback(CHILDMGR_Class_t *ChildMgr);
 
 
-/******************************************************************************
-** Function: MQTT_MGR_ConfigSbTopicTestCmd
-**
-** Start/stop a topic test. 
-**
-** Notes:
-**   1. Topic tests verify the topic SB-to-MQTT translation path. The tests 
-**      create and send SB topic messages. These messages are looped back
-**      to MQTT_GW whcih causes the CfeToJson transaltion to occur. The tests
-**      are continuously run by MQTT_MGR_Execute() until they are commanded
-**      to stop. 
-**   2. In addition to testing the tranlation process they are useful for 
-**      verifying web apps that are processing the MQTT messages.
-**   3. Signature must match CMDMGR_CmdFuncPtr_t
-*/
-bool MQTT_MGR_ConfigSbTopicTestCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
-
-
 /******************************************************************************
 ** Function: MQTT_MGR_ConnectToMqttBrokerCmd
 **
@@ -140,19 +169,16 @@ bool MQTT_MGR_ConnectToMqttBrokerCmd(void* DataObjPtr, const CFE_MSG_Message_t *
 
 
 /******************************************************************************
-** Function: MQTT_MGR_Execute
+** Function: MQTT_MGR_PublishSbMsg
 **
-** Perform management functions that need to be performed on a periodic basis.
+** Translate a SB topic message to JSON and publish it to the MQTT broker.
 **
 ** Notes:
-**   1. This function is designed to be continuously called from the app's main
-**      loop so it pends with a timeout on the SB
-**   2. In normal operations it receives topic messages from the SB and 
-**      creates/sends corresponding MQTT JSON messages to the MQTT_CLIENT. It 
-**      also has test modes of operation.
+**   1. Latency and traffic statistics are recorded for the message's topic.
+**   2. Returns true if the message was published.
 **
 */
-void MQTT_MGR_Execute(uint32 PerfId);
+bool MQTT_MGR_PublishSbMsg(const CFE_MSG_Message_t *MsgPtr);
 
 
 /******************************************************************************
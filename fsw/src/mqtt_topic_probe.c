@@ -0,0 +1,184 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Manage MQTT latency probe topic
+**
+** Notes:
+**   1. See mqtt_topic_probe.h
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+
+/*
+** Includes
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mqtt_topic_probe.h"
+#include "msg_stats.h"
+
+/************************************/
+/** Local File Function Prototypes **/
+/************************************/
+
+static bool JsonUint(const char *Payload, uint16 PayloadLen, const char *Key, uint32 *Value);
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_PROBE_Constructor
+**
+*/
+void MQTT_TOPIC_PROBE_Constructor(MQTT_TOPIC_PROBE_Class_t *MqttTopicProbe,
+                                  CFE_SB_MsgId_t TlmMsgMid)
+{
+
+   memset(MqttTopicProbe, 0, sizeof(MQTT_TOPIC_PROBE_Class_t));
+
+   CFE_MSG_Init(CFE_MSG_PTR(MqttTopicProbe->ReturnPkt.TelemetryHeader), TlmMsgMid,
+                sizeof(MQTT_TOPIC_PROBE_Pkt_t));
+
+} /* End MQTT_TOPIC_PROBE_Constructor() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_PROBE_CfeToJson
+**
+** Notes:
+**   1. Only full size OUT packets are encoded so a returned probe can't be
+**      published again.
+**
+*/
+bool MQTT_TOPIC_PROBE_CfeToJson(void *Codec, const char **JsonMsgPayload,
+                                const CFE_MSG_Message_t *CfeMsg)
+{
+
+   MQTT_TOPIC_PROBE_Class_t *MqttTopicProbe = (MQTT_TOPIC_PROBE_Class_t *)Codec;
+   const MQTT_TOPIC_PROBE_Pkt_t *Pkt = (const MQTT_TOPIC_PROBE_Pkt_t *)CfeMsg;
+   bool  RetStatus = false;
+   CFE_MSG_Size_t MsgSize = 0;
+
+   CFE_MSG_GetSize(CfeMsg, &MsgSize);
+   if (MsgSize == sizeof(MQTT_TOPIC_PROBE_Pkt_t) && Pkt->Phase == MQTT_TOPIC_PROBE_PHASE_OUT)
+   {
+
+      snprintf(MqttTopicProbe->JsonMsgPayload, sizeof(MqttTopicProbe->JsonMsgPayload),
+               "{\"gw\":%u,\"seq\":%u,\"t0\":%u}",
+               (unsigned int)Pkt->Instance, (unsigned int)Pkt->Seq, (unsigned int)Pkt->SendTime);
+      *JsonMsgPayload = MqttTopicProbe->JsonMsgPayload;
+
+      ++MqttTopicProbe->CfeToJsonCnt;
+      RetStatus = true;
+
+   }
+
+   return RetStatus;
+
+} /* End MQTT_TOPIC_PROBE_CfeToJson() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_PROBE_JsonToCfe
+**
+*/
+bool MQTT_TOPIC_PROBE_JsonToCfe(void *Codec, CFE_MSG_Message_t **CfeMsg,
+                                const char *JsonMsgPayload, uint16 PayloadLen)
+{
+
+   MQTT_TOPIC_PROBE_Class_t *MqttTopicProbe = (MQTT_TOPIC_PROBE_Class_t *)Codec;
+   MQTT_TOPIC_PROBE_Pkt_t   *Pkt = &MqttTopicProbe->ReturnPkt;
+   bool RetStatus = false;
+
+   *CfeMsg = NULL;
+
+   if (JsonUint(JsonMsgPayload, PayloadLen, "gw",  &Pkt->Instance) &&
+       JsonUint(JsonMsgPayload, PayloadLen, "seq", &Pkt->Seq) &&
+       JsonUint(JsonMsgPayload, PayloadLen, "t0",  &Pkt->SendTime))
+   {
+
+      Pkt->Phase       = MQTT_TOPIC_PROBE_PHASE_RETURN;
+      Pkt->MqttRcvTime = MSG_STATS_GetTime();
+      *CfeMsg = CFE_MSG_PTR(Pkt->TelemetryHeader);
+
+      ++MqttTopicProbe->JsonToCfeCnt;
+      RetStatus = true;
+
+   }
+
+   return RetStatus;
+
+} /* End MQTT_TOPIC_PROBE_JsonToCfe() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_PROBE_SbMsgFill
+**
+** Notes:
+**   1. A zero phase is neither OUT nor RETURN so a load generator can
+**      exercise the probe topic's SB path without publishing probes or
+**      corrupting the latency window.
+**
+*/
+void MQTT_TOPIC_PROBE_SbMsgFill(void *Codec, CFE_MSG_Message_t *SbMsg, CFE_MSG_Size_t MsgSize,
+                                uint32 Seq, int16 Param)
+{
+
+   MQTT_TOPIC_PROBE_Pkt_t *Pkt = (MQTT_TOPIC_PROBE_Pkt_t *)SbMsg;
+
+   if (MsgSize >= sizeof(MQTT_TOPIC_PROBE_Pkt_t))
+   {
+      Pkt->Phase       = 0;
+      Pkt->Instance    = 0;
+      Pkt->Seq         = Seq;
+      Pkt->SendTime    = 0;
+      Pkt->MqttRcvTime = 0;
+   }
+
+} /* End MQTT_TOPIC_PROBE_SbMsgFill() */
+
+
+/******************************************************************************
+** Function: JsonUint
+**
+** Return true if 'Key' is an unsigned integer in the JSON object 'Payload'.
+**
+*/
+static bool JsonUint(const char *Payload, uint16 PayloadLen, const char *Key, uint32 *Value)
+{
+
+   bool        RetStatus = false;
+   const char *NumValue;
+   size_t      NumLen;
+   JSONTypes_t ValueType;
+   char        NumStr[16];
+   char       *NumEnd;
+
+   if (JSON_SearchConst(Payload, PayloadLen, Key, strlen(Key), &NumValue, &NumLen, &ValueType) == JSONValid &&
+       ValueType == JSONNumber && NumLen > 0 && NumLen < sizeof(NumStr) && NumValue[0] != '-')
+   {
+      memcpy(NumStr, NumValue, NumLen);
+      NumStr[NumLen] = '\0';
+      *Value = strtoul(NumStr, &NumEnd, 10);
+      RetStatus = (*NumEnd == '\0');
+   }
+
+   return RetStatus;
+
+} /* End JsonUint() */
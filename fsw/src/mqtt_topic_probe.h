@@ -0,0 +1,156 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Manage MQTT latency probe topic
+**
+** Notes:
+**   1. This is a codec type. See mqtt_topic_rate.h for the codec instance
+**      design.
+**   2. The probe packet is internal to LAT_PROBE so it isn't defined in
+**      the EDS. Only OUT packets are encoded and decoded messages are
+**      RETURN packets.
+**   3. A decoded probe's MqttRcvTime is its decode time so LAT_PROBE's
+**      broker stage includes the time the message waited in DECODE_POOL.
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+
+#ifndef _mqtt_topic_probe_
+#define _mqtt_topic_probe_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+typedef enum
+{
+
+   MQTT_TOPIC_PROBE_PHASE_OUT    = 1,   /* Sent by the main task, to be published */
+   MQTT_TOPIC_PROBE_PHASE_RETURN = 2    /* Received from the broker */
+
+} MQTT_TOPIC_PROBE_Phase_t;
+
+
+/*
+** SB probe packet. Times are MSG_STATS_GetTime() microseconds.
+*/
+
+typedef struct
+{
+
+   CFE_MSG_TelemetryHeader_t  TelemetryHeader;
+   uint32  Phase;
+   uint32  Instance;        /* Gateway instance that sent the probe */
+   uint32  Seq;
+   uint32  SendTime;        /* OUT packet sent */
+   uint32  MqttRcvTime;     /* RETURN message decoded */
+
+} MQTT_TOPIC_PROBE_Pkt_t;
+
+
+typedef struct
+{
+
+   /*
+   ** Decode: JSON to probe packet
+   */
+
+   MQTT_TOPIC_PROBE_Pkt_t  ReturnPkt;
+
+   /*
+   ** Encode: Probe packet to JSON
+   */
+
+   char    JsonMsgPayload[64];
+
+   uint32  CfeToJsonCnt;
+   uint32  JsonToCfeCnt;
+
+} MQTT_TOPIC_PROBE_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_PROBE_Constructor
+**
+** Initialize a MQTT latency probe topic codec instance
+**
+** Notes:
+**   1. TlmMsgMid initializes the telemetry header. Decoded messages are
+**      given their topic's message ID by MSG_TRANS.
+**
+*/
+void MQTT_TOPIC_PROBE_Constructor(MQTT_TOPIC_PROBE_Class_t *MqttTopicProbe,
+                                  CFE_SB_MsgId_t TlmMsgMid);
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_PROBE_CfeToJson
+**
+** Convert an outgoing probe packet to a JSON topic message
+**
+** Notes:
+**   1.  Signature must match MQTT_TOPIC_TBL_CfeToJson_t
+*/
+bool MQTT_TOPIC_PROBE_CfeToJson(void *Codec, const char **JsonMsgPayload,
+                                const CFE_MSG_Message_t *CfeMsg);
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_PROBE_JsonToCfe
+**
+** Convert a JSON probe topic message to a returned probe packet
+**
+** Notes:
+**   1.  Signature must match MQTT_TOPIC_TBL_JsonToCfe_t
+*/
+bool MQTT_TOPIC_PROBE_JsonToCfe(void *Codec, CFE_MSG_Message_t **CfeMsg,
+                                const char *JsonMsgPayload, uint16 PayloadLen);
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_PROBE_SbMsgFill
+**
+** Fill a load generator SB message with a probe that LAT_PROBE ignores.
+**
+** Notes:
+**   1.  Signature must match MQTT_TOPIC_TBL_SbMsgFill_t
+**   2.  The message is not modified if MsgSize is too small for a probe
+**       packet.
+*/
+void MQTT_TOPIC_PROBE_SbMsgFill(void *Codec, CFE_MSG_Message_t *SbMsg, CFE_MSG_Size_t MsgSize,
+                                uint32 Seq, int16 Param);
+
+
+#endif /* _mqtt_topic_probe_ */
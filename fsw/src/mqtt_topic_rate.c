@@ -16,7 +16,7 @@
 **   Manage MQTT rate topic
 **
 ** Notes:
-**   None
+**   1. See mqtt_topic_rate.h for the codec instance design.
 **
 ** References:
 **   1. OpenSatKit Object-based Application Developer's Guide
@@ -34,26 +34,24 @@
 /** Local File Function Prototypes **/
 /************************************/
 
-static bool LoadJsonData(const char *JsonMsgPayload, uint16 PayloadLen);
+static bool LoadJsonData(MQTT_TOPIC_RATE_Class_t *MqttTopicRate,
+                         const char *JsonMsgPayload, uint16 PayloadLen);
 
 
 /**********************/
 /** Global File Data **/
 /**********************/
 
-static MQTT_TOPIC_RATE_Class_t* MqttTopicRate = NULL;
-
-static MQTT_GW_RateTlm_Payload_t  RateData; /* Working buffer for loads */
-
-static CJSON_Obj_t JsonTblObjs[] = 
+/* Data addresses are set to each instance's RateData by the constructor */
+static const CJSON_Obj_t JsonTblObjs[MQTT_TOPIC_RATE_JSON_OBJ_CNT] = 
 {
 
    /* Table           Table                                      core-json      length of query      */
    /* Data Address,   Data Length,  Updated, Data Type,  Float,  query string,  string(exclude '\0') */
    
-   { &RateData.X,     4,            false,   JSONNumber, true,   { "rate.x",    (sizeof("rate.x")-1)} },
-   { &RateData.Y,     4,            false,   JSONNumber, true,   { "rate.y",    (sizeof("rate.y")-1)} },
-   { &RateData.Z,     4,            false,   JSONNumber, true,   { "rate.z",    (sizeof("rate.z")-1)} }
+   { NULL,            4,            false,   JSONNumber, true,   { "rate.x",    (sizeof("rate.x")-1)} },
+   { NULL,            4,            false,   JSONNumber, true,   { "rate.y",    (sizeof("rate.y")-1)} },
+   { NULL,            4,            false,   JSONNumber, true,   { "rate.z",    (sizeof("rate.z")-1)} }
    
 };
 
@@ -62,35 +60,33 @@ static const char *NullRateMsg = "{\"rate\":{\"x\": 0.0,\"y\": 0.0,\"z\": 0.0}}"
 /******************************************************************************
 ** Function: MQTT_TOPIC_RATE_Constructor
 **
-** Initialize the MQTT rate topic
+** Initialize a MQTT rate topic codec instance
 **
 ** Notes:
 **   None
 **
 */
 #define DEG_PER_SEC_IN_RADIANS 0.0174533
-void MQTT_TOPIC_RATE_Constructor(MQTT_TOPIC_RATE_Class_t *MqttTopicRatePtr, 
-                                 CFE_SB_MsgId_t TlmMsgMid, const char *Topic)
+void MQTT_TOPIC_RATE_Constructor(MQTT_TOPIC_RATE_Class_t *MqttTopicRate, 
+                                 CFE_SB_MsgId_t TlmMsgMid)
 {
 
-   MqttTopicRate = MqttTopicRatePtr;
    memset(MqttTopicRate, 0, sizeof(MQTT_TOPIC_RATE_Class_t));
 
-   strncpy(MqttTopicRate->JsonMsgTopic, Topic, MQTT_TOPIC_TBL_MAX_TOPIC_LEN);
-   MqttTopicRate->JsonObjCnt = (sizeof(JsonTblObjs)/sizeof(CJSON_Obj_t));
+   memcpy(MqttTopicRate->JsonTblObjs, JsonTblObjs, sizeof(JsonTblObjs));
+   MqttTopicRate->JsonTblObjs[0].TblData = &MqttTopicRate->RateData.X;
+   MqttTopicRate->JsonTblObjs[1].TblData = &MqttTopicRate->RateData.Y;
+   MqttTopicRate->JsonTblObjs[2].TblData = &MqttTopicRate->RateData.Z;
    
    CFE_MSG_Init(CFE_MSG_PTR(MqttTopicRate->TlmMsg), TlmMsgMid, sizeof(MQTT_GW_RateTlm_t));
    
    /*
-   ** Cycle counts are used by sim to switch axis
-   ** Need to coordinate with topic message SB pend time
+   ** Message counts are used by the load generator fill to switch axis
+   ** Need to coordinate with the load generator message rate
    */
-   MqttTopicRate->TestAxis         = MQTT_TOPIC_RATE_TEST_AXIS_X;
-   MqttTopicRate->TestAxisCycleCnt = 0;
    MqttTopicRate->TestAxisDefRate  = 0.0087265;  /* 0.5 deg/sec in radians with 250ms pend */
    MqttTopicRate->TestAxisDefRate  = 0.0174533;  /* 1.0 deg/sec in radians with 250ms pend */
    MqttTopicRate->TestAxisDefRate  *= 7.5;        /* 7.5 deg/s so 24 cycles for 90 deg */
-   MqttTopicRate->TestAxisRate     = MqttTopicRate->TestAxisDefRate;
    MqttTopicRate->TestAxisCycleLim = 12*4;       /* Rotate 90 deg on each axis */
    
 } /* End MQTT_TOPIC_RATE_Constructor() */
@@ -101,21 +97,31 @@ void MQTT_TOPIC_RATE_Constructor(MQTT_TOPIC_RATE_Class_t *MqttTopicRatePtr,
 **
 ** Convert a cFE rate message to a JSON topic message 
 **
+** Notes:
+**   1. Messages too short to hold a rate payload are rejected so a load
+**      generator or misconfigured sender can't cause a read past the end
+**      of the SB buffer.
+**
 */
-bool MQTT_TOPIC_RATE_CfeToJson(const char **JsonMsgTopic, const char **JsonMsgPayload,
+bool MQTT_TOPIC_RATE_CfeToJson(void *Codec, const char **JsonMsgPayload,
                                const CFE_MSG_Message_t *CfeMsg)
 {
 
+   MQTT_TOPIC_RATE_Class_t *MqttTopicRate = (MQTT_TOPIC_RATE_Class_t *)Codec;
    bool  RetStatus = false;
-   int   PayloadLen; 
+   int   PayloadLen = 0; 
+   CFE_MSG_Size_t MsgSize = 0;
    const MQTT_GW_RateTlm_Payload_t *RateMsg = CMDMGR_PAYLOAD_PTR(CfeMsg, MQTT_GW_RateTlm_t);
 
-   *JsonMsgTopic   = MqttTopicRate->JsonMsgTopic;
    *JsonMsgPayload = NullRateMsg;
    
-   PayloadLen = sprintf(MqttTopicRate->JsonMsgPayload,
-                "{\"rate\":{\"x\": %0.6f,\"y\": %0.6f,\"z\": %0.6f}}",
-                RateMsg->X, RateMsg->Y, RateMsg->Z);
+   CFE_MSG_GetSize(CfeMsg, &MsgSize);
+   if (MsgSize >= sizeof(MQTT_GW_RateTlm_t))
+   {
+      PayloadLen = sprintf(MqttTopicRate->JsonMsgPayload,
+                   "{\"rate\":{\"x\": %0.6f,\"y\": %0.6f,\"z\": %0.6f}}",
+                   RateMsg->X, RateMsg->Y, RateMsg->Z);
+   }
 
    if (PayloadLen > 0)
    {
@@ -136,15 +142,16 @@ bool MQTT_TOPIC_RATE_CfeToJson(const char **JsonMsgTopic, const char **JsonMsgPa
 ** Convert a JSON rate topic message to a cFE rate message 
 **
 */
-bool MQTT_TOPIC_RATE_JsonToCfe(CFE_MSG_Message_t **CfeMsg, 
+bool MQTT_TOPIC_RATE_JsonToCfe(void *Codec, CFE_MSG_Message_t **CfeMsg, 
                                const char *JsonMsgPayload, uint16 PayloadLen)
 {
    
+   MQTT_TOPIC_RATE_Class_t *MqttTopicRate = (MQTT_TOPIC_RATE_Class_t *)Codec;
    bool RetStatus = false;
    
    *CfeMsg = NULL;
    
-   if (LoadJsonData(JsonMsgPayload, PayloadLen))
+   if (LoadJsonData(MqttTopicRate, JsonMsgPayload, PayloadLen))
    {
       *CfeMsg = (CFE_MSG_Message_t *)&MqttTopicRate->TlmMsg;
 
@@ -158,85 +165,58 @@ bool MQTT_TOPIC_RATE_JsonToCfe(CFE_MSG_Message_t **CfeMsg,
 
 
 /******************************************************************************
-** Function: MQTT_TOPIC_RATE_SbMsgTest
-**
-** Convert a JSON rate topic message to a cFE rate message
+** Function: MQTT_TOPIC_RATE_SbMsgFill
 **
 ** Notes:
 **   1. Param is used scale the default test rate and change the sign
 **      Increase rate:   2 <= Param <= 10
 **      Deccrease rate: 12 <= Param <= 20
+**   2. The rate is put on a single axis for TestAxisCycleLim messages and
+**      then moves to the next axis. The axis is computed from Seq so no
+**      state is kept between calls.
 **
 */
-void MQTT_TOPIC_RATE_SbMsgTest(bool Init, int16 Param)
+void MQTT_TOPIC_RATE_SbMsgFill(void *Codec, CFE_MSG_Message_t *SbMsg, CFE_MSG_Size_t MsgSize,
+                               uint32 Seq, int16 Param)
 {
 
-   if (Init)
-   {
+   const MQTT_TOPIC_RATE_Class_t *MqttTopicRate = (const MQTT_TOPIC_RATE_Class_t *)Codec;
+   MQTT_GW_RateTlm_Payload_t *RateMsg;
+   float TestAxisRate = MqttTopicRate->TestAxisDefRate;
 
-      MqttTopicRate->TestAxisRate = MqttTopicRate->TestAxisDefRate;
+   if (MsgSize >= sizeof(MQTT_GW_RateTlm_t))
+   {
       
       if (Param >= 2 && Param <= 10)
       {
-         MqttTopicRate->TestAxisRate *= (float)Param;
+         TestAxisRate *= (float)Param;
       }
       else if (Param >= 12 && Param <= 20)
       {         
-         MqttTopicRate->TestAxisRate /= ((float)Param - 10.0);
+         TestAxisRate /= ((float)Param - 10.0);
       }
-      MqttTopicRate->TlmMsg.Payload.X = MqttTopicRate->TestAxisRate;
-      MqttTopicRate->TlmMsg.Payload.Y = 0.0;
-      MqttTopicRate->TlmMsg.Payload.Z = 0.0;
-      MqttTopicRate->TestAxis         = MQTT_TOPIC_RATE_TEST_AXIS_X;
-      MqttTopicRate->TestAxisCycleCnt = 0;
 
-   }
-   else
-   {
-      switch (MqttTopicRate->TestAxis)
+      RateMsg = &((MQTT_GW_RateTlm_t *)SbMsg)->Payload;
+      RateMsg->X = 0.0;
+      RateMsg->Y = 0.0;
+      RateMsg->Z = 0.0;
+      
+      switch ((Seq / MqttTopicRate->TestAxisCycleLim) % 3 + MQTT_TOPIC_RATE_TEST_AXIS_X)
       {
          case MQTT_TOPIC_RATE_TEST_AXIS_X:
-            if (++MqttTopicRate->TestAxisCycleCnt > MqttTopicRate->TestAxisCycleLim)
-            {
-               MqttTopicRate->TestAxisCycleCnt = 0;
-               MqttTopicRate->TlmMsg.Payload.X = 0.0;
-               MqttTopicRate->TlmMsg.Payload.Y = MqttTopicRate->TestAxisRate;
-               MqttTopicRate->TestAxis         = MQTT_TOPIC_RATE_TEST_AXIS_Y;
-            }
+            RateMsg->X = TestAxisRate;
             break;
          case MQTT_TOPIC_RATE_TEST_AXIS_Y:
-            if (++MqttTopicRate->TestAxisCycleCnt > MqttTopicRate->TestAxisCycleLim)
-            {
-               MqttTopicRate->TestAxisCycleCnt = 0;
-               MqttTopicRate->TlmMsg.Payload.Y = 0.0;
-               MqttTopicRate->TlmMsg.Payload.Z = MqttTopicRate->TestAxisRate;
-               MqttTopicRate->TestAxis         = MQTT_TOPIC_RATE_TEST_AXIS_Z;
-            }
-            break;
-         case MQTT_TOPIC_RATE_TEST_AXIS_Z:
-            if (++MqttTopicRate->TestAxisCycleCnt > MqttTopicRate->TestAxisCycleLim)
-            {
-               MqttTopicRate->TestAxisCycleCnt = 0;
-               MqttTopicRate->TlmMsg.Payload.Z = 0.0;
-               MqttTopicRate->TlmMsg.Payload.X = MqttTopicRate->TestAxisRate;
-               MqttTopicRate->TestAxis         = MQTT_TOPIC_RATE_TEST_AXIS_X;
-            }
+            RateMsg->Y = TestAxisRate;
             break;
          default:
-            MqttTopicRate->TestAxisCycleCnt = 0;
-            MqttTopicRate->TlmMsg.Payload.X = MqttTopicRate->TestAxisRate;
-            MqttTopicRate->TlmMsg.Payload.Y = 0.0;
-            MqttTopicRate->TlmMsg.Payload.Z = 0.0;
-            MqttTopicRate->TestAxis         = MQTT_TOPIC_RATE_TEST_AXIS_X;
+            RateMsg->Z = TestAxisRate;
             break;
-         
       } /* End axis switch */
-   }
    
-   CFE_SB_TimeStampMsg(CFE_MSG_PTR(MqttTopicRate->TlmMsg.TelemetryHeader));
-   CFE_SB_TransmitMsg(CFE_MSG_PTR(MqttTopicRate->TlmMsg.TelemetryHeader), true);
+   } /* End if message holds a rate payload */
    
-} /* End MQTT_TOPIC_RATE_SbMsgTest() */
+} /* End MQTT_TOPIC_RATE_SbMsgFill() */
 
 
 /******************************************************************************
@@ -245,27 +225,29 @@ void MQTT_TOPIC_RATE_SbMsgTest(bool Init, int16 Param)
 ** Notes:
 **  1. See file prologue for full/partial table load scenarios
 */
-static bool LoadJsonData(const char *JsonMsgPayload, uint16 PayloadLen)
+static bool LoadJsonData(MQTT_TOPIC_RATE_Class_t *MqttTopicRate,
+                         const char *JsonMsgPayload, uint16 PayloadLen)
 {
 
    bool      RetStatus = false;
    size_t    ObjLoadCnt;
 
    memset(&MqttTopicRate->TlmMsg.Payload, 0, sizeof(MQTT_GW_RateTlm_Payload_t));
-OS_printf("LoadJsonData() %s, %d\n",JsonMsgPayload, PayloadLen);
-   ObjLoadCnt = CJSON_LoadObjArray(JsonTblObjs, MqttTopicRate->JsonObjCnt, 
+   TRACE_RING_Write(TRACE_RING_MODULE_TOPIC, TRACE_RING_LEVEL_DEBUG, MQTT_TOPIC_RATE_LOAD_JSON_TID,
+                    PayloadLen, 0, JsonMsgPayload, PayloadLen);
+   ObjLoadCnt = CJSON_LoadObjArray(MqttTopicRate->JsonTblObjs, MQTT_TOPIC_RATE_JSON_OBJ_CNT, 
                                   JsonMsgPayload, PayloadLen);
 
-   if (ObjLoadCnt == MqttTopicRate->JsonObjCnt)
+   if (ObjLoadCnt == MQTT_TOPIC_RATE_JSON_OBJ_CNT)
    {
-      memcpy(&MqttTopicRate->TlmMsg.Payload, &RateData, sizeof(MQTT_GW_RateTlm_Payload_t));      
+      memcpy(&MqttTopicRate->TlmMsg.Payload, &MqttTopicRate->RateData, sizeof(MQTT_GW_RateTlm_Payload_t));      
       RetStatus = true;
    }
    else
    {
       CFE_EVS_SendEvent(MQTT_TOPIC_RATE_JSON_TO_CCSDS_ERR_EID, CFE_EVS_EventType_ERROR, 
                         "Error processing rate topic, payload contained %d of %d data objects",
-                        (unsigned int)ObjLoadCnt, (unsigned int)MqttTopicRate->JsonObjCnt);
+                        (unsigned int)ObjLoadCnt, MQTT_TOPIC_RATE_JSON_OBJ_CNT);
    }
    
    return RetStatus;
@@ -16,7 +16,12 @@
 **   Manage MQTT rate topic
 **
 ** Notes:
-**   None
+**   1. This is a codec type. Each topic that uses it has its own instance
+**      and the instance is passed as the Codec context of every
+**      MQTT_TOPIC_TBL_VirtualFunc_t call.
+**   2. Encode and decode use separate instance buffers so one task may
+**      encode while another task decodes. Concurrent encodes or concurrent
+**      decodes of the same instance must be serialized by the caller.
 **
 ** References:
 **   1. OpenSatKit Object-based Application Developer's Guide
@@ -32,6 +37,7 @@
 */
 
 #include "app_cfg.h"
+#include "trace_ring.h"
 
 
 /***********************/
@@ -45,6 +51,14 @@
 
 #define MQTT_TOPIC_RATE_JSON_TO_CCSDS_ERR_EID (MQTT_TOPIC_RATE_BASE_EID + 0)
 
+/*
+** Trace Point IDs
+*/
+
+#define MQTT_TOPIC_RATE_LOAD_JSON_TID  1  /* Param: Payload length. Text: Payload */
+
+#define MQTT_TOPIC_RATE_JSON_OBJ_CNT   3
+
 
 /**********************/
 /** Type Definitions **/
@@ -71,30 +85,26 @@ typedef struct
 {
 
    /*
-   ** Rate Telemetry
+   ** Decode: JSON to rate telemetry
+   */
+   
+   MQTT_GW_RateTlm_t          TlmMsg;
+   MQTT_GW_RateTlm_Payload_t  RateData;   /* Working buffer for loads */
+   CJSON_Obj_t                JsonTblObjs[MQTT_TOPIC_RATE_JSON_OBJ_CNT];
+
+   /*
+   ** Encode: Rate telemetry to JSON
    */
    
-   MQTT_GW_RateTlm_t  TlmMsg;
-   char               JsonMsgTopic[MQTT_TOPIC_TBL_MAX_TOPIC_LEN];
    char               JsonMsgPayload[1024];
 
    /*
-   ** SB test puts rate on a single axis for N cycles
+   ** Load generator fill puts rate on a single axis for N messages
    */
    
-   MQTT_TOPIC_RATE_TestAxis_t  TestAxis;
-   uint16                      TestAxisCycleCnt;
    uint16                      TestAxisCycleLim;
    float                       TestAxisDefRate;
-   float                       TestAxisRate;
    
-   /*
-   ** Subset of the standard CJSON table data because this isn't using the OSK
-   ** table manager service, but is using core-json in the same way as an OSK
-   ** table.
-   */
-   size_t  JsonObjCnt;
-
    uint32  CfeToJsonCnt;
    uint32  JsonToCfeCnt;
    
@@ -110,14 +120,15 @@ typedef struct
 /******************************************************************************
 ** Function: MQTT_TOPIC_RATE_Constructor
 **
-** Initialize the MQTT rate topic
+** Initialize a MQTT rate topic codec instance
 **
 ** Notes:
-**   None
+**   1. TlmMsgMid initializes the telemetry header. Decoded messages are
+**      given their topic's message ID by MSG_TRANS.
 **
 */
-void MQTT_TOPIC_RATE_Constructor(MQTT_TOPIC_RATE_Class_t *MqttTopicRatePtr,
-                                 CFE_SB_MsgId_t TlmMsgMid, const char *Topic);
+void MQTT_TOPIC_RATE_Constructor(MQTT_TOPIC_RATE_Class_t *MqttTopicRate,
+                                 CFE_SB_MsgId_t TlmMsgMid);
 
 
 /******************************************************************************
@@ -128,7 +139,7 @@ void MQTT_TOPIC_RATE_Constructor(MQTT_TOPIC_RATE_Class_t *MqttTopicRatePtr,
 ** Notes:
 **   1.  Signature must match MQTT_TOPIC_TBL_CfeToJson_t
 */
-bool MQTT_TOPIC_RATE_CfeToJson(const char **JsonMsgTopic, const char **JsonMsgPayload,
+bool MQTT_TOPIC_RATE_CfeToJson(void *Codec, const char **JsonMsgPayload,
                                const CFE_MSG_Message_t *CfeMsg);
 
 
@@ -140,17 +151,21 @@ bool MQTT_TOPIC_RATE_CfeToJson(const char **JsonMsgTopic, const char **JsonMsgPa
 ** Notes:
 **   1.  Signature must match MQTT_TOPIC_TBL_JsonToCfe_t
 */
-bool MQTT_TOPIC_RATE_JsonToCfe(CFE_MSG_Message_t **CfeMsg, 
+bool MQTT_TOPIC_RATE_JsonToCfe(void *Codec, CFE_MSG_Message_t **CfeMsg, 
                                const char *JsonMsgPayload, uint16 PayloadLen);
 
 /******************************************************************************
-** Function: MQTT_TOPIC_RATE_SbMsgTest
+** Function: MQTT_TOPIC_RATE_SbMsgFill
 **
-** Generate and send SB rate topic messages on SB that are read back by MQTT_GW
-** and cause MQTT messages to be generated from the SB messages.  
+** Fill a load generator SB message with a rate that rotates between axes.
 **
+** Notes:
+**   1.  Signature must match MQTT_TOPIC_TBL_SbMsgFill_t
+**   2.  The message is not modified if MsgSize is too small for a rate
+**       telemetry packet.
 */
-void MQTT_TOPIC_RATE_SbMsgTest(bool Init, int16 Param);
+void MQTT_TOPIC_RATE_SbMsgFill(void *Codec, CFE_MSG_Message_t *SbMsg, CFE_MSG_Size_t MsgSize,
+                               uint32 Seq, int16 Param);
 
 
 #endif /* _mqtt_topic_rate_ */
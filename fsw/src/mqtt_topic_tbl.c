@@ -29,19 +29,36 @@
 ** Include Files:
 */
 
+#include <ctype.h>
+#include <stdlib.h>
 #include <string.h>
 #include "mqtt_topic_tbl.h"
 #include "mqtt_topic_rate.h"
+#include "mqtt_topic_probe.h"
 
 
 /************************************/
 /** Local File Function Prototypes **/
 /************************************/
 
-static bool LoadJsonData(size_t JsonFileLen);
-static bool StubCfeToJson(const char **JsonMsgTopic, const char **JsonMsgPayload, const CFE_MSG_Message_t *CfeMsg);
-static bool StubJsonToCfe(CFE_MSG_Message_t **CfeMsg, const char *JsonMsgPayload, uint16 PayloadLen);
-static void StubSbMsgTest(bool Init, int16 Param);
+static void *CodecInst(const MQTT_TOPIC_TBL_Data_t *Data, uint8 CodecType, uint16 InstIdx);
+static uint32 HashName(const char *Name, uint16 NameLen);
+static void InitTblData(MQTT_TOPIC_TBL_Data_t *Data);
+static bool LoadEntry(const char *JsonObj, size_t JsonObjLen, uint16 ArrayIdx);
+static bool LoadFile(const char *Filename);
+static uint16 NameIndexSlot(const MQTT_TOPIC_TBL_Data_t *Data, const char *Name,
+                            uint16 NameLen, uint32 NameHash);
+static bool ParseUint(const char *Value, size_t ValueLen, JSONTypes_t ValueType,
+                      uint32 MaxValue, uint32 *Number);
+static bool ReadersQuiescent(void);
+static bool RenderName(char *Name, size_t *NameLen, uint8 *NameKey,
+                       const char *Template, size_t TemplateLen);
+static bool ScanChar(char c);
+static bool SnapshotValidId(const MQTT_TOPIC_TBL_Data_t *Data, uint16 Idx);
+static bool WaitForReaders(void);
+static bool StubCfeToJson(void *Codec, const char **JsonMsgPayload, const CFE_MSG_Message_t *CfeMsg);
+static bool StubJsonToCfe(void *Codec, CFE_MSG_Message_t **CfeMsg, const char *JsonMsgPayload, uint16 PayloadLen);
+static void StubSbMsgFill(void *Codec, CFE_MSG_Message_t *SbMsg, CFE_MSG_Size_t MsgSize, uint32 Seq, int16 Param);
 
 
 /**********************/
@@ -50,45 +67,42 @@ static void StubSbMsgTest(bool Init, int16 Param);
 
 static MQTT_TOPIC_TBL_Class_t* MqttTopicTbl = NULL;
 
-static MQTT_TOPIC_TBL_Data_t TblData; /* Working buffer for loads */
+static MQTT_TOPIC_TBL_Data_t *TblData = NULL; /* Inactive buffer being built by a load */
 
-static CJSON_Obj_t JsonTblObjs[] = 
+static const char *SbRoleStr[] =
 {
-
-   /* Table Data Address         Table Data Length  Updated, Data Type,  Float  core-json query string, length of query string(exclude '\0') */
-   
-   { &TblData.Entry[0].Name,     OS_MAX_PATH_LEN,   false,   JSONString, false, { "topic[0].name",       (sizeof("topic[0].name")-1)}   },
-   { &TblData.Entry[0].Id,       2,                 false,   JSONNumber, false, { "topic[0].id",         (sizeof("topic[0].id")-1)}     },
-   { &TblData.Entry[0].SbRole,   OS_MAX_PATH_LEN,   false,   JSONString, false, { "topic[0].sb-role",    (sizeof("topic[0].sb-role")-1)}},
-   { &TblData.Entry[1].Name,     OS_MAX_PATH_LEN,   false,   JSONString, false, { "topic[1].name",       (sizeof("topic[1].name")-1)}   },
-   { &TblData.Entry[1].Id,       2,                 false,   JSONNumber, false, { "topic[1].id",         (sizeof("topic[1].id")-1)}     },
-   { &TblData.Entry[1].SbRole,   OS_MAX_PATH_LEN,   false,   JSONString, false, { "topic[1].sb-role",    (sizeof("topic[1].sb-role")-1)}},
-   { &TblData.Entry[2].Name,     OS_MAX_PATH_LEN,   false,   JSONString, false, { "topic[2].name",       (sizeof("topic[2].name")-1)}   },
-   { &TblData.Entry[2].Id,       2,                 false,   JSONNumber, false, { "topic[2].id",         (sizeof("topic[2].id")-1)}     },
-   { &TblData.Entry[2].SbRole,   OS_MAX_PATH_LEN,   false,   JSONString, false, { "topic[2].sb-role",    (sizeof("topic[2].sb-role")-1)}},
-   { &TblData.Entry[3].Name,     OS_MAX_PATH_LEN,   false,   JSONString, false, { "topic[3].name",       (sizeof("topic[3].name")-1)}   },
-   { &TblData.Entry[3].Id,       2,                 false,   JSONNumber, false, { "topic[3].id",         (sizeof("topic[3].id")-1)}     },
-   { &TblData.Entry[3].SbRole,   OS_MAX_PATH_LEN,   false,   JSONString, false, { "topic[3].sb-role",    (sizeof("topic[3].sb-role")-1)}},
-   { &TblData.Entry[4].Name,     OS_MAX_PATH_LEN,   false,   JSONString, false, { "topic[4].name",       (sizeof("topic[4].name")-1)}   },
-   { &TblData.Entry[4].Id,       2,                 false,   JSONNumber, false, { "topic[4].id",         (sizeof("topic[4].id")-1)}     },
-   { &TblData.Entry[4].SbRole,   OS_MAX_PATH_LEN,   false,   JSONString, false, { "topic[4].sb-role",    (sizeof("topic[4].sb-role")-1)}}
-   
+   "undef",
+   "pub",
+   "sub"
 };
 
 /*
-** The indices into this table must match the topic IDs in the mqtt_topic-json file
+** Codec types indexed by MQTT_TOPIC_TBL_CodecType_t. A topic's 'codec' must
+** be one of the CodecStr[] names. Topics without a 'codec' use the stub.
 */
 
-static MQTT_TOPIC_TBL_VirtualFunc_t VirtualFunc[] =
+static const char *CodecStr[] =
 {
-   { MQTT_TOPIC_RATE_CfeToJson, MQTT_TOPIC_RATE_JsonToCfe, MQTT_TOPIC_RATE_SbMsgTest },
-   { StubCfeToJson, StubJsonToCfe, StubSbMsgTest },
-   { StubCfeToJson, StubJsonToCfe, StubSbMsgTest },
-   { StubCfeToJson, StubJsonToCfe, StubSbMsgTest },
-   { StubCfeToJson, StubJsonToCfe, StubSbMsgTest }
-   
+   "stub",
+   "rate",
+   "probe"
+};
+
+static const MQTT_TOPIC_TBL_VirtualFunc_t CodecFunc[] =
+{
+   { StubCfeToJson, StubJsonToCfe, StubSbMsgFill, 0 },
+   { MQTT_TOPIC_RATE_CfeToJson, MQTT_TOPIC_RATE_JsonToCfe, MQTT_TOPIC_RATE_SbMsgFill, sizeof(MQTT_GW_RateTlm_t) },
+   { MQTT_TOPIC_PROBE_CfeToJson, MQTT_TOPIC_PROBE_JsonToCfe, MQTT_TOPIC_PROBE_SbMsgFill, sizeof(MQTT_TOPIC_PROBE_Pkt_t) }
+};
+
+static const uint16 CodecInstLim[] =
+{
+   MQTT_TOPIC_TBL_MAX_TOPICS,  /* Stub has no instance data */
+   MQTT_TOPIC_RATE_INST_CNT,
+   MQTT_TOPIC_PROBE_INST_CNT
 };
 
+
 /******************************************************************************
 ** Function: MQTT_TOPIC_TBL_Constructor
 **
@@ -97,27 +111,44 @@ static MQTT_TOPIC_TBL_VirtualFunc_t VirtualFunc[] =
 **
 */
 void MQTT_TOPIC_TBL_Constructor(MQTT_TOPIC_TBL_Class_t *MqttTopicTblPtr, 
-                               const char *AppName, uint32 TopicBaseMid)
+                               const char *AppName, uint32 TopicBaseMid,
+                               const uint32 *ReservedMid, uint32 ProbeMid)
 {
 
-   uint8 i;
+   uint16 i, Bank;
+   
    MqttTopicTbl = MqttTopicTblPtr;
 
    CFE_PSP_MemSet(MqttTopicTbl, 0, sizeof(MQTT_TOPIC_TBL_Class_t));
 
    MqttTopicTbl->AppName = AppName;
-   MqttTopicTbl->JsonObjCnt = (sizeof(JsonTblObjs)/sizeof(CJSON_Obj_t));
+   MqttTopicTbl->TopicBaseMid = TopicBaseMid;
+   memcpy(MqttTopicTbl->ReservedMid, ReservedMid, sizeof(MqttTopicTbl->ReservedMid));
+   MqttTopicTbl->ProbeMid = ProbeMid;
    
-   for (i=0; i < MQTT_TOPIC_TBL_MAX_TOPICS; i++)
+   InitTblData(&MqttTopicTbl->Buf[0]);
+   MqttTopicTbl->Active = &MqttTopicTbl->Buf[0];
+   MqttTopicTbl->GracePeriod = 1;
+   
+   MQTT_TOPIC_RATE_Constructor(&MqttTopicTbl->PrivateRate, CFE_SB_ValueToMsgId(TopicBaseMid));
+   for (Bank=0; Bank < 2; Bank++)
    {
-      MqttTopicTbl->Data.Entry[i].Id = MQTT_TOPIC_TBL_UNUSED_ID;
+      for (i=0; i < MQTT_TOPIC_RATE_INST_CNT; i++)
+      {
+         MQTT_TOPIC_RATE_Constructor(&MqttTopicTbl->Rate[Bank][i], 
+                                     CFE_SB_ValueToMsgId(TopicBaseMid));
+      }
    }
    
-   // TODO - Use topic definition from table in constructors
-   MQTT_TOPIC_RATE_Constructor(&MqttTopicTbl->Rate, 
-                               CFE_SB_ValueToMsgId(TopicBaseMid+0),
-                               "osk/rate");
-   
+   MQTT_TOPIC_PROBE_Constructor(&MqttTopicTbl->PrivateProbe, CFE_SB_ValueToMsgId(ProbeMid));
+   for (Bank=0; Bank < 2; Bank++)
+   {
+      for (i=0; i < MQTT_TOPIC_PROBE_INST_CNT; i++)
+      {
+         MQTT_TOPIC_PROBE_Constructor(&MqttTopicTbl->Probe[Bank][i], 
+                                      CFE_SB_ValueToMsgId(ProbeMid));
+      }
+   }
    
 } /* End MQTT_TOPIC_TBL_Constructor() */
 
@@ -138,16 +169,20 @@ void MQTT_TOPIC_TBL_Constructor(MQTT_TOPIC_TBL_Class_t *MqttTopicTblPtr,
 bool MQTT_TOPIC_TBL_DumpCmd(TBLMGR_Tbl_t* Tbl, uint8 DumpType, const char* Filename)
 {
 
-   uint8      i;
+   uint16     i;
+   uint16     DumpCnt = 0;
    bool       RetStatus = false;
    int32      SysStatus;
    osal_id_t  FileHandle;
    os_err_name_t OsErrStr;
-   char DumpRecord[256];
+   const MQTT_TOPIC_TBL_Data_t  *Data = MQTT_TOPIC_TBL_GetData();
+   const MQTT_TOPIC_TBL_Entry_t *Entry;
+   char DumpRecord[256 + MQTT_TOPIC_TBL_MAX_TOPIC_LEN];
    char SysTimeStr[128];
+   char TagStr[32];
 
    
-   SysStatus = OS_OpenCreate(&FileHandle, Filename, OS_FILE_FLAG_CREATE, OS_READ_WRITE);
+   SysStatus = OS_OpenCreate(&FileHandle, Filename, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_READ_WRITE);
 
    if (SysStatus == OS_SUCCESS)
    {
@@ -159,25 +194,33 @@ bool MQTT_TOPIC_TBL_DumpCmd(TBLMGR_Tbl_t* Tbl, uint8 DumpType, const char* Filen
       sprintf(DumpRecord,"   \"description\": \"Table dumped at %s\",\n",SysTimeStr);
       OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
 
-      sprintf(DumpRecord,"   \"topics\": [\n");
+      sprintf(DumpRecord,"   \"topic\": [\n");
       OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
 
-      for (i=0; i < MQTT_TOPIC_TBL_MAX_TOPICS; i++)
+      for (i=0; i < Data->TopicCnt; i++)
       {
-         if (MqttTopicTbl->Data.Entry[i].Id != MQTT_TOPIC_TBL_UNUSED_ID)
+         Entry = &Data->Entry[i];
+         if (Entry->Id != MQTT_TOPIC_TBL_UNUSED_ID)
          {
-            if (i > 0)
+            if (DumpCnt > 0)
             {
                sprintf(DumpRecord,",\n");
                OS_write(FileHandle,DumpRecord,strlen(DumpRecord));      
             }
-            sprintf(DumpRecord,"   {\n         \"name\": \"%s\",\n         \"id\": %d\n      }",
-                    MqttTopicTbl->Data.Entry[i].Name, MqttTopicTbl->Data.Entry[i].Id);
+            TagStr[0] = '\0';
+            if (Entry->MuxIdx != MQTT_TOPIC_TBL_MUX_NONE)
+            {
+               sprintf(TagStr,",\n         \"tag\": %u", Entry->MuxTag);
+            }
+            sprintf(DumpRecord,"      {\n         \"name\": \"%s\",\n         \"id\": %d,\n         \"sb-mid\": %u,\n         \"sb-role\": \"%s\",\n         \"codec\": \"%s\",\n         \"retain\": %s,\n         \"dedup\": %u%s\n      }",
+                    &Data->Arena[Entry->NameOffset], Entry->Id, (unsigned int)Entry->SbMid, SbRoleStr[Entry->SbRole],
+                    CodecStr[Entry->CodecType], (Entry->Retain ? "true" : "false"), Entry->DedupTime, TagStr);
             OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+            ++DumpCnt;
          }
       }
 
-      sprintf(DumpRecord,"   ]\n}\n");
+      sprintf(DumpRecord,"\n   ]\n}\n");
       OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
 
       OS_close(FileHandle);
@@ -200,46 +243,139 @@ bool MQTT_TOPIC_TBL_DumpCmd(TBLMGR_Tbl_t* Tbl, uint8 DumpType, const char* Filen
 
 
 /******************************************************************************
-** Function: MQTT_TOPIC_TBL_GetCfeToJson
+** Function: MQTT_TOPIC_TBL_FindMid
+**
+*/
+uint16 MQTT_TOPIC_TBL_FindMid(uint32 MidValue)
+{
+
+   return MQTT_TOPIC_TBL_FindSnapshotMid(MQTT_TOPIC_TBL_GetData(), MidValue);
+
+} /* End MQTT_TOPIC_TBL_FindMid() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_FindName
+**
+*/
+uint16 MQTT_TOPIC_TBL_FindName(const char *Name, uint16 NameLen)
+{
+
+   return MQTT_TOPIC_TBL_FindSnapshotName(MQTT_TOPIC_TBL_GetData(), Name, NameLen);
+
+} /* End MQTT_TOPIC_TBL_FindName() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_FindSnapshotMid
+**
+*/
+uint16 MQTT_TOPIC_TBL_FindSnapshotMid(const MQTT_TOPIC_TBL_Data_t *Data, uint32 MidValue)
+{
+
+   uint16 Id = MQTT_TOPIC_TBL_UNUSED_ID;
+   
+   if (MidValue < MQTT_TOPIC_TBL_MID_INDEX_LEN)
+   {
+      Id = Data->MidIndex[MidValue];
+   }
+   
+   return Id;
+
+} /* End MQTT_TOPIC_TBL_FindSnapshotMid() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_FindSnapshotName
+**
+*/
+uint16 MQTT_TOPIC_TBL_FindSnapshotName(const MQTT_TOPIC_TBL_Data_t *Data,
+                                       const char *Name, uint16 NameLen)
+{
+
+   uint16 Slot = NameIndexSlot(Data, Name, NameLen, HashName(Name, NameLen));
+
+   return Data->NameIndex[Slot];
+
+} /* End MQTT_TOPIC_TBL_FindSnapshotName() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_FindTag
+**
+*/
+uint16 MQTT_TOPIC_TBL_FindTag(uint16 Idx, uint32 Tag)
+{
+
+   const MQTT_TOPIC_TBL_Data_t *Data = MQTT_TOPIC_TBL_GetData();
+   uint16 Id = MQTT_TOPIC_TBL_UNUSED_ID;
+   
+   if (SnapshotValidId(Data, Idx) && Data->Entry[Idx].MuxIdx != MQTT_TOPIC_TBL_MUX_NONE &&
+       Tag < MQTT_TOPIC_TBL_MAX_MUX_TAGS)
+   {
+      Id = Data->MuxIndex[Data->Entry[Idx].MuxIdx][Tag];
+   }
+   
+   return Id;
+
+} /* End MQTT_TOPIC_TBL_FindTag() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_GetCodec
 **
-** Return a pointer to the CfeToJson conversion function for 'Idx'.
+** Return a pointer to the codec of the topic identified by 'Idx'.
 ** 
 ** Notes:
 **   1. Idx must be less than MQTT_TOPIC_TBL_MAX_TOPICS
 **
 */
-MQTT_TOPIC_TBL_CfeToJson_t MQTT_TOPIC_TBL_GetCfeToJson(uint8 Idx)
+const MQTT_TOPIC_TBL_Codec_t *MQTT_TOPIC_TBL_GetCodec(uint16 Idx)
 {
 
-   MQTT_TOPIC_TBL_CfeToJson_t CfeToJsonFunc = NULL;
+   const MQTT_TOPIC_TBL_Data_t  *Data  = MQTT_TOPIC_TBL_GetData();
+   const MQTT_TOPIC_TBL_Codec_t *Codec = NULL;
    
-   if (MQTT_TOPIC_TBL_ValidId(Idx))
+   if (SnapshotValidId(Data, Idx))
    {
-         CfeToJsonFunc = VirtualFunc[Idx].CfeToJson;
+      Codec = &Data->Codec[Idx];
    }
 
-   return CfeToJsonFunc;
+   return Codec;
    
-} /* End MQTT_TOPIC_TBL_GetCfeToJson() */
+} /* End MQTT_TOPIC_TBL_GetCodec() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_GetData
+**
+*/
+const MQTT_TOPIC_TBL_Data_t *MQTT_TOPIC_TBL_GetData(void)
+{
+
+   return __atomic_load_n(&MqttTopicTbl->Active, __ATOMIC_ACQUIRE);
+
+} /* End MQTT_TOPIC_TBL_GetData() */
 
 
 /******************************************************************************
 ** Function: MQTT_TOPIC_TBL_GetEntry
 **
-** Return a pointer to the table entry ide=entified by 'i'.
+** Return a pointer to the table entry identified by 'Idx'.
 ** 
 ** Notes:
-**   1. i must be less than MQTT_TOPIC_TBL_MAX_TOPICS
+**   1. Idx must be less than MQTT_TOPIC_TBL_MAX_TOPICS
 **
 */
-const MQTT_TOPIC_TBL_Entry_t *MQTT_TOPIC_TBL_GetEntry(uint8 Idx)
+const MQTT_TOPIC_TBL_Entry_t *MQTT_TOPIC_TBL_GetEntry(uint16 Idx)
 {
 
-   MQTT_TOPIC_TBL_Entry_t *Entry = NULL;
+   const MQTT_TOPIC_TBL_Data_t  *Data  = MQTT_TOPIC_TBL_GetData();
+   const MQTT_TOPIC_TBL_Entry_t *Entry = NULL;
    
-   if (MQTT_TOPIC_TBL_ValidId(Idx))
+   if (SnapshotValidId(Data, Idx))
    {
-      Entry = &MqttTopicTbl->Data.Entry[Idx];
+      Entry = &Data->Entry[Idx];
    }
 
    return Entry;
@@ -248,27 +384,134 @@ const MQTT_TOPIC_TBL_Entry_t *MQTT_TOPIC_TBL_GetEntry(uint8 Idx)
 
 
 /******************************************************************************
-** Function: MQTT_TOPIC_TBL_GetJsonToCfe
+** Function: MQTT_TOPIC_TBL_GetMuxCnt
 **
-** Return a pointer to the JsonToCfe conversion function for 'Idx'.
-** 
-** Notes:
-**   1. Idx must be less than MQTT_TOPIC_TBL_MAX_TOPICS
+*/
+uint16 MQTT_TOPIC_TBL_GetMuxCnt(void)
+{
+
+   return MQTT_TOPIC_TBL_GetData()->MuxCnt;
+   
+} /* End MQTT_TOPIC_TBL_GetMuxCnt() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_GetName
 **
 */
-MQTT_TOPIC_TBL_JsonToCfe_t MQTT_TOPIC_TBL_GetJsonToCfe(uint8 Idx)
+const char *MQTT_TOPIC_TBL_GetName(uint16 Idx)
 {
 
-   MQTT_TOPIC_TBL_JsonToCfe_t JsonToCfeFunc = NULL;
+   const MQTT_TOPIC_TBL_Data_t *Data = MQTT_TOPIC_TBL_GetData();
+   const char *Name = NULL;
    
-   if (MQTT_TOPIC_TBL_ValidId(Idx))
+   if (SnapshotValidId(Data, Idx))
    {
-      JsonToCfeFunc = VirtualFunc[Idx].JsonToCfe;
+      Name = MQTT_TOPIC_TBL_DATA_NAME(Data, Idx);
    }
 
-   return JsonToCfeFunc;
+   return Name;
+   
+} /* End MQTT_TOPIC_TBL_GetName() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_GetPrivateCodec
+**
+*/
+bool MQTT_TOPIC_TBL_GetPrivateCodec(uint16 Idx, MQTT_TOPIC_TBL_Codec_t *Codec)
+{
+
+   const MQTT_TOPIC_TBL_Data_t *Data = MQTT_TOPIC_TBL_GetData();
+   bool RetStatus = false;
+   
+   if (SnapshotValidId(Data, Idx))
+   {
+      
+      Codec->Func = Data->Codec[Idx].Func;
+      Codec->Inst = NULL;
+      
+      switch (Data->Entry[Idx].CodecType)
+      {
+         case MQTT_TOPIC_TBL_CODEC_RATE:
+            Codec->Inst = &MqttTopicTbl->PrivateRate;
+            break;
+         case MQTT_TOPIC_TBL_CODEC_PROBE:
+            Codec->Inst = &MqttTopicTbl->PrivateProbe;
+            break;
+         default:
+            break;
+      }
+      RetStatus = true;
+      
+   } /* End if valid topic */
+
+   return RetStatus;
+   
+} /* End MQTT_TOPIC_TBL_GetPrivateCodec() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_GetSbTopicName
+**
+** Notes:
+**   1. The cache is direct mapped by topic ID and key value. A collision
+**      replaces the slot's name.
+**   2. A rendered {apid} is never longer than the "{apid}" field because
+**      an APID has at most four digits.
+**
+*/
+const char *MQTT_TOPIC_TBL_GetSbTopicName(uint16 Idx, const CFE_MSG_Message_t *SbMsg)
+{
+
+   const MQTT_TOPIC_TBL_Data_t *Data = MQTT_TOPIC_TBL_GetData();
+   const char *Name = NULL;
+   const char *Key;
+   CFE_MSG_ApId_t ApId = 0;
+   MQTT_TOPIC_TBL_NameCache_t *Cache;
+   
+   if (SnapshotValidId(Data, Idx))
+   {
+      
+      Name = MQTT_TOPIC_TBL_DATA_NAME(Data, Idx);
+      
+      if (Data->Entry[Idx].NameKey == MQTT_TOPIC_TBL_NAME_KEY_APID)
+      {
+      
+         CFE_MSG_GetApId(SbMsg, &ApId);
+         Cache = &MqttTopicTbl->NameCache[(Idx * 31 + ApId) & (MQTT_TOPIC_TBL_NAME_CACHE_LEN - 1)];
+         
+         if (Cache->Generation != Data->Generation || Cache->Id != Idx || Cache->KeyValue != ApId)
+         {
+            Key = strstr(Name, "{apid}");
+            snprintf(Cache->Name, MQTT_TOPIC_TBL_MAX_TOPIC_LEN, "%.*s%u%s",
+                     (int)(Key - Name), Name, (unsigned int)ApId, &Key[6]);
+            Cache->Generation = Data->Generation;
+            Cache->Id         = Idx;
+            Cache->KeyValue   = ApId;
+            ++MqttTopicTbl->NameCacheMissCnt;
+         }
+         Name = Cache->Name;
+      
+      } /* End if per-message key */
+   
+   } /* End if valid topic */
+   
+   return Name;
+   
+} /* End MQTT_TOPIC_TBL_GetSbTopicName() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_GetTopicCnt
+**
+*/
+uint16 MQTT_TOPIC_TBL_GetTopicCnt(void)
+{
+
+   return MQTT_TOPIC_TBL_GetData()->TopicCnt;
    
-} /* End MQTT_TOPIC_TBL_GetJsonToCfe() */
+} /* End MQTT_TOPIC_TBL_GetTopicCnt() */
 
 
 /******************************************************************************
@@ -278,13 +521,17 @@ MQTT_TOPIC_TBL_JsonToCfe_t MQTT_TOPIC_TBL_GetJsonToCfe(uint8 Idx)
 **  1. Function signature must match TBLMGR_LoadTblFuncPtr_t.
 **  2. This could migrate into table manager but I think I'll keep it here so
 **     user's can add table processing code if needed.
+**  3. The file is streamed by LoadFile() rather than read into a buffer by
+**     CJSON_ProcessFile() so the table size is not limited by a file buffer.
+**  4. The new table is built in the inactive snapshot buffer so it can't be
+**     started until the buffer's grace period has ended.
 */
 bool MQTT_TOPIC_TBL_LoadCmd(TBLMGR_Tbl_t* Tbl, uint8 LoadType, const char* Filename)
 {
 
    bool  RetStatus = false;
 
-   if (CJSON_ProcessFile(Filename, MqttTopicTbl->JsonBuf, MQTT_TOPIC_TBL_JSON_FILE_MAX_CHAR, LoadJsonData))
+   if (WaitForReaders() && LoadFile(Filename))
    {
       
       MqttTopicTbl->Loaded = true;
@@ -305,162 +552,1036 @@ bool MQTT_TOPIC_TBL_LoadCmd(TBLMGR_Tbl_t* Tbl, uint8 LoadType, const char* Filen
 
 
 /******************************************************************************
-** Function: MQTT_TOPIC_TBL_ResetStatus
+** Function: MQTT_TOPIC_TBL_ReaderOffline
 **
 */
-void MQTT_TOPIC_TBL_ResetStatus(void)
+void MQTT_TOPIC_TBL_ReaderOffline(MQTT_TOPIC_TBL_Reader_t Reader)
 {
 
-   MqttTopicTbl->LastLoadStatus = TBLMGR_STATUS_UNDEF;
-   MqttTopicTbl->LastLoadCnt = 0;
- 
-} /* End MQTT_TOPIC_TBL_ResetStatus() */
+   __atomic_store_n(&MqttTopicTbl->ReaderPeriod[Reader], 0, __ATOMIC_SEQ_CST);
+
+} /* End MQTT_TOPIC_TBL_ReaderOffline() */
 
 
 /******************************************************************************
-** Function: MQTT_TOPIC_TBL_RunSbMsgTest
-**
-** Notes:
-**   1. Assumes Idx has been verified and that the VirtaulFunc array does not
-**      have any NULL pointers 
+** Function: MQTT_TOPIC_TBL_ReaderQuiescent
 **
 */
-void MQTT_TOPIC_TBL_RunSbMsgTest(uint8 Idx, bool Init, int16 Param)
+void MQTT_TOPIC_TBL_ReaderQuiescent(MQTT_TOPIC_TBL_Reader_t Reader)
 {
 
-   (VirtualFunc[Idx].SbMsgTest)(Init, Param);
+   __atomic_store_n(&MqttTopicTbl->ReaderPeriod[Reader], 
+                    __atomic_load_n(&MqttTopicTbl->GracePeriod, __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
 
-} /* End MQTT_TOPIC_TBL_RunSbMsgTest() */
+} /* End MQTT_TOPIC_TBL_ReaderQuiescent() */
 
 
 /******************************************************************************
-** Function: MQTT_TOPIC_TBL_ValidId
+** Function: MQTT_TOPIC_TBL_ReservedMid
 **
-** In addition to being in range, valid means that the ID has been defined.
 */
-bool MQTT_TOPIC_TBL_ValidId(uint8 Idx)
+bool MQTT_TOPIC_TBL_ReservedMid(uint32 MidValue)
 {
 
-   bool RetStatus = false;
-   
-   if (Idx < MQTT_TOPIC_TBL_MAX_TOPICS)
-   {
-      if (MqttTopicTbl->Data.Entry[Idx].Id != MQTT_TOPIC_TBL_UNUSED_ID)
-      {
-         RetStatus = true;
-      }
-   }
-   else
+   bool   RetStatus = (MqttTopicTbl->ProbeMid == MidValue);
+   uint16 i;
+
+   for (i=0; i < MQTT_TOPIC_TBL_RESERVED_MID_CNT && !RetStatus; i++)
    {
-      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_INDEX_ERR_EID, CFE_EVS_EventType_ERROR, 
-                        "Table index %d is out of range. It must less than %d",
-                        Idx, MQTT_TOPIC_TBL_MAX_TOPICS);
+      RetStatus = (MqttTopicTbl->ReservedMid[i] == MidValue);
    }
 
    return RetStatus;
-   
 
-} /* End MQTT_TOPIC_TBL_ValidId() */
+} /* End MQTT_TOPIC_TBL_ReservedMid() */
 
 
 /******************************************************************************
-** Function: LoadJsonData
+** Function: MQTT_TOPIC_TBL_ResetStatus
 **
-** Notes:
-**   None
 */
-static bool LoadJsonData(size_t JsonFileLen)
+void MQTT_TOPIC_TBL_ResetStatus(void)
 {
 
-   bool      RetStatus = false;
-   size_t    ObjLoadCnt;
+   MqttTopicTbl->LastLoadStatus = TBLMGR_STATUS_UNDEF;
+   MqttTopicTbl->LastLoadCnt = 0;
+ 
+} /* End MQTT_TOPIC_TBL_ResetStatus() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_ValidId
+**
+** In addition to being in range, valid means that the ID has been defined.
+*/
+bool MQTT_TOPIC_TBL_ValidId(uint16 Idx)
+{
 
+   return SnapshotValidId(MQTT_TOPIC_TBL_GetData(), Idx);
 
-   MqttTopicTbl->JsonFileLen = JsonFileLen;
+} /* End MQTT_TOPIC_TBL_ValidId() */
 
-   /* 
-   ** 1. Copy table owner data into local table buffer
-   ** 2. Process JSON file which updates local table buffer with JSON supplied values
-   ** 3. If valid, copy local buffer over owner's data 
-   */
-   
-   memcpy(&TblData, &MqttTopicTbl->Data, sizeof(MQTT_TOPIC_TBL_Data_t));
-   
-   ObjLoadCnt = CJSON_LoadObjArray(JsonTblObjs, MqttTopicTbl->JsonObjCnt, MqttTopicTbl->JsonBuf, MqttTopicTbl->JsonFileLen);
 
-   if (!MqttTopicTbl->Loaded && (ObjLoadCnt != MqttTopicTbl->JsonObjCnt))
-   {
+/******************************************************************************
+** Function: CodecInst
+**
+** Return codec instance 'InstIdx' of 'CodecType' from the instance bank of
+** snapshot buffer 'Data'.
+**
+** Notes:
+**   1. InstIdx must be less than the type's CodecInstLim[].
+**   2. An instance is owned by one topic of a table snapshot. Instance
+**      counts restart with each load so the other buffer's bank is never
+**      used. The loaded buffer's bank was last used by the snapshot that
+**      WaitForReaders() retired so no reader can still be using it.
+**
+*/
+static void *CodecInst(const MQTT_TOPIC_TBL_Data_t *Data, uint8 CodecType, uint16 InstIdx)
+{
 
-      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
-                        "Table has never been loaded and new table only contains %d of %d data objects",
-                        (unsigned int)ObjLoadCnt, (unsigned int)MqttTopicTbl->JsonObjCnt);
+   void   *Inst = NULL;
+   uint16  Bank = (Data == &MqttTopicTbl->Buf[0]) ? 0 : 1;
    
-   }
-   else
+   switch (CodecType)
    {
-   
-      memcpy(&MqttTopicTbl->Data,&TblData, sizeof(MQTT_TOPIC_TBL_Data_t));
-      MqttTopicTbl->LastLoadCnt = ObjLoadCnt;
-      RetStatus = true;
-      
+      case MQTT_TOPIC_TBL_CODEC_RATE:
+         Inst = &MqttTopicTbl->Rate[Bank][InstIdx];
+         break;
+      case MQTT_TOPIC_TBL_CODEC_PROBE:
+         Inst = &MqttTopicTbl->Probe[Bank][InstIdx];
+         break;
+      default:
+         break;
    }
    
-   return RetStatus;
-   
-} /* End LoadJsonData() */
+   return Inst;
+
+} /* End CodecInst() */
 
 
 /******************************************************************************
-** Function: StubCfeToJson
+** Function: HashName
 **
-** Provide a CfeToJson stub function to be used as a non-NULL pointer in the
-** VirtualFunc default values.
+** Compute the 32-bit FNV-1a hash of a topic name.
 **
 */
-static bool StubCfeToJson(const char **JsonMsgTopic, const char **JsonMsgPayload, 
-                          const CFE_MSG_Message_t *CfeMsg)
+static uint32 HashName(const char *Name, uint16 NameLen)
 {
 
-   CFE_EVS_SendEvent(MQTT_TOPIC_TBL_STUB_EID, CFE_EVS_EventType_INFORMATION, 
-                     "CfeToJson stub");
+   uint16 i;
+   uint32 Hash = 2166136261u;
 
-   return false;
-   
-} /* End StubCfeToJson() */
+   for (i=0; i < NameLen; i++)
+   {
+      Hash ^= (uint8)Name[i];
+      Hash *= 16777619u;
+   }
+
+   return Hash;
+
+} /* End HashName() */
 
 
 /******************************************************************************
-** Function: StubJsonToCfe
+** Function: InitTblData
 **
-** Provide a CfeToJson stub function to be used as a non-NULL pointer in the
-** VirtualFunc default values.
+** Set a table buffer to an empty table.
 **
 */
-static bool StubJsonToCfe(CFE_MSG_Message_t **CfeMsg, 
-                          const char *JsonMsgPayload, uint16 PayloadLen)
+static void InitTblData(MQTT_TOPIC_TBL_Data_t *Data)
 {
-   
-   CFE_EVS_SendEvent(MQTT_TOPIC_TBL_STUB_EID, CFE_EVS_EventType_INFORMATION, 
-                     "JsonToCfe stub");
 
-   return false;
+   uint16 i, j;
+
+   Data->TopicCnt = 0;
+   Data->ArenaLen = 0;
    
-} /* End StubJsonToCfe() */
+   /* Retire any cached names rendered from the buffer's previous table */
+   Data->Generation = ++MqttTopicTbl->LastGeneration;
+   
+   memset(Data->Dispatch, 0, sizeof(Data->Dispatch));
+   memset(Data->Codec, 0, sizeof(Data->Codec));
+   memset(Data->CodecInstCnt, 0, sizeof(Data->CodecInstCnt));
+   Data->MuxCnt = 0;
+   for (i=0; i < MQTT_TOPIC_TBL_MAX_TOPICS; i++)
+   {
+      Data->Entry[i].Id = MQTT_TOPIC_TBL_UNUSED_ID;
+   }
+   for (i=0; i < MQTT_TOPIC_TBL_NAME_INDEX_LEN; i++)
+   {
+      Data->NameIndex[i] = MQTT_TOPIC_TBL_UNUSED_ID;
+   }
+   for (i=0; i < MQTT_TOPIC_TBL_MID_INDEX_LEN; i++)
+   {
+      Data->MidIndex[i] = MQTT_TOPIC_TBL_UNUSED_ID;
+   }
+   for (i=0; i < MQTT_TOPIC_TBL_MAX_MUX_TOPICS; i++)
+   {
+      for (j=0; j < MQTT_TOPIC_TBL_MAX_MUX_TAGS; j++)
+      {
+         Data->MuxIndex[i][j] = MQTT_TOPIC_TBL_UNUSED_ID;
+      }
+   }
+
+} /* End InitTblData() */
 
 
 /******************************************************************************
-** Function: StubSbMsgTest
+** Function: LoadEntry
 **
-** Provide a CfeToJson stub function to be used as a non-NULL pointer in the
-** VirtualFunc default values.
+** Validate one topic array object and add it to the working table buffer.
+**
+** Notes:
+**   1. Errors are reported with the topic's array index because the topic
+**      ID may be the invalid field.
+**   2. A topic without an 'sb-mid' uses its ID as an offset from the base
+**      message ID. An 'sb-mid' that isn't an integer is rejected.
+**   3. Name checks are applied to the name rendered from the template.
+**   4. A topic without a 'codec' uses the stub codec. Each topic is given
+**      the next free instance of its codec type.
+**   5. 'retain' is optional and defaults to false. 'dedup' is optional
+**      and defaults to 0.
+**   6. A 'tag' makes the topic a member of the multiplexed topic with its
+**      name. The first member creates the multiplexed topic and keeps the
+**      name index slot. Later members reuse its arena name.
+**   7. 'id', 'sb-mid', 'dedup' and 'tag' are parsed with ParseUint() so a
+**      fraction or an out of range value is rejected rather than truncated.
 **
 */
-static void StubSbMsgTest(bool Init, int16 Param)
+static bool LoadEntry(const char *JsonObj, size_t JsonObjLen, uint16 ArrayIdx)
 {
 
-   CFE_EVS_SendEvent(MQTT_TOPIC_TBL_STUB_EID, CFE_EVS_EventType_INFORMATION, 
-                     "SbMsgTest stub");
+   bool         RetStatus = false;
+   char         Name[MQTT_TOPIC_TBL_MAX_TOPIC_LEN];
+   size_t       NameLen = 0;
+   uint8        NameKey = MQTT_TOPIC_TBL_NAME_KEY_NONE;
+   uint32       NameHash;
+   uint16       Slot;
+   const char  *Value;
+   size_t       ValueLen;
+   JSONTypes_t  ValueType;
+   uint32       Id;
+   uint32       SbMid;
+   uint8        SbRole = MQTT_TOPIC_TBL_SB_ROLE_UNDEF;
+   uint8        CodecType = MQTT_TOPIC_TBL_CODEC_STUB;
+   uint8        Retain = 0;
+   bool         RetainValid = true;
+   uint32       DedupTime = 0;
+   uint32       MuxTag = MQTT_TOPIC_TBL_MUX_NONE;
+   uint16       MuxHead;
+   uint8        MuxIdx;
    
-} /* End StubSbMsgTest() */
+   if (JSON_SearchConst(JsonObj, JsonObjLen, "id", 2, &Value, &ValueLen, &ValueType) != JSONValid ||
+       !ParseUint(Value, ValueLen, ValueType, (MQTT_TOPIC_TBL_MAX_TOPICS-1), &Id))
+   {
+      Id = MQTT_TOPIC_TBL_UNUSED_ID;
+   }
 
+   SbMid = MqttTopicTbl->TopicBaseMid + Id;
+   if (JSON_SearchConst(JsonObj, JsonObjLen, "sb-mid", 6, &Value, &ValueLen, &ValueType) == JSONValid &&
+       !ParseUint(Value, ValueLen, ValueType, (MQTT_TOPIC_TBL_MID_INDEX_LEN-1), &SbMid))
+   {
+      SbMid = MQTT_TOPIC_TBL_MID_INDEX_LEN;
+   }
+
+   if (JSON_SearchConst(JsonObj, JsonObjLen, "sb-role", 7, &Value, &ValueLen, &ValueType) == JSONValid &&
+       ValueType == JSONString)
+   {
+      if (ValueLen == 3 && strncmp(Value, "pub", 3) == 0)
+      {
+         SbRole = MQTT_TOPIC_TBL_SB_ROLE_PUB;
+      }
+      else if (ValueLen == 3 && strncmp(Value, "sub", 3) == 0)
+      {
+         SbRole = MQTT_TOPIC_TBL_SB_ROLE_SUB;
+      }
+   }
+   
+   if (JSON_SearchConst(JsonObj, JsonObjLen, "codec", 5, &Value, &ValueLen, &ValueType) == JSONValid)
+   {
+      for (CodecType=0; CodecType < MQTT_TOPIC_TBL_CODEC_CNT; CodecType++)
+      {
+         if (ValueType == JSONString && ValueLen == strlen(CodecStr[CodecType]) &&
+             strncmp(Value, CodecStr[CodecType], ValueLen) == 0)
+         {
+            break;
+         }
+      }
+   }
+   
+   if (JSON_SearchConst(JsonObj, JsonObjLen, "retain", 6, &Value, &ValueLen, &ValueType) == JSONValid)
+   {
+      Retain = (ValueType == JSONTrue);
+      RetainValid = (ValueType == JSONTrue || ValueType == JSONFalse);
+   }
+   
+   if (JSON_SearchConst(JsonObj, JsonObjLen, "dedup", 5, &Value, &ValueLen, &ValueType) == JSONValid &&
+       !ParseUint(Value, ValueLen, ValueType, UINT16_MAX, &DedupTime))
+   {
+      DedupTime = UINT16_MAX + 1;
+   }
+   
+   if (JSON_SearchConst(JsonObj, JsonObjLen, "tag", 3, &Value, &ValueLen, &ValueType) == JSONValid &&
+       !ParseUint(Value, ValueLen, ValueType, (MQTT_TOPIC_TBL_MAX_MUX_TAGS-1), &MuxTag))
+   {
+      MuxTag = MQTT_TOPIC_TBL_MAX_MUX_TAGS;
+   }
+   
+   if (JSON_SearchConst(JsonObj, JsonObjLen, "name", 4, &Value, &ValueLen, &ValueType) != JSONValid ||
+       ValueType != JSONString || !RenderName(Name, &NameLen, &NameKey, Value, ValueLen))
+   {
+      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "Topic[%d] name is missing, has an undefined {key}, or is longer than %d characters",
+                        ArrayIdx, (MQTT_TOPIC_TBL_MAX_TOPIC_LEN-1));
+   }
+   else if (Id >= MQTT_TOPIC_TBL_MAX_TOPICS)
+   {
+      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "Topic[%d] %.*s id is missing or not an integer up to %d",
+                        ArrayIdx, (int)NameLen, Name, (MQTT_TOPIC_TBL_MAX_TOPICS-1));
+   }
+   else if (TblData->Entry[Id].Id != MQTT_TOPIC_TBL_UNUSED_ID)
+   {
+      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "Topic[%d] %.*s id %d is already used by %s",
+                        ArrayIdx, (int)NameLen, Name, (int)Id, &TblData->Arena[TblData->Entry[Id].NameOffset]);
+   }
+   else if (SbRole == MQTT_TOPIC_TBL_SB_ROLE_UNDEF)
+   {
+      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "Topic[%d] %.*s sb-role is missing or not 'pub' or 'sub'",
+                        ArrayIdx, (int)NameLen, Name);
+   }
+   else if (NameKey != MQTT_TOPIC_TBL_NAME_KEY_NONE && SbRole != MQTT_TOPIC_TBL_SB_ROLE_SUB)
+   {
+      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "Topic[%d] %.*s per-message name keys are only allowed for sb-role 'sub'",
+                        ArrayIdx, (int)NameLen, Name);
+   }
+   else if (!RetainValid || (Retain && SbRole != MQTT_TOPIC_TBL_SB_ROLE_SUB))
+   {
+      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "Topic[%d] %.*s retain must be true or false and is only allowed for sb-role 'sub'",
+                        ArrayIdx, (int)NameLen, Name);
+   }
+   else if (DedupTime > UINT16_MAX || (DedupTime > 0 && SbRole != MQTT_TOPIC_TBL_SB_ROLE_SUB))
+   {
+      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "Topic[%d] %.*s dedup must be an integer number of seconds up to %d and is only allowed for sb-role 'sub'",
+                        ArrayIdx, (int)NameLen, Name, UINT16_MAX);
+   }
+   else if (MuxTag != MQTT_TOPIC_TBL_MUX_NONE && MuxTag >= MQTT_TOPIC_TBL_MAX_MUX_TAGS)
+   {
+      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "Topic[%d] %.*s tag is not an integer less than %d",
+                        ArrayIdx, (int)NameLen, Name, MQTT_TOPIC_TBL_MAX_MUX_TAGS);
+   }
+   else if (SbMid >= MQTT_TOPIC_TBL_MID_INDEX_LEN)
+   {
+      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "Topic[%d] %.*s sb-mid is not an integer less than %d",
+                        ArrayIdx, (int)NameLen, Name, MQTT_TOPIC_TBL_MID_INDEX_LEN);
+   }
+   else if ((MQTT_TOPIC_TBL_ReservedMid(SbMid) &&
+             !(CodecType == MQTT_TOPIC_TBL_CODEC_PROBE && SbMid == MqttTopicTbl->ProbeMid)) ||
+            (SbMid == MqttTopicTbl->TopicBaseMid && Id != 0))
+   {
+      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "Topic[%d] %.*s sb-mid 0x%04X is reserved for the app's own messages",
+                        ArrayIdx, (int)NameLen, Name, (unsigned int)SbMid);
+   }
+   else if (CodecType == MQTT_TOPIC_TBL_CODEC_PROBE &&
+            (SbMid != MqttTopicTbl->ProbeMid || SbRole != MQTT_TOPIC_TBL_SB_ROLE_PUB ||
+             MuxTag != MQTT_TOPIC_TBL_MUX_NONE))
+   {
+      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "Topic[%d] %.*s probe codec requires an untagged sb-role 'pub' topic with sb-mid 0x%04X",
+                        ArrayIdx, (int)NameLen, Name, (unsigned int)MqttTopicTbl->ProbeMid);
+   }
+   else if (TblData->MidIndex[SbMid] != MQTT_TOPIC_TBL_UNUSED_ID)
+   {
+      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "Topic[%d] %.*s sb-mid 0x%04X is already used by %s",
+                        ArrayIdx, (int)NameLen, Name, (unsigned int)SbMid,
+                        MQTT_TOPIC_TBL_DATA_NAME(TblData, TblData->MidIndex[SbMid]));
+   }
+   else if (CodecType >= MQTT_TOPIC_TBL_CODEC_CNT)
+   {
+      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "Topic[%d] %.*s codec is not a defined codec type",
+                        ArrayIdx, (int)NameLen, Name);
+   }
+   else if (TblData->CodecInstCnt[CodecType] >= CodecInstLim[CodecType])
+   {
+      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "Topic[%d] %.*s exceeds the %d %s codec instances",
+                        ArrayIdx, (int)NameLen, Name, CodecInstLim[CodecType], CodecStr[CodecType]);
+   }
+   else if ((TblData->ArenaLen + NameLen + 1) > MQTT_TOPIC_TBL_STR_ARENA_LEN)
+   {
+      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "Topic[%d] %.*s exceeds the %d byte topic name arena",
+                        ArrayIdx, (int)NameLen, Name, MQTT_TOPIC_TBL_STR_ARENA_LEN);
+   }
+   else
+   {
+   
+      NameHash = HashName(Name, NameLen);
+      Slot     = NameIndexSlot(TblData, Name, NameLen, NameHash);
+      MuxHead  = TblData->NameIndex[Slot];
+      MuxIdx   = MQTT_TOPIC_TBL_MUX_NONE;
+      
+      if (MuxHead != MQTT_TOPIC_TBL_UNUSED_ID)
+      {
+         MuxIdx = TblData->Entry[MuxHead].MuxIdx;
+      }
+      
+      if (MuxHead != MQTT_TOPIC_TBL_UNUSED_ID &&
+          (MuxTag == MQTT_TOPIC_TBL_MUX_NONE || MuxIdx == MQTT_TOPIC_TBL_MUX_NONE ||
+           TblData->Entry[MuxHead].SbRole != SbRole))
+      {
+         CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                           "Topic[%d] %.*s name is already used by id %d and both topics aren't tagged with the same sb-role",
+                           ArrayIdx, (int)NameLen, Name, MuxHead);
+      }
+      else if (MuxIdx != MQTT_TOPIC_TBL_MUX_NONE &&
+               TblData->MuxIndex[MuxIdx][MuxTag] != MQTT_TOPIC_TBL_UNUSED_ID)
+      {
+         CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                           "Topic[%d] %.*s tag %d is already used by id %d",
+                           ArrayIdx, (int)NameLen, Name, (int)MuxTag, TblData->MuxIndex[MuxIdx][MuxTag]);
+      }
+      else if (MuxHead == MQTT_TOPIC_TBL_UNUSED_ID && MuxTag != MQTT_TOPIC_TBL_MUX_NONE &&
+               TblData->MuxCnt >= MQTT_TOPIC_TBL_MAX_MUX_TOPICS)
+      {
+         CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                           "Topic[%d] %.*s exceeds the %d multiplexed topics",
+                           ArrayIdx, (int)NameLen, Name, MQTT_TOPIC_TBL_MAX_MUX_TOPICS);
+      }
+      else
+      {
+      
+         if (MuxHead == MQTT_TOPIC_TBL_UNUSED_ID)
+         {
+            memcpy(&TblData->Arena[TblData->ArenaLen], Name, NameLen);
+            TblData->Arena[TblData->ArenaLen + NameLen] = '\0';
+            TblData->Entry[Id].NameOffset = TblData->ArenaLen;
+            TblData->ArenaLen += NameLen + 1;
+            
+            TblData->NameIndex[Slot] = Id;
+            if (MuxTag != MQTT_TOPIC_TBL_MUX_NONE)
+            {
+               MuxIdx = TblData->MuxCnt++;
+            }
+         }
+         else
+         {
+            TblData->Entry[Id].NameOffset = TblData->Entry[MuxHead].NameOffset;
+         }
+         
+         TblData->Entry[Id].Id         = Id;
+         TblData->Entry[Id].SbRole     = SbRole;
+         TblData->Entry[Id].SbMid      = SbMid;
+         TblData->Entry[Id].NameKey    = NameKey;
+         TblData->Entry[Id].CodecType  = CodecType;
+         TblData->Entry[Id].Retain     = Retain;
+         TblData->Entry[Id].DedupTime  = DedupTime;
+         TblData->Entry[Id].MuxIdx     = MuxIdx;
+         TblData->Entry[Id].MuxTag     = (MuxIdx == MQTT_TOPIC_TBL_MUX_NONE) ? 0 : MuxTag;
+         
+         TblData->Codec[Id].Func = &CodecFunc[CodecType];
+         TblData->Codec[Id].Inst = CodecInst(TblData, CodecType, TblData->CodecInstCnt[CodecType]++);
+         
+         TblData->Dispatch[Id].NameHash = NameHash;
+         TblData->Dispatch[Id].NameLen  = NameLen;
+         
+         TblData->MidIndex[SbMid] = Id;
+         if (MuxIdx != MQTT_TOPIC_TBL_MUX_NONE)
+         {
+            TblData->MuxIndex[MuxIdx][MuxTag] = Id;
+         }
+         
+         if (Id >= TblData->TopicCnt)
+         {
+            TblData->TopicCnt = Id + 1;
+         }
+         
+         RetStatus = true;
+         
+      }
+   } /* End if valid fields */
+
+   return RetStatus;
+   
+} /* End LoadEntry() */
+
+
+/******************************************************************************
+** Function: LoadFile
+**
+** Notes:
+**   1. The table is built in the inactive buffer and only published if every
+**      topic is valid. The buffer is not touched until every reader has
+**      passed a quiescent point since it was retired.
+**   2. The file is read in MQTT_TOPIC_TBL_LOAD_BUF_LEN blocks and each
+**      character is scanned once. Reading stops at the end of the topic
+**      array.
+*/
+static bool LoadFile(const char *Filename)
+{
+
+   bool       RetStatus = false;
+   int32      SysStatus;
+   int32      ReadLen;
+   int32      i;
+   osal_id_t  FileHandle;
+   os_err_name_t OsErrStr;
+   MQTT_TOPIC_TBL_Loader_t *Loader = &MqttTopicTbl->Loader;
+   
+   TblData = (MqttTopicTbl->Active == &MqttTopicTbl->Buf[0]) ? &MqttTopicTbl->Buf[1] : &MqttTopicTbl->Buf[0];
+   
+   SysStatus = OS_OpenCreate(&FileHandle, Filename, OS_FILE_FLAG_NONE, OS_READ_ONLY);
+
+   if (SysStatus == OS_SUCCESS)
+   {
+   
+      InitTblData(TblData);
+      Loader->State      = MQTT_TOPIC_TBL_LOAD_ROOT;
+      Loader->InString   = false;
+      Loader->Escape     = false;
+      Loader->KeyLen     = 0;
+      Loader->Depth      = 0;
+      Loader->ArrayIdx   = 0;
+      Loader->FileOffset = 0;
+      
+      RetStatus = true;
+      while (RetStatus && Loader->State != MQTT_TOPIC_TBL_LOAD_DONE)
+      {
+      
+         ReadLen = OS_read(FileHandle, Loader->ReadBuf, MQTT_TOPIC_TBL_LOAD_BUF_LEN);
+         if (ReadLen <= 0)
+         {
+            break;
+         }
+         
+         for (i=0; RetStatus && i < ReadLen && Loader->State != MQTT_TOPIC_TBL_LOAD_DONE; i++)
+         {
+            RetStatus = ScanChar(Loader->ReadBuf[i]);
+            Loader->FileOffset++;
+         }
+      
+      } /* End file read loop */
+      
+      OS_close(FileHandle);
+      MqttTopicTbl->JsonFileLen = Loader->FileOffset;
+
+      if (RetStatus)
+      {
+
+         if (Loader->State != MQTT_TOPIC_TBL_LOAD_DONE)
+         {
+            RetStatus = false;
+            CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                              "%s ended before the end of the topic array",
+                              Filename);
+         }
+         else if (Loader->ArrayIdx == 0)
+         {
+            RetStatus = false;
+            CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                              "Table does not define any topics");
+         }
+         else
+         {
+            __atomic_store_n(&MqttTopicTbl->Active, TblData, __ATOMIC_RELEASE);
+            if (__atomic_add_fetch(&MqttTopicTbl->GracePeriod, 1, __ATOMIC_SEQ_CST) == 0)
+            {
+               __atomic_add_fetch(&MqttTopicTbl->GracePeriod, 1, __ATOMIC_SEQ_CST);
+            }
+            MqttTopicTbl->LastLoadCnt = Loader->ArrayIdx;
+         }
+         
+      } /* End if no scan errors */
+      
+   } /* End if file open */
+   else
+   {
+      OS_GetErrorName(SysStatus, &OsErrStr);
+      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Error opening table file '%s', status=%s",
+                        Filename, OsErrStr);
+   }
+   
+   return RetStatus;
+   
+} /* End LoadFile() */
+
+
+/******************************************************************************
+** Function: NameIndexSlot
+**
+** Return the name index slot that holds the topic named 'Name' or the empty
+** slot where the name should be inserted.
+**
+** Notes:
+**   1. The index is twice the size of the topic table so the linear probe
+**      always ends at an empty slot.
+**
+*/
+static uint16 NameIndexSlot(const MQTT_TOPIC_TBL_Data_t *Data, const char *Name,
+                            uint16 NameLen, uint32 NameHash)
+{
+
+   uint16 Slot = NameHash & (MQTT_TOPIC_TBL_NAME_INDEX_LEN - 1);
+   uint16 Id;
+
+   while ((Id = Data->NameIndex[Slot]) != MQTT_TOPIC_TBL_UNUSED_ID)
+   {
+      if (Data->Dispatch[Id].NameHash == NameHash && Data->Dispatch[Id].NameLen == NameLen &&
+          memcmp(&Data->Arena[Data->Entry[Id].NameOffset], Name, NameLen) == 0)
+      {
+         break;
+      }
+      Slot = (Slot + 1) & (MQTT_TOPIC_TBL_NAME_INDEX_LEN - 1);
+   }
+
+   return Slot;
+
+} /* End NameIndexSlot() */
+
+
+/******************************************************************************
+** Function: ParseUint
+**
+** Return true and write the value to 'Number' if a JSON value is a decimal
+** integer no greater than MaxValue.
+**
+** Notes:
+**   1. coreJSON types fractions, exponents and negative values as numbers
+**      so the whole value must be digits.
+**   2. The range check is done before the value is narrowed to a uint32 so
+**      large values can't wrap into range.
+**
+*/
+static bool ParseUint(const char *Value, size_t ValueLen, JSONTypes_t ValueType,
+                      uint32 MaxValue, uint32 *Number)
+{
+
+   bool          RetStatus = false;
+   char          NumStr[12];
+   char         *NumEnd;
+   unsigned long NumValue;
+
+   if (ValueType == JSONNumber && ValueLen > 0 && ValueLen < sizeof(NumStr) && Value[0] != '-')
+   {
+      memcpy(NumStr, Value, ValueLen);
+      NumStr[ValueLen] = '\0';
+      NumValue = strtoul(NumStr, &NumEnd, 10);
+      if (*NumEnd == '\0' && NumValue <= MaxValue)
+      {
+         *Number   = (uint32)NumValue;
+         RetStatus = true;
+      }
+   }
+
+   return RetStatus;
+
+} /* End ParseUint() */
+
+
+/******************************************************************************
+** Function: ReadersQuiescent
+**
+** Return true if every online reader has passed a quiescent point in the
+** current grace period.
+**
+*/
+static bool ReadersQuiescent(void)
+{
+
+   bool   RetStatus = true;
+   uint16 i;
+   uint32 GracePeriod = __atomic_load_n(&MqttTopicTbl->GracePeriod, __ATOMIC_SEQ_CST);
+   uint32 ReaderPeriod;
+
+   for (i=0; i < MQTT_TOPIC_TBL_READER_CNT; i++)
+   {
+      ReaderPeriod = __atomic_load_n(&MqttTopicTbl->ReaderPeriod[i], __ATOMIC_SEQ_CST);
+      if (ReaderPeriod != 0 && ReaderPeriod != GracePeriod)
+      {
+         RetStatus = false;
+      }
+   }
+
+   return RetStatus;
+
+} /* End ReadersQuiescent() */
+
+
+/******************************************************************************
+** Function: RenderName
+**
+** Render a topic name template into 'Name' and return false if the template
+** is empty, has an undefined key, or the name doesn't fit.
+**
+** Notes:
+**   1. Load time keys are replaced. The {apid} key is copied to the name and
+**      reported in NameKey. A name can have at most one {apid}.
+**
+*/
+static bool RenderName(char *Name, size_t *NameLen, uint8 *NameKey,
+                       const char *Template, size_t TemplateLen)
+{
+
+   bool        RetStatus = true;
+   size_t      i = 0;
+   size_t      Len = 0;
+   size_t      KeyLen;
+   const char *Key;
+   const char *Value;
+   size_t      ValueLen;
+   char        ScId[12];
+   
+   *NameKey = MQTT_TOPIC_TBL_NAME_KEY_NONE;
+   
+   while (RetStatus && i < TemplateLen)
+   {
+      
+      Value    = &Template[i];
+      ValueLen = 1;
+      
+      if (Template[i] == '{')
+      {
+         
+         Key    = &Template[i+1];
+         KeyLen = 0;
+         while ((i + 1 + KeyLen) < TemplateLen && Key[KeyLen] != '}')
+         {
+            KeyLen++;
+         }
+         ValueLen = KeyLen + 2;
+         
+         if ((i + 1 + KeyLen) >= TemplateLen)
+         {
+            RetStatus = false;
+         }
+         else if (KeyLen == 4 && strncmp(Key, "scid", 4) == 0)
+         {
+            snprintf(ScId, sizeof(ScId), "%u", (unsigned int)CFE_PSP_GetSpacecraftId());
+            Value    = ScId;
+            ValueLen = strlen(ScId);
+         }
+         else if (KeyLen == 3 && strncmp(Key, "app", 3) == 0)
+         {
+            Value    = MqttTopicTbl->AppName;
+            ValueLen = strlen(MqttTopicTbl->AppName);
+         }
+         else if (KeyLen == 4 && strncmp(Key, "apid", 4) == 0 && *NameKey == MQTT_TOPIC_TBL_NAME_KEY_NONE)
+         {
+            *NameKey = MQTT_TOPIC_TBL_NAME_KEY_APID;
+         }
+         else
+         {
+            RetStatus = false;
+         }
+         i += KeyLen + 1;
+         
+      } /* End if key */
+      
+      if (RetStatus && (Len + ValueLen) < MQTT_TOPIC_TBL_MAX_TOPIC_LEN)
+      {
+         memcpy(&Name[Len], Value, ValueLen);
+         Len += ValueLen;
+      }
+      else
+      {
+         RetStatus = false;
+      }
+      i++;
+      
+   } /* End template loop */
+   
+   Name[Len] = '\0';
+   *NameLen  = Len;
+   
+   return (RetStatus && Len > 0);
+   
+} /* End RenderName() */
+
+
+/******************************************************************************
+** Function: ScanChar
+**
+** Advance the streaming loader by one file character.
+**
+** Notes:
+**   1. Outside of the topic array only string boundaries and nesting depth
+**      are tracked so the root's other keys are skipped without being
+**      parsed.
+**   2. Each topic object is copied to ObjBuf and loaded as soon as its
+**      closing brace is scanned.
+**
+*/
+static bool ScanChar(char c)
+{
+
+   bool RetStatus = true;
+   MQTT_TOPIC_TBL_Loader_t *Loader = &MqttTopicTbl->Loader;
+
+   switch (Loader->State)
+   {
+   
+      case MQTT_TOPIC_TBL_LOAD_ROOT:
+         if (Loader->InString)
+         {
+            if (Loader->Escape)
+            {
+               Loader->Escape = false;
+            }
+            else if (c == '\\')
+            {
+               Loader->Escape = true;
+            }
+            else if (c == '"')
+            {
+               Loader->InString = false;
+            }
+            else if (Loader->KeyLen < sizeof(Loader->Key))
+            {
+               Loader->Key[Loader->KeyLen++] = c;
+            }
+         }
+         else if (c == '"')
+         {
+            Loader->InString = true;
+            Loader->KeyLen   = 0;
+         }
+         else if (c == '{' || c == '[')
+         {
+            Loader->Depth++;
+         }
+         else if (c == '}' || c == ']')
+         {
+            Loader->Depth--;
+         }
+         else if (c == ':' && Loader->Depth == 1 &&
+                  Loader->KeyLen == 5 && strncmp(Loader->Key, "topic", 5) == 0)
+         {
+            Loader->State = MQTT_TOPIC_TBL_LOAD_ARRAY_START;
+         }
+         break;
+         
+      case MQTT_TOPIC_TBL_LOAD_ARRAY_START:
+         if (c == '[')
+         {
+            Loader->State = MQTT_TOPIC_TBL_LOAD_ARRAY;
+         }
+         else if (!isspace((unsigned char)c))
+         {
+            RetStatus = false;
+            CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                              "The topic key at byte %u is not an array",
+                              (unsigned int)Loader->FileOffset);
+         }
+         break;
+         
+      case MQTT_TOPIC_TBL_LOAD_ARRAY:
+         if (c == '{')
+         {
+            Loader->State     = MQTT_TOPIC_TBL_LOAD_OBJ;
+            Loader->InString  = false;
+            Loader->Escape    = false;
+            Loader->ObjDepth  = 1;
+            Loader->ObjBuf[0] = c;
+            Loader->ObjLen    = 1;
+         }
+         else if (c == ']')
+         {
+            Loader->State = MQTT_TOPIC_TBL_LOAD_DONE;
+         }
+         else if (c != ',' && !isspace((unsigned char)c))
+         {
+            RetStatus = false;
+            CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                              "Topic[%d] at byte %u is not an object",
+                              Loader->ArrayIdx, (unsigned int)Loader->FileOffset);
+         }
+         break;
+
+      case MQTT_TOPIC_TBL_LOAD_OBJ:
+         if (Loader->ObjLen >= MQTT_TOPIC_TBL_OBJ_MAX_CHAR)
+         {
+            RetStatus = false;
+            CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                              "Topic[%d] object exceeds %d characters",
+                              Loader->ArrayIdx, MQTT_TOPIC_TBL_OBJ_MAX_CHAR);
+         }
+         else
+         {
+         
+            Loader->ObjBuf[Loader->ObjLen++] = c;
+            if (Loader->InString)
+            {
+               if (Loader->Escape)
+               {
+                  Loader->Escape = false;
+               }
+               else if (c == '\\')
+               {
+                  Loader->Escape = true;
+               }
+               else if (c == '"')
+               {
+                  Loader->InString = false;
+               }
+            }
+            else if (c == '"')
+            {
+               Loader->InString = true;
+            }
+            else if (c == '{' || c == '[')
+            {
+               Loader->ObjDepth++;
+            }
+            else if ((c == '}' || c == ']') && --Loader->ObjDepth == 0)
+            {
+               if (Loader->ArrayIdx >= MQTT_TOPIC_TBL_MAX_TOPICS)
+               {
+                  RetStatus = false;
+                  CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR, 
+                                    "Table defines more than %d topics", MQTT_TOPIC_TBL_MAX_TOPICS);
+               }
+               else
+               {
+                  RetStatus = LoadEntry(Loader->ObjBuf, Loader->ObjLen, Loader->ArrayIdx++);
+                  Loader->State = MQTT_TOPIC_TBL_LOAD_ARRAY;
+               }
+            }
+            
+         } /* End if object buffer not full */
+         break;
+         
+      default:
+         break;
+         
+   } /* End state switch */
+   
+   return RetStatus;
+   
+} /* End ScanChar() */
+
+
+/******************************************************************************
+** Function: SnapshotValidId
+**
+** In addition to being in range, valid means that the ID has been defined in
+** the snapshot.
+*/
+static bool SnapshotValidId(const MQTT_TOPIC_TBL_Data_t *Data, uint16 Idx)
+{
+
+   bool RetStatus = false;
+   
+   if (Idx < MQTT_TOPIC_TBL_MAX_TOPICS)
+   {
+      if (Data->Entry[Idx].Id != MQTT_TOPIC_TBL_UNUSED_ID)
+      {
+         RetStatus = true;
+      }
+   }
+   else
+   {
+      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_INDEX_ERR_EID, CFE_EVS_EventType_ERROR, 
+                        "Table index %d is out of range. It must less than %d",
+                        Idx, MQTT_TOPIC_TBL_MAX_TOPICS);
+   }
+
+   return RetStatus;
+
+} /* End SnapshotValidId() */
+
+
+/******************************************************************************
+** Function: StubCfeToJson
+**
+** Provide a CfeToJson stub function for topics without a codec.
+**
+*/
+static bool StubCfeToJson(void *Codec, const char **JsonMsgPayload, 
+                          const CFE_MSG_Message_t *CfeMsg)
+{
+
+   TRACE_RING_Write(TRACE_RING_MODULE_TOPIC_TBL, TRACE_RING_LEVEL_INFO, MQTT_TOPIC_TBL_STUB_CFE_TO_JSON_TID,
+                    0, 0, NULL, 0);
+
+   return false;
+   
+} /* End StubCfeToJson() */
+
+
+/******************************************************************************
+** Function: StubJsonToCfe
+**
+** Provide a JsonToCfe stub function for topics without a codec.
+**
+*/
+static bool StubJsonToCfe(void *Codec, CFE_MSG_Message_t **CfeMsg, 
+                          const char *JsonMsgPayload, uint16 PayloadLen)
+{
+   
+   TRACE_RING_Write(TRACE_RING_MODULE_TOPIC_TBL, TRACE_RING_LEVEL_INFO, MQTT_TOPIC_TBL_STUB_JSON_TO_CFE_TID,
+                    PayloadLen, 0, NULL, 0);
+
+   return false;
+   
+} /* End StubJsonToCfe() */
+
+
+/******************************************************************************
+** Function: StubSbMsgFill
+**
+** Provide a SbMsgFill stub function for topics without a codec. The load
+** generator message payload is left zero filled.
+**
+*/
+static void StubSbMsgFill(void *Codec, CFE_MSG_Message_t *SbMsg, CFE_MSG_Size_t MsgSize,
+                          uint32 Seq, int16 Param)
+{
+
+} /* End StubSbMsgFill() */
+
+
+/******************************************************************************
+** Function: WaitForReaders
+**
+** Wait for the end of the grace period of the retired snapshot.
+**
+** Notes:
+**   1. The retired snapshot is normally free because readers pass a
+**      quiescent point every loop. This only waits when loads are issued
+**      back to back.
+**
+*/
+static bool WaitForReaders(void)
+{
+
+   uint32 WaitTime  = 0;
+   bool   RetStatus = ReadersQuiescent();
+
+   while (!RetStatus && WaitTime < MQTT_TOPIC_TBL_GRACE_TIMEOUT_MS)
+   {
+      OS_TaskDelay(MQTT_TOPIC_TBL_GRACE_POLL_MS);
+      WaitTime += MQTT_TOPIC_TBL_GRACE_POLL_MS;
+      RetStatus = ReadersQuiescent();
+   }
+
+   if (!RetStatus)
+   {
+      CFE_EVS_SendEvent(MQTT_TOPIC_TBL_LOAD_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Table load rejected. Readers of the previous table did not reach a quiescent point within %d ms",
+                        MQTT_TOPIC_TBL_GRACE_TIMEOUT_MS);
+   }
+
+   return RetStatus;
 
+} /* End WaitForReaders() */
@@ -17,25 +17,85 @@
 **
 ** Notes:
 **   1. The JSON topic table defines each supported MQTT topic. A topic
-**      is either published or subcribed to by the MQTT_GW app. A block
-**      of SB message IDs is used and the ID in the topic table is an
-**      offset from the base message ID define in MQTT_GW's JSON init
-**      table. The number of messages in the block is defined by
-**      MQTT_TOPIC_TBL_MAX_TOPICS for the C code but must be manually
-**      configured when the EDS topic IDs are used.
-**   2. Steps to create a mqtt_topic_xxx translator:
-**      1. Create the translator object mqtt_topic_xxx
+**      is either published or subcribed to by the MQTT_GW app. Each topic
+**      names the SB message ID it is bridged to with 'sb-mid' so existing
+**      app messages can be bridged without renumbering them. If 'sb-mid'
+**      is omitted the topic ID is used as an offset from the base message
+**      ID defined in MQTT_GW's JSON init table.
+**   2. The table is laid out for hundreds to thousands of topics:
+**      - Topic names are packed into a string arena and entries store an
+**        offset so an entry does not reserve space for the longest name.
+**      - Inbound MQTT topic names are resolved through an open addressed
+**        hash index of topic IDs. Fields that are read for every probe
+**        (name hash and length) are kept in a separate dense dispatch
+**        array so the arena name is only compared on a hash match. The
+**        remaining topic metadata is only read when subscribing, dumping,
+**        reporting, and for the SB-to-MQTT publish options.
+**      - Received SB messages are resolved through a direct index of topic
+**        IDs over the SB message ID value space so the SB path is one
+**        array read regardless of how the message IDs are spread.
+**      - The table file is streamed through a fixed size buffer and the
+**        topic array is scanned once. Each topic object is validated and
+**        added to the indexes as soon as it is complete.
+**      - Each topic names its codec type and is given its own instance of
+**        the codec so one codec type can serve many topics. Topics without
+**        a codec use the stub translator functions. Each snapshot buffer
+**        has its own bank of instances so a load never gives a topic an
+**        instance that a reader of the retired snapshot may still be
+**        using. A bank is only reused after its buffer's grace period.
+**   3. The active table is an immutable snapshot. A load builds the new
+**      table in the inactive buffer and publishes it with one atomic pointer
+**      store so readers never see a partially loaded table. The app's main
+**      task is the only writer. Child tasks that read the table are
+**      quiescent state based readers: they report a quiescent point when
+**      they hold no table pointers and go offline before blocking. The
+**      retired buffer is only rebuilt after every online reader has passed
+**      a quiescent point since it was retired.
+**   4. Topic names may be templates with {key} fields:
+**      - {scid}: Spacecraft ID
+**      - {app}:  MQTT_GW's cFE app name
+**      - {apid}: CCSDS APID of each SB message, only for 'sub' topics
+**      {scid} and {app} are rendered when the table is loaded so the table
+**      holds the final name. {apid} is rendered the first time a topic is
+**      seen with a new APID and the name is interned in a cache so the
+**      SB-to-MQTT path only formats a name on a cache miss. Table dumps
+**      contain the load time rendering.
+**   5. A 'sub' topic with "retain": true is published with the MQTT retain
+**      flag so the broker holds its last value for new subscribers,
+**      including the next instance of the gateway.
+**   6. A 'sub' topic with "dedup": N doesn't publish an SB message whose
+**      content matches the last published message until N seconds have
+**      passed since that publish. See MSG_TRANS.
+**   7. Topics with a "tag": N share one MQTT topic name. Each tagged topic
+**      keeps its own ID, SB message ID and codec, and the topics with the
+**      same name form a multiplexed topic whose messages are carried in a
+**      {"t":N,"d":<payload>} envelope. Several SB message IDs fan in to one
+**      'sub' topic and one 'pub' topic fans out to several SB message IDs.
+**      Every topic with the name must be tagged and have the same sb-role.
+**      The first topic loaded with the name holds the name index slot and
+**      each multiplexed topic has a jump table of topic IDs indexed by tag
+**      so the receive path resolves a tag with one array read. The name is
+**      only stored once in the arena and is subscribed once.
+**   8. Steps to create a mqtt_topic_xxx codec:
+**      1. Create the codec object mqtt_topic_xxx
 **         See mqtt_topic_rate.h/c for an example
+**         Keep all state in the instance that is passed as the Codec
+**         context of each function
 **         Define CCSDS packet in mqtt_gw.xml EDS file
-**         Include a test function to generate CCSDS packets
-**      2. mqtt_topic_tbl.h:
-**         - Include the translator object header
-**         - Add the class/object declaration to MQTT_TOPIC_TBL_Class_t.
+**         Include a fill function for load generator CCSDS packets
+**      2. app_cfg.h:
+**         - Define the number of codec instances
 **      3. mqtt_topic_tbl.h:
-**         - Add the conversion functions to ConvertFunc[]
-**         - Add a call to the translator object in constructor 
-**      4. cpu1_mqtt_topic.json:
-**         - Add topic definition
+**         - Include the codec object header
+**         - Add a codec type to MQTT_TOPIC_TBL_CodecType_t
+**         - Add the instance bank array to MQTT_TOPIC_TBL_Class_t.
+**      4. mqtt_topic_tbl.c:
+**         - Add the codec functions to CodecFunc[] and name to CodecStr[]
+**         - Add the instance bank array to CodecInst()
+**         - Construct both banks' instances in the constructor
+**         - Add a private instance to MQTT_TOPIC_TBL_GetPrivateCodec()
+**      5. cpu1_mqtt_topic.json:
+**         - Add topic definitions that name the codec
 **      5. Create/modify apps that generate CCSDS topic packets to
 **         use the EDS definition
 **
@@ -54,12 +114,23 @@
 
 #include "app_cfg.h"
 #include "mqtt_topic_rate.h"
+#include "mqtt_topic_probe.h"
+#include "trace_ring.h"
 
 /***********************/
 /** Macro Definitions **/
 /***********************/
 
-#define MQTT_TOPIC_TBL_UNUSED_ID 99
+#define MQTT_TOPIC_TBL_UNUSED_ID 0xFFFF
+
+#define MQTT_TOPIC_TBL_NAME_INDEX_LEN  (2*MQTT_TOPIC_TBL_MAX_TOPICS)
+
+#define MQTT_TOPIC_TBL_MUX_NONE  0xFF   /* Entry MuxIdx of a topic without a tag */
+
+#define MQTT_TOPIC_TBL_RESERVED_MID_CNT  5   /* App message IDs that topics can't use */
+
+/* Name of topic 'Idx' in a table snapshot. The topic must be defined. */
+#define MQTT_TOPIC_TBL_DATA_NAME(Data, Idx)  (&(Data)->Arena[(Data)->Entry[(Idx)].NameOffset])
 
 /*
 ** Event Message IDs
@@ -68,7 +139,13 @@
 #define MQTT_TOPIC_TBL_INDEX_ERR_EID  (MQTT_TOPIC_TBL_BASE_EID + 0)
 #define MQTT_TOPIC_TBL_DUMP_ERR_EID   (MQTT_TOPIC_TBL_BASE_EID + 1)
 #define MQTT_TOPIC_TBL_LOAD_ERR_EID   (MQTT_TOPIC_TBL_BASE_EID + 2)
-#define MQTT_TOPIC_TBL_STUB_EID       (MQTT_TOPIC_TBL_BASE_EID + 3)
+
+/*
+** Trace Point IDs
+*/
+
+#define MQTT_TOPIC_TBL_STUB_CFE_TO_JSON_TID  1
+#define MQTT_TOPIC_TBL_STUB_JSON_TO_CFE_TID  2
 
 /**********************/
 /** Type Definitions **/
@@ -80,49 +157,207 @@
 ** 
 */
 
-typedef struct
+typedef enum
 {
 
-   char  Name[OS_MAX_PATH_LEN];
-   uint8 Id;
-   char  SbRole[OS_MAX_PATH_LEN];
+   MQTT_TOPIC_TBL_SB_ROLE_UNDEF = 0,
+   MQTT_TOPIC_TBL_SB_ROLE_PUB   = 1,   /* Subscribe to the MQTT topic and publish it on the SB */
+   MQTT_TOPIC_TBL_SB_ROLE_SUB   = 2    /* Subscribe to the SB message and publish it to MQTT   */
 
-} MQTT_TOPIC_TBL_Entry_t;
+} MQTT_TOPIC_TBL_SbRole_t;
 
-typedef struct
+
+/*
+** Per-message topic name template keys
+*/
+
+typedef enum
 {
 
-  MQTT_TOPIC_TBL_Entry_t Entry[MQTT_TOPIC_TBL_MAX_TOPICS];
-   
-} MQTT_TOPIC_TBL_Data_t;
+   MQTT_TOPIC_TBL_NAME_KEY_NONE = 0,
+   MQTT_TOPIC_TBL_NAME_KEY_APID = 1    /* Name contains {apid} */
 
+} MQTT_TOPIC_TBL_NameKey_t;
+
+
+typedef enum
+{
+
+   MQTT_TOPIC_TBL_CODEC_STUB  = 0,
+   MQTT_TOPIC_TBL_CODEC_RATE  = 1,
+   MQTT_TOPIC_TBL_CODEC_PROBE = 2,   /* LAT_PROBE round trip probes */
+   MQTT_TOPIC_TBL_CODEC_CNT   = 3
+
+} MQTT_TOPIC_TBL_CodecType_t;
 
-/* Return pointer to owner's table data */
-typedef MQTT_TOPIC_TBL_Data_t* (*MQTT_TOPIC_TBL_GetDataPtr_t)(void);
 
 /******************************************************************************
-** Topic 'virtual' function signatures
-** - Using separate MQTT_TOPIC_xxx files for each topic type and this table
+** Topic codec function signatures
+** - Using separate MQTT_TOPIC_xxx files for each codec type and this table
 **   below is mimicing an abstract base class with inheritance design
 ** - Naming it MQTT_TOPIC_TBL_VirtualFunc_t complies with the naming OSK naming
 **   standard, but it's a little misleading because the MQTT_TOPIC_xxx objects
 **   are not designed as subclasses of MQTT_TOPIC_TBL.
+** - Codec is the topic's codec instance, the equivalent of 'this'.
+** - SbMsgLen is the size of the codec's SB packet. CfeToJson rejects and
+**   SbMsgFill leaves unfilled shorter messages. Zero if any size is valid.
 */
 
-typedef bool (*MQTT_TOPIC_TBL_JsonToCfe_t)(CFE_MSG_Message_t **CfeMsg, const char *JsonMsgPayload, uint16 PayloadLen);
-typedef bool (*MQTT_TOPIC_TBL_CfeToJson_t)(const char **JsonMsgTopic, const char **JsonMsgPayload, const CFE_MSG_Message_t *CfeMsg);
-typedef void (*MQTT_TOPIC_TBL_SbMsgTest_t)(bool Init, int16 Param);
+typedef bool (*MQTT_TOPIC_TBL_JsonToCfe_t)(void *Codec, CFE_MSG_Message_t **CfeMsg, const char *JsonMsgPayload, uint16 PayloadLen);
+typedef bool (*MQTT_TOPIC_TBL_CfeToJson_t)(void *Codec, const char **JsonMsgPayload, const CFE_MSG_Message_t *CfeMsg);
+typedef void (*MQTT_TOPIC_TBL_SbMsgFill_t)(void *Codec, CFE_MSG_Message_t *SbMsg, CFE_MSG_Size_t MsgSize, uint32 Seq, int16 Param);
 
 typedef struct
 {
 
    MQTT_TOPIC_TBL_CfeToJson_t  CfeToJson;
    MQTT_TOPIC_TBL_JsonToCfe_t  JsonToCfe;  
-   MQTT_TOPIC_TBL_SbMsgTest_t  SbMsgTest;
+   MQTT_TOPIC_TBL_SbMsgFill_t  SbMsgFill;
+   CFE_MSG_Size_t              SbMsgLen;
 
 } MQTT_TOPIC_TBL_VirtualFunc_t; 
 
 
+/*
+** A topic's codec functions and instance. Instances exist for the life of
+** the app but an instance is given to another topic by the second load
+** after the one that assigned it.
+*/
+
+typedef struct
+{
+
+   const MQTT_TOPIC_TBL_VirtualFunc_t  *Func;
+   void                                *Inst;
+
+} MQTT_TOPIC_TBL_Codec_t;
+
+
+/*
+** Cold topic metadata
+*/
+
+typedef struct
+{
+
+   uint32  NameOffset;   /* Null terminated topic name in the string arena */
+   uint16  Id;           /* MQTT_TOPIC_TBL_UNUSED_ID if the topic is not defined */
+   uint8   SbRole;       /* MQTT_TOPIC_TBL_SbRole_t */
+   uint8   NameKey;      /* MQTT_TOPIC_TBL_NameKey_t */
+   uint32  SbMid;        /* SB message ID value */
+   uint8   CodecType;    /* MQTT_TOPIC_TBL_CodecType_t */
+   uint8   Retain;       /* Publish with the MQTT retain flag, only for 'sub' topics */
+   uint16  DedupTime;    /* Seconds an unchanged SB message is suppressed, 0 = Publish every message */
+   uint8   MuxIdx;       /* Multiplexed topic jump table, MQTT_TOPIC_TBL_MUX_NONE if untagged */
+   uint8   MuxTag;       /* Envelope type tag, only valid if MuxIdx is defined */
+
+} MQTT_TOPIC_TBL_Entry_t;
+
+
+/*
+** Hot per-message dispatch fields
+*/
+
+typedef struct
+{
+
+   uint32  NameHash;     /* FNV-1a hash of the topic name */
+   uint16  NameLen;      /* Zero if the topic is not defined */
+   uint16  Spare;
+
+} MQTT_TOPIC_TBL_Dispatch_t;
+
+
+typedef struct
+{
+
+   uint16  TopicCnt;     /* Highest defined topic ID plus one */
+   uint32  ArenaLen;     /* Bytes used in the string arena */
+   uint32  Generation;   /* Unique for each table build, never zero */
+
+   uint16                     NameIndex[MQTT_TOPIC_TBL_NAME_INDEX_LEN];  /* Topic IDs hashed by name */
+   uint16                     MidIndex[MQTT_TOPIC_TBL_MID_INDEX_LEN];    /* Topic IDs indexed by SB message ID value */
+   MQTT_TOPIC_TBL_Dispatch_t  Dispatch[MQTT_TOPIC_TBL_MAX_TOPICS];
+   MQTT_TOPIC_TBL_Codec_t     Codec[MQTT_TOPIC_TBL_MAX_TOPICS];
+   uint16                     CodecInstCnt[MQTT_TOPIC_TBL_CODEC_CNT];
+   uint16                     MuxCnt;    /* Multiplexed topics */
+   uint16                     MuxIndex[MQTT_TOPIC_TBL_MAX_MUX_TOPICS][MQTT_TOPIC_TBL_MAX_MUX_TAGS];  /* Topic IDs indexed by tag */
+   MQTT_TOPIC_TBL_Entry_t     Entry[MQTT_TOPIC_TBL_MAX_TOPICS];
+   char                       Arena[MQTT_TOPIC_TBL_STR_ARENA_LEN];
+   
+} MQTT_TOPIC_TBL_Data_t;
+
+
+/*
+** Rendered per-message topic names
+*/
+
+typedef struct
+{
+
+   uint32  Generation;   /* Table generation the name was rendered from, zero if unused */
+   uint16  Id;
+   uint16  KeyValue;
+   char    Name[MQTT_TOPIC_TBL_MAX_TOPIC_LEN];
+
+} MQTT_TOPIC_TBL_NameCache_t;
+
+
+/******************************************************************************
+** Snapshot readers
+*/
+
+typedef enum
+{
+
+   MQTT_TOPIC_TBL_READER_MQTT_CHILD = 0,
+   MQTT_TOPIC_TBL_READER_LOAD_GEN   = 1,
+   MQTT_TOPIC_TBL_READER_LAST_VALUE = 2,
+   MQTT_TOPIC_TBL_READER_DECODE     = 3,   /* First of DECODE_POOL_MAX_WORKERS readers */
+   MQTT_TOPIC_TBL_READER_CNT        = (3 + DECODE_POOL_MAX_WORKERS)
+
+} MQTT_TOPIC_TBL_Reader_t;
+
+
+/******************************************************************************
+** Streaming loader
+*/
+
+typedef enum
+{
+
+   MQTT_TOPIC_TBL_LOAD_ROOT        = 0,   /* Searching the root object for the topic key */
+   MQTT_TOPIC_TBL_LOAD_ARRAY_START = 1,   /* Topic key found, expecting '[' */
+   MQTT_TOPIC_TBL_LOAD_ARRAY       = 2,   /* Between topic objects */
+   MQTT_TOPIC_TBL_LOAD_OBJ         = 3,   /* Collecting a topic object */
+   MQTT_TOPIC_TBL_LOAD_DONE        = 4    /* End of the topic array */
+
+} MQTT_TOPIC_TBL_LoadState_t;
+
+
+typedef struct
+{
+
+   uint8   State;        /* MQTT_TOPIC_TBL_LoadState_t */
+   bool    InString;
+   bool    Escape;
+   uint8   KeyLen;
+   uint16  Depth;        /* Nesting depth of the root scan */
+   uint16  ObjDepth;
+   uint16  ObjLen;
+   uint16  ArrayIdx;
+   uint32  FileOffset;
+   char    Key[8];       /* Only needs to hold "topic" */
+
+   char    ReadBuf[MQTT_TOPIC_TBL_LOAD_BUF_LEN];
+   char    ObjBuf[MQTT_TOPIC_TBL_OBJ_MAX_CHAR];
+
+} MQTT_TOPIC_TBL_Loader_t;
+
+
+/* Return pointer to owner's table data */
+typedef MQTT_TOPIC_TBL_Data_t* (*MQTT_TOPIC_TBL_GetDataPtr_t)(void);
+
 /******************************************************************************
 ** Class
 */
@@ -131,24 +366,42 @@ typedef struct
 {
 
    /*
-   ** Topic Table
+   ** Topic Table snapshots
+   */
+   
+   MQTT_TOPIC_TBL_Data_t   Buf[2];
+   MQTT_TOPIC_TBL_Data_t  *Active;        /* Accessed atomically */
+   uint32                  GracePeriod;   /* Incremented when a snapshot is retired, never zero */
+   uint32                  ReaderPeriod[MQTT_TOPIC_TBL_READER_CNT];  /* Last GracePeriod seen, zero when offline */
+   uint32                  LastGeneration;
+
+   MQTT_TOPIC_TBL_NameCache_t  NameCache[MQTT_TOPIC_TBL_NAME_CACHE_LEN];
+   uint32                      NameCacheMissCnt;
+
+   /*
+   ** Codec instances
    */
    
-   MQTT_TOPIC_TBL_Data_t   Data;
-   MQTT_TOPIC_RATE_Class_t Rate;
+   MQTT_TOPIC_RATE_Class_t Rate[2][MQTT_TOPIC_RATE_INST_CNT];   /* Indexed by snapshot buffer */
+   MQTT_TOPIC_RATE_Class_t PrivateRate;                         /* Never given to a topic */
+   
+   MQTT_TOPIC_PROBE_Class_t Probe[2][MQTT_TOPIC_PROBE_INST_CNT];
+   MQTT_TOPIC_PROBE_Class_t PrivateProbe;
    
    /*
-   ** Standard CJSON table data
+   ** Table load data
    */
    
    const char*  AppName;
+   uint32       TopicBaseMid;   /* Default SB message ID value for topic ID 0 */
+   uint32       ReservedMid[MQTT_TOPIC_TBL_RESERVED_MID_CNT];   /* SB message ID values */
+   uint32       ProbeMid;       /* Only allowed for the probe codec's topic */
    bool         Loaded;   /* Has entire table been loaded? */
    uint8        LastLoadStatus;
    uint16       LastLoadCnt;
    
-   size_t       JsonObjCnt;
-   char         JsonBuf[MQTT_TOPIC_TBL_JSON_FILE_MAX_CHAR];   
-   size_t       JsonFileLen;
+   uint32       JsonFileLen;   /* Bytes scanned by the last load */
+   MQTT_TOPIC_TBL_Loader_t Loader;
    
 } MQTT_TOPIC_TBL_Class_t;
 
@@ -166,10 +419,16 @@ typedef struct
 ** Notes:
 **   1. The table values are not populated. This is done when the table is 
 **      registered with the table manager.
+**   2. ReservedMid is the MQTT_TOPIC_TBL_RESERVED_MID_CNT SB message ID
+**      values of the app's own messages. Topics can't be bridged to them.
+**      TopicBaseMid is also reserved for topic ID 0.
+**   3. ProbeMid is LAT_PROBE's message ID value. It is reserved for the
+**      one 'pub' topic that uses the probe codec.
 **
 */
 void MQTT_TOPIC_TBL_Constructor(MQTT_TOPIC_TBL_Class_t *TopicMgrPtr,
-                                const char *AppName, uint32 TopicBaseMid);
+                                const char *AppName, uint32 TopicBaseMid,
+                                const uint32 *ReservedMid, uint32 ProbeMid);
 
 
 /******************************************************************************
@@ -187,15 +446,105 @@ bool MQTT_TOPIC_TBL_DumpCmd(TBLMGR_Tbl_t *Tbl, uint8 DumpType, const char *Filen
 
 
 /******************************************************************************
-** Function: MQTT_TOPIC_TBL_GetCfeToJson
+** Function: MQTT_TOPIC_TBL_FindMid
 **
-** Return a pointer to the CfeToJson conversion function for 'Idx'.
+** Return the ID of the topic bridged to SB message ID value 'MidValue' or
+** MQTT_TOPIC_TBL_UNUSED_ID if no topic uses the message ID.
+** 
+*/
+uint16 MQTT_TOPIC_TBL_FindMid(uint32 MidValue);
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_FindName
+**
+** Return the ID of the topic named 'Name' or MQTT_TOPIC_TBL_UNUSED_ID if the
+** topic is not defined.
 ** 
 ** Notes:
-**   1. Idx must be less than MQTT_TOPIC_TBL_MAX_TOPICS
+**   1. Name does not need to be null terminated so MQTT length strings can
+**      be used directly.
+**   2. The first topic loaded with a multiplexed topic's name is returned.
+**      See MQTT_TOPIC_TBL_FindTag().
+**
+*/
+uint16 MQTT_TOPIC_TBL_FindName(const char *Name, uint16 NameLen);
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_FindSnapshotMid
+**
+** Return the ID of the topic bridged to SB message ID value 'MidValue' in
+** the 'Data' table snapshot or MQTT_TOPIC_TBL_UNUSED_ID if no topic uses
+** the message ID.
+** 
+** Notes:
+**   1. See MQTT_TOPIC_TBL_FindSnapshotName()
+**
+*/
+uint16 MQTT_TOPIC_TBL_FindSnapshotMid(const MQTT_TOPIC_TBL_Data_t *Data, uint32 MidValue);
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_FindSnapshotName
+**
+** Return the ID of the topic named 'Name' in the 'Data' table snapshot or
+** MQTT_TOPIC_TBL_UNUSED_ID if the topic is not defined.
+** 
+** Notes:
+**   1. Used to compare two snapshots. The caller must be a topic table
+**      reader that has not reported a quiescent point since it read 'Data'.
 **
 */
-MQTT_TOPIC_TBL_CfeToJson_t MQTT_TOPIC_TBL_GetCfeToJson(uint8 Idx);
+uint16 MQTT_TOPIC_TBL_FindSnapshotName(const MQTT_TOPIC_TBL_Data_t *Data,
+                                       const char *Name, uint16 NameLen);
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_FindTag
+**
+** Return the ID of the topic tagged 'Tag' in the multiplexed topic of topic
+** 'Idx' or MQTT_TOPIC_TBL_UNUSED_ID if Idx isn't multiplexed or no topic
+** has the tag.
+** 
+** Notes:
+**   1. Idx is usually the ID returned by MQTT_TOPIC_TBL_FindName() for a
+**      received topic name.
+**
+*/
+uint16 MQTT_TOPIC_TBL_FindTag(uint16 Idx, uint32 Tag);
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_GetCodec
+**
+** Return a pointer to the codec of the topic identified by 'Idx' or NULL if
+** the topic is not defined.
+** 
+** Notes:
+**   1. Pass the codec's Inst as the Codec argument of its functions.
+**   2. See MQTT_TOPIC_TBL_GetData() for how long the pointer remains valid.
+**      Func is valid for the life of the app. Inst belongs to the snapshot
+**      so it must not be used after the pointer expires.
+**
+*/
+const MQTT_TOPIC_TBL_Codec_t *MQTT_TOPIC_TBL_GetCodec(uint16 Idx);
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_GetData
+**
+** Return the active table snapshot.
+** 
+** Notes:
+**   1. Use this when a consistent view is needed across several topics.
+**      The other accessors each read the active snapshot once.
+**   2. Pointers into a snapshot are valid until the calling reader's next
+**      quiescent point. The main task may hold them until its next table
+**      load.
+**
+*/
+const MQTT_TOPIC_TBL_Data_t *MQTT_TOPIC_TBL_GetData(void);
 
 
 /******************************************************************************
@@ -205,21 +554,76 @@ MQTT_TOPIC_TBL_CfeToJson_t MQTT_TOPIC_TBL_GetCfeToJson(uint8 Idx);
 ** 
 ** Notes:
 **   1. Idx must be less than MQTT_TOPIC_TBL_MAX_TOPICS
+**   2. See MQTT_TOPIC_TBL_GetData() for how long the entry remains valid.
+**
+*/
+const MQTT_TOPIC_TBL_Entry_t *MQTT_TOPIC_TBL_GetEntry(uint16 Idx);
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_GetMuxCnt
 **
+** Return the number of multiplexed topics in the active table.
+** 
 */
-const MQTT_TOPIC_TBL_Entry_t *MQTT_TOPIC_TBL_GetEntry(uint8 Idx);
+uint16 MQTT_TOPIC_TBL_GetMuxCnt(void);
 
 
 /******************************************************************************
-** Function: MQTT_TOPIC_TBL_GetJsonToCfe
+** Function: MQTT_TOPIC_TBL_GetName
 **
-** Return a pointer to the JsonToCfe conversion function for 'Idx'.
+** Return the name of the topic identified by 'Idx' or NULL if the topic is
+** not defined.
 ** 
 ** Notes:
-**   1. Idx must be less than MQTT_TOPIC_TBL_MAX_TOPICS
+**   1. See MQTT_TOPIC_TBL_GetData() for how long the name remains valid.
 **
 */
-MQTT_TOPIC_TBL_JsonToCfe_t MQTT_TOPIC_TBL_GetJsonToCfe(uint8 Idx);
+const char *MQTT_TOPIC_TBL_GetName(uint16 Idx);
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_GetPrivateCodec
+**
+** Load 'Codec' with the codec functions of the topic identified by 'Idx' and
+** a private instance of its codec type. Returns false if the topic is not
+** defined.
+** 
+** Notes:
+**   1. Each codec type has one private instance that is never given to a
+**      topic so it can be used without the topic's decode stripe lock and
+**      without disturbing the topic's encode and decode buffers. It is
+**      reserved for PERF_BENCH which runs one benchmark at a time.
+**   2. The private instance remains valid for the life of the app.
+**
+*/
+bool MQTT_TOPIC_TBL_GetPrivateCodec(uint16 Idx, MQTT_TOPIC_TBL_Codec_t *Codec);
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_GetSbTopicName
+**
+** Return the MQTT topic name for SB message 'SbMsg' of topic 'Idx' or NULL
+** if the topic is not defined.
+** 
+** Notes:
+**   1. Per-message template keys are filled in from SbMsg. The rendered
+**      name is valid until another SB message is processed.
+**   2. The name cache is not locked so it must only be used by one task at
+**      a time.
+**
+*/
+const char *MQTT_TOPIC_TBL_GetSbTopicName(uint16 Idx, const CFE_MSG_Message_t *SbMsg);
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_GetTopicCnt
+**
+** Return the highest defined topic ID plus one. Topic loops can stop at this
+** count rather than MQTT_TOPIC_TBL_MAX_TOPICS.
+** 
+*/
+uint16 MQTT_TOPIC_TBL_GetTopicCnt(void);
 
 
 /******************************************************************************
@@ -231,32 +635,69 @@ MQTT_TOPIC_TBL_JsonToCfe_t MQTT_TOPIC_TBL_GetJsonToCfe(uint8 Idx);
 **  1. Function signature must match TBLMGR_LoadTblFuncPtr_t.
 **  2. Can assume valid table file name because this is a callback from 
 **     the app framework table manager.
+**  3. A load replaces the entire table. Topics that are not listed in the
+**     file are undefined after the load.
+**  4. Rejected if a reader has not passed a quiescent point since the
+**     previous load within MQTT_TOPIC_TBL_GRACE_TIMEOUT_MS.
 **
 */
 bool MQTT_TOPIC_TBL_LoadCmd(TBLMGR_Tbl_t *Tbl, uint8 LoadType, const char *Filename);
 
 
 /******************************************************************************
-** Function: MQTT_TOPIC_TBL_ResetStatus
+** Function: MQTT_TOPIC_TBL_ReaderOffline
 **
-** Reset counters and status flags to a known reset state.  The behavior of
-** the table manager should not be impacted. The intent is to clear counters
-** and flags to a known default state for telemetry.
+** Report that a reader task is about to block and holds no table pointers.
+** 
+** Notes:
+**   1. An offline reader does not delay table loads. It comes back online
+**      with its next call to MQTT_TOPIC_TBL_ReaderQuiescent() which must be
+**      made before it reads the table.
 **
 */
-void MQTT_TOPIC_TBL_ResetStatus(void);
+void MQTT_TOPIC_TBL_ReaderOffline(MQTT_TOPIC_TBL_Reader_t Reader);
 
 
 /******************************************************************************
-** Function: MQTT_TOPIC_TBL_RunSbMsgTest
+** Function: MQTT_TOPIC_TBL_ReaderQuiescent
 **
-** Execute a topic's SB message test.
+** Report that a reader task holds no table pointers.
 ** 
 ** Notes:
-**   1. Idx must be less than MQTT_TOPIC_TBL_MAX_TOPICS
+**   1. Called once per reader task loop. A table load waits for each online
+**      reader's next quiescent point before it reuses the retired buffer.
 **
 */
-void MQTT_TOPIC_TBL_RunSbMsgTest(uint8 Idx, bool Init, int16 Param);
+void MQTT_TOPIC_TBL_ReaderQuiescent(MQTT_TOPIC_TBL_Reader_t Reader);
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_ReservedMid
+**
+** Return true if an SB message ID value is one of the app's own messages.
+** 
+** Notes:
+**   1. Table loads reject topics with a reserved message ID so the SB
+**      subscriptions of a topic never share a message ID with the app's
+**      command, housekeeping, or internal telemetry messages.
+**   2. The probe message ID is reserved. Only the probe codec's topic,
+**      which is never subscribed on the SB, may use it.
+**
+*/
+bool MQTT_TOPIC_TBL_ReservedMid(uint32 MidValue);
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_ResetStatus
+**
+** Reset counters and status flags to a known reset state.  The behavior of
+** the table manager should not be impacted. The intent is to clear counters
+** and flags to a known default state for telemetry.
+**
+*/
+void MQTT_TOPIC_TBL_ResetStatus(void);
+
+
 
 
 /******************************************************************************
@@ -264,7 +705,7 @@ void MQTT_TOPIC_TBL_RunSbMsgTest(uint8 Idx, bool Init, int16 Param);
 **
 ** In addition to being in range, valid means that the ID has been defined.
 */
-bool MQTT_TOPIC_TBL_ValidId(uint8 Idx);
+bool MQTT_TOPIC_TBL_ValidId(uint16 Idx);
 
 
 
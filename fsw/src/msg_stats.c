@@ -0,0 +1,480 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Collect per-topic message statistics
+**
+** Notes:
+**   None
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#ifdef __linux__
+#include <time.h>
+#endif
+
+#include "msg_stats.h"
+#include "mqtt_topic_tbl.h"
+
+
+/************************************/
+/** Local File Function Prototypes **/
+/************************************/
+
+static void   LoadDirCntTlm(MQTT_GW_DirCnt_t *DirTlm, const MSG_STATS_Cnt_t *Cnt);
+static void   LoadStageTlm(MQTT_GW_LatencyStage_t *StageTlm, const MSG_STATS_Hist_t *Hist);
+static void   SendLatencyTlm(void);
+static void   SendTopicStatsTlm(void);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static MSG_STATS_Class_t *MsgStats = NULL;
+
+
+/******************************************************************************
+** Function: MSG_STATS_Constructor
+**
+*/
+void MSG_STATS_Constructor(MSG_STATS_Class_t *MsgStatsPtr,
+                           const INITBL_Class_t *IniTbl)
+{
+
+   MsgStats = MsgStatsPtr;
+
+   CFE_PSP_MemSet((void*)MsgStats, 0, sizeof(MSG_STATS_Class_t));
+
+   MsgStats->TlmHkPeriod = INITBL_GetIntConfig(IniTbl, CFG_STATS_TLM_HK_PERIOD);
+
+   CFE_MSG_Init(CFE_MSG_PTR(MsgStats->LatencyTlm.TelemetryHeader),
+                CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_MQTT_GW_LATENCY_TLM_TOPICID)),
+                sizeof(MQTT_GW_LatencyTlm_t));
+
+   CFE_MSG_Init(CFE_MSG_PTR(MsgStats->TopicStatsTlm.TelemetryHeader),
+                CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_MQTT_GW_TOPIC_STATS_TLM_TOPICID)),
+                sizeof(MQTT_GW_TopicStatsTlm_t));
+
+} /* End MSG_STATS_Constructor() */
+
+
+/******************************************************************************
+** Function: MSG_STATS_AddSample
+**
+*/
+void MSG_STATS_AddSample(MSG_STATS_Hist_t *Hist, uint32 Latency)
+{
+
+   uint16 Bucket = 0;
+   uint32 Value  = Latency >> 1;
+
+   while (Value > 0 && Bucket < (MSG_STATS_HIST_BUCKETS-1))
+   {
+      Value >>= 1;
+      ++Bucket;
+   }
+
+   ++Hist->Bucket[Bucket];
+   ++Hist->Count;
+
+   if (Latency > Hist->Max)
+   {
+      Hist->Max = Latency;
+   }
+
+} /* End MSG_STATS_AddSample() */
+
+
+/******************************************************************************
+** Function: MSG_STATS_CountDrop
+**
+*/
+void MSG_STATS_CountDrop(uint16 TopicId, MSG_STATS_Dir_t Dir)
+{
+
+   if (TopicId < MQTT_TOPIC_TBL_MAX_TOPICS && Dir < MSG_STATS_DIR_CNT)
+   {
+      ++MsgStats->Topic[TopicId].Cnt[Dir].DropCnt;
+   }
+
+} /* End MSG_STATS_CountDrop() */
+
+
+/******************************************************************************
+** Function: MSG_STATS_CountMsgIn
+**
+*/
+void MSG_STATS_CountMsgIn(uint16 TopicId, MSG_STATS_Dir_t Dir, uint32 ByteCnt)
+{
+
+   if (TopicId < MQTT_TOPIC_TBL_MAX_TOPICS && Dir < MSG_STATS_DIR_CNT)
+   {
+      ++MsgStats->Topic[TopicId].Cnt[Dir].MsgInCnt;
+      MsgStats->Topic[TopicId].Cnt[Dir].ByteInCnt += ByteCnt;
+   }
+
+} /* End MSG_STATS_CountMsgIn() */
+
+
+/******************************************************************************
+** Function: MSG_STATS_CountMsgOut
+**
+*/
+void MSG_STATS_CountMsgOut(uint16 TopicId, MSG_STATS_Dir_t Dir, uint32 ByteCnt)
+{
+
+   if (TopicId < MQTT_TOPIC_TBL_MAX_TOPICS && Dir < MSG_STATS_DIR_CNT)
+   {
+      ++MsgStats->Topic[TopicId].Cnt[Dir].MsgOutCnt;
+      MsgStats->Topic[TopicId].Cnt[Dir].ByteOutCnt += ByteCnt;
+   }
+
+} /* End MSG_STATS_CountMsgOut() */
+
+
+/******************************************************************************
+** Function: MSG_STATS_CountSuppressed
+**
+*/
+void MSG_STATS_CountSuppressed(uint16 TopicId, MSG_STATS_Dir_t Dir)
+{
+
+   if (TopicId < MQTT_TOPIC_TBL_MAX_TOPICS && Dir < MSG_STATS_DIR_CNT)
+   {
+      ++MsgStats->Topic[TopicId].Cnt[Dir].SuppressCnt;
+   }
+
+} /* End MSG_STATS_CountSuppressed() */
+
+
+/******************************************************************************
+** Function: MSG_STATS_CountUnmatched
+**
+*/
+void MSG_STATS_CountUnmatched(MSG_STATS_Dir_t Dir)
+{
+
+   if (Dir < MSG_STATS_DIR_CNT)
+   {
+      ++MsgStats->UnmatchedCnt[Dir];
+   }
+
+} /* End MSG_STATS_CountUnmatched() */
+
+
+/******************************************************************************
+** Function: MSG_STATS_CountXlateErr
+**
+*/
+void MSG_STATS_CountXlateErr(uint16 TopicId, MSG_STATS_Dir_t Dir)
+{
+
+   if (TopicId < MQTT_TOPIC_TBL_MAX_TOPICS && Dir < MSG_STATS_DIR_CNT)
+   {
+      ++MsgStats->Topic[TopicId].Cnt[Dir].XlateErrCnt;
+   }
+
+} /* End MSG_STATS_CountXlateErr() */
+
+
+/******************************************************************************
+** Function: MSG_STATS_GetTime
+**
+** Notes:
+**   1. OS_GetLocalTime() is the settable wall clock which can step during a
+**      measurement so the monotonic clock is used where it is available.
+**
+*/
+uint32 MSG_STATS_GetTime(void)
+{
+
+#ifdef __linux__
+
+   struct timespec Now;
+
+   clock_gettime(CLOCK_MONOTONIC, &Now);
+
+   return (uint32)(((uint64)Now.tv_sec * 1000000) + ((uint64)Now.tv_nsec / 1000));
+
+#else
+
+   OS_time_t LocalTime;
+
+   OS_GetLocalTime(&LocalTime);
+
+   return (uint32)OS_TimeGetTotalMicroseconds(LocalTime);
+
+#endif
+
+} /* End MSG_STATS_GetTime() */
+
+
+/******************************************************************************
+** Function: MSG_STATS_GetTopic
+**
+*/
+const MSG_STATS_Topic_t *MSG_STATS_GetTopic(uint16 TopicId)
+{
+
+   const MSG_STATS_Topic_t *Topic = NULL;
+
+   if (TopicId < MQTT_TOPIC_TBL_MAX_TOPICS)
+   {
+      Topic = &MsgStats->Topic[TopicId];
+   }
+
+   return Topic;
+
+} /* End MSG_STATS_GetTopic() */
+
+
+/******************************************************************************
+** Function: MSG_STATS_Percentile
+**
+*/
+uint32 MSG_STATS_Percentile(const MSG_STATS_Hist_t *Hist, uint32 Percent)
+{
+
+   uint16 Bucket;
+   uint32 CumCount   = 0;
+   uint32 Threshold;
+   uint32 RetValue   = 0;
+
+   if (Hist->Count > 0)
+   {
+
+      /* Round up so a single sample yields its own bucket */
+      Threshold = (uint32)(((uint64)Hist->Count * Percent + 99) / 100);
+
+      for (Bucket = 0; Bucket < MSG_STATS_HIST_BUCKETS; Bucket++)
+      {
+         CumCount += Hist->Bucket[Bucket];
+         if (CumCount >= Threshold)
+         {
+            RetValue = (2u << Bucket) - 1;
+            break;
+         }
+      }
+
+      if (RetValue > Hist->Max || Bucket == (MSG_STATS_HIST_BUCKETS-1))
+      {
+         RetValue = Hist->Max;
+      }
+
+   } /* End if samples */
+
+   return RetValue;
+
+} /* End MSG_STATS_Percentile() */
+
+
+/******************************************************************************
+** Function: MSG_STATS_RecordLatency
+**
+** Notes:
+**   1. Unsigned subtraction handles the timestamp wrap
+**
+*/
+void MSG_STATS_RecordLatency(uint16 TopicId, MSG_STATS_Dir_t Dir, uint32 StartTime,
+                             uint32 XlateTime, uint32 EndTime)
+{
+
+   MSG_STATS_Hist_t *Hist;
+
+   if (TopicId < MQTT_TOPIC_TBL_MAX_TOPICS && Dir < MSG_STATS_DIR_CNT)
+   {
+
+      Hist = MsgStats->Topic[TopicId].Hist[Dir];
+
+      MSG_STATS_AddSample(&Hist[MSG_STATS_STAGE_TRANSLATE], XlateTime - StartTime);
+      MSG_STATS_AddSample(&Hist[MSG_STATS_STAGE_FORWARD],   EndTime - XlateTime);
+      MSG_STATS_AddSample(&Hist[MSG_STATS_STAGE_TOTAL],     EndTime - StartTime);
+
+   }
+
+} /* End MSG_STATS_RecordLatency() */
+
+
+/******************************************************************************
+** Function: MSG_STATS_ResetStatus
+**
+*/
+void MSG_STATS_ResetStatus(void)
+{
+
+   memset(MsgStats->Topic, 0, sizeof(MsgStats->Topic));
+   memset(MsgStats->UnmatchedCnt, 0, sizeof(MsgStats->UnmatchedCnt));
+
+   MsgStats->TlmHkCnt = 0;
+   MsgStats->TlmTopicStartId = 0;
+
+} /* End MSG_STATS_ResetStatus() */
+
+
+/******************************************************************************
+** Function: MSG_STATS_SendTlm
+**
+** Notes:
+**   1. A zero period disables statistics telemetry
+**
+*/
+void MSG_STATS_SendTlm(void)
+{
+
+   if (MsgStats->TlmHkPeriod > 0)
+   {
+      if (++MsgStats->TlmHkCnt >= MsgStats->TlmHkPeriod)
+      {
+
+         MsgStats->TlmHkCnt = 0;
+
+         SendTopicStatsTlm();
+         SendLatencyTlm();
+
+         MsgStats->TlmTopicStartId += MSG_STATS_TLM_TOPIC_CNT;
+         if (MsgStats->TlmTopicStartId >= MQTT_TOPIC_TBL_GetTopicCnt())
+         {
+            MsgStats->TlmTopicStartId = 0;
+         }
+      }
+   }
+
+} /* End MSG_STATS_SendTlm() */
+
+
+/******************************************************************************
+** Function: LoadDirCntTlm
+**
+*/
+static void LoadDirCntTlm(MQTT_GW_DirCnt_t *DirTlm, const MSG_STATS_Cnt_t *Cnt)
+{
+
+   DirTlm->MsgInCnt    = Cnt->MsgInCnt;
+   DirTlm->MsgOutCnt   = Cnt->MsgOutCnt;
+   DirTlm->ByteInCnt   = Cnt->ByteInCnt;
+   DirTlm->ByteOutCnt  = Cnt->ByteOutCnt;
+   DirTlm->XlateErrCnt = Cnt->XlateErrCnt;
+   DirTlm->DropCnt     = Cnt->DropCnt;
+   DirTlm->SuppressCnt = Cnt->SuppressCnt;
+
+} /* End LoadDirCntTlm() */
+
+
+/******************************************************************************
+** Function: LoadStageTlm
+**
+*/
+static void LoadStageTlm(MQTT_GW_LatencyStage_t *StageTlm, const MSG_STATS_Hist_t *Hist)
+{
+
+   StageTlm->Count = Hist->Count;
+   StageTlm->P50   = MSG_STATS_Percentile(Hist, 50);
+   StageTlm->P99   = MSG_STATS_Percentile(Hist, 99);
+   StageTlm->Max   = Hist->Max;
+
+} /* End LoadStageTlm() */
+
+
+/******************************************************************************
+** Function: SendLatencyTlm
+**
+*/
+static void SendLatencyTlm(void)
+{
+
+   uint16 i;
+   uint16 TopicId;
+   const MSG_STATS_Hist_t *Hist;
+   MQTT_GW_LatencyTlm_Payload_t *Payload = &MsgStats->LatencyTlm.Payload;
+
+   memset(Payload, 0, sizeof(MQTT_GW_LatencyTlm_Payload_t));
+
+   Payload->TopicStartId = MsgStats->TlmTopicStartId;
+
+   for (i=0; i < MSG_STATS_TLM_TOPIC_CNT; i++)
+   {
+
+      TopicId = MsgStats->TlmTopicStartId + i;
+      if (TopicId >= MQTT_TOPIC_TBL_GetTopicCnt())
+      {
+         break;
+      }
+
+      Hist = MsgStats->Topic[TopicId].Hist[MSG_STATS_DIR_SB_TO_MQTT];
+      LoadStageTlm(&Payload->Topic[i].SbToMqtt.Translate, &Hist[MSG_STATS_STAGE_TRANSLATE]);
+      LoadStageTlm(&Payload->Topic[i].SbToMqtt.Forward,   &Hist[MSG_STATS_STAGE_FORWARD]);
+      LoadStageTlm(&Payload->Topic[i].SbToMqtt.Total,     &Hist[MSG_STATS_STAGE_TOTAL]);
+
+      Hist = MsgStats->Topic[TopicId].Hist[MSG_STATS_DIR_MQTT_TO_SB];
+      LoadStageTlm(&Payload->Topic[i].MqttToSb.Translate, &Hist[MSG_STATS_STAGE_TRANSLATE]);
+      LoadStageTlm(&Payload->Topic[i].MqttToSb.Forward,   &Hist[MSG_STATS_STAGE_FORWARD]);
+      LoadStageTlm(&Payload->Topic[i].MqttToSb.Total,     &Hist[MSG_STATS_STAGE_TOTAL]);
+
+      ++Payload->TopicCnt;
+
+   } /* End topic loop */
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(MsgStats->LatencyTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(MsgStats->LatencyTlm.TelemetryHeader), true);
+
+} /* End SendLatencyTlm() */
+
+
+/******************************************************************************
+** Function: SendTopicStatsTlm
+**
+*/
+static void SendTopicStatsTlm(void)
+{
+
+   uint16 i;
+   uint16 TopicId;
+   MQTT_GW_TopicStatsTlm_Payload_t *Payload = &MsgStats->TopicStatsTlm.Payload;
+
+   memset(Payload, 0, sizeof(MQTT_GW_TopicStatsTlm_Payload_t));
+
+   Payload->TopicStartId     = MsgStats->TlmTopicStartId;
+   Payload->SbUnmatchedCnt   = MsgStats->UnmatchedCnt[MSG_STATS_DIR_SB_TO_MQTT];
+   Payload->MqttUnmatchedCnt = MsgStats->UnmatchedCnt[MSG_STATS_DIR_MQTT_TO_SB];
+
+   for (i=0; i < MSG_STATS_TLM_TOPIC_CNT; i++)
+   {
+
+      TopicId = MsgStats->TlmTopicStartId + i;
+      if (TopicId >= MQTT_TOPIC_TBL_GetTopicCnt())
+      {
+         break;
+      }
+
+      LoadDirCntTlm(&Payload->Topic[i].SbToMqtt, &MsgStats->Topic[TopicId].Cnt[MSG_STATS_DIR_SB_TO_MQTT]);
+      LoadDirCntTlm(&Payload->Topic[i].MqttToSb, &MsgStats->Topic[TopicId].Cnt[MSG_STATS_DIR_MQTT_TO_SB]);
+
+      ++Payload->TopicCnt;
+
+   } /* End topic loop */
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(MsgStats->TopicStatsTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(MsgStats->TopicStatsTlm.TelemetryHeader), true);
+
+} /* End SendTopicStatsTlm() */
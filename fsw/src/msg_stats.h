@@ -0,0 +1,303 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Collect per-topic message statistics
+**
+** Notes:
+**   1. Latency is measured at three points in each direction and the
+**      differences are accumulated in fixed-bucket log2 histograms:
+**      - SB-to-MQTT: SB receive, encode done, socket write
+**      - MQTT-to-SB: socket read, decode done, CFE_SB_TransmitMsg()
+**   2. Bucket i holds latencies in [2^i, 2^(i+1)) microseconds with bucket 0
+**      also holding zero. The last bucket holds everything larger. The
+**      percentiles reported in telemetry are the upper bound of the bucket
+**      containing the percentile, clipped to the observed maximum.
+**   3. Message and byte counters are also maintained for each topic and
+**      direction. "In" is traffic entering the gateway (SB messages for
+**      SB-to-MQTT, MQTT payloads for MQTT-to-SB) and "Out" is the translated
+**      traffic leaving the gateway.
+**   4. Each topic and direction is only written by one task at a time
+**      (SB-to-MQTT by the main task and MQTT-to-SB under the topic's
+**      MSG_TRANS decode mutex) so no locking is used. The unmatched
+**      counts are diagnostics that may miss a count if the load generator
+**      and MQTT child task miss at the same time. A reset
+**      that occurs while a sample is being recorded may leave one sample
+**      in the cleared histogram which is acceptable for diagnostics.
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+#ifndef _msg_stats_
+#define _msg_stats_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+typedef enum
+{
+
+   MSG_STATS_DIR_SB_TO_MQTT = 0,
+   MSG_STATS_DIR_MQTT_TO_SB = 1,
+   MSG_STATS_DIR_CNT        = 2
+
+} MSG_STATS_Dir_t;
+
+/*
+** Translate: SB receive to encode done, or socket read to decode done
+** Forward:   Encode done to socket write, or decode done to SB transmit
+** Total:     First timestamp to last timestamp
+*/
+typedef enum
+{
+
+   MSG_STATS_STAGE_TRANSLATE = 0,
+   MSG_STATS_STAGE_FORWARD   = 1,
+   MSG_STATS_STAGE_TOTAL     = 2,
+   MSG_STATS_STAGE_CNT       = 3
+
+} MSG_STATS_Stage_t;
+
+
+typedef struct
+{
+
+   uint32  Count;
+   uint32  Max;
+   uint32  Bucket[MSG_STATS_HIST_BUCKETS];
+
+} MSG_STATS_Hist_t;
+
+
+typedef struct
+{
+
+   uint32  MsgInCnt;
+   uint32  MsgOutCnt;
+   uint32  ByteInCnt;
+   uint32  ByteOutCnt;
+   uint32  XlateErrCnt;
+   uint32  DropCnt;
+   uint32  SuppressCnt;
+
+} MSG_STATS_Cnt_t;
+
+
+typedef struct
+{
+
+   MSG_STATS_Cnt_t   Cnt[MSG_STATS_DIR_CNT];
+   MSG_STATS_Hist_t  Hist[MSG_STATS_DIR_CNT][MSG_STATS_STAGE_CNT];
+
+} MSG_STATS_Topic_t;
+
+
+/*
+** Class Definition
+*/
+
+typedef struct
+{
+
+   uint16  TlmHkPeriod;   /* Send statistics telemetry every N housekeeping requests */
+   uint16  TlmHkCnt;
+   uint16  TlmTopicStartId;
+
+   uint32  UnmatchedCnt[MSG_STATS_DIR_CNT];
+
+   MSG_STATS_Topic_t  Topic[MQTT_TOPIC_TBL_MAX_TOPICS];
+
+   /*
+   ** Telemetry Packets
+   */
+
+   MQTT_GW_LatencyTlm_t     LatencyTlm;
+   MQTT_GW_TopicStatsTlm_t  TopicStatsTlm;
+
+} MSG_STATS_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: MSG_STATS_Constructor
+**
+** Notes:
+**    1. This function must be called prior to any other functions being
+**       called using the same MSG_STATS instance.
+*/
+void MSG_STATS_Constructor(MSG_STATS_Class_t *MsgStatsPtr,
+                           const INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: MSG_STATS_GetTime
+**
+** Return a free running microsecond timestamp for latency measurements.
+**
+** Notes:
+**   1. The timestamp wraps so it must only be used to compute differences
+**      between samples that are less than ~71 minutes apart.
+**   2. The timestamp is monotonic on Linux. Other platforms use the OSAL
+**      local time which may step if the clock is set.
+**
+*/
+uint32 MSG_STATS_GetTime(void);
+
+
+/******************************************************************************
+** Function: MSG_STATS_AddSample
+**
+** Add a latency sample in microseconds to a histogram.
+**
+** Notes:
+**   1. Used by MSG_STATS_RecordLatency() and by benchmarks that keep their
+**      own histograms so their samples aren't mixed with gateway traffic.
+**
+*/
+void MSG_STATS_AddSample(MSG_STATS_Hist_t *Hist, uint32 Latency);
+
+
+/******************************************************************************
+** Function: MSG_STATS_CountDrop
+**
+** Count a translated message that could not be sent (publish or SB transmit
+** error).
+**
+*/
+void MSG_STATS_CountDrop(uint16 TopicId, MSG_STATS_Dir_t Dir);
+
+
+/******************************************************************************
+** Function: MSG_STATS_CountMsgIn
+**
+** Count a message entering the gateway for a topic.
+**
+*/
+void MSG_STATS_CountMsgIn(uint16 TopicId, MSG_STATS_Dir_t Dir, uint32 ByteCnt);
+
+
+/******************************************************************************
+** Function: MSG_STATS_CountMsgOut
+**
+** Count a translated message that was sent by the gateway.
+**
+*/
+void MSG_STATS_CountMsgOut(uint16 TopicId, MSG_STATS_Dir_t Dir, uint32 ByteCnt);
+
+
+/******************************************************************************
+** Function: MSG_STATS_CountSuppressed
+**
+** Count a received message that was not translated because it duplicates
+** the last published message.
+**
+*/
+void MSG_STATS_CountSuppressed(uint16 TopicId, MSG_STATS_Dir_t Dir);
+
+
+/******************************************************************************
+** Function: MSG_STATS_CountUnmatched
+**
+** Count a message that could not be mapped to a topic table entry.
+**
+*/
+void MSG_STATS_CountUnmatched(MSG_STATS_Dir_t Dir);
+
+
+/******************************************************************************
+** Function: MSG_STATS_CountXlateErr
+**
+** Count a message that failed to be encoded (SB-to-MQTT) or decoded
+** (MQTT-to-SB).
+**
+*/
+void MSG_STATS_CountXlateErr(uint16 TopicId, MSG_STATS_Dir_t Dir);
+
+
+/******************************************************************************
+** Function: MSG_STATS_GetTopic
+**
+** Return a pointer to a topic's statistics or NULL if TopicId is invalid.
+**
+*/
+const MSG_STATS_Topic_t *MSG_STATS_GetTopic(uint16 TopicId);
+
+
+/******************************************************************************
+** Function: MSG_STATS_Percentile
+**
+** Return the upper bound of the bucket containing the requested percentile.
+**
+** Notes:
+**   1. Percent must be in the range 1..100. Zero is returned if the histogram
+**      has no samples.
+**
+*/
+uint32 MSG_STATS_Percentile(const MSG_STATS_Hist_t *Hist, uint32 Percent);
+
+
+/******************************************************************************
+** Function: MSG_STATS_RecordLatency
+**
+** Record the latency of a message that passed through the gateway.
+**
+** Notes:
+**   1. StartTime, XlateTime, and EndTime are MSG_STATS_GetTime() values taken
+**      at the three measurement points defined in the file prologue.
+**   2. Invalid topic IDs are ignored.
+**
+*/
+void MSG_STATS_RecordLatency(uint16 TopicId, MSG_STATS_Dir_t Dir, uint32 StartTime,
+                             uint32 XlateTime, uint32 EndTime);
+
+
+/******************************************************************************
+** Function: MSG_STATS_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+*/
+void MSG_STATS_ResetStatus(void);
+
+
+/******************************************************************************
+** Function: MSG_STATS_SendTlm
+**
+** Send the statistics telemetry packets if the housekeeping cycle period has
+** elapsed.
+**
+** Notes:
+**   1. Called each time the app receives a send housekeeping request.
+**   2. If there are more topics than fit in a packet then each packet reports
+**      the next block of topic IDs.
+**
+*/
+void MSG_STATS_SendTlm(void);
+
+
+#endif /* _msg_stats_ */
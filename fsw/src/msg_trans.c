@@ -33,9 +33,26 @@
 ** Include Files:
 */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "msg_trans.h"
+#include "last_value.h"
+
+
+/************************************/
+/** Local File Function Prototypes **/
+/************************************/
+
+static bool   DecodePayload(const MQTT_TOPIC_TBL_Data_t *Data, uint16 TopicId,
+                            const char *Payload, uint16 PayloadLen,
+                            CFE_MSG_Message_t **CfeMsg);
+static bool   DedupSuppress(uint16 TopicId, uint16 DedupTime, const CFE_MSG_Message_t *MsgPtr,
+                            CFE_MSG_Size_t MsgSize);
+static uint64 HashSbMsg(const CFE_MSG_Message_t *MsgPtr, CFE_MSG_Size_t MsgSize);
+static bool   MuxData(const char *Payload, uint16 PayloadLen, const char **Data, uint16 *DataLen);
+static bool   MuxWrap(const MQTT_TOPIC_TBL_Entry_t *Entry, const char **Payload);
+
 
 /**********************/
 /** Global File Data **/
@@ -53,15 +70,34 @@ void MSG_TRANS_Constructor(MSG_TRANS_Class_t *MsgTransPtr,
                            TBLMGR_Class_t *TblMgr)
 {
  
+   uint16 i;
+   char   MutexName[OS_MAX_API_NAME];
+   uint32 ReservedMid[MQTT_TOPIC_TBL_RESERVED_MID_CNT];
+   
    MsgTrans = MsgTransPtr;
 
    CFE_PSP_MemSet((void*)MsgTransPtr, 0, sizeof(MSG_TRANS_Class_t));
 
+   MsgTrans->DedupClockTime = MSG_STATS_GetTime();
+
    MsgTrans->TopicBaseMid  = INITBL_GetIntConfig(IniTbl, CFG_MQTT_GW_TOPIC_1_TLM_TOPICID);
    
+   ReservedMid[0] = INITBL_GetIntConfig(IniTbl, CFG_MQTT_GW_CMD_TOPICID);
+   ReservedMid[1] = INITBL_GetIntConfig(IniTbl, CFG_MQTT_GW_SEND_HK_TOPICID);
+   ReservedMid[2] = INITBL_GetIntConfig(IniTbl, CFG_MQTT_GW_HK_TLM_TOPICID);
+   ReservedMid[3] = INITBL_GetIntConfig(IniTbl, CFG_MQTT_GW_LATENCY_TLM_TOPICID);
+   ReservedMid[4] = INITBL_GetIntConfig(IniTbl, CFG_MQTT_GW_TOPIC_STATS_TLM_TOPICID);
+   
+   for (i=0; i < DECODE_POOL_MAX_WORKERS; i++)
+   {
+      sprintf(MutexName, "MQTT_DECODE_%d", i);
+      OS_MutSemCreate(&MsgTrans->DecodeMutex[i], MutexName, 0);
+   }
+   
    MQTT_TOPIC_TBL_Constructor(&MsgTrans->TopicTbl, 
                               INITBL_GetStrConfig(IniTbl, CFG_APP_CFE_NAME),
-                              MsgTrans->TopicBaseMid);
+                              MsgTrans->TopicBaseMid, ReservedMid,
+                              INITBL_GetIntConfig(IniTbl, CFG_MQTT_GW_LAT_PROBE_TLM_TOPICID));
                               
    TBLMGR_RegisterTblWithDef(TblMgr, MQTT_TOPIC_TBL_LoadCmd, 
                              MQTT_TOPIC_TBL_DumpCmd,  
@@ -72,109 +108,217 @@ void MSG_TRANS_Constructor(MSG_TRANS_Class_t *MsgTransPtr,
 
 
 /******************************************************************************
-** Function: MSG_TRANS_ProcessMqttMsg
+** Function: MSG_TRANS_ClearDedup
+**
+*/
+void MSG_TRANS_ClearDedup(uint16 TopicId)
+{
+
+   if (TopicId < MQTT_TOPIC_TBL_MAX_TOPICS)
+   {
+      MsgTrans->Dedup[TopicId].Valid = false;
+   }
+
+} /* End MSG_TRANS_ClearDedup() */
+
+
+/******************************************************************************
+** Function: MSG_TRANS_DecodeMqttMsg
 **
 ** Notes:
-**   1. Signature must match MQTT_CLIENT_MsgCallback_t
-**   2. MQTT has no delimeter between the topic and payload
+**   1. See DecodePayload() for the translation.
+**   2. A stale message is not counted in the topic's statistics because
+**      its topic ID may belong to another topic in the active snapshot.
+**   3. The last value cache keeps a multiplexed topic's envelope so it can
+**      be replayed on the topic.
 **
 */
-void MSG_TRANS_ProcessMqttMsg(MessageData* MsgData)
+bool MSG_TRANS_DecodeMqttMsg(uint16 TopicId, uint32 Generation, const char *Payload,
+                             uint16 PayloadLen, uint32 RcvTime)
 {
    
-   MQTTMessage* MsgPtr = MsgData->message;
-
-   uint16  id = 0;
-   uint16  TopicLen;
-   char    TopicStr[MQTT_TOPIC_TBL_MAX_TOPIC_LEN];
-   bool    MsgFound = false;
-   const MQTT_TOPIC_TBL_Entry_t *TopicTblEntry;
-   MQTT_TOPIC_TBL_JsonToCfe_t JsonToCfe;
+   const MQTT_TOPIC_TBL_Data_t *Data = MQTT_TOPIC_TBL_GetData();
+   bool RetStatus = (Generation == 0 || Generation == Data->Generation);
    CFE_MSG_Message_t *CfeMsg;
    CFE_SB_MsgId_t    MsgId = CFE_SB_INVALID_MSG_ID;
-      
-OS_printf("\n****************************  MSG_TRANS_ProcessMqttMsg() ****************************\n");
-   CFE_EVS_SendEvent(MSG_TRANS_PROCESS_MQTT_MSG_EID, CFE_EVS_EventType_INFORMATION,
-                     "MSG_TRANS_ProcessMsg: Received topic %s", MsgData->topicName->lenstring.data);
-                    
-   if(MsgPtr->payloadlen)
+   CFE_MSG_Size_t    MsgSize = 0;
+   uint32 DecodeTime;
+   osal_id_t DecodeMutex = MsgTrans->DecodeMutex[MSG_TRANS_DECODE_STRIPE(TopicId)];
+   
+   if (RetStatus)
    {
-      
-      OS_printf("MsgPtr->payloadlen=%d\n", (int)MsgPtr->payloadlen);
 
-      while ( MsgFound == false && id < MQTT_TOPIC_TBL_MAX_TOPICS)
+      OS_MutSemTake(DecodeMutex);
+   
+      MSG_STATS_CountMsgIn(TopicId, MSG_STATS_DIR_MQTT_TO_SB, PayloadLen);
+   
+      if (DecodePayload(Data, TopicId, Payload, PayloadLen, &CfeMsg))
       {
 
-        TopicTblEntry = MQTT_TOPIC_TBL_GetEntry(id);
-        if (TopicTblEntry != NULL)
-        {
-            
-            TopicLen = strlen(TopicTblEntry->Name);
-            
-            OS_printf("Table topic name=%s, length=%d\n", TopicTblEntry->Name, TopicLen);
-            if (strncmp(TopicTblEntry->Name, MsgData->topicName->lenstring.data, TopicLen) == 0)
-            {
-               MsgFound = true;
-               memcpy(TopicStr, MsgData->topicName->lenstring.data, TopicLen);
-               TopicStr[TopicLen] = '\0';
-               CFE_EVS_SendEvent(MSG_TRANS_PROCESS_MQTT_MSG_EID, CFE_EVS_EventType_INFORMATION,
-                                "MSG_TRANS_ProcessMqttMsg: Topic=%s, Payload=%s", 
-                                 TopicStr, &MsgData->topicName->lenstring.data[TopicLen]);
-            } 
-            else
-            {
-               id++;
-            }
-        }
-      } /* End while loop */
-
-      if (MsgFound)
-      {
-            
-         CFE_EVS_SendEvent(MSG_TRANS_PROCESS_MQTT_MSG_EID, CFE_EVS_EventType_INFORMATION,
-                           "MSG_TRANS_ProcessMqttMsg: Found message at index %d", id); 
-                       
-         JsonToCfe = MQTT_TOPIC_TBL_GetJsonToCfe(id);    
-         
-         if (JsonToCfe(&CfeMsg, &MsgData->topicName->lenstring.data[TopicLen], MsgPtr->payloadlen))
-         {
-      
-            CFE_MSG_GetMsgId(CfeMsg, &MsgId);
-      
-            CFE_EVS_SendEvent(MSG_TRANS_PROCESS_MQTT_MSG_EID, CFE_EVS_EventType_INFORMATION,
-                              "MSG_TRANS_ProcessMqttMsg: Sending SB message 0x%04X", CFE_SB_MsgIdToValue(MsgId)); 
-            
-            CFE_SB_TimeStampMsg(CFE_MSG_PTR(*CfeMsg));
-            CFE_SB_TransmitMsg(CFE_MSG_PTR(*CfeMsg), true);
+         DecodeTime = MSG_STATS_GetTime();
+         CFE_MSG_GetMsgId(CfeMsg, &MsgId);
 
+         TRACE_RING_Write(TRACE_RING_MODULE_MSG_TRANS, TRACE_RING_LEVEL_DEBUG, MSG_TRANS_MQTT_TO_SB_TID,
+                          TopicId, CFE_SB_MsgIdToValue(MsgId), NULL, 0);
+      
+         CFE_SB_TimeStampMsg(CFE_MSG_PTR(*CfeMsg));
+         LAST_VALUE_Update(TopicId, MSG_STATS_DIR_MQTT_TO_SB, MQTT_TOPIC_TBL_DATA_NAME(Data, TopicId),
+                           Payload, PayloadLen, CfeMsg);
+         if (CFE_SB_TransmitMsg(CFE_MSG_PTR(*CfeMsg), true) == CFE_SUCCESS)
+         {
+            MSG_STATS_RecordLatency(TopicId, MSG_STATS_DIR_MQTT_TO_SB, RcvTime,
+                                    DecodeTime, MSG_STATS_GetTime());
+            CFE_MSG_GetSize(CfeMsg, &MsgSize);
+            MSG_STATS_CountMsgOut(TopicId, MSG_STATS_DIR_MQTT_TO_SB, MsgSize);
          }
          else
          {
-            CFE_EVS_SendEvent(MSG_TRANS_PROCESS_MQTT_MSG_EID, CFE_EVS_EventType_ERROR,
-                              "MSG_TRANS_ProcessMqttMsg: Error creating SB message from JSON topic %s, Id %d",
-                               TopicStr, id); 
+            MSG_STATS_CountDrop(TopicId, MSG_STATS_DIR_MQTT_TO_SB);
          }
-         
-      } /* End if message found */
-      else 
+
+      }
+      else
+      {
+         MSG_STATS_CountXlateErr(TopicId, MSG_STATS_DIR_MQTT_TO_SB);
+         CFE_EVS_SendEvent(MSG_TRANS_PROCESS_MQTT_MSG_EID, CFE_EVS_EventType_ERROR,
+                           "MSG_TRANS_DecodeMqttMsg: Error creating SB message from JSON for topic %d",
+                           TopicId); 
+      }
+   
+      OS_MutSemGive(DecodeMutex);
+
+   } /* End if current snapshot */
+
+   return RetStatus;
+   
+} /* End MSG_TRANS_DecodeMqttMsg() */
+
+
+/******************************************************************************
+** Function: MSG_TRANS_DemuxMqttMsg
+**
+** Notes:
+**   1. The tag is the envelope's first member so the search stops early.
+**      The tag's topic is one jump table read.
+**   2. The tag must be an unsigned integer. A JSON number with a fraction
+**      or exponent is an undefined tag rather than being truncated.
+**
+*/
+uint16 MSG_TRANS_DemuxMqttMsg(uint16 TopicId, const char *Payload, uint16 PayloadLen)
+{
+
+   uint16       DemuxTopicId = TopicId;
+   uint32       Tag = MQTT_TOPIC_TBL_MAX_MUX_TAGS;
+   const char  *Value;
+   size_t       ValueLen;
+   JSONTypes_t  ValueType;
+   char         NumStr[12];
+   char        *NumEnd;
+   unsigned long NumValue;
+   const MQTT_TOPIC_TBL_Entry_t *Entry = MQTT_TOPIC_TBL_GetEntry(TopicId);
+
+   if (Entry != NULL && Entry->MuxIdx != MQTT_TOPIC_TBL_MUX_NONE)
+   {
+   
+      if (JSON_SearchConst(Payload, PayloadLen, "t", 1, &Value, &ValueLen, &ValueType) == JSONValid &&
+          ValueType == JSONNumber && ValueLen < sizeof(NumStr))
+      {
+         memcpy(NumStr, Value, ValueLen);
+         NumStr[ValueLen] = '\0';
+         NumValue = strtoul(NumStr, &NumEnd, 10);
+         if (ValueLen > 0 && *NumEnd == '\0' && NumStr[0] != '-' &&
+             NumValue < MQTT_TOPIC_TBL_MAX_MUX_TAGS)
+         {
+            Tag = (uint32)NumValue;
+         }
+      }
+      
+      DemuxTopicId = MQTT_TOPIC_TBL_FindTag(TopicId, Tag);
+      
+      if (DemuxTopicId == MQTT_TOPIC_TBL_UNUSED_ID)
       {
+         ++MsgTrans->DemuxErrCnt;
+         MSG_STATS_CountUnmatched(MSG_STATS_DIR_MQTT_TO_SB);
+         CFE_EVS_SendEvent(MSG_TRANS_DEMUX_ERR_EID, CFE_EVS_EventType_ERROR, 
+                           "MSG_TRANS_DemuxMqttMsg: Multiplexed topic %s message has no tag or an undefined tag",
+                           MQTT_TOPIC_TBL_GetName(TopicId));
+      }
+   
+   } /* End if multiplexed */
+   
+   return DemuxTopicId;
+
+} /* End MSG_TRANS_DemuxMqttMsg() */
+
+
+/******************************************************************************
+** Function: MSG_TRANS_FindMqttTopic
+**
+** Notes:
+**   1. The MQTT topic name is a length string that is not null terminated
+**   2. Per-message diagnostics are written to the trace ring. Only errors
+**      generate event messages and they are filtered at registration.
+**
+*/
+uint16 MSG_TRANS_FindMqttTopic(const MessageData* MsgData)
+{
+   
+   const MQTTMessage* MsgPtr = MsgData->message;
+   const char*  TopicName = MsgData->topicName->lenstring.data;
+   uint16       TopicLen  = (uint16)MsgData->topicName->lenstring.len;
+   uint16       TopicId   = MQTT_TOPIC_TBL_UNUSED_ID;
+   
+   TRACE_RING_Write(TRACE_RING_MODULE_MSG_TRANS, TRACE_RING_LEVEL_DEBUG, MSG_TRANS_MQTT_RCV_TID,
+                    TopicLen, MsgPtr->payloadlen, TopicName, TopicLen);
+                    
+   if(MsgPtr->payloadlen)
+   {
       
+      TopicId = MQTT_TOPIC_TBL_FindName(TopicName, TopicLen);
+
+      if (TopicId == MQTT_TOPIC_TBL_UNUSED_ID)
+      {
+         MSG_STATS_CountUnmatched(MSG_STATS_DIR_MQTT_TO_SB);
          CFE_EVS_SendEvent(MSG_TRANS_PROCESS_MQTT_MSG_EID, CFE_EVS_EventType_ERROR, 
-                           "MSG_TRANS_ProcessMqttMsg: Could not find a topic match for %s", 
-                           MsgData->topicName->lenstring.data);
-      
+                           "MSG_TRANS_FindMqttTopic: Could not find a topic match for %.*s", 
+                           TopicLen, TopicName);
+      }
+      else
+      {
+         TopicId = MSG_TRANS_DemuxMqttMsg(TopicId, (const char *)MsgPtr->payload,
+                                          (uint16)MsgPtr->payloadlen);
       }
    
    } /* End null message len */
    else {
       
-      OS_printf("Null MQTT wessage data length for %s\n", MsgData->topicName->lenstring.data);
+      TRACE_RING_Write(TRACE_RING_MODULE_MSG_TRANS, TRACE_RING_LEVEL_INFO, MSG_TRANS_MQTT_NULL_PAYLOAD_TID,
+                       TopicLen, 0, TopicName, TopicLen);
     
    }
+  
+   return TopicId;
    
-   fflush(stdout);
+} /* End MSG_TRANS_FindMqttTopic() */
 
-  
+
+/******************************************************************************
+** Function: MSG_TRANS_ProcessMqttMsg
+**
+*/
+void MSG_TRANS_ProcessMqttMsg(MessageData* MsgData)
+{
+   
+   uint32 RcvTime    = MSG_STATS_GetTime();
+   uint32 Generation = MQTT_TOPIC_TBL_GetData()->Generation;
+   uint16 TopicId    = MSG_TRANS_FindMqttTopic(MsgData);
+   
+   if (TopicId != MQTT_TOPIC_TBL_UNUSED_ID)
+   {
+      MSG_TRANS_DecodeMqttMsg(TopicId, Generation, (const char *)MsgData->message->payload,
+                              (uint16)MsgData->message->payloadlen, RcvTime);
+   }
+   
 } /* End MSG_TRANS_ProcessMqttMsg() */
 
 
@@ -182,57 +326,73 @@ OS_printf("\n****************************  MSG_TRANS_ProcessMqttMsg() **********
 ** Function: MSG_TRANS_ProcessSbMsg
 **
 ** Notes:
-**   None
+**   1. See MSG_TRANS_ProcessMqttMsg() notes for diagnostic reporting.
+**   2. Duplicates are suppressed before the encode so they cost one hash.
+**      The last value cache already holds their content.
 **
 */
-bool MSG_TRANS_ProcessSbMsg(const CFE_MSG_Message_t *MsgPtr,
+bool MSG_TRANS_ProcessSbMsg(const CFE_MSG_Message_t *MsgPtr, uint16 *TopicId,
                             const char **Topic, const char **Payload)
 {
    
    bool RetStatus = false;
-   int32 TopicId;
+   uint16 SbTopicId;
    int32 SbStatus;
    CFE_SB_MsgId_t  MsgId = CFE_SB_INVALID_MSG_ID;
-   MQTT_TOPIC_TBL_CfeToJson_t CfeToJson;
+   CFE_MSG_Size_t  MsgSize = 0;
+   const MQTT_TOPIC_TBL_Entry_t *Entry;
    const char *JsonMsgTopic;
    const char *JsonMsgPayload;
+   uint16      PayloadLen;
 
-OS_printf("\n****************************  MSG_TRANS_ProcessSBMsg() ****************************\n");
    SbStatus = CFE_MSG_GetMsgId(MsgPtr, &MsgId);
    if (SbStatus == CFE_SUCCESS)
    {
    
-      CFE_EVS_SendEvent(MSG_TRANS_PROCESS_SB_MSG_EID, CFE_EVS_EventType_INFORMATION, 
-                        "MSG_TRANS_ProcessSbMsg: Received SB message ID 0x%04X, MQTT base ID 0x%04X", 
-                        CFE_SB_MsgIdToValue(MsgId), MsgTrans->TopicBaseMid); 
+      SbTopicId = MQTT_TOPIC_TBL_FindMid(CFE_SB_MsgIdToValue(MsgId));
       
-      TopicId = CFE_SB_MsgIdToValue(MsgId) - MsgTrans->TopicBaseMid;
-      if (TopicId >= 0 && TopicId < MQTT_TOPIC_TBL_MAX_TOPICS)
+      TRACE_RING_Write(TRACE_RING_MODULE_MSG_TRANS, TRACE_RING_LEVEL_DEBUG, MSG_TRANS_SB_RCV_TID,
+                       CFE_SB_MsgIdToValue(MsgId), SbTopicId, NULL, 0);
+
+      if (SbTopicId != MQTT_TOPIC_TBL_UNUSED_ID)
       {
          
-         CfeToJson = MQTT_TOPIC_TBL_GetCfeToJson(TopicId);    
+         CFE_MSG_GetSize(MsgPtr, &MsgSize);
+         MSG_STATS_CountMsgIn(SbTopicId, MSG_STATS_DIR_SB_TO_MQTT, MsgSize);
+
+         Entry = MQTT_TOPIC_TBL_GetEntry(SbTopicId);
          
-         if (CfeToJson(&JsonMsgTopic, &JsonMsgPayload, MsgPtr))
+         if (Entry != NULL && Entry->DedupTime > 0 &&
+             DedupSuppress(SbTopicId, Entry->DedupTime, MsgPtr, MsgSize))
          {
+            MSG_STATS_CountSuppressed(SbTopicId, MSG_STATS_DIR_SB_TO_MQTT);
+         }
+         else if (MSG_TRANS_TranslateSbMsg(SbTopicId, MsgPtr, &JsonMsgTopic, &JsonMsgPayload))
+         {
+            *TopicId = SbTopicId;
             *Topic   = JsonMsgTopic; 
             *Payload = JsonMsgPayload;
             RetStatus = true;
-            CFE_EVS_SendEvent(MSG_TRANS_PROCESS_SB_MSG_EID, CFE_EVS_EventType_INFORMATION,
-                              "MSG_TRANS_ProcessMqttMsg: Created MQTT topic %s message %s",
-                              JsonMsgTopic, JsonMsgPayload);             
+            PayloadLen = strlen(JsonMsgPayload);
+            LAST_VALUE_Update(SbTopicId, MSG_STATS_DIR_SB_TO_MQTT, JsonMsgTopic,
+                              JsonMsgPayload, PayloadLen, MsgPtr);
+            TRACE_RING_Write(TRACE_RING_MODULE_MSG_TRANS, TRACE_RING_LEVEL_DEBUG, MSG_TRANS_SB_TO_MQTT_TID,
+                             SbTopicId, PayloadLen, JsonMsgTopic, MQTT_TOPIC_TBL_MAX_TOPIC_LEN);
          }
          else
          {
-            CFE_EVS_SendEvent(MSG_TRANS_PROCESS_MQTT_MSG_EID, CFE_EVS_EventType_ERROR,
-                              "MSG_TRANS_ProcessMqttMsg: Error creating JSON message from SB for topic %d", TopicId); 
+            MSG_STATS_CountXlateErr(SbTopicId, MSG_STATS_DIR_SB_TO_MQTT);
+            CFE_EVS_SendEvent(MSG_TRANS_PROCESS_SB_MSG_EID, CFE_EVS_EventType_ERROR,
+                              "MSG_TRANS_ProcessSbMsg: Error creating JSON message from SB for topic %d", SbTopicId); 
          
          }        
       }
       else
       {
+         MSG_STATS_CountUnmatched(MSG_STATS_DIR_SB_TO_MQTT);
          CFE_EVS_SendEvent(MSG_TRANS_PROCESS_SB_MSG_EID, CFE_EVS_EventType_ERROR, 
-                           "MSG_TRANS_ProcessMsg: Computed invalid topic id  %d from received MID 0x%04X and base MID 0x%04X", 
-                           TopicId, CFE_SB_MsgIdToValue(MsgId), MsgTrans->TopicBaseMid);
+                           "MSG_TRANS_ProcessSbMsg: No topic is defined for received MID 0x%04X", 
+                           CFE_SB_MsgIdToValue(MsgId));
       }
 
    } /* End message Id */
@@ -251,8 +411,285 @@ OS_printf("\n****************************  MSG_TRANS_ProcessSBMsg() ************
 void MSG_TRANS_ResetStatus(void)
 {
 
+   MsgTrans->DedupSuppressCnt = 0;
+   MsgTrans->DemuxErrCnt      = 0;
    MQTT_TOPIC_TBL_ResetStatus();
 
 } /* MSG_TRANS_ResetStatus() */
 
 
+/******************************************************************************
+** Function: MSG_TRANS_TranslateMqttMsg
+**
+*/
+bool MSG_TRANS_TranslateMqttMsg(uint16 TopicId, const char *Payload, uint16 PayloadLen,
+                                CFE_MSG_Size_t *MsgSize)
+{
+
+   bool RetStatus = false;
+   CFE_MSG_Message_t *CfeMsg;
+   osal_id_t DecodeMutex = MsgTrans->DecodeMutex[MSG_TRANS_DECODE_STRIPE(TopicId)];
+   
+   OS_MutSemTake(DecodeMutex);
+   
+   if (DecodePayload(MQTT_TOPIC_TBL_GetData(), TopicId, Payload, PayloadLen, &CfeMsg))
+   {
+      CFE_MSG_GetSize(CfeMsg, MsgSize);
+      RetStatus = true;
+   }
+   
+   OS_MutSemGive(DecodeMutex);
+
+   return RetStatus;
+
+} /* End MSG_TRANS_TranslateMqttMsg() */
+
+
+/******************************************************************************
+** Function: MSG_TRANS_TranslateSbMsg
+**
+** Notes:
+**   1. A multiplexed topic's payload is wrapped in its tag envelope.
+**
+*/
+bool MSG_TRANS_TranslateSbMsg(uint16 TopicId, const CFE_MSG_Message_t *MsgPtr,
+                              const char **Topic, const char **Payload)
+{
+
+   bool RetStatus = false;
+   const MQTT_TOPIC_TBL_Entry_t *Entry = MQTT_TOPIC_TBL_GetEntry(TopicId);
+   const MQTT_TOPIC_TBL_Codec_t *Codec = MQTT_TOPIC_TBL_GetCodec(TopicId);
+   const char *JsonMsgTopic = MQTT_TOPIC_TBL_GetSbTopicName(TopicId, MsgPtr);
+   const char *JsonMsgPayload;
+
+   if (Codec != NULL && JsonMsgTopic != NULL &&
+       Codec->Func->CfeToJson(Codec->Inst, &JsonMsgPayload, MsgPtr) &&
+       (Entry == NULL || Entry->MuxIdx == MQTT_TOPIC_TBL_MUX_NONE ||
+        MuxWrap(Entry, &JsonMsgPayload)))
+   {
+      *Topic   = JsonMsgTopic;
+      *Payload = JsonMsgPayload;
+      RetStatus = true;
+   }
+
+   return RetStatus;
+
+} /* End MSG_TRANS_TranslateSbMsg() */
+
+
+/******************************************************************************
+** Function: MSG_TRANS_UpdateDedupClock
+**
+*/
+void MSG_TRANS_UpdateDedupClock(void)
+{
+
+   uint32 Now = MSG_STATS_GetTime();
+
+   MsgTrans->DedupClock    += (uint32)(Now - MsgTrans->DedupClockTime);
+   MsgTrans->DedupClockTime = Now;
+
+} /* End MSG_TRANS_UpdateDedupClock() */
+
+
+/******************************************************************************
+** Function: DecodePayload
+**
+** Decode an MQTT payload of topic 'TopicId' into the topic codec's SB
+** message.
+**
+** Notes:
+**   1. The caller must hold the topic's decode stripe mutex until it is
+**      done with CfeMsg.
+**   2. The SB message ID is set from the topic table so translators don't
+**      need to know which message ID their topic is bridged to.
+**   3. A multiplexed topic's codec decodes the envelope's data.
+**   4. The entry and codec are read from the one snapshot 'Data' so they
+**      always describe the same topic.
+**
+*/
+static bool DecodePayload(const MQTT_TOPIC_TBL_Data_t *Data, uint16 TopicId,
+                          const char *Payload, uint16 PayloadLen,
+                          CFE_MSG_Message_t **CfeMsg)
+{
+
+   bool RetStatus = false;
+   const MQTT_TOPIC_TBL_Entry_t *Entry = NULL;
+   const MQTT_TOPIC_TBL_Codec_t *Codec = NULL;
+   const char *MsgData = Payload;
+   uint16      MsgDataLen = PayloadLen;
+   bool        DataValid = true;
+   
+   if (TopicId < MQTT_TOPIC_TBL_MAX_TOPICS && Data->Entry[TopicId].Id != MQTT_TOPIC_TBL_UNUSED_ID)
+   {
+      Entry = &Data->Entry[TopicId];
+      Codec = &Data->Codec[TopicId];
+   }
+   
+   if (Entry != NULL && Entry->MuxIdx != MQTT_TOPIC_TBL_MUX_NONE)
+   {
+      DataValid = MuxData(Payload, PayloadLen, &MsgData, &MsgDataLen);
+   }
+   
+   if (Entry != NULL && Codec->Func != NULL && DataValid &&
+       Codec->Func->JsonToCfe(Codec->Inst, CfeMsg, MsgData, MsgDataLen))
+   {
+      CFE_MSG_SetMsgId(*CfeMsg, CFE_SB_ValueToMsgId(Entry->SbMid));
+      RetStatus = true;
+   }
+
+   return RetStatus;
+
+} /* End DecodePayload() */
+
+
+/******************************************************************************
+** Function: DedupSuppress
+**
+** Return true if an SB message of topic 'TopicId' matches the topic's last
+** published message and was received less than DedupTime seconds after
+** that publish. Otherwise the message is recorded as the last publish.
+**
+** Notes:
+**   1. The window is timed with the monotonic de-duplication clock so
+**      setting the cFE time doesn't suppress or release messages.
+**   2. A topic ID may be assigned to a different topic by a table load so
+**      every topic's last publish is forgotten when a new table is
+**      published.
+**
+*/
+static bool DedupSuppress(uint16 TopicId, uint16 DedupTime, const CFE_MSG_Message_t *MsgPtr,
+                          CFE_MSG_Size_t MsgSize)
+{
+
+   bool   RetStatus  = false;
+   uint32 Generation = MQTT_TOPIC_TBL_GetData()->Generation;
+   uint64 Hash = HashSbMsg(MsgPtr, MsgSize);
+   MSG_TRANS_Dedup_t *Dedup = &MsgTrans->Dedup[TopicId];
+
+   if (Generation != MsgTrans->DedupGeneration)
+   {
+      CFE_PSP_MemSet((void*)MsgTrans->Dedup, 0, sizeof(MsgTrans->Dedup));
+      MsgTrans->DedupGeneration = Generation;
+   }
+
+   MSG_TRANS_UpdateDedupClock();
+
+   if (Dedup->Valid && Dedup->Hash == Hash &&
+       (MsgTrans->DedupClock - Dedup->PubTime) < ((uint64)DedupTime * 1000000))
+   {
+      ++MsgTrans->DedupSuppressCnt;
+      RetStatus = true;
+   }
+   else
+   {
+      Dedup->Valid   = true;
+      Dedup->PubTime = MsgTrans->DedupClock;
+      Dedup->Hash    = Hash;
+   }
+
+   return RetStatus;
+
+} /* End DedupSuppress() */
+
+
+/******************************************************************************
+** Function: HashSbMsg
+**
+** Compute the 64-bit FNV-1a hash of an SB message's content.
+**
+** Notes:
+**   1. The APID and length are hashed in place of the primary header and
+**      the secondary header is skipped so the sequence count and
+**      timestamp are ignored.
+**
+*/
+static uint64 HashSbMsg(const CFE_MSG_Message_t *MsgPtr, CFE_MSG_Size_t MsgSize)
+{
+
+   const uint8   *MsgByte = (const uint8 *)MsgPtr;
+   CFE_MSG_Type_t MsgType = CFE_MSG_Type_Invalid;
+   CFE_MSG_ApId_t ApId = 0;
+   CFE_MSG_Size_t i = sizeof(CFE_MSG_CommandHeader_t);
+   uint64 Hash = 14695981039346656037u;
+
+   CFE_MSG_GetType(MsgPtr, &MsgType);
+   if (MsgType == CFE_MSG_Type_Tlm)
+   {
+      i = sizeof(CFE_MSG_TelemetryHeader_t);
+   }
+   CFE_MSG_GetApId(MsgPtr, &ApId);
+
+   Hash = (Hash ^ ApId) * 1099511628211u;
+   Hash = (Hash ^ MsgSize) * 1099511628211u;
+   for ( ; i < MsgSize; i++)
+   {
+      Hash ^= MsgByte[i];
+      Hash *= 1099511628211u;
+   }
+
+   return Hash;
+
+} /* End HashSbMsg() */
+
+
+/******************************************************************************
+** Function: MuxData
+**
+** Return the "d" value of a multiplexed topic envelope.
+**
+** Notes:
+**   1. A string value is returned with its quotes.
+**
+*/
+static bool MuxData(const char *Payload, uint16 PayloadLen, const char **Data, uint16 *DataLen)
+{
+
+   bool         RetStatus = false;
+   const char  *Value;
+   size_t       ValueLen;
+   JSONTypes_t  ValueType;
+
+   if (JSON_SearchConst(Payload, PayloadLen, "d", 1, &Value, &ValueLen, &ValueType) == JSONValid)
+   {
+      if (ValueType == JSONString)
+      {
+         --Value;
+         ValueLen += 2;
+      }
+      *Data     = Value;
+      *DataLen  = (uint16)ValueLen;
+      RetStatus = true;
+   }
+
+   return RetStatus;
+
+} /* End MuxData() */
+
+
+/******************************************************************************
+** Function: MuxWrap
+**
+** Wrap an encoded payload of multiplexed topic 'Entry' in its tag envelope.
+** Returns false if the envelope doesn't fit in the envelope buffer.
+**
+*/
+static bool MuxWrap(const MQTT_TOPIC_TBL_Entry_t *Entry, const char **Payload)
+{
+
+   bool  RetStatus = false;
+   char *MuxPayload = MsgTrans->MuxPayload[Entry->MuxIdx];
+   int   MuxLen;
+
+   MuxLen = snprintf(MuxPayload, MQTT_TOPIC_TBL_MUX_PAYLOAD_LEN, "{\"t\":%u,\"d\":%s}",
+                     Entry->MuxTag, *Payload);
+
+   if (MuxLen > 0 && MuxLen < MQTT_TOPIC_TBL_MUX_PAYLOAD_LEN)
+   {
+      *Payload  = MuxPayload;
+      RetStatus = true;
+   }
+
+   return RetStatus;
+
+} /* End MuxWrap() */
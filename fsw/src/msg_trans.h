@@ -22,6 +22,22 @@
 **      the table. Since MQTT manager has very little functionality beyond
 **      processing the table, a single object is used for management functions
 **      and table processing.
+**   3. SB-to-MQTT de-duplication: a topic with a table 'dedup' time keeps
+**      the 64-bit FNV-1a hash of its last published SB message. The hash
+**      covers the message's APID, length, and the bytes after the
+**      secondary header so the timestamp and sequence count don't defeat
+**      it. A message with the same hash is suppressed before it is encoded
+**      unless the dedup time has passed since the last publish. Topics
+**      whose messages come from several APIDs are only de-duplicated while
+**      one APID repeats. The dedup time is measured with a monotonic clock
+**      and a table load forgets every topic's last publish.
+**   4. Multiplexed topics (see MQTT_TOPIC_TBL) carry each message in a
+**      {"t":<tag>,"d":<codec payload>} envelope. SB-to-MQTT messages are
+**      wrapped after their codec encodes them so the last value cache and
+**      every output stage see the envelope. Received MQTT messages are
+**      resolved to the tagged topic when the topic name is looked up so
+**      the decode queues, statistics and decode stripes use the tagged
+**      topic's ID, and the codec is passed the "d" value.
 **
 ** References:
 **   1. OpenSatKit Object-based Application Developer's Guide
@@ -37,6 +53,8 @@
 
 #include "app_cfg.h"
 #include "mqtt_topic_tbl.h"
+#include "msg_stats.h"
+#include "trace_ring.h"
 
 
 /***********************/
@@ -50,6 +68,24 @@
 
 #define MSG_TRANS_PROCESS_MQTT_MSG_EID  (MSG_TRANS_BASE_EID + 0)
 #define MSG_TRANS_PROCESS_SB_MSG_EID    (MSG_TRANS_BASE_EID + 1)
+#define MSG_TRANS_DEMUX_ERR_EID         (MSG_TRANS_BASE_EID + 2)
+
+/*
+** Trace Point IDs
+*/
+
+#define MSG_TRANS_MQTT_RCV_TID           1  /* Param: Topic length, payload length. Text: Topic */
+#define MSG_TRANS_MQTT_TO_SB_TID         2  /* Param: Topic ID, SB message ID */
+#define MSG_TRANS_MQTT_NULL_PAYLOAD_TID  3  /* Param: Topic length. Text: Topic */
+#define MSG_TRANS_SB_RCV_TID             4  /* Param: SB message ID, computed topic ID */
+#define MSG_TRANS_SB_TO_MQTT_TID         5  /* Param: Topic ID, payload length. Text: Topic */
+
+/*
+** Decode mutex stripe of a topic. Topics in the same stripe are never
+** decoded in parallel.
+*/
+
+#define MSG_TRANS_DECODE_STRIPE(TopicId)  ((TopicId) % DECODE_POOL_MAX_WORKERS)
 
 
 /**********************/
@@ -57,23 +93,17 @@
 /**********************/
 
 /*
-** JSON Message
+** SB-to-MQTT de-duplication state of one topic, only used by the main task
 */
 
 typedef struct
 {
-   
-   char   Data[MQTT_CLIENT_READ_BUF_LEN];
 
-}  JSON_MSG_Payload_t;
+   bool    Valid;
+   uint64  PubTime;    /* DedupClock microseconds of the last publish */
+   uint64  Hash;       /* Hash of the last published SB message */
 
-typedef struct
-{
-   
-   CFE_MSG_TelemetryHeader_t TelemetryHeader;
-   JSON_MSG_Payload_t        Payload;
-
-}  JSON_MSG_Pkt_t;
+} MSG_TRANS_Dedup_t;
 
 
 /*
@@ -83,13 +113,23 @@ typedef struct
 typedef struct 
 {
 
-   uint32  TopicBaseMid;
+   uint32     TopicBaseMid;
+   osal_id_t  DecodeMutex[DECODE_POOL_MAX_WORKERS];   /* Serializes decodes of each topic stripe */
+   
+   uint32             DedupSuppressCnt;
+   uint32             DedupGeneration;   /* Topic table generation of Dedup[] */
+   uint32             DedupClockTime;    /* MSG_STATS_GetTime() of the last DedupClock update */
+   uint64             DedupClock;        /* Monotonic microseconds since the constructor */
+   MSG_TRANS_Dedup_t  Dedup[MQTT_TOPIC_TBL_MAX_TOPICS];
    
    /*
-   ** Telemetry Messages
+   ** Multiplexed topics. An envelope buffer is shared by the topics of one
+   ** multiplexed topic the same way a codec instance's output is shared by
+   ** the messages of one topic.
    */
    
-   JSON_MSG_Pkt_t  JsonMsgPkt;
+   uint32  DemuxErrCnt;   /* Received multiplexed messages without a defined tag */
+   char    MuxPayload[MQTT_TOPIC_TBL_MAX_MUX_TOPICS][MQTT_TOPIC_TBL_MUX_PAYLOAD_LEN];
    
    /*
    ** Contained Objects
@@ -117,11 +157,80 @@ void MSG_TRANS_Constructor(MSG_TRANS_Class_t *MsgTransPtr,
                            TBLMGR_Class_t *TblMgr);
 
 
+/******************************************************************************
+** Function: MSG_TRANS_ClearDedup
+**
+** Forget the last published SB message of topic 'TopicId' so its next
+** message is published.
+**
+** Notes:
+**   1. Called when the publish of a message that passed de-duplication
+**      fails.
+**
+*/
+void MSG_TRANS_ClearDedup(uint16 TopicId);
+
+
+/******************************************************************************
+** Function: MSG_TRANS_DecodeMqttMsg
+**
+** Decode an MQTT payload for topic 'TopicId' and send it on the SB.
+**
+** Notes:
+**   1. RcvTime is the MSG_STATS_GetTime() socket read time.
+**   2. Messages may be decoded by the decode workers, the MQTT child task
+**      and the load generator child task. A topic's codec instance has one
+**      output message for JsonToCfe so decodes are serialized by a mutex
+**      for each topic stripe. Topic IDs in different stripes are decoded in
+**      parallel. See MSG_TRANS_DECODE_STRIPE().
+**   3. Generation is the topic table snapshot generation that TopicId was
+**      found in. If a table load has made a different snapshot active the
+**      ID may name another topic so the message isn't decoded and false is
+**      returned. A Generation of 0 decodes with the active snapshot.
+**   4. The caller must be a topic table reader that is online or the main
+**      task because the snapshot is used for the whole decode.
+**
+*/
+bool MSG_TRANS_DecodeMqttMsg(uint16 TopicId, uint32 Generation, const char *Payload,
+                             uint16 PayloadLen, uint32 RcvTime);
+
+
+/******************************************************************************
+** Function: MSG_TRANS_DemuxMqttMsg
+**
+** Return the ID of the topic that decodes an MQTT payload received on topic
+** 'TopicId'.
+**
+** Notes:
+**   1. TopicId is returned unchanged if it isn't multiplexed. The envelope's
+**      tag selects the topic of a multiplexed topic and
+**      MQTT_TOPIC_TBL_UNUSED_ID is returned if no topic has the tag.
+**
+*/
+uint16 MSG_TRANS_DemuxMqttMsg(uint16 TopicId, const char *Payload, uint16 PayloadLen);
+
+
+/******************************************************************************
+** Function: MSG_TRANS_FindMqttTopic
+**
+** Return the topic ID of a received MQTT message or MQTT_TOPIC_TBL_UNUSED_ID
+** if the message has no payload or its topic is not defined.
+**
+** Notes:
+**   1. Unmatched topics are counted and reported so the caller only needs
+**      to process valid IDs.
+**
+*/
+uint16 MSG_TRANS_FindMqttTopic(const MessageData* MsgData);
+
+
 /******************************************************************************
 ** Function: MSG_TRANS_ProcessMqttMsg
 **
 ** Notes:
 **   1. Signature must mach MQTT_CLIENT_MsgCallback
+**   2. The message is decoded in the calling task. See
+**      MSG_TRANS_DecodeMqttMsg().
 **
 */
 void MSG_TRANS_ProcessMqttMsg(MessageData* MsgData);
@@ -131,10 +240,15 @@ void MSG_TRANS_ProcessMqttMsg(MessageData* MsgData);
 ** Function: MSG_TRANS_ProcessSbMsg
 **
 ** Notes:
-**   None
+**   1. TopicId is the topic table ID of the translated message and is only
+**      valid when true is returned.
+**   2. Topic is the topic table name rendered for MsgPtr. See
+**      MQTT_TOPIC_TBL_GetSbTopicName().
+**   3. False is also returned when the message is suppressed as a
+**      duplicate. Suppressed messages are counted and are not errors.
 **
 */
-bool MSG_TRANS_ProcessSbMsg(const CFE_MSG_Message_t *MsgPt,
+bool MSG_TRANS_ProcessSbMsg(const CFE_MSG_Message_t *MsgPt, uint16 *TopicId,
                             const char **Topic, const char **Payload);
 
 
@@ -146,4 +260,54 @@ bool MSG_TRANS_ProcessSbMsg(const CFE_MSG_Message_t *MsgPt,
 */
 void MSG_TRANS_ResetStatus(void);
 
+
+/******************************************************************************
+** Function: MSG_TRANS_TranslateMqttMsg
+**
+** Decode an MQTT payload of topic 'TopicId' and return the decoded SB
+** message's size.
+**
+** Notes:
+**   1. Only the translation of MSG_TRANS_DecodeMqttMsg() is performed. The
+**      message isn't sent on the SB and the statistics and last value cache
+**      are not updated so it can be used by benchmarks.
+**   2. The topic's decode stripe mutex is held during the decode so any
+**      task may call this.
+**
+*/
+bool MSG_TRANS_TranslateMqttMsg(uint16 TopicId, const char *Payload, uint16 PayloadLen,
+                                CFE_MSG_Size_t *MsgSize);
+
+
+/******************************************************************************
+** Function: MSG_TRANS_TranslateSbMsg
+**
+** Encode SB message 'MsgPtr' of topic 'TopicId' and return its MQTT topic
+** name and payload.
+**
+** Notes:
+**   1. Only the translation of MSG_TRANS_ProcessSbMsg() is performed. The
+**      message isn't de-duplicated and the statistics and last value cache
+**      are not updated so it can be used by benchmarks.
+**   2. Must only be called by the main task. The topic name and payload
+**      are valid until the main task translates another SB message.
+**
+*/
+bool MSG_TRANS_TranslateSbMsg(uint16 TopicId, const CFE_MSG_Message_t *MsgPtr,
+                              const char **Topic, const char **Payload);
+
+
+/******************************************************************************
+** Function: MSG_TRANS_UpdateDedupClock
+**
+** Advance the SB-to-MQTT de-duplication clock.
+**
+** Notes:
+**   1. The clock accumulates MSG_STATS_GetTime() differences so it must be
+**      updated less than ~71 minutes apart. The main loop updates it each
+**      iteration and each de-duplication check updates it.
+**
+*/
+void MSG_TRANS_UpdateDedupClock(void);
+
 #endif /* _msg_trans_ */
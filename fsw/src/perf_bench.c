@@ -0,0 +1,896 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Provide repeatable gateway and codec performance benchmarks
+**
+** Notes:
+**   None
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+
+#include "perf_bench.h"
+#include "msg_trans.h"
+
+
+/************************************/
+/** Local File Function Prototypes **/
+/************************************/
+
+static void   BenchCfeToJson(const MQTT_TOPIC_TBL_Codec_t *Codec, PERF_BENCH_CodecResult_t *Result);
+static bool   BenchJsonToCfe(const MQTT_TOPIC_TBL_Codec_t *Codec, PERF_BENCH_CodecResult_t *Result);
+static void   BenchMqttToSb(void);
+static void   BenchSbToMqtt(void);
+static bool   CreateSbMsg(uint16 TopicId);
+static uint32 NsPerOp(uint32 ElapsedTime, uint32 OpCnt);
+static uint32 PerSecond(uint32 Cnt, uint32 ElapsedTime);
+static void   ProcessLoopbackMsg(MessageData *MsgData);
+static bool   ReadPayloadFile(const char *Filename, uint16 PayloadPad);
+static void   RunBenchmark(void);
+static void   RunCodecBenchmark(void);
+static void   WriteCodecResult(osal_id_t FileHandle, const char *Name,
+                               const PERF_BENCH_CodecResult_t *Result, bool Last);
+static void   WriteDirReport(osal_id_t FileHandle, MSG_STATS_Dir_t Dir,
+                             const MSG_STATS_Topic_t *Stats, bool LastDir);
+static bool   WriteReport(void);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static PERF_BENCH_Class_t *PerfBench = NULL;
+
+static const char *DirStr[MSG_STATS_DIR_CNT] =
+{
+   "sb-to-mqtt",
+   "mqtt-to-sb"
+};
+
+static const char *StageStr[MSG_STATS_STAGE_CNT] =
+{
+   "translate",
+   "forward",
+   "total"
+};
+
+
+/******************************************************************************
+** Function: PERF_BENCH_Constructor
+**
+*/
+void PERF_BENCH_Constructor(PERF_BENCH_Class_t *PerfBenchPtr)
+{
+
+   PerfBench = PerfBenchPtr;
+
+   CFE_PSP_MemSet((void*)PerfBench, 0, sizeof(PERF_BENCH_Class_t));
+
+} /* End PERF_BENCH_Constructor() */
+
+
+/******************************************************************************
+** Function: PERF_BENCH_ChildExecute
+**
+*/
+bool PERF_BENCH_ChildExecute(void)
+{
+
+   bool RetStatus = false;
+
+   if (__atomic_load_n(&PerfBench->Pending, __ATOMIC_ACQUIRE) &&
+       PerfBench->Type == PERF_BENCH_TYPE_CODEC)
+   {
+
+      RunCodecBenchmark();
+
+      ++PerfBench->RunCnt;
+      __atomic_store_n(&PerfBench->Pending, false, __ATOMIC_RELEASE);
+      RetStatus = true;
+
+   }
+
+   return RetStatus;
+
+} /* End PERF_BENCH_ChildExecute() */
+
+
+/******************************************************************************
+** Function: PERF_BENCH_Execute
+**
+*/
+bool PERF_BENCH_Execute(void)
+{
+
+   bool RetStatus = false;
+
+   if (__atomic_load_n(&PerfBench->Pending, __ATOMIC_ACQUIRE) &&
+       PerfBench->Type == PERF_BENCH_TYPE_GATEWAY)
+   {
+
+      RunBenchmark();
+
+      RetStatus = PerfBench->Pending;
+
+   }
+
+   return RetStatus;
+
+} /* End PERF_BENCH_Execute() */
+
+
+/******************************************************************************
+** Function: PERF_BENCH_RunCmd
+**
+** Notes:
+**   1. The canned messages are created here so file and decode errors are
+**      reported with the command's status.
+**
+*/
+bool PERF_BENCH_RunCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const MQTT_GW_RunPerfBench_Payload_t *RunPerfBenchCmd = CMDMGR_PAYLOAD_PTR(MsgPtr, MQTT_GW_RunPerfBench_t);
+   bool RetStatus = false;
+
+   if (__atomic_load_n(&PerfBench->Pending, __ATOMIC_ACQUIRE))
+   {
+      CFE_EVS_SendEvent(PERF_BENCH_RUN_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Run benchmark command rejected. A benchmark is already in progress");
+   }
+   else if (!MQTT_TOPIC_TBL_ValidId(RunPerfBenchCmd->TopicId))
+   {
+      CFE_EVS_SendEvent(PERF_BENCH_RUN_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Run benchmark command rejected. Topic ID %d either invalid or not loaded",
+                        RunPerfBenchCmd->TopicId);
+   }
+   else if (RunPerfBenchCmd->MsgCnt == 0 || RunPerfBenchCmd->MsgCnt > PERF_BENCH_MAX_MSG_CNT)
+   {
+      CFE_EVS_SendEvent(PERF_BENCH_RUN_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Run benchmark command rejected. Message count %u must be in the range 1..%u",
+                        (unsigned int)RunPerfBenchCmd->MsgCnt, (unsigned int)PERF_BENCH_MAX_MSG_CNT);
+   }
+   else if (ReadPayloadFile(RunPerfBenchCmd->PayloadFile, RunPerfBenchCmd->PayloadPad) &&
+            CreateSbMsg(RunPerfBenchCmd->TopicId))
+   {
+
+      PerfBench->Type    = PERF_BENCH_TYPE_GATEWAY;
+      PerfBench->TopicId = RunPerfBenchCmd->TopicId;
+      PerfBench->MsgCnt  = RunPerfBenchCmd->MsgCnt;
+      strncpy(PerfBench->ReportFile, RunPerfBenchCmd->ReportFile, OS_MAX_PATH_LEN);
+      PerfBench->ReportFile[OS_MAX_PATH_LEN-1] = '\0';
+
+      PerfBench->Dir           = MSG_STATS_DIR_SB_TO_MQTT;
+      PerfBench->MsgIdx        = 0;
+      PerfBench->TblGeneration = MQTT_TOPIC_TBL_GetData()->Generation;
+      PerfBench->TopicName     = MQTT_TOPIC_TBL_GetName(PerfBench->TopicId);
+      memset(PerfBench->ElapsedTime, 0, sizeof(PerfBench->ElapsedTime));
+      memset(&PerfBench->Stats, 0, sizeof(MSG_STATS_Topic_t));
+
+      __atomic_store_n(&PerfBench->Pending, true, __ATOMIC_RELEASE);
+      RetStatus = true;
+
+      CFE_EVS_SendEvent(PERF_BENCH_RUN_EID, CFE_EVS_EventType_INFORMATION,
+                        "Started benchmark for topic ID %d with %u messages and a %d byte payload",
+                        PerfBench->TopicId, (unsigned int)PerfBench->MsgCnt, PerfBench->PayloadLen);
+
+   } /* End if valid parameters */
+
+   return RetStatus;
+
+} /* End PERF_BENCH_RunCmd() */
+
+
+/******************************************************************************
+** Function: PERF_BENCH_RunCodecCmd
+**
+*/
+bool PERF_BENCH_RunCodecCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const MQTT_GW_RunCodecBench_Payload_t *RunCodecBenchCmd = CMDMGR_PAYLOAD_PTR(MsgPtr, MQTT_GW_RunCodecBench_t);
+   bool RetStatus = false;
+
+   if (__atomic_load_n(&PerfBench->Pending, __ATOMIC_ACQUIRE))
+   {
+      CFE_EVS_SendEvent(PERF_BENCH_RUN_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Run codec benchmark command rejected. A benchmark is already in progress");
+   }
+   else if (RunCodecBenchCmd->IterCnt == 0 || RunCodecBenchCmd->IterCnt > PERF_BENCH_MAX_ITER_CNT)
+   {
+      CFE_EVS_SendEvent(PERF_BENCH_RUN_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Run codec benchmark command rejected. Iteration count %u must be in the range 1..%u",
+                        (unsigned int)RunCodecBenchCmd->IterCnt, (unsigned int)PERF_BENCH_MAX_ITER_CNT);
+   }
+   else
+   {
+
+      PerfBench->Type   = PERF_BENCH_TYPE_CODEC;
+      PerfBench->MsgCnt = RunCodecBenchCmd->IterCnt;
+      strncpy(PerfBench->PayloadDir, RunCodecBenchCmd->PayloadDir, OS_MAX_PATH_LEN);
+      PerfBench->PayloadDir[OS_MAX_PATH_LEN-1] = '\0';
+      strncpy(PerfBench->ReportFile, RunCodecBenchCmd->ReportFile, OS_MAX_PATH_LEN);
+      PerfBench->ReportFile[OS_MAX_PATH_LEN-1] = '\0';
+
+      __atomic_store_n(&PerfBench->Pending, true, __ATOMIC_RELEASE);
+      RetStatus = true;
+
+      CFE_EVS_SendEvent(PERF_BENCH_RUN_EID, CFE_EVS_EventType_INFORMATION,
+                        "Started codec benchmark with %u iterations using payloads from %s",
+                        (unsigned int)PerfBench->MsgCnt, PerfBench->PayloadDir);
+
+   } /* End if valid parameters */
+
+   return RetStatus;
+
+} /* End PERF_BENCH_RunCodecCmd() */
+
+
+/******************************************************************************
+** Function: BenchCfeToJson
+**
+** Notes:
+**   1. The canned SB message must have been created by BenchJsonToCfe()
+**
+*/
+static void BenchCfeToJson(const MQTT_TOPIC_TBL_Codec_t *Codec, PERF_BENCH_CodecResult_t *Result)
+{
+
+   uint32 i;
+   uint32 StartTime;
+   CFE_MSG_Size_t MsgSize = 0;
+   const char *JsonMsgPayload;
+   const char *FirstPayload = NULL;
+
+   memset(Result, 0, sizeof(PERF_BENCH_CodecResult_t));
+   Result->StaticBuf = true;
+
+   CFE_MSG_GetSize(&PerfBench->SbMsg.Msg, &MsgSize);
+   Result->ByteInCnt = MsgSize;
+
+   StartTime = MSG_STATS_GetTime();
+   for (i=0; i < PerfBench->MsgCnt; i++)
+   {
+      if (Codec->Func->CfeToJson(Codec->Inst, &JsonMsgPayload, &PerfBench->SbMsg.Msg))
+      {
+         if (FirstPayload == NULL)
+         {
+            FirstPayload = JsonMsgPayload;
+         }
+         else if (JsonMsgPayload != FirstPayload)
+         {
+            Result->StaticBuf = false;
+         }
+      }
+      else
+      {
+         ++Result->ErrCnt;
+      }
+   }
+   Result->ElapsedTime = MSG_STATS_GetTime() - StartTime;
+
+   if (FirstPayload != NULL)
+   {
+      Result->ByteOutCnt = strlen(FirstPayload);
+   }
+
+} /* End BenchCfeToJson() */
+
+
+/******************************************************************************
+** Function: BenchJsonToCfe
+**
+** Notes:
+**   1. The last decoded message is saved as the canned SB message for
+**      BenchCfeToJson(). Returns true if it was saved.
+**
+*/
+static bool BenchJsonToCfe(const MQTT_TOPIC_TBL_Codec_t *Codec, PERF_BENCH_CodecResult_t *Result)
+{
+
+   bool   RetStatus = false;
+   uint32 i;
+   uint32 StartTime;
+   CFE_MSG_Size_t     MsgSize = 0;
+   CFE_MSG_Message_t *CfeMsg;
+   CFE_MSG_Message_t *FirstMsg = NULL;
+
+   memset(Result, 0, sizeof(PERF_BENCH_CodecResult_t));
+   Result->StaticBuf = true;
+   Result->ByteInCnt = PerfBench->PayloadLen;
+
+   StartTime = MSG_STATS_GetTime();
+   for (i=0; i < PerfBench->MsgCnt; i++)
+   {
+      if (Codec->Func->JsonToCfe(Codec->Inst, &CfeMsg, PerfBench->Payload, PerfBench->PayloadLen))
+      {
+         if (FirstMsg == NULL)
+         {
+            FirstMsg = CfeMsg;
+         }
+         else if (CfeMsg != FirstMsg)
+         {
+            Result->StaticBuf = false;
+         }
+      }
+      else
+      {
+         ++Result->ErrCnt;
+      }
+   }
+   Result->ElapsedTime = MSG_STATS_GetTime() - StartTime;
+
+   if (FirstMsg != NULL)
+   {
+      CFE_MSG_GetSize(FirstMsg, &MsgSize);
+      Result->ByteOutCnt = MsgSize;
+      if (MsgSize <= PERF_BENCH_SB_MSG_LEN)
+      {
+         memcpy(PerfBench->SbMsg.Byte, FirstMsg, MsgSize);
+         RetStatus = true;
+      }
+   }
+
+   return RetStatus;
+
+} /* End BenchJsonToCfe() */
+
+
+/******************************************************************************
+** Function: BenchMqttToSb
+**
+** Pass the canned payload through a loopback PUBLISH packet to
+** ProcessLoopbackMsg() which decodes it.
+**
+*/
+static void BenchMqttToSb(void)
+{
+
+   MSG_STATS_Cnt_t *Cnt = &PerfBench->Stats.Cnt[MSG_STATS_DIR_MQTT_TO_SB];
+
+   ++Cnt->MsgInCnt;
+   Cnt->ByteInCnt += PerfBench->PayloadLen;
+
+   PerfBench->PubTime = MSG_STATS_GetTime();
+   if (!MQTT_CLIENT_LoopbackPublish(PerfBench->PacketBuf, MQTT_CLIENT_SEND_BUF_LEN, PerfBench->TopicName,
+                                    PerfBench->Payload, ProcessLoopbackMsg))
+   {
+      ++Cnt->DropCnt;
+   }
+
+} /* End BenchMqttToSb() */
+
+
+/******************************************************************************
+** Function: BenchSbToMqtt
+**
+** Encode the canned SB message and pass it through a loopback PUBLISH
+** packet.
+**
+*/
+static void BenchSbToMqtt(void)
+{
+
+   MSG_STATS_Cnt_t  *Cnt  = &PerfBench->Stats.Cnt[MSG_STATS_DIR_SB_TO_MQTT];
+   MSG_STATS_Hist_t *Hist = PerfBench->Stats.Hist[MSG_STATS_DIR_SB_TO_MQTT];
+   const char *Topic;
+   const char *Payload;
+   uint32 StartTime;
+   uint32 EncodeTime;
+   uint32 EndTime;
+
+   ++Cnt->MsgInCnt;
+   Cnt->ByteInCnt += PerfBench->SbMsgLen;
+
+   StartTime = MSG_STATS_GetTime();
+   if (MSG_TRANS_TranslateSbMsg(PerfBench->TopicId, &PerfBench->SbMsg.Msg, &Topic, &Payload))
+   {
+      EncodeTime = MSG_STATS_GetTime();
+      if (MQTT_CLIENT_LoopbackPublish(PerfBench->PacketBuf, MQTT_CLIENT_SEND_BUF_LEN, Topic, Payload, NULL))
+      {
+         EndTime = MSG_STATS_GetTime();
+         MSG_STATS_AddSample(&Hist[MSG_STATS_STAGE_TRANSLATE], EncodeTime - StartTime);
+         MSG_STATS_AddSample(&Hist[MSG_STATS_STAGE_FORWARD],   EndTime - EncodeTime);
+         MSG_STATS_AddSample(&Hist[MSG_STATS_STAGE_TOTAL],     EndTime - StartTime);
+         ++Cnt->MsgOutCnt;
+         Cnt->ByteOutCnt += strlen(Payload);
+      }
+      else
+      {
+         ++Cnt->DropCnt;
+      }
+   }
+   else
+   {
+      ++Cnt->XlateErrCnt;
+   }
+
+} /* End BenchSbToMqtt() */
+
+
+/******************************************************************************
+** Function: CreateSbMsg
+**
+** Decode the canned payload to create the canned SB message.
+**
+** Notes:
+**   1. A private codec instance is used so the topic's decode stripe lock
+**      isn't needed.
+**
+*/
+static bool CreateSbMsg(uint16 TopicId)
+{
+
+   bool RetStatus = false;
+   MQTT_TOPIC_TBL_Codec_t Codec;
+   CFE_MSG_Message_t *CfeMsg;
+   CFE_MSG_Size_t    MsgSize = 0;
+
+   if (MQTT_TOPIC_TBL_GetPrivateCodec(TopicId, &Codec) &&
+       Codec.Func->JsonToCfe(Codec.Inst, &CfeMsg, PerfBench->Payload, PerfBench->PayloadLen))
+   {
+
+      CFE_MSG_GetSize(CfeMsg, &MsgSize);
+      if (MsgSize <= PERF_BENCH_SB_MSG_LEN)
+      {
+         memcpy(PerfBench->SbMsg.Byte, CfeMsg, MsgSize);
+         PerfBench->SbMsgLen = MsgSize;
+         RetStatus = true;
+      }
+      else
+      {
+         CFE_EVS_SendEvent(PERF_BENCH_RUN_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Run benchmark command rejected. Topic ID %d SB message length %u exceeds %d byte buffer",
+                           TopicId, (unsigned int)MsgSize, PERF_BENCH_SB_MSG_LEN);
+      }
+
+   }
+   else
+   {
+      CFE_EVS_SendEvent(PERF_BENCH_RUN_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Run benchmark command rejected. Topic ID %d could not decode the canned payload",
+                        TopicId);
+   }
+
+   return RetStatus;
+
+} /* End CreateSbMsg() */
+
+
+/******************************************************************************
+** Function: NsPerOp
+**
+*/
+static uint32 NsPerOp(uint32 ElapsedTime, uint32 OpCnt)
+{
+
+   return (uint32)(((uint64)ElapsedTime * 1000) / ((OpCnt > 0) ? OpCnt : 1));
+
+} /* End NsPerOp() */
+
+
+/******************************************************************************
+** Function: PerSecond
+**
+*/
+static uint32 PerSecond(uint32 Cnt, uint32 ElapsedTime)
+{
+
+   return (uint32)(((uint64)Cnt * 1000000) / ((ElapsedTime > 0) ? ElapsedTime : 1));
+
+} /* End PerSecond() */
+
+
+/******************************************************************************
+** Function: ProcessLoopbackMsg
+**
+** Decode a gateway benchmark message received from the MQTT loopback.
+**
+** Notes:
+**   1. Signature must match MQTT_CLIENT_MsgCallback_t
+**   2. Called by MQTT_CLIENT_LoopbackPublish() before it returns.
+**   3. The topic is known so the received topic name isn't looked up.
+**
+*/
+static void ProcessLoopbackMsg(MessageData *MsgData)
+{
+
+   MSG_STATS_Cnt_t  *Cnt  = &PerfBench->Stats.Cnt[MSG_STATS_DIR_MQTT_TO_SB];
+   MSG_STATS_Hist_t *Hist = PerfBench->Stats.Hist[MSG_STATS_DIR_MQTT_TO_SB];
+   CFE_MSG_Size_t MsgSize = 0;
+   uint32 RcvTime = MSG_STATS_GetTime();
+   uint32 EndTime;
+
+   if (MSG_TRANS_TranslateMqttMsg(PerfBench->TopicId, (const char *)MsgData->message->payload,
+                                  (uint16)MsgData->message->payloadlen, &MsgSize))
+   {
+      EndTime = MSG_STATS_GetTime();
+      MSG_STATS_AddSample(&Hist[MSG_STATS_STAGE_TRANSLATE], EndTime - RcvTime);
+      MSG_STATS_AddSample(&Hist[MSG_STATS_STAGE_FORWARD],   RcvTime - PerfBench->PubTime);
+      MSG_STATS_AddSample(&Hist[MSG_STATS_STAGE_TOTAL],     EndTime - PerfBench->PubTime);
+      ++Cnt->MsgOutCnt;
+      Cnt->ByteOutCnt += MsgSize;
+   }
+   else
+   {
+      ++Cnt->XlateErrCnt;
+   }
+
+} /* End ProcessLoopbackMsg() */
+
+
+/******************************************************************************
+** Function: ReadPayloadFile
+**
+** Notes:
+**   1. PayloadPad spaces are appended to the file contents and the payload is
+**      null terminated.
+**
+*/
+static bool ReadPayloadFile(const char *Filename, uint16 PayloadPad)
+{
+
+   bool       RetStatus = false;
+   int32      SysStatus;
+   int32      ReadLen;
+   osal_id_t  FileHandle;
+   os_err_name_t OsErrStr;
+
+   SysStatus = OS_OpenCreate(&FileHandle, Filename, OS_FILE_FLAG_NONE, OS_READ_ONLY);
+
+   if (SysStatus == OS_SUCCESS)
+   {
+
+      ReadLen = OS_read(FileHandle, PerfBench->Payload, PERF_BENCH_PAYLOAD_LEN);
+      OS_close(FileHandle);
+
+      if (ReadLen > 0 && (ReadLen + PayloadPad) < PERF_BENCH_PAYLOAD_LEN)
+      {
+         memset(&PerfBench->Payload[ReadLen], ' ', PayloadPad);
+         PerfBench->PayloadLen = ReadLen + PayloadPad;
+         PerfBench->Payload[PerfBench->PayloadLen] = '\0';
+         RetStatus = true;
+      }
+      else
+      {
+         CFE_EVS_SendEvent(PERF_BENCH_RUN_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Benchmark payload file %s length plus %d pad bytes must be less than %d",
+                           Filename, PayloadPad, PERF_BENCH_PAYLOAD_LEN);
+      }
+
+   } /* End if file open */
+   else
+   {
+      OS_GetErrorName(SysStatus, &OsErrStr);
+      CFE_EVS_SendEvent(PERF_BENCH_RUN_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Error opening benchmark payload file '%s', status=%s",
+                        Filename, OsErrStr);
+   }
+
+   return RetStatus;
+
+} /* End ReadPayloadFile() */
+
+
+/******************************************************************************
+** Function: RunBenchmark
+**
+** Run the next batch of the gateway benchmark.
+**
+** Notes:
+**   1. The SB-to-MQTT direction is run first. The report is written when
+**      the MQTT-to-SB direction completes.
+**   2. The topic ID and name are only valid in the table snapshot the
+**      benchmark started with so a table load aborts the benchmark.
+**
+*/
+static void RunBenchmark(void)
+{
+
+   uint32 i;
+   uint32 StartTime;
+   bool   Done = false;
+
+   if (MQTT_TOPIC_TBL_GetData()->Generation != PerfBench->TblGeneration)
+   {
+      CFE_EVS_SendEvent(PERF_BENCH_RESULT_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Benchmark for topic ID %d aborted by a topic table load",
+                        PerfBench->TopicId);
+      Done = true;
+   }
+   else
+   {
+
+      StartTime = MSG_STATS_GetTime();
+      for (i=0; i < PERF_BENCH_BATCH_LEN && PerfBench->MsgIdx < PerfBench->MsgCnt; i++)
+      {
+         if (PerfBench->Dir == MSG_STATS_DIR_SB_TO_MQTT)
+         {
+            BenchSbToMqtt();
+         }
+         else
+         {
+            BenchMqttToSb();
+         }
+         ++PerfBench->MsgIdx;
+      }
+      PerfBench->ElapsedTime[PerfBench->Dir] += MSG_STATS_GetTime() - StartTime;
+
+      if (PerfBench->MsgIdx >= PerfBench->MsgCnt)
+      {
+         if (PerfBench->Dir == MSG_STATS_DIR_SB_TO_MQTT)
+         {
+            PerfBench->Dir    = MSG_STATS_DIR_MQTT_TO_SB;
+            PerfBench->MsgIdx = 0;
+         }
+         else
+         {
+            Done = true;
+            if (WriteReport())
+            {
+               CFE_EVS_SendEvent(PERF_BENCH_RESULT_EID, CFE_EVS_EventType_INFORMATION,
+                                 "Benchmark topic ID %d: SB-to-MQTT %u msg/s, MQTT-to-SB %u msg/s. Report written to %s",
+                                 PerfBench->TopicId,
+                                 (unsigned int)PerSecond(PerfBench->MsgCnt, PerfBench->ElapsedTime[MSG_STATS_DIR_SB_TO_MQTT]),
+                                 (unsigned int)PerSecond(PerfBench->MsgCnt, PerfBench->ElapsedTime[MSG_STATS_DIR_MQTT_TO_SB]),
+                                 PerfBench->ReportFile);
+            }
+         }
+      } /* End if direction complete */
+
+   } /* End if same table */
+
+   if (Done)
+   {
+      ++PerfBench->RunCnt;
+      __atomic_store_n(&PerfBench->Pending, false, __ATOMIC_RELEASE);
+   }
+
+} /* End RunBenchmark() */
+
+
+/******************************************************************************
+** Function: RunCodecBenchmark
+**
+** Notes:
+**   1. The report is written as each topic is measured.
+**   2. A topic's CfeToJson function is only measured if its JsonToCfe
+**      function created a canned SB message.
+**   3. The codec functions are called with a private codec instance so the
+**      benchmark doesn't need the topic's decode stripe lock and can't
+**      overwrite the buffers of a message the gateway is translating.
+**
+*/
+static void RunCodecBenchmark(void)
+{
+
+   uint16     TopicId;
+   uint16     MeasuredCnt = 0;
+   uint16     SkippedCnt  = 0;
+   int32      SysStatus;
+   osal_id_t  FileHandle;
+   os_err_name_t OsErrStr;
+   os_fstat_t FileStats;
+   const char *NameSeg;
+   const char *TopicName;
+   MQTT_TOPIC_TBL_Codec_t   Codec;
+   PERF_BENCH_CodecResult_t DecodeResult;
+   PERF_BENCH_CodecResult_t EncodeResult;
+   char PayloadFile[OS_MAX_PATH_LEN];
+   char DumpRecord[OS_MAX_PATH_LEN+128];
+   char SysTimeStr[128];
+
+   SysStatus = OS_OpenCreate(&FileHandle, PerfBench->ReportFile, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_READ_WRITE);
+
+   if (SysStatus == OS_SUCCESS)
+   {
+
+      CFE_TIME_Print(SysTimeStr, CFE_TIME_GetTime());
+      sprintf(DumpRecord,"{\n   \"description\": \"Codec benchmark run at %s\",\n   \"iter-cnt\": %u,\n   \"codec\": [",
+              SysTimeStr, (unsigned int)PerfBench->MsgCnt);
+      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+      for (TopicId=0; TopicId < MQTT_TOPIC_TBL_GetTopicCnt(); TopicId++)
+      {
+
+         TopicName = MQTT_TOPIC_TBL_GetName(TopicId);
+         if (TopicName == NULL || !MQTT_TOPIC_TBL_GetPrivateCodec(TopicId, &Codec))
+         {
+            continue;
+         }
+
+         NameSeg = strrchr(TopicName, '/');
+         NameSeg = (NameSeg == NULL) ? TopicName : (NameSeg + 1);
+         snprintf(PayloadFile, OS_MAX_PATH_LEN, "%s/mqtt_topic_%s.json", PerfBench->PayloadDir, NameSeg);
+
+         sprintf(DumpRecord,"%s\n      {\"topic-id\": %d, \"topic\": \"%s\", \"payload-file\": \"%s\"",
+                 (MeasuredCnt + SkippedCnt) > 0 ? "," : "", TopicId, TopicName, PayloadFile);
+         OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+         if (OS_stat(PayloadFile, &FileStats) != OS_SUCCESS || !ReadPayloadFile(PayloadFile, 0))
+         {
+            ++SkippedCnt;
+            sprintf(DumpRecord,", \"status\": \"no-payload\"}");
+            OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+            continue;
+         }
+
+         ++MeasuredCnt;
+         sprintf(DumpRecord,", \"status\": \"measured\",\n");
+         OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+         if (BenchJsonToCfe(&Codec, &DecodeResult))
+         {
+            BenchCfeToJson(&Codec, &EncodeResult);
+            WriteCodecResult(FileHandle, "json-to-cfe", &DecodeResult, false);
+            WriteCodecResult(FileHandle, "cfe-to-json", &EncodeResult, true);
+         }
+         else
+         {
+            WriteCodecResult(FileHandle, "json-to-cfe", &DecodeResult, true);
+         }
+
+         sprintf(DumpRecord,"      }");
+         OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+      } /* End topic loop */
+
+      sprintf(DumpRecord,"\n   ]\n}\n");
+      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+      OS_close(FileHandle);
+
+      CFE_EVS_SendEvent(PERF_BENCH_CODEC_EID, CFE_EVS_EventType_INFORMATION,
+                        "Codec benchmark measured %d topics and skipped %d without a payload file. Report written to %s",
+                        MeasuredCnt, SkippedCnt, PerfBench->ReportFile);
+
+   } /* End if file create */
+   else
+   {
+      OS_GetErrorName(SysStatus, &OsErrStr);
+      CFE_EVS_SendEvent(PERF_BENCH_CODEC_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating codec benchmark report file '%s', status=%s",
+                        PerfBench->ReportFile, OsErrStr);
+   }
+
+} /* End RunCodecBenchmark() */
+
+
+/******************************************************************************
+** Function: WriteCodecResult
+**
+*/
+static void WriteCodecResult(osal_id_t FileHandle, const char *Name,
+                             const PERF_BENCH_CodecResult_t *Result, bool Last)
+{
+
+   char DumpRecord[256];
+
+   sprintf(DumpRecord,"         \"%s\": {\"ns-per-op\": %u, \"bytes-in-per-op\": %u, \"bytes-out-per-op\": %u, "
+           "\"err-cnt\": %u, \"static-buf\": %s}%s\n",
+           Name, (unsigned int)NsPerOp(Result->ElapsedTime, PerfBench->MsgCnt),
+           (unsigned int)Result->ByteInCnt, (unsigned int)Result->ByteOutCnt,
+           (unsigned int)Result->ErrCnt, Result->StaticBuf ? "true" : "false", Last ? "" : ",");
+   OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+} /* End WriteCodecResult() */
+
+
+/******************************************************************************
+** Function: WriteDirReport
+**
+*/
+static void WriteDirReport(osal_id_t FileHandle, MSG_STATS_Dir_t Dir,
+                           const MSG_STATS_Topic_t *Stats, bool LastDir)
+{
+
+   uint16 Stage;
+   uint32 ElapsedTime = PerfBench->ElapsedTime[Dir];
+   const MSG_STATS_Cnt_t  *Cnt = &Stats->Cnt[Dir];
+   const MSG_STATS_Hist_t *Hist;
+   char DumpRecord[256];
+
+   sprintf(DumpRecord,"   \"%s\": {\n      \"elapsed-us\": %u,\n      \"msg-out\": %u,\n"
+           "      \"xlate-err\": %u,\n      \"drop\": %u,\n",
+           DirStr[Dir], (unsigned int)ElapsedTime, (unsigned int)Cnt->MsgOutCnt,
+           (unsigned int)Cnt->XlateErrCnt, (unsigned int)Cnt->DropCnt);
+   OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+   sprintf(DumpRecord,"      \"msg-per-sec\": %u,\n      \"byte-in-per-sec\": %u,\n      \"byte-out-per-sec\": %u,\n"
+           "      \"latency-us\": {\n",
+           (unsigned int)PerSecond(Cnt->MsgOutCnt, ElapsedTime),
+           (unsigned int)PerSecond(Cnt->ByteInCnt, ElapsedTime),
+           (unsigned int)PerSecond(Cnt->ByteOutCnt, ElapsedTime));
+   OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+   for (Stage=0; Stage < MSG_STATS_STAGE_CNT; Stage++)
+   {
+      Hist = &Stats->Hist[Dir][Stage];
+      sprintf(DumpRecord,"         \"%s\": {\"p50\": %u, \"p99\": %u, \"max\": %u}%s\n",
+              StageStr[Stage], (unsigned int)MSG_STATS_Percentile(Hist, 50),
+              (unsigned int)MSG_STATS_Percentile(Hist, 99), (unsigned int)Hist->Max,
+              (Stage < (MSG_STATS_STAGE_CNT-1)) ? "," : "");
+      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+   }
+
+   sprintf(DumpRecord,"      }\n   }%s\n", LastDir ? "" : ",");
+   OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+} /* End WriteDirReport() */
+
+
+/******************************************************************************
+** Function: WriteReport
+**
+** Notes:
+**  1. Creates a new report file, overwriting anything that may have existed
+**     previously
+*/
+static bool WriteReport(void)
+{
+
+   bool       RetStatus = false;
+   int32      SysStatus;
+   osal_id_t  FileHandle;
+   os_err_name_t OsErrStr;
+   const MSG_STATS_Topic_t *Stats = &PerfBench->Stats;
+   char DumpRecord[256];
+   char SysTimeStr[128];
+
+   SysStatus = OS_OpenCreate(&FileHandle, PerfBench->ReportFile, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_READ_WRITE);
+
+   if (SysStatus == OS_SUCCESS)
+   {
+
+      CFE_TIME_Print(SysTimeStr, CFE_TIME_GetTime());
+      sprintf(DumpRecord,"{\n   \"description\": \"Gateway benchmark run at %s\",\n",SysTimeStr);
+      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+      sprintf(DumpRecord,"   \"topic-id\": %d,\n   \"msg-cnt\": %u,\n   \"payload-len\": %d,\n",
+              PerfBench->TopicId, (unsigned int)PerfBench->MsgCnt, PerfBench->PayloadLen);
+      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+      WriteDirReport(FileHandle, MSG_STATS_DIR_SB_TO_MQTT, Stats, false);
+      WriteDirReport(FileHandle, MSG_STATS_DIR_MQTT_TO_SB, Stats, true);
+
+      sprintf(DumpRecord,"}\n");
+      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+      OS_close(FileHandle);
+
+      RetStatus = true;
+
+   } /* End if file create */
+   else
+   {
+      OS_GetErrorName(SysStatus, &OsErrStr);
+      CFE_EVS_SendEvent(PERF_BENCH_RESULT_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating benchmark report file '%s', status=%s",
+                        PerfBench->ReportFile, OsErrStr);
+
+   } /* End if file create error */
+
+   return RetStatus;
+
+} /* End WriteReport() */
@@ -0,0 +1,237 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Provide repeatable gateway and codec performance benchmarks
+**
+** Notes:
+**   1. The gateway benchmark drives a topic's translation path in both
+**      directions through MQTT_CLIENT loopback publishes so results do not
+**      depend on a network or broker:
+**      - SB-to-MQTT: A canned SB message is encoded by
+**        MSG_TRANS_TranslateSbMsg() and passed through a PUBLISH packet.
+**      - MQTT-to-SB: A canned JSON payload is passed through a PUBLISH
+**        packet and decoded by MSG_TRANS_TranslateMqttMsg().
+**   2. Benchmark messages only use the gateway's translation functions.
+**      They are not de-duplicated, counted in MSG_STATS, saved in the last
+**      value cache, written to SHM_RING or LOCAL_BROKER, published to the
+**      broker or sent on the SB so a benchmark doesn't disturb or measure
+**      the gateway's own traffic.
+**   3. The canned JSON payload is read from a file. It is decoded once with
+**      a private instance of the topic's codec to create the canned SB
+**      message. The payload can be padded with whitespace to measure the
+**      effect of payload size.
+**   4. Results are kept in the benchmark's own counters and histograms
+**      which are written to a JSON report file so runs can be compared.
+**      Each direction's stages are the translation, the loopback PUBLISH
+**      packet ("forward") and the total.
+**   5. The gateway benchmark runs in the main task because the SB-to-MQTT
+**      translation state is owned by the main task. PERF_BENCH_BATCH_LEN
+**      messages are run each main loop iteration and the app's pipe is
+**      polled while a benchmark runs so commands and topic messages are
+**      still processed. Elapsed times only include the batches. A topic
+**      table load aborts a running benchmark.
+**   6. The codec benchmark calls each loaded topic's JsonToCfe and CfeToJson
+**      functions in a tight loop without the SB or MQTT client. A topic's
+**      canned JSON payload is read from <PayloadDir>/mqtt_topic_<name>.json
+**      where <name> is the last segment of the topic name. Topics without a
+**      payload file are skipped. Each codec is checked for returning the
+**      same output buffer on every call which confirms it does not allocate
+**      per message. The functions are passed the codec type's private
+**      instance (see MQTT_TOPIC_TBL_GetPrivateCodec()) so the benchmark
+**      runs alongside the gateway's translations without sharing their
+**      codec instances. It runs in the MQTT child task in place of the MQTT
+**      yield so messages received from the broker are not processed while
+**      it runs and long runs may exceed the broker keep alive interval.
+**   7. Only one benchmark runs at a time.
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+#ifndef _perf_bench_
+#define _perf_bench_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "mqtt_client.h"
+#include "msg_stats.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/*
+** Event Message IDs
+*/
+
+#define PERF_BENCH_RUN_EID         (PERF_BENCH_BASE_EID + 0)
+#define PERF_BENCH_RUN_ERR_EID     (PERF_BENCH_BASE_EID + 1)
+#define PERF_BENCH_RESULT_EID      (PERF_BENCH_BASE_EID + 2)
+#define PERF_BENCH_RESULT_ERR_EID  (PERF_BENCH_BASE_EID + 3)
+#define PERF_BENCH_CODEC_EID       (PERF_BENCH_BASE_EID + 4)
+#define PERF_BENCH_CODEC_ERR_EID   (PERF_BENCH_BASE_EID + 5)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+typedef enum
+{
+
+   PERF_BENCH_TYPE_GATEWAY = 1,
+   PERF_BENCH_TYPE_CODEC   = 2
+
+} PERF_BENCH_Type_t;
+
+
+/*
+** Results of one codec function
+*/
+
+typedef struct
+{
+
+   uint32  ElapsedTime;    /* Microseconds for all iterations */
+   uint32  ByteInCnt;      /* Per operation */
+   uint32  ByteOutCnt;     /* Per operation */
+   uint32  ErrCnt;
+   bool    StaticBuf;      /* Same output buffer returned by every call */
+
+} PERF_BENCH_CodecResult_t;
+
+
+/*
+** Class Definition
+*/
+
+typedef struct
+{
+
+   bool    Pending;     /* Set by command, cleared by the task running the benchmark when complete */
+   uint32  RunCnt;
+
+   /*
+   ** Benchmark parameters
+   */
+
+   PERF_BENCH_Type_t  Type;
+   uint16  TopicId;
+   uint16  PayloadLen;
+   uint32  MsgCnt;      /* Gateway messages in each direction or codec iterations */
+   char    PayloadDir[OS_MAX_PATH_LEN];
+   char    ReportFile[OS_MAX_PATH_LEN];
+
+   /*
+   ** Gateway benchmark progress and results
+   */
+   
+   MSG_STATS_Dir_t  Dir;        /* Direction being run */
+   uint32  MsgIdx;              /* Next message of the direction */
+   uint32  TblGeneration;       /* Topic table the benchmark started with */
+   const char *TopicName;
+   uint32  PubTime;             /* Start of the current MQTT-to-SB message */
+
+   uint32  ElapsedTime[MSG_STATS_DIR_CNT];   /* Microseconds */
+   MSG_STATS_Topic_t  Stats;
+   unsigned char      PacketBuf[MQTT_CLIENT_SEND_BUF_LEN];
+
+   /*
+   ** Canned messages
+   */
+
+   char    Payload[PERF_BENCH_PAYLOAD_LEN];
+   CFE_MSG_Size_t  SbMsgLen;
+   union
+   {
+      CFE_MSG_Message_t  Msg;
+      uint8              Byte[PERF_BENCH_SB_MSG_LEN];
+   } SbMsg;
+
+} PERF_BENCH_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: PERF_BENCH_Constructor
+**
+** Notes:
+**    1. This function must be called prior to any other functions being
+**       called using the same PERF_BENCH instance.
+*/
+void PERF_BENCH_Constructor(PERF_BENCH_Class_t *PerfBenchPtr);
+
+
+/******************************************************************************
+** Function: PERF_BENCH_ChildExecute
+**
+** Run a pending codec benchmark.
+**
+** Notes:
+**   1. Called from the MQTT child task. Returns true if a benchmark was run.
+**
+*/
+bool PERF_BENCH_ChildExecute(void);
+
+
+/******************************************************************************
+** Function: PERF_BENCH_Execute
+**
+** Run the next batch of a pending gateway benchmark.
+**
+** Notes:
+**   1. Called from the main task each loop iteration. Returns true while
+**      a gateway benchmark is running so the caller doesn't block.
+**
+*/
+bool PERF_BENCH_Execute(void);
+
+
+/******************************************************************************
+** Function: PERF_BENCH_RunCmd
+**
+** Validate the gateway benchmark parameters, create the canned messages, and
+** start the benchmark.
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**
+*/
+bool PERF_BENCH_RunCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: PERF_BENCH_RunCodecCmd
+**
+** Validate the codec benchmark parameters and schedule the benchmark to run
+** in the MQTT child task.
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**
+*/
+bool PERF_BENCH_RunCodecCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+#endif /* _perf_bench_ */
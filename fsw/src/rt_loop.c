@@ -0,0 +1,262 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Manage the run-time behavior of the app's two forwarding loops
+**
+** Notes:
+**   1. See rt_loop.h
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#ifdef __linux__
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE     /* pthread_setaffinity_np() */
+#endif
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "rt_loop.h"
+#include "msg_stats.h"
+
+
+/************************************/
+/** Local File Function Prototypes **/
+/************************************/
+
+static void StartLoop(RT_LOOP_Id_t Id, RT_LOOP_Loop_t *Loop);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static RT_LOOP_Class_t *RtLoop = NULL;
+
+static const char *LoopStr[RT_LOOP_CNT] = { "MQTT I/O", "SB drain" };
+
+
+/******************************************************************************
+** Function: RT_LOOP_Constructor
+**
+*/
+void RT_LOOP_Constructor(RT_LOOP_Class_t *RtLoopPtr,
+                         const INITBL_Class_t *IniTbl)
+{
+
+   RtLoop = RtLoopPtr;
+
+   CFE_PSP_MemSet((void*)RtLoop, 0, sizeof(RT_LOOP_Class_t));
+
+   RtLoop->BusyPoll = (INITBL_GetIntConfig(IniTbl, CFG_BUSY_POLL_ENABLE) != 0);
+   RtLoop->SpinTime = INITBL_GetIntConfig(IniTbl, CFG_BUSY_POLL_SPIN_TIME);
+
+   RtLoop->Loop[RT_LOOP_MQTT_IO].CpuMask  = INITBL_GetIntConfig(IniTbl, CFG_CHILD_CPU_MASK);
+   RtLoop->Loop[RT_LOOP_SB_DRAIN].CpuMask = INITBL_GetIntConfig(IniTbl, CFG_APP_MAIN_CPU_MASK);
+   RtLoop->Loop[RT_LOOP_SB_DRAIN].Priority = INITBL_GetIntConfig(IniTbl, CFG_APP_MAIN_PRIORITY);
+
+   CFE_EVS_SendEvent(RT_LOOP_CONSTRUCT_EID, CFE_EVS_EventType_INFORMATION,
+                     "Busy-poll mode %s, spin time %u usec",
+                     (RtLoop->BusyPoll ? "enabled" : "disabled"), (unsigned int)RtLoop->SpinTime);
+
+} /* End RT_LOOP_Constructor() */
+
+
+/******************************************************************************
+** Function: RT_LOOP_Activity
+**
+*/
+void RT_LOOP_Activity(RT_LOOP_Id_t Id)
+{
+
+   RtLoop->Loop[Id].ActiveTime = MSG_STATS_GetTime();
+
+} /* End RT_LOOP_Activity() */
+
+
+/******************************************************************************
+** Function: RT_LOOP_GetPeriod
+**
+** Notes:
+**   1. Read by the main task while the MQTT I/O loop updates its statistics
+**      so a value may be one period out of date.
+**
+*/
+void RT_LOOP_GetPeriod(RT_LOOP_Id_t Id, uint32 *Min, uint32 *Avg, uint32 *Max)
+{
+
+   const RT_LOOP_Loop_t *Loop = &RtLoop->Loop[Id];
+   uint32 PeriodCnt = Loop->PeriodCnt;
+
+   if (PeriodCnt > 0)
+   {
+      *Min = Loop->MinPeriod;
+      *Avg = (uint32)(Loop->PeriodSum / PeriodCnt);
+      *Max = Loop->MaxPeriod;
+   }
+   else
+   {
+      *Min = 0;
+      *Avg = 0;
+      *Max = 0;
+   }
+
+} /* End RT_LOOP_GetPeriod() */
+
+
+/******************************************************************************
+** Function: RT_LOOP_ResetStatus
+**
+*/
+void RT_LOOP_ResetStatus(void)
+{
+
+   uint16 i;
+
+   for (i=0; i < RT_LOOP_CNT; i++)
+   {
+      RtLoop->Loop[i].ResetReq = true;
+   }
+
+} /* End RT_LOOP_ResetStatus() */
+
+
+/******************************************************************************
+** Function: RT_LOOP_Spin
+**
+** Notes:
+**   1. The first period after a reset is discarded because it includes the
+**      time spent before the reset.
+**
+*/
+bool RT_LOOP_Spin(RT_LOOP_Id_t Id)
+{
+
+   bool   RetStatus = false;
+   uint32 Now    = MSG_STATS_GetTime();
+   uint32 Period;
+   RT_LOOP_Loop_t *Loop = &RtLoop->Loop[Id];
+
+   if (!Loop->Started)
+   {
+      StartLoop(Id, Loop);
+      Loop->ActiveTime = Now;
+   }
+   else if (Loop->ResetReq)
+   {
+      Loop->ResetReq  = false;
+      Loop->PeriodCnt = 0;
+      Loop->PeriodSum = 0;
+      Loop->MinPeriod = 0;
+      Loop->MaxPeriod = 0;
+   }
+   else
+   {
+      Period = Now - Loop->LastTime;
+      if (Loop->PeriodCnt == 0 || Period < Loop->MinPeriod)
+      {
+         Loop->MinPeriod = Period;
+      }
+      if (Period > Loop->MaxPeriod)
+      {
+         Loop->MaxPeriod = Period;
+      }
+      Loop->PeriodSum += Period;
+      ++Loop->PeriodCnt;
+   }
+   Loop->LastTime = Now;
+
+   if (RtLoop->BusyPoll)
+   {
+      RetStatus = ((Now - Loop->ActiveTime) < RtLoop->SpinTime);
+   }
+
+   return RetStatus;
+
+} /* End RT_LOOP_Spin() */
+
+
+/******************************************************************************
+** Function: StartLoop
+**
+** Apply the loop's CPU pinning and priority to the calling task.
+**
+*/
+static void StartLoop(RT_LOOP_Id_t Id, RT_LOOP_Loop_t *Loop)
+{
+
+   int32  SysStatus;
+
+   Loop->Started = true;
+
+   if (Loop->Priority != 0)
+   {
+      SysStatus = OS_TaskSetPriority(OS_TaskGetId(), Loop->Priority);
+      if (SysStatus != OS_SUCCESS)
+      {
+         CFE_EVS_SendEvent(RT_LOOP_START_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Error setting %s loop priority to %u, status=%d",
+                           LoopStr[Id], (unsigned int)Loop->Priority, (int)SysStatus);
+      }
+   }
+
+   if (Loop->CpuMask != 0)
+   {
+#ifdef __linux__
+
+      uint16    Cpu;
+      cpu_set_t CpuSet;
+
+      CPU_ZERO(&CpuSet);
+      for (Cpu=0; Cpu < 32; Cpu++)
+      {
+         if (Loop->CpuMask & (1u << Cpu))
+         {
+            CPU_SET(Cpu, &CpuSet);
+         }
+      }
+
+      SysStatus = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &CpuSet);
+      if (SysStatus == 0)
+      {
+         CFE_EVS_SendEvent(RT_LOOP_START_EID, CFE_EVS_EventType_INFORMATION,
+                           "%s loop pinned to CPU mask 0x%08X",
+                           LoopStr[Id], (unsigned int)Loop->CpuMask);
+      }
+      else
+      {
+         CFE_EVS_SendEvent(RT_LOOP_START_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Error pinning %s loop to CPU mask 0x%08X, error=%d",
+                           LoopStr[Id], (unsigned int)Loop->CpuMask, (int)SysStatus);
+      }
+
+#else
+
+      CFE_EVS_SendEvent(RT_LOOP_START_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "%s loop CPU mask 0x%08X ignored, CPU pinning is only supported on Linux",
+                        LoopStr[Id], (unsigned int)Loop->CpuMask);
+
+#endif
+   }
+
+} /* End StartLoop() */
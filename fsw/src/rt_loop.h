@@ -0,0 +1,180 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Manage the run-time behavior of the app's two forwarding loops
+**
+** Notes:
+**   1. The MQTT I/O loop is the MQTT child task and the SB drain loop is the
+**      app's main task. Each loop calls RT_LOOP_Spin() once per iteration
+**      and RT_LOOP_Activity() when it processed a message.
+**   2. When busy-poll mode is enabled a loop polls without blocking until
+**      BUSY_POLL_SPIN_TIME microseconds pass without a message. It then
+**      blocks with its normal timeout until the next message arrives. The
+**      spin is bounded so an idle gateway doesn't hold its cores.
+**   3. CPU pinning and the main task priority are applied by each loop's
+**      own task on its first RT_LOOP_Spin() call. OSAL doesn't provide CPU
+**      affinity so the calling thread is pinned with the native thread API
+**      which is only supported on Linux.
+**   4. The period between RT_LOOP_Spin() calls is recorded for each loop
+**      so the loop jitter can be monitored. A status reset is performed by
+**      the loop's task so the statistics have a single writer.
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+#ifndef _rt_loop_
+#define _rt_loop_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/*
+** Event Message IDs
+*/
+
+#define RT_LOOP_CONSTRUCT_EID  (RT_LOOP_BASE_EID + 0)
+#define RT_LOOP_START_EID      (RT_LOOP_BASE_EID + 1)
+#define RT_LOOP_START_ERR_EID  (RT_LOOP_BASE_EID + 2)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+typedef enum
+{
+
+   RT_LOOP_MQTT_IO  = 0,   /* MQTT child task */
+   RT_LOOP_SB_DRAIN = 1,   /* App main task   */
+   RT_LOOP_CNT      = 2
+
+} RT_LOOP_Id_t;
+
+
+typedef struct
+{
+
+   /*
+   ** Configuration
+   */
+
+   uint32  CpuMask;    /* 0 = Not pinned */
+   uint32  Priority;   /* 0 = Keep the task's creation priority */
+
+   /*
+   ** State and statistics, written by the loop's task
+   */
+
+   bool    Started;
+   bool    ResetReq;   /* Set by RT_LOOP_ResetStatus() */
+   uint32  LastTime;
+   uint32  ActiveTime;
+
+   uint32  PeriodCnt;
+   uint64  PeriodSum;
+   uint32  MinPeriod;
+   uint32  MaxPeriod;
+
+} RT_LOOP_Loop_t;
+
+
+/*
+** Class Definition
+*/
+
+typedef struct
+{
+
+   bool    BusyPoll;
+   uint32  SpinTime;
+
+   RT_LOOP_Loop_t  Loop[RT_LOOP_CNT];
+
+} RT_LOOP_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: RT_LOOP_Constructor
+**
+** Notes:
+**    1. This function must be called prior to any other functions being
+**       called using the same RT_LOOP instance.
+**
+*/
+void RT_LOOP_Constructor(RT_LOOP_Class_t *RtLoopPtr,
+                         const INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: RT_LOOP_Activity
+**
+** Report that loop 'Id' processed a message. This restarts its spin window.
+**
+*/
+void RT_LOOP_Activity(RT_LOOP_Id_t Id);
+
+
+/******************************************************************************
+** Function: RT_LOOP_GetPeriod
+**
+** Return the minimum, average, and maximum period of loop 'Id' in
+** microseconds. All are zero until a period has been recorded.
+**
+*/
+void RT_LOOP_GetPeriod(RT_LOOP_Id_t Id, uint32 *Min, uint32 *Avg, uint32 *Max);
+
+
+/******************************************************************************
+** Function: RT_LOOP_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+** Notes:
+**   1. Each loop clears its statistics on its next RT_LOOP_Spin() call.
+**
+*/
+void RT_LOOP_ResetStatus(void);
+
+
+/******************************************************************************
+** Function: RT_LOOP_Spin
+**
+** Start an iteration of loop 'Id'. Returns true if the loop should poll
+** for its next message and false if it should block with its timeout.
+**
+** Notes:
+**   1. Must only be called by the loop's own task.
+**   2. Always returns false when busy-poll mode is disabled.
+**
+*/
+bool RT_LOOP_Spin(RT_LOOP_Id_t Id);
+
+
+#endif /* _rt_loop_ */
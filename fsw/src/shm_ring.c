@@ -0,0 +1,266 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Write SB-to-MQTT messages to a shared memory ring
+**
+** Notes:
+**   1. See shm_ring.h
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <string.h>
+
+#include "shm_ring.h"
+
+
+/************************************/
+/** Local File Function Prototypes **/
+/************************************/
+
+static void InitRing(MQTT_GW_SHM_Hdr_t *Hdr);
+static bool MapRing(const char *Name);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static SHM_RING_Class_t *ShmRing = NULL;
+
+
+/******************************************************************************
+** Function: SHM_RING_Constructor
+**
+** Notes:
+**   1. A SHM_RING_NAME of "UNDEF" disables the ring.
+**
+*/
+void SHM_RING_Constructor(SHM_RING_Class_t *ShmRingPtr,
+                          const INITBL_Class_t *IniTbl)
+{
+
+   const char *Name = INITBL_GetStrConfig(IniTbl, CFG_SHM_RING_NAME);
+
+   ShmRing = ShmRingPtr;
+
+   CFE_PSP_MemSet((void*)ShmRing, 0, sizeof(SHM_RING_Class_t));
+
+   if (strcmp(Name, "UNDEF") != 0)
+   {
+      if (MapRing(Name))
+      {
+         OS_MutSemCreate(&ShmRing->Mutex, "SHM_RING", 0);
+         InitRing(ShmRing->Hdr);
+         CFE_EVS_SendEvent(SHM_RING_CONSTRUCT_EID, CFE_EVS_EventType_INFORMATION,
+                           "Shared memory ring %s created with %d slots of %d bytes, epoch %u",
+                           Name, SHM_RING_SLOT_CNT, SHM_RING_SLOT_LEN,
+                           (unsigned int)ShmRing->Hdr->Epoch);
+      }
+   }
+
+} /* End SHM_RING_Constructor() */
+
+
+/******************************************************************************
+** Function: SHM_RING_ResetStatus
+**
+*/
+void SHM_RING_ResetStatus(void)
+{
+
+   ShmRing->WriteCnt = 0;
+   ShmRing->SkipCnt  = 0;
+
+} /* End SHM_RING_ResetStatus() */
+
+
+/******************************************************************************
+** Function: SHM_RING_Write
+**
+** Notes:
+**   1. The slot's Seq is cleared before the message is written and set to
+**      the message's sequence number after so a reader that copies the
+**      slot during the write discards its copy. The header's WriteSeq is
+**      updated last so readers never look for a message that isn't
+**      complete.
+**
+*/
+void SHM_RING_Write(uint16 TopicId, const char *Topic, const char *Payload,
+                    uint32 PayloadLen)
+{
+
+   uint16  TopicLen;
+   uint64  Seq;
+   MQTT_GW_SHM_Slot_t *Slot;
+   char    *Data;
+
+   if (ShmRing->Hdr != NULL)
+   {
+
+      TopicLen = strlen(Topic);
+
+      if ((sizeof(MQTT_GW_SHM_Slot_t) + TopicLen + PayloadLen + 2) > SHM_RING_SLOT_LEN)
+      {
+         ++ShmRing->SkipCnt;
+      }
+      else
+      {
+
+         OS_MutSemTake(ShmRing->Mutex);
+
+         Seq  = ShmRing->Hdr->WriteSeq + 1;
+         Slot = MQTT_GW_SHM_SLOT(ShmRing->Hdr, Seq);
+
+         __atomic_store_n(&Slot->Seq, 0, __ATOMIC_RELAXED);
+         __atomic_thread_fence(__ATOMIC_RELEASE);
+
+         Slot->TopicId    = TopicId;
+         Slot->TopicLen   = TopicLen;
+         Slot->PayloadLen = PayloadLen;
+         Data = (char *)(Slot + 1);
+         memcpy(Data, Topic, TopicLen + 1);
+         memcpy(&Data[TopicLen + 1], Payload, PayloadLen + 1);
+
+         __atomic_store_n(&Slot->Seq, Seq, __ATOMIC_RELEASE);
+         __atomic_store_n(&ShmRing->Hdr->WriteSeq, Seq, __ATOMIC_RELEASE);
+         ++ShmRing->WriteCnt;
+
+         OS_MutSemGive(ShmRing->Mutex);
+
+      }
+   } /* End if enabled */
+
+} /* End SHM_RING_Write() */
+
+
+/******************************************************************************
+** Function: InitRing
+**
+** Notes:
+**   1. A ring left by a previous run keeps its mapping in any running
+**      readers so the epoch continues from the previous ring's epoch. The
+**      sequence numbers are reset before the new epoch is published and the
+**      magic number is written last so a reader that opens the ring during
+**      initialization waits for it to complete.
+**
+*/
+static void InitRing(MQTT_GW_SHM_Hdr_t *Hdr)
+{
+
+   uint32 i;
+   uint32 Epoch = 1;
+
+   if (Hdr->Magic == MQTT_GW_SHM_MAGIC && Hdr->Version == MQTT_GW_SHM_VERSION)
+   {
+      Epoch = Hdr->Epoch + 1;
+   }
+
+   __atomic_store_n(&Hdr->Magic, 0, __ATOMIC_RELEASE);
+   __atomic_store_n(&Hdr->WriteSeq, 0, __ATOMIC_RELEASE);
+
+   Hdr->Version = MQTT_GW_SHM_VERSION;
+   Hdr->SlotCnt = SHM_RING_SLOT_CNT;
+   Hdr->SlotLen = SHM_RING_SLOT_LEN;
+   for (i=0; i < SHM_RING_SLOT_CNT; i++)
+   {
+      __atomic_store_n(&MQTT_GW_SHM_SLOT(Hdr, i)->Seq, 0, __ATOMIC_RELAXED);
+   }
+
+   __atomic_store_n(&Hdr->Epoch, Epoch, __ATOMIC_RELEASE);
+   __atomic_store_n(&Hdr->Magic, MQTT_GW_SHM_MAGIC, __ATOMIC_RELEASE);
+
+} /* End InitRing() */
+
+
+/******************************************************************************
+** Function: MapRing
+**
+** Create or open the shared memory object 'Name', size it for the ring, and
+** map it.
+**
+*/
+static bool MapRing(const char *Name)
+{
+
+   bool RetStatus = false;
+
+#ifdef __linux__
+
+   int   Fd;
+   void *Map;
+   size_t MapLen = MQTT_GW_SHM_SIZE(SHM_RING_SLOT_CNT, SHM_RING_SLOT_LEN);
+
+   Fd = shm_open(Name, O_CREAT | O_RDWR, 0644);
+   if (Fd >= 0)
+   {
+
+      if (ftruncate(Fd, MapLen) == 0)
+      {
+
+         Map = mmap(NULL, MapLen, PROT_READ | PROT_WRITE, MAP_SHARED, Fd, 0);
+         if (Map != MAP_FAILED)
+         {
+            ShmRing->Hdr    = (MQTT_GW_SHM_Hdr_t *)Map;
+            ShmRing->MapLen = MapLen;
+            RetStatus = true;
+         }
+         else
+         {
+            CFE_EVS_SendEvent(SHM_RING_CONSTRUCT_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "Error mapping shared memory ring %s, errno=%d", Name, errno);
+         }
+      }
+      else
+      {
+         CFE_EVS_SendEvent(SHM_RING_CONSTRUCT_ERR_EID, CFE_EVS_EventType_ERROR,
+                           "Error sizing shared memory ring %s to %u bytes, errno=%d",
+                           Name, (unsigned int)MapLen, errno);
+      }
+
+      close(Fd);   /* The mapping stays valid */
+
+   }
+   else
+   {
+      CFE_EVS_SendEvent(SHM_RING_CONSTRUCT_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Error opening shared memory ring %s, errno=%d", Name, errno);
+   }
+
+#else
+
+   CFE_EVS_SendEvent(SHM_RING_CONSTRUCT_ERR_EID, CFE_EVS_EventType_ERROR,
+                     "Shared memory ring %s disabled, shared memory is only supported on Linux",
+                     Name);
+
+#endif
+
+   return RetStatus;
+
+} /* End MapRing() */
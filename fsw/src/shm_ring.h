@@ -0,0 +1,122 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Write SB-to-MQTT messages to a shared memory ring
+**
+** Notes:
+**   1. An optional output stage for consumers on the same host. Each
+**      message encoded for MQTT is also written to a POSIX shared memory
+**      ring so a local process can read the JSON without a broker round
+**      trip. The ring layout is defined in mqtt_gw_shm.h and local
+**      processes read it with mqtt_gw_shm_reader.h.
+**   2. The ring is enabled by setting SHM_RING_NAME to a shared memory
+**      object name such as "/mqtt_gw". Shared memory is only supported on
+**      Linux.
+**   3. The writer never waits for readers. Readers that fall behind lose
+**      the overwritten messages.
+**   4. Messages are written by the main task and the PERF_BENCH child task
+**      so writes are serialized by a mutex. Readers never take the mutex.
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+#ifndef _shm_ring_
+#define _shm_ring_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "mqtt_gw_shm.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/*
+** Event Message IDs
+*/
+
+#define SHM_RING_CONSTRUCT_EID      (SHM_RING_BASE_EID + 0)
+#define SHM_RING_CONSTRUCT_ERR_EID  (SHM_RING_BASE_EID + 1)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/*
+** Class Definition
+*/
+
+typedef struct
+{
+
+   MQTT_GW_SHM_Hdr_t  *Hdr;     /* NULL if the ring is disabled */
+   size_t     MapLen;
+   osal_id_t  Mutex;
+
+   uint32  WriteCnt;    /* Messages written to the ring */
+   uint32  SkipCnt;     /* Messages too long for a slot */
+
+} SHM_RING_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: SHM_RING_Constructor
+**
+** Notes:
+**    1. This function must be called prior to any other functions being
+**       called using the same SHM_RING instance.
+**
+*/
+void SHM_RING_Constructor(SHM_RING_Class_t *ShmRingPtr,
+                          const INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: SHM_RING_ResetStatus
+**
+** Reset counters and status flags to a known reset state.
+**
+*/
+void SHM_RING_ResetStatus(void);
+
+
+/******************************************************************************
+** Function: SHM_RING_Write
+**
+** Write a message to the ring if the ring is enabled.
+**
+** Notes:
+**   1. Topic and Payload are null terminated and PayloadLen is
+**      strlen(Payload).
+**
+*/
+void SHM_RING_Write(uint16 TopicId, const char *Topic, const char *Payload,
+                    uint32 PayloadLen);
+
+
+#endif /* _shm_ring_ */
@@ -0,0 +1,255 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Provide an in-memory trace ring for per-message diagnostics
+**
+** Notes:
+**   1. The GCC __atomic builtins are used for the lock-free slot reservation
+**      because OSAL does not provide atomic operations.
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+
+#include "trace_ring.h"
+#include "msg_stats.h"
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static TRACE_RING_Class_t *TraceRing = NULL;
+
+static const char *ModuleStr[TRACE_RING_MODULE_CNT] =
+{
+   "MQTT_MGR",
+   "MQTT_CLIENT",
+   "MSG_TRANS",
+   "TOPIC_TBL",
+   "TOPIC"
+};
+
+
+/******************************************************************************
+** Function: TRACE_RING_Constructor
+**
+*/
+void TRACE_RING_Constructor(TRACE_RING_Class_t *TraceRingPtr,
+                            const INITBL_Class_t *IniTbl)
+{
+
+   TraceRing = TraceRingPtr;
+
+   CFE_PSP_MemSet((void*)TraceRing, 0, sizeof(TRACE_RING_Class_t));
+
+   memset(TraceRing->Level, INITBL_GetIntConfig(IniTbl, CFG_TRACE_DEF_LEVEL),
+          sizeof(TraceRing->Level));
+
+} /* End TRACE_RING_Constructor() */
+
+
+/******************************************************************************
+** Function: TRACE_RING_ConfigCmd
+**
+*/
+bool TRACE_RING_ConfigCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const MQTT_GW_ConfigTrace_Payload_t *ConfigTraceCmd = CMDMGR_PAYLOAD_PTR(MsgPtr, MQTT_GW_ConfigTrace_t);
+   bool RetStatus = false;
+
+   if (ConfigTraceCmd->Level > TRACE_RING_LEVEL_DEBUG)
+   {
+      CFE_EVS_SendEvent(TRACE_RING_CONFIG_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Config trace command rejected. Invalid level %d, must be less than or equal to %d",
+                        ConfigTraceCmd->Level, TRACE_RING_LEVEL_DEBUG);
+   }
+   else if (ConfigTraceCmd->Module == TRACE_RING_ALL_MODULES)
+   {
+      memset(TraceRing->Level, ConfigTraceCmd->Level, sizeof(TraceRing->Level));
+      RetStatus = true;
+      CFE_EVS_SendEvent(TRACE_RING_CONFIG_EID, CFE_EVS_EventType_INFORMATION,
+                        "Trace level set to %d for all modules", ConfigTraceCmd->Level);
+   }
+   else if (ConfigTraceCmd->Module < TRACE_RING_MODULE_CNT)
+   {
+      TraceRing->Level[ConfigTraceCmd->Module] = ConfigTraceCmd->Level;
+      RetStatus = true;
+      CFE_EVS_SendEvent(TRACE_RING_CONFIG_EID, CFE_EVS_EventType_INFORMATION,
+                        "Trace level set to %d for module %s", ConfigTraceCmd->Level,
+                        ModuleStr[ConfigTraceCmd->Module]);
+   }
+   else
+   {
+      CFE_EVS_SendEvent(TRACE_RING_CONFIG_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Config trace command rejected. Invalid module %d, must be less than %d or %d for all",
+                        ConfigTraceCmd->Module, TRACE_RING_MODULE_CNT, TRACE_RING_ALL_MODULES);
+   }
+
+   return RetStatus;
+
+} /* End TRACE_RING_ConfigCmd() */
+
+
+/******************************************************************************
+** Function: TRACE_RING_DumpCmd
+**
+** Notes:
+**  1. File is formatted as a JSON array with the oldest entry first.
+**  2. Creates a new dump file, overwriting anything that may have existed
+**     previously
+*/
+bool TRACE_RING_DumpCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const MQTT_GW_DumpTrace_Payload_t *DumpTraceCmd = CMDMGR_PAYLOAD_PTR(MsgPtr, MQTT_GW_DumpTrace_t);
+   bool       RetStatus = false;
+   int32      SysStatus;
+   osal_id_t  FileHandle;
+   os_err_name_t OsErrStr;
+   uint32     WriteIdx;
+   uint32     Idx;
+   uint32     EntryCnt = 0;
+   TRACE_RING_Entry_t Entry;
+   char DumpRecord[256];
+   char SysTimeStr[128];
+
+
+   SysStatus = OS_OpenCreate(&FileHandle, DumpTraceCmd->Filename, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE, OS_READ_WRITE);
+
+   if (SysStatus == OS_SUCCESS)
+   {
+
+      WriteIdx = __atomic_load_n(&TraceRing->WriteIdx, __ATOMIC_ACQUIRE);
+      Idx = (WriteIdx > TRACE_RING_DEPTH) ? (WriteIdx - TRACE_RING_DEPTH) : 0;
+
+      CFE_TIME_Print(SysTimeStr, CFE_TIME_GetTime());
+      sprintf(DumpRecord,"{\n   \"description\": \"Trace ring dumped at %s\",\n   \"trace\": [\n",SysTimeStr);
+      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+      for ( ; Idx < WriteIdx; Idx++)
+      {
+
+         memcpy(&Entry, &TraceRing->Entry[Idx % TRACE_RING_DEPTH], sizeof(TRACE_RING_Entry_t));
+
+         /* Skip entries overwritten or in the process of being written */
+         if (Entry.Seq != (Idx + 1) ||
+             __atomic_load_n(&TraceRing->Entry[Idx % TRACE_RING_DEPTH].Seq, __ATOMIC_ACQUIRE) != Entry.Seq)
+         {
+            continue;
+         }
+
+         Entry.Text[TRACE_RING_TEXT_LEN-1] = '\0';
+         sprintf(DumpRecord,"%s      {\"seq\": %u, \"time\": %u, \"module\": \"%s\", \"level\": %u, \"id\": %u, "
+                 "\"param\": [%u, %u], \"text\": \"%s\"}",
+                 (EntryCnt > 0) ? ",\n" : "",
+                 (unsigned int)Entry.Seq, (unsigned int)Entry.Time,
+                 (Entry.Module < TRACE_RING_MODULE_CNT) ? ModuleStr[Entry.Module] : "UNDEF",
+                 Entry.Level, Entry.Id, (unsigned int)Entry.Param[0], (unsigned int)Entry.Param[1], Entry.Text);
+         OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+         ++EntryCnt;
+
+      } /* End entry loop */
+
+      sprintf(DumpRecord,"\n   ]\n}\n");
+      OS_write(FileHandle,DumpRecord,strlen(DumpRecord));
+
+      OS_close(FileHandle);
+
+      ++TraceRing->DumpCnt;
+      RetStatus = true;
+
+      CFE_EVS_SendEvent(TRACE_RING_DUMP_EID, CFE_EVS_EventType_INFORMATION,
+                        "Dumped %u trace entries to %s", (unsigned int)EntryCnt, DumpTraceCmd->Filename);
+
+   } /* End if file create */
+   else
+   {
+      OS_GetErrorName(SysStatus, &OsErrStr);
+      CFE_EVS_SendEvent(TRACE_RING_DUMP_ERR_EID, CFE_EVS_EventType_ERROR,
+                        "Error creating trace dump file '%s', status=%s",
+                        DumpTraceCmd->Filename, OsErrStr);
+
+   } /* End if file create error */
+
+   return RetStatus;
+
+} /* End TRACE_RING_DumpCmd() */
+
+
+/******************************************************************************
+** Function: TRACE_RING_Enabled
+**
+*/
+bool TRACE_RING_Enabled(TRACE_RING_Module_t Module, TRACE_RING_Level_t Level)
+{
+
+   return (Level <= TraceRing->Level[Module] && Level != TRACE_RING_LEVEL_OFF);
+
+} /* End TRACE_RING_Enabled() */
+
+
+/******************************************************************************
+** Function: TRACE_RING_Write
+**
+*/
+void TRACE_RING_Write(TRACE_RING_Module_t Module, TRACE_RING_Level_t Level, uint16 Id,
+                      uint32 Param1, uint32 Param2, const char *Text, uint16 TextLen)
+{
+
+   uint32 Idx;
+   uint16 i;
+   TRACE_RING_Entry_t *Entry;
+
+   if (TRACE_RING_Enabled(Module, Level))
+   {
+
+      Idx   = __atomic_fetch_add(&TraceRing->WriteIdx, 1, __ATOMIC_RELAXED);
+      Entry = &TraceRing->Entry[Idx % TRACE_RING_DEPTH];
+
+      __atomic_store_n(&Entry->Seq, 0, __ATOMIC_RELAXED);
+
+      Entry->Time     = MSG_STATS_GetTime();
+      Entry->Module   = Module;
+      Entry->Level    = Level;
+      Entry->Id       = Id;
+      Entry->Param[0] = Param1;
+      Entry->Param[1] = Param2;
+
+      i = 0;
+      if (Text != NULL)
+      {
+         /* Quotes and control characters would break the JSON dump */
+         for ( ; i < TextLen && i < (TRACE_RING_TEXT_LEN-1) && Text[i] != '\0'; i++)
+         {
+            Entry->Text[i] = (Text[i] == '"' || Text[i] == '\\' || Text[i] < ' ') ? '.' : Text[i];
+         }
+      }
+      Entry->Text[i] = '\0';
+
+      __atomic_store_n(&Entry->Seq, Idx + 1, __ATOMIC_RELEASE);
+
+   } /* End if enabled */
+
+} /* End TRACE_RING_Write() */
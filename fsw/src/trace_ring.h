@@ -0,0 +1,186 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Provide an in-memory trace ring for per-message diagnostics
+**
+** Notes:
+**   1. Per-message diagnostics must not use event messages or OS_printf()
+**      because they flood EVS and dominate the CPU at high message rates.
+**      Trace points are written to a fixed size ring that is dumped to a
+**      file on command. Event messages are reserved for errors.
+**   2. Each module has its own verbosity level that is set by command. A
+**      trace point is only recorded if its level is less than or equal to
+**      the module's level.
+**   3. Writers from any task reserve a slot with an atomic increment so no
+**      lock is needed. Each entry's sequence number is written last so the
+**      dump can skip entries that were being overwritten while it read them.
+**   4. Trace point IDs are defined by each module in its header file.
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+#ifndef _trace_ring_
+#define _trace_ring_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define TRACE_RING_ALL_MODULES  0xFF
+
+/*
+** Event Message IDs
+*/
+
+#define TRACE_RING_CONFIG_EID    (TRACE_RING_BASE_EID + 0)
+#define TRACE_RING_CONFIG_ERR_EID (TRACE_RING_BASE_EID + 1)
+#define TRACE_RING_DUMP_EID      (TRACE_RING_BASE_EID + 2)
+#define TRACE_RING_DUMP_ERR_EID  (TRACE_RING_BASE_EID + 3)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+typedef enum
+{
+
+   TRACE_RING_MODULE_MQTT_MGR    = 0,
+   TRACE_RING_MODULE_MQTT_CLIENT = 1,
+   TRACE_RING_MODULE_MSG_TRANS   = 2,
+   TRACE_RING_MODULE_TOPIC_TBL   = 3,
+   TRACE_RING_MODULE_TOPIC       = 4,   /* MQTT_TOPIC_xxx translators */
+   TRACE_RING_MODULE_CNT         = 5
+
+} TRACE_RING_Module_t;
+
+
+typedef enum
+{
+
+   TRACE_RING_LEVEL_OFF   = 0,
+   TRACE_RING_LEVEL_ERROR = 1,
+   TRACE_RING_LEVEL_INFO  = 2,
+   TRACE_RING_LEVEL_DEBUG = 3
+
+} TRACE_RING_Level_t;
+
+
+typedef struct
+{
+
+   uint32  Seq;       /* Write index plus one, zero means never written */
+   uint32  Time;      /* Microseconds, see MSG_STATS_GetTime() */
+   uint8   Module;
+   uint8   Level;
+   uint16  Id;
+   uint32  Param[2];
+   char    Text[TRACE_RING_TEXT_LEN];
+
+} TRACE_RING_Entry_t;
+
+
+/*
+** Class Definition
+*/
+
+typedef struct
+{
+
+   uint8   Level[TRACE_RING_MODULE_CNT];
+
+   uint32  WriteIdx;
+   uint32  DumpCnt;
+
+   TRACE_RING_Entry_t  Entry[TRACE_RING_DEPTH];
+
+} TRACE_RING_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: TRACE_RING_Constructor
+**
+** Notes:
+**    1. This function must be called prior to any other functions being
+**       called using the same TRACE_RING instance.
+*/
+void TRACE_RING_Constructor(TRACE_RING_Class_t *TraceRingPtr,
+                            const INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: TRACE_RING_ConfigCmd
+**
+** Set the verbosity level of one or all modules.
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+*/
+bool TRACE_RING_ConfigCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: TRACE_RING_DumpCmd
+**
+** Write the contents of the trace ring to a file, oldest entry first.
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**   2. Tracing continues during the dump. Entries that are overwritten while
+**      the dump is in progress are skipped.
+*/
+bool TRACE_RING_DumpCmd(void* DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: TRACE_RING_Enabled
+**
+** Return true if a trace point at the given level would be recorded. Callers
+** use this to avoid preparing expensive trace arguments.
+**
+*/
+bool TRACE_RING_Enabled(TRACE_RING_Module_t Module, TRACE_RING_Level_t Level);
+
+
+/******************************************************************************
+** Function: TRACE_RING_Write
+**
+** Record a trace point if the module's level allows it.
+**
+** Notes:
+**   1. Text may be NULL. At most TextLen characters are copied and the text
+**      is truncated to fit the entry. Text does not need to be null
+**      terminated so MQTT length strings can be traced directly.
+**
+*/
+void TRACE_RING_Write(TRACE_RING_Module_t Module, TRACE_RING_Level_t Level, uint16 Id,
+                      uint32 Param1, uint32 Param2, const char *Text, uint16 TextLen);
+
+
+#endif /* _trace_ring_ */
@@ -0,0 +1,382 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Unit test DECODE_POOL's single producer single consumer worker queues
+**
+** Notes:
+**   1. The producer is DECODE_POOL_ProcessMqttMsg() and the consumer is
+**      DECODE_POOL_WorkerTask(). The tests run both in one task and check
+**      the queue indices, ordering, overflow and stale generation paths.
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+
+/*
+** Includes
+*/
+
+#include "mqtt_gw_coveragetest_common.h"
+#include "decode_pool.h"
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static DECODE_POOL_Class_t    DecodePool;
+static MQTT_TOPIC_TBL_Data_t  TopicTblData;
+static INITBL_Class_t         IniTbl;
+
+static MQTTMessage  MqttMsg;
+static MessageData  MqttMsgData;
+static char         MqttPayload[DECODE_POOL_PAYLOAD_LEN+1];
+
+
+/******************************************************************************
+** Function: ConstructDecodePool
+**
+** Construct a pool with WorkerCnt workers that are assigned messages for
+** topic ID TopicId in generation Generation.
+**
+*/
+static void ConstructDecodePool(uint16 WorkerCnt, uint16 TopicId, uint32 Generation)
+{
+
+   memset(&DecodePool, 0, sizeof(DecodePool));
+   memset(&TopicTblData, 0, sizeof(TopicTblData));
+
+   TopicTblData.Generation = Generation;
+   UT_MqttGw.TopicTblData  = &TopicTblData;
+   UT_MqttGw.IntConfig[CFG_DECODE_POOL_WORKER_CNT] = WorkerCnt;
+   UT_MqttGw.StrConfig[CFG_DECODE_POOL_CHILD_NAME] = "UT_DECODE";
+   UT_SetDefaultReturnValue(UT_KEY(MSG_TRANS_FindMqttTopic), TopicId);
+
+   DECODE_POOL_Constructor(&DecodePool, &IniTbl);
+
+} /* End ConstructDecodePool() */
+
+
+/******************************************************************************
+** Function: ReceiveMqttMsg
+**
+** Pass a message to the pool as the MQTT child task's message handler.
+**
+*/
+static void ReceiveMqttMsg(const char *Payload, size_t PayloadLen)
+{
+
+   memcpy(MqttPayload, Payload, PayloadLen);
+   MqttMsg.payload    = MqttPayload;
+   MqttMsg.payloadlen = PayloadLen;
+   MqttMsgData.message = &MqttMsg;
+
+   DECODE_POOL_ProcessMqttMsg(&MqttMsgData);
+
+} /* End ReceiveMqttMsg() */
+
+
+/******************************************************************************
+** Function: WorkerDepth
+**
+*/
+static uint32 WorkerDepth(const DECODE_POOL_Worker_t *Worker)
+{
+
+   return Worker->Head - Worker->Tail;
+
+} /* End WorkerDepth() */
+
+
+/******************************************************************************
+** Function: Test_DECODE_POOL_Constructor
+**
+*/
+void Test_DECODE_POOL_Constructor(void)
+{
+
+   ConstructDecodePool(DECODE_POOL_MAX_WORKERS + 1, 0, 1);
+   UtAssert_UINT32_EQ(DecodePool.WorkerCnt, DECODE_POOL_MAX_WORKERS);
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(CHILDMGR_Constructor)), DECODE_POOL_MAX_WORKERS);
+
+   UT_MqttGw_Setup();
+   ConstructDecodePool(0, 0, 1);
+   ReceiveMqttMsg("{}", 2);
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(MSG_TRANS_ProcessMqttMsg)), 1);
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(OS_CountSemGive)), 0);
+
+} /* End Test_DECODE_POOL_Constructor() */
+
+
+/******************************************************************************
+** Function: Test_DECODE_POOL_QueueOrder
+**
+** Messages are decoded in the order they were received with the topic
+** table generation they were queued with.
+**
+*/
+void Test_DECODE_POOL_QueueOrder(void)
+{
+
+   DECODE_POOL_Worker_t *Worker;
+   uint16 i;
+
+   ConstructDecodePool(1, 5, 7);
+   Worker = &DecodePool.Worker[0];
+
+   ReceiveMqttMsg("{\"a\":1}", 7);
+   ReceiveMqttMsg("{\"b\":22}", 8);
+   ReceiveMqttMsg("{\"c\":333}", 9);
+
+   UtAssert_UINT32_EQ(WorkerDepth(Worker), 3);
+   UtAssert_UINT32_EQ(Worker->QueuedCnt, 3);
+   UtAssert_UINT32_EQ(DECODE_POOL_GetMaxDepth(), 3);
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(OS_CountSemGive)), 3);
+   UtAssert_UINT32_EQ(UT_MqttGw.DecodeCnt, 0);
+
+   for (i=0; i < 3; i++)
+   {
+      DECODE_POOL_WorkerTask(&Worker->ChildMgr);
+   }
+
+   UtAssert_UINT32_EQ(WorkerDepth(Worker), 0);
+   UtAssert_UINT32_EQ(UT_MqttGw.DecodeCnt, 3);
+   UtAssert_STRINGBUF_EQ(UT_MqttGw.Decode[0].Payload, sizeof(UT_MqttGw.Decode[0].Payload), "{\"a\":1}", 7);
+   UtAssert_STRINGBUF_EQ(UT_MqttGw.Decode[1].Payload, sizeof(UT_MqttGw.Decode[1].Payload), "{\"b\":22}", 8);
+   UtAssert_STRINGBUF_EQ(UT_MqttGw.Decode[2].Payload, sizeof(UT_MqttGw.Decode[2].Payload), "{\"c\":333}", 9);
+   for (i=0; i < 3; i++)
+   {
+      UtAssert_UINT32_EQ(UT_MqttGw.Decode[i].TopicId, 5);
+      UtAssert_UINT32_EQ(UT_MqttGw.Decode[i].Generation, 7);
+   }
+   UtAssert_UINT32_EQ(DECODE_POOL_GetStaleCnt(), 0);
+
+   /* The worker is only a topic table reader while it decodes */
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(MQTT_TOPIC_TBL_ReaderOffline)), 3);
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(MQTT_TOPIC_TBL_ReaderQuiescent)), 3);
+
+} /* End Test_DECODE_POOL_QueueOrder() */
+
+
+/******************************************************************************
+** Function: Test_DECODE_POOL_QueueFull
+**
+** A full queue drops messages without waiting and accepts messages again
+** once the worker has released an entry.
+**
+*/
+void Test_DECODE_POOL_QueueFull(void)
+{
+
+   DECODE_POOL_Worker_t *Worker;
+   char   Payload[16];
+   uint16 i;
+
+   ConstructDecodePool(1, 2, 3);
+   Worker = &DecodePool.Worker[0];
+
+   for (i=0; i < DECODE_POOL_QUEUE_LEN + 2; i++)
+   {
+      snprintf(Payload, sizeof(Payload), "%u", i);
+      ReceiveMqttMsg(Payload, strlen(Payload));
+   }
+
+   UtAssert_UINT32_EQ(WorkerDepth(Worker), DECODE_POOL_QUEUE_LEN);
+   UtAssert_UINT32_EQ(DECODE_POOL_GetDropCnt(), 2);
+   UtAssert_UINT32_EQ(DECODE_POOL_GetMaxDepth(), DECODE_POOL_QUEUE_LEN);
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(OS_CountSemGive)), DECODE_POOL_QUEUE_LEN);
+
+   DECODE_POOL_WorkerTask(&Worker->ChildMgr);
+   ReceiveMqttMsg("new", 3);
+
+   UtAssert_UINT32_EQ(WorkerDepth(Worker), DECODE_POOL_QUEUE_LEN);
+   UtAssert_UINT32_EQ(DECODE_POOL_GetDropCnt(), 2);
+
+   for (i=0; i < DECODE_POOL_QUEUE_LEN; i++)
+   {
+      DECODE_POOL_WorkerTask(&Worker->ChildMgr);
+   }
+
+   UtAssert_UINT32_EQ(UT_MqttGw.DecodeCnt, DECODE_POOL_QUEUE_LEN + 1);
+   UtAssert_STRINGBUF_EQ(UT_MqttGw.Decode[0].Payload, sizeof(UT_MqttGw.Decode[0].Payload), "0", 1);
+   snprintf(Payload, sizeof(Payload), "%u", DECODE_POOL_QUEUE_LEN-1);
+   UtAssert_STRINGBUF_EQ(UT_MqttGw.Decode[DECODE_POOL_QUEUE_LEN-1].Payload,
+                         sizeof(UT_MqttGw.Decode[0].Payload), Payload, sizeof(Payload));
+   UtAssert_STRINGBUF_EQ(UT_MqttGw.Decode[DECODE_POOL_QUEUE_LEN].Payload,
+                         sizeof(UT_MqttGw.Decode[0].Payload), "new", 3);
+
+   DECODE_POOL_ResetStatus();
+   UtAssert_UINT32_EQ(DECODE_POOL_GetDropCnt(), 0);
+   UtAssert_UINT32_EQ(DECODE_POOL_GetMaxDepth(), 0);
+
+} /* End Test_DECODE_POOL_QueueFull() */
+
+
+/******************************************************************************
+** Function: Test_DECODE_POOL_IndexWrap
+**
+** The free running queue indices wrap from 0xFFFFFFFF to 0.
+**
+*/
+void Test_DECODE_POOL_IndexWrap(void)
+{
+
+   DECODE_POOL_Worker_t *Worker;
+   uint16 i;
+
+   ConstructDecodePool(1, 1, 1);
+   Worker = &DecodePool.Worker[0];
+   Worker->Head = 0xFFFFFFFE;
+   Worker->Tail = 0xFFFFFFFE;
+
+   ReceiveMqttMsg("w0", 2);
+   ReceiveMqttMsg("w1", 2);
+   ReceiveMqttMsg("w2", 2);
+
+   UtAssert_UINT32_EQ(Worker->Head, 1);
+   UtAssert_UINT32_EQ(WorkerDepth(Worker), 3);
+   UtAssert_UINT32_EQ(DECODE_POOL_GetMaxDepth(), 3);
+
+   for (i=0; i < 3; i++)
+   {
+      DECODE_POOL_WorkerTask(&Worker->ChildMgr);
+   }
+
+   UtAssert_UINT32_EQ(Worker->Tail, 1);
+   UtAssert_UINT32_EQ(UT_MqttGw.DecodeCnt, 3);
+   UtAssert_STRINGBUF_EQ(UT_MqttGw.Decode[2].Payload, sizeof(UT_MqttGw.Decode[2].Payload), "w2", 2);
+
+} /* End Test_DECODE_POOL_IndexWrap() */
+
+
+/******************************************************************************
+** Function: Test_DECODE_POOL_Drop
+**
+** Messages that can't be queued are dropped by the producer and a wake up
+** without a queued message doesn't decode.
+**
+*/
+void Test_DECODE_POOL_Drop(void)
+{
+
+   static char LongPayload[DECODE_POOL_PAYLOAD_LEN+1];
+   DECODE_POOL_Worker_t *Worker;
+
+   ConstructDecodePool(1, 4, 1);
+   Worker = &DecodePool.Worker[0];
+
+   memset(LongPayload, 'x', sizeof(LongPayload));
+   ReceiveMqttMsg(LongPayload, sizeof(LongPayload));
+
+   UtAssert_UINT32_EQ(WorkerDepth(Worker), 0);
+   UtAssert_UINT32_EQ(DECODE_POOL_GetDropCnt(), 1);
+
+   UT_SetDefaultReturnValue(UT_KEY(MSG_TRANS_FindMqttTopic), MQTT_TOPIC_TBL_UNUSED_ID);
+   ReceiveMqttMsg("{}", 2);
+
+   UtAssert_UINT32_EQ(WorkerDepth(Worker), 0);
+   UtAssert_UINT32_EQ(DECODE_POOL_GetDropCnt(), 1);
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(OS_CountSemGive)), 0);
+
+   DECODE_POOL_WorkerTask(&Worker->ChildMgr);
+   UtAssert_UINT32_EQ(UT_MqttGw.DecodeCnt, 0);
+   UtAssert_UINT32_EQ(Worker->Tail, 0);
+
+} /* End Test_DECODE_POOL_Drop() */
+
+
+/******************************************************************************
+** Function: Test_DECODE_POOL_Stale
+**
+** A message whose topic table snapshot was retired is released and counted.
+**
+*/
+void Test_DECODE_POOL_Stale(void)
+{
+
+   DECODE_POOL_Worker_t *Worker;
+
+   ConstructDecodePool(1, 3, 10);
+   Worker = &DecodePool.Worker[0];
+
+   ReceiveMqttMsg("{}", 2);
+   TopicTblData.Generation = 11;
+   ReceiveMqttMsg("{}", 2);
+
+   UT_SetDeferredRetcode(UT_KEY(MSG_TRANS_DecodeMqttMsg), 1, false);
+   DECODE_POOL_WorkerTask(&Worker->ChildMgr);
+   DECODE_POOL_WorkerTask(&Worker->ChildMgr);
+
+   UtAssert_UINT32_EQ(UT_MqttGw.DecodeCnt, 2);
+   UtAssert_UINT32_EQ(UT_MqttGw.Decode[0].Generation, 10);
+   UtAssert_UINT32_EQ(UT_MqttGw.Decode[1].Generation, 11);
+   UtAssert_UINT32_EQ(WorkerDepth(Worker), 0);
+   UtAssert_UINT32_EQ(DECODE_POOL_GetStaleCnt(), 1);
+
+} /* End Test_DECODE_POOL_Stale() */
+
+
+/******************************************************************************
+** Function: Test_DECODE_POOL_TopicStripe
+**
+** A topic is always queued to the same worker.
+**
+*/
+void Test_DECODE_POOL_TopicStripe(void)
+{
+
+   uint16 TopicId;
+   uint16 i;
+
+   ConstructDecodePool(DECODE_POOL_MAX_WORKERS, 0, 1);
+
+   for (TopicId=0; TopicId < 2*DECODE_POOL_MAX_WORKERS; TopicId++)
+   {
+      UT_SetDefaultReturnValue(UT_KEY(MSG_TRANS_FindMqttTopic), TopicId);
+      ReceiveMqttMsg("{}", 2);
+   }
+
+   for (i=0; i < DECODE_POOL_MAX_WORKERS; i++)
+   {
+      UtAssert_UINT32_EQ(WorkerDepth(&DecodePool.Worker[i]), 2);
+      UtAssert_UINT32_EQ(DecodePool.Worker[i].Queue[0].TopicId, i);
+      UtAssert_UINT32_EQ(DecodePool.Worker[i].Queue[1].TopicId, i + DECODE_POOL_MAX_WORKERS);
+   }
+
+   /* A callback for a child manager that isn't a worker doesn't decode */
+   DECODE_POOL_WorkerTask(NULL);
+   UtAssert_UINT32_EQ(UT_MqttGw.DecodeCnt, 0);
+
+} /* End Test_DECODE_POOL_TopicStripe() */
+
+
+/******************************************************************************
+** Function: UtTest_Setup
+**
+*/
+void UtTest_Setup(void)
+{
+
+   ADD_TEST(DECODE_POOL_Constructor);
+   ADD_TEST(DECODE_POOL_QueueOrder);
+   ADD_TEST(DECODE_POOL_QueueFull);
+   ADD_TEST(DECODE_POOL_IndexWrap);
+   ADD_TEST(DECODE_POOL_Drop);
+   ADD_TEST(DECODE_POOL_Stale);
+   ADD_TEST(DECODE_POOL_TopicStripe);
+
+} /* End UtTest_Setup() */
@@ -0,0 +1,241 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Unit test LAST_VALUE's slot sequence lock
+**
+** Notes:
+**   1. A writer that is still writing a slot is simulated by setting the
+**      slot's sequence number to an odd value.
+**   2. Slots are read by publishing a snapshot, each value that is read
+**      is published with MQTT_CLIENT_Publish().
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+
+/*
+** Includes
+*/
+
+#include "mqtt_gw_coveragetest_common.h"
+#include "last_value.h"
+#include "mqtt_client.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define UT_TOPIC_ID   1
+#define UT_SB_MID     0x1F01
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static LAST_VALUE_Class_t      LastValue;
+static MQTT_TOPIC_TBL_Entry_t  TopicEntry;
+static INITBL_Class_t          IniTbl;
+static CFE_MSG_Message_t       SbMsg;
+
+
+/******************************************************************************
+** Function: ConstructLastValue
+**
+** Construct LAST_VALUE with requests and saves disabled and two SB-to-MQTT
+** topics.
+**
+*/
+static void ConstructLastValue(void)
+{
+
+   memset(&LastValue, 0, sizeof(LastValue));
+   memset(&TopicEntry, 0, sizeof(TopicEntry));
+   memset(&SbMsg, 0, sizeof(SbMsg));
+
+   TopicEntry.SbMid  = UT_SB_MID;
+   TopicEntry.SbRole = MQTT_TOPIC_TBL_SB_ROLE_SUB;
+   UT_MqttGw.TopicEntry = &TopicEntry;
+   UT_MqttGw.TopicCnt   = 2;
+
+   LAST_VALUE_Constructor(&LastValue, &IniTbl);
+
+} /* End ConstructLastValue() */
+
+
+/******************************************************************************
+** Function: PublishedCnt
+**
+** Publish a snapshot and return the number of values that were read.
+**
+*/
+static uint32 PublishedCnt(void)
+{
+
+   uint32 PublishCnt = UT_GetStubCount(UT_KEY(MQTT_CLIENT_Publish));
+
+   LAST_VALUE_PublishCmd(NULL, NULL);
+
+   return UT_GetStubCount(UT_KEY(MQTT_CLIENT_Publish)) - PublishCnt;
+
+} /* End PublishedCnt() */
+
+
+/******************************************************************************
+** Function: Test_LAST_VALUE_UpdateSlot
+**
+** Each update leaves the slot's sequence number even and two greater.
+**
+*/
+void Test_LAST_VALUE_UpdateSlot(void)
+{
+
+   const LAST_VALUE_Slot_t *Slot;
+
+   ConstructLastValue();
+   Slot = &LastValue.Slot[UT_TOPIC_ID];
+
+   UtAssert_UINT32_EQ(Slot->Seq, 0);
+   UtAssert_UINT32_EQ(LAST_VALUE_GetTopicCnt(), 0);
+   UtAssert_UINT32_EQ(PublishedCnt(), 0);
+
+   LAST_VALUE_Update(UT_TOPIC_ID, MSG_STATS_DIR_SB_TO_MQTT, "ut/topic", "{\"v\":1}", 7, &SbMsg);
+
+   UtAssert_UINT32_EQ(Slot->Seq, 2);
+   UtAssert_UINT32_EQ(Slot->SbMid, UT_SB_MID);
+   UtAssert_UINT32_EQ(Slot->PayloadLen, 7);
+   UtAssert_STRINGBUF_EQ(Slot->Topic, sizeof(Slot->Topic), "ut/topic", 8);
+   UtAssert_STRINGBUF_EQ(Slot->Payload, sizeof(Slot->Payload), "{\"v\":1}", 7);
+   UtAssert_UINT32_EQ(LAST_VALUE_GetTopicCnt(), 1);
+
+   LAST_VALUE_Update(UT_TOPIC_ID, MSG_STATS_DIR_SB_TO_MQTT, "ut/topic", "{\"v\":22}", 8, &SbMsg);
+
+   UtAssert_UINT32_EQ(Slot->Seq, 4);
+   UtAssert_STRINGBUF_EQ(Slot->Payload, sizeof(Slot->Payload), "{\"v\":22}", 8);
+   UtAssert_UINT32_EQ(LastValue.SkipCnt, 0);
+   UtAssert_UINT32_EQ(PublishedCnt(), 1);
+
+} /* End Test_LAST_VALUE_UpdateSlot() */
+
+
+/******************************************************************************
+** Function: Test_LAST_VALUE_WriterBusy
+**
+** A slot that another writer holds is neither written nor read.
+**
+*/
+void Test_LAST_VALUE_WriterBusy(void)
+{
+
+   LAST_VALUE_Slot_t *Slot;
+
+   ConstructLastValue();
+   Slot = &LastValue.Slot[UT_TOPIC_ID];
+
+   LAST_VALUE_Update(UT_TOPIC_ID, MSG_STATS_DIR_SB_TO_MQTT, "ut/topic", "{\"v\":1}", 7, &SbMsg);
+   UtAssert_UINT32_EQ(PublishedCnt(), 1);
+
+   /* Another writer has locked the slot */
+   Slot->Seq = 3;
+
+   LAST_VALUE_Update(UT_TOPIC_ID, MSG_STATS_DIR_SB_TO_MQTT, "ut/topic", "{\"v\":2}", 7, &SbMsg);
+
+   UtAssert_UINT32_EQ(Slot->Seq, 3);
+   UtAssert_UINT32_EQ(LastValue.SkipCnt, 1);
+   UtAssert_STRINGBUF_EQ(Slot->Payload, sizeof(Slot->Payload), "{\"v\":1}", 7);
+   UtAssert_UINT32_EQ(PublishedCnt(), 0);
+
+   /* The other writer unlocks the slot */
+   Slot->Seq = 4;
+
+   LAST_VALUE_Update(UT_TOPIC_ID, MSG_STATS_DIR_SB_TO_MQTT, "ut/topic", "{\"v\":3}", 7, &SbMsg);
+
+   UtAssert_UINT32_EQ(Slot->Seq, 6);
+   UtAssert_STRINGBUF_EQ(Slot->Payload, sizeof(Slot->Payload), "{\"v\":3}", 7);
+   UtAssert_UINT32_EQ(PublishedCnt(), 1);
+
+} /* End Test_LAST_VALUE_WriterBusy() */
+
+
+/******************************************************************************
+** Function: Test_LAST_VALUE_UpdateSkip
+**
+** Updates for unknown topics and oversize payloads don't lock the slot.
+**
+*/
+void Test_LAST_VALUE_UpdateSkip(void)
+{
+
+   static char LongPayload[LAST_VALUE_PAYLOAD_LEN+1];
+
+   ConstructLastValue();
+
+   LAST_VALUE_Update(UT_MqttGw.TopicCnt, MSG_STATS_DIR_SB_TO_MQTT, "ut/topic", "{}", 2, &SbMsg);
+   UtAssert_UINT32_EQ(LastValue.Slot[UT_MqttGw.TopicCnt].Seq, 0);
+
+   memset(LongPayload, 'x', LAST_VALUE_PAYLOAD_LEN);
+   LAST_VALUE_Update(UT_TOPIC_ID, MSG_STATS_DIR_SB_TO_MQTT, "ut/topic", LongPayload,
+                     LAST_VALUE_PAYLOAD_LEN, &SbMsg);
+   UtAssert_UINT32_EQ(LastValue.Slot[UT_TOPIC_ID].Seq, 0);
+
+   UtAssert_UINT32_EQ(LastValue.SkipCnt, 2);
+   UtAssert_UINT32_EQ(LAST_VALUE_GetTopicCnt(), 0);
+
+   LAST_VALUE_ResetStatus();
+   UtAssert_UINT32_EQ(LastValue.SkipCnt, 0);
+
+} /* End Test_LAST_VALUE_UpdateSkip() */
+
+
+/******************************************************************************
+** Function: Test_LAST_VALUE_StaleSlot
+**
+** A value written for a topic's previous table definition isn't read.
+**
+*/
+void Test_LAST_VALUE_StaleSlot(void)
+{
+
+   ConstructLastValue();
+
+   LAST_VALUE_Update(UT_TOPIC_ID, MSG_STATS_DIR_SB_TO_MQTT, "ut/topic", "{}", 2, &SbMsg);
+   UtAssert_UINT32_EQ(PublishedCnt(), 1);
+
+   TopicEntry.SbMid = UT_SB_MID + 1;
+   UtAssert_UINT32_EQ(PublishedCnt(), 0);
+
+   TopicEntry.SbMid  = UT_SB_MID;
+   TopicEntry.SbRole = MQTT_TOPIC_TBL_SB_ROLE_PUB;
+   UtAssert_UINT32_EQ(PublishedCnt(), 0);
+
+} /* End Test_LAST_VALUE_StaleSlot() */
+
+
+/******************************************************************************
+** Function: UtTest_Setup
+**
+*/
+void UtTest_Setup(void)
+{
+
+   ADD_TEST(LAST_VALUE_UpdateSlot);
+   ADD_TEST(LAST_VALUE_WriterBusy);
+   ADD_TEST(LAST_VALUE_UpdateSkip);
+   ADD_TEST(LAST_VALUE_StaleSlot);
+
+} /* End UtTest_Setup() */
@@ -0,0 +1,812 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Unit test MQTT_TOPIC_TBL's streaming loader and snapshot grace period
+**
+** Notes:
+**   1. Tables are loaded through MQTT_TOPIC_TBL_LoadCmd() with the JSON
+**      text delivered by the OS_read() stub's data buffer. The
+**      JSON_SearchConst() stub searches each topic object.
+**   2. A table load must wait until every online reader has been quiescent
+**      since the last snapshot was published. Readers are simulated with an
+**      OS_TaskDelay() hook that runs while the load command polls.
+**   3. Rejected loads are checked for their LOAD_ERR event text so each
+**      test case proves which check rejected the table.
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+
+/*
+** Includes
+*/
+
+#include <stdio.h>
+
+#include "mqtt_gw_coveragetest_common.h"
+#include "mqtt_topic_tbl.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define GRACE_POLL_CNT  (MQTT_TOPIC_TBL_GRACE_TIMEOUT_MS / MQTT_TOPIC_TBL_GRACE_POLL_MS)
+
+#define UT_TBL_FILE       "/cf/ut_topics.json"
+#define UT_SPACECRAFT_ID  42
+#define UT_BASE_MID       0x1F00
+#define UT_PROBE_MID      0x0861
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static MQTT_TOPIC_TBL_Class_t  MqttTopicTbl;
+static TBLMGR_Tbl_t            TblMgrTbl;
+
+static const uint32 ReservedMid[MQTT_TOPIC_TBL_RESERVED_MID_CNT] = { 0x1880, 0x1881, 0x0880, 0x0881, 0x0882 };
+
+static char TblJson[16384];
+
+/*
+** The root's other keys have strings and nested values that look like the
+** topic array. Loading stops at the end of the topic array so the
+** truncated 'after' key is never read.
+*/
+static const char ValidTbl[] =
+   "{\n"
+   "   \"title\": \"Not the \\\"topic\\\": [ { } ] array\",\n"
+   "   \"doc\": { \"topic\": [ 7 ], \"list\": [ \"]\", \"}\" ] },\n"
+   "   \"topic\": [\n"
+   "      { \"name\": \"{app}/sc{scid}/hk\", \"id\": 0, \"sb-role\": \"sub\", \"retain\": true },\n"
+   "      { \"name\": \"ut/cmd/{app}\", \"id\": 3, \"sb-mid\": 4096, \"sb-role\": \"pub\" },\n"
+   "      { \"name\": \"ut/apid/{apid}\", \"id\": 5, \"sb-role\": \"sub\", \"dedup\": 10 }\n"
+   "   ],\n"
+   "   \"after\": ";
+
+
+/*
+** The last event sent
+*/
+static struct
+{
+
+   uint16  EventId;
+   char    Text[256];
+
+} LastEvent;
+
+
+/*
+** A reader that reports in on OS_TaskDelay() call number CallCnt
+*/
+static struct
+{
+
+   MQTT_TOPIC_TBL_Reader_t  Reader;
+   uint32  CallCnt;
+   uint32  DelayCnt;
+   bool    Offline;
+
+} DelayReader;
+
+
+/******************************************************************************
+** Function: EventHook
+**
+*/
+static int32 EventHook(void *UserObj, int32 StubRetcode, uint32 CallCount,
+                       const UT_StubContext_t *Context, va_list va)
+{
+
+   LastEvent.EventId = UT_Hook_GetArgValueByName(Context, "EventID", uint16);
+   vsnprintf(LastEvent.Text, sizeof(LastEvent.Text),
+             UT_Hook_GetArgValueByName(Context, "Spec", const char *), va);
+
+   return StubRetcode;
+
+} /* End EventHook() */
+
+
+/******************************************************************************
+** Function: ConstructTopicTbl
+**
+*/
+static void ConstructTopicTbl(void)
+{
+
+   memset(&MqttTopicTbl, 0, sizeof(MqttTopicTbl));
+   memset(&DelayReader, 0, sizeof(DelayReader));
+
+   MQTT_TOPIC_TBL_Constructor(&MqttTopicTbl, "MQTT_GW", UT_BASE_MID, ReservedMid, UT_PROBE_MID);
+
+   UT_MqttGw.JsonSearch = true;
+   UT_SetDefaultReturnValue(UT_KEY(CFE_PSP_GetSpacecraftId), UT_SPACECRAFT_ID);
+   UT_SetVaHookFunction(UT_KEY(CFE_EVS_SendEvent), EventHook, NULL);
+
+} /* End ConstructTopicTbl() */
+
+
+/******************************************************************************
+** Function: DelayReaderHook
+**
+*/
+static int32 DelayReaderHook(void *UserObj, int32 StubRetcode, uint32 CallCount,
+                             const UT_StubContext_t *Context)
+{
+
+   if (++DelayReader.DelayCnt == DelayReader.CallCnt)
+   {
+      if (DelayReader.Offline)
+      {
+         MQTT_TOPIC_TBL_ReaderOffline(DelayReader.Reader);
+      }
+      else
+      {
+         MQTT_TOPIC_TBL_ReaderQuiescent(DelayReader.Reader);
+      }
+   }
+
+   return StubRetcode;
+
+} /* End DelayReaderHook() */
+
+
+/******************************************************************************
+** Function: LoadTbl
+**
+** Load a table file with the contents 'Json'.
+**
+*/
+static bool LoadTbl(const char *Json)
+{
+
+   memset(&LastEvent, 0, sizeof(LastEvent));
+   UT_SetDataBuffer(UT_KEY(OS_read), (void *)Json, strlen(Json), false);
+
+   return MQTT_TOPIC_TBL_LoadCmd(&TblMgrTbl, 0, UT_TBL_FILE);
+
+} /* End LoadTbl() */
+
+
+/******************************************************************************
+** Function: LoadTopics
+**
+** Load a table whose topic array has the objects in 'Topics'.
+**
+*/
+static bool LoadTopics(const char *Topics)
+{
+
+   snprintf(TblJson, sizeof(TblJson), "{\"topic\": [ %s ]}", Topics);
+
+   return LoadTbl(TblJson);
+
+} /* End LoadTopics() */
+
+
+/******************************************************************************
+** Function: CheckRejectedTbl
+**
+** Check that loading 'Json' is rejected with an event that contains 'Error'
+** and the active snapshot is not changed.
+**
+*/
+static void CheckRejectedTbl(const char *Json, const char *Error)
+{
+
+   const MQTT_TOPIC_TBL_Data_t *Active = MQTT_TOPIC_TBL_GetData();
+
+   UtAssert_True(!LoadTbl(Json), "Load rejected: %s", Json);
+   UtAssert_UINT32_EQ(MqttTopicTbl.LastLoadStatus, TBLMGR_STATUS_INVALID);
+   UtAssert_True(MQTT_TOPIC_TBL_GetData() == Active, "Active snapshot unchanged");
+   UtAssert_UINT32_EQ(LastEvent.EventId, MQTT_TOPIC_TBL_LOAD_ERR_EID);
+   UtAssert_True(strstr(LastEvent.Text, Error) != NULL, "Event '%s' contains '%s'", LastEvent.Text, Error);
+
+} /* End CheckRejectedTbl() */
+
+
+/******************************************************************************
+** Function: CheckRejected
+**
+** Check that a table with the topic objects in 'Topics' is rejected.
+**
+*/
+static void CheckRejected(const char *Topics, const char *Error)
+{
+
+   char Json[1024];
+
+   snprintf(Json, sizeof(Json), "{\"topic\": [ %s ]}", Topics);
+   CheckRejectedTbl(Json, Error);
+
+} /* End CheckRejected() */
+
+
+/******************************************************************************
+** Function: TopicEntry
+**
+** Return a topic's entry or an unused entry so a failed load can't crash
+** the test.
+**
+*/
+static const MQTT_TOPIC_TBL_Entry_t *TopicEntry(uint16 Id)
+{
+
+   static MQTT_TOPIC_TBL_Entry_t UnusedEntry;
+   const MQTT_TOPIC_TBL_Entry_t *Entry = MQTT_TOPIC_TBL_GetEntry(Id);
+
+   UtAssert_True(Entry != NULL, "Topic %d is defined", Id);
+
+   return (Entry == NULL) ? &UnusedEntry : Entry;
+
+} /* End TopicEntry() */
+
+
+/******************************************************************************
+** Function: TopicName
+**
+*/
+static const char *TopicName(uint16 Id)
+{
+
+   const char *Name = MQTT_TOPIC_TBL_GetName(Id);
+
+   return (Name == NULL) ? "" : Name;
+
+} /* End TopicName() */
+
+
+/******************************************************************************
+** Function: PublishSnapshot
+**
+** Load the valid table to publish a new snapshot.
+**
+*/
+static void PublishSnapshot(void)
+{
+
+   UtAssert_True(LoadTbl(ValidTbl), "Snapshot published");
+
+} /* End PublishSnapshot() */
+
+
+/******************************************************************************
+** Function: Test_MQTT_TOPIC_TBL_LoadValid
+**
+** A valid table is published with its names rendered and its indices built.
+**
+*/
+void Test_MQTT_TOPIC_TBL_LoadValid(void)
+{
+
+   const MQTT_TOPIC_TBL_Entry_t *Entry;
+   uint32 ArrayEnd = strstr(ValidTbl, "\n   ],") - ValidTbl + 5;
+
+   ConstructTopicTbl();
+
+   UtAssert_True(LoadTbl(ValidTbl), "Valid table loaded");
+   UtAssert_UINT32_EQ(MqttTopicTbl.LastLoadStatus, TBLMGR_STATUS_VALID);
+   UtAssert_True(MQTT_TOPIC_TBL_GetData() == &MqttTopicTbl.Buf[1], "Inactive buffer published");
+   UtAssert_UINT32_EQ(MqttTopicTbl.GracePeriod, 2);
+   UtAssert_UINT32_EQ(MqttTopicTbl.LastLoadCnt, 3);
+   UtAssert_UINT32_EQ(MqttTopicTbl.JsonFileLen, ArrayEnd);
+   UtAssert_UINT32_EQ(MQTT_TOPIC_TBL_GetTopicCnt(), 6);
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(CFE_EVS_SendEvent)), 0);
+
+   UtAssert_STRINGBUF_EQ(TopicName(0), MQTT_TOPIC_TBL_MAX_TOPIC_LEN, "MQTT_GW/sc42/hk", 16);
+   UtAssert_STRINGBUF_EQ(TopicName(3), MQTT_TOPIC_TBL_MAX_TOPIC_LEN, "ut/cmd/MQTT_GW", 15);
+   UtAssert_STRINGBUF_EQ(TopicName(5), MQTT_TOPIC_TBL_MAX_TOPIC_LEN, "ut/apid/{apid}", 15);
+   UtAssert_True(MQTT_TOPIC_TBL_GetEntry(1) == NULL, "Undefined ID 1 has no entry");
+
+   UtAssert_UINT32_EQ(MQTT_TOPIC_TBL_FindMid(UT_BASE_MID), 0);
+   UtAssert_UINT32_EQ(MQTT_TOPIC_TBL_FindMid(4096), 3);
+   UtAssert_UINT32_EQ(MQTT_TOPIC_TBL_FindMid(UT_BASE_MID + 5), 5);
+   UtAssert_UINT32_EQ(MQTT_TOPIC_TBL_FindMid(UT_BASE_MID + 3), MQTT_TOPIC_TBL_UNUSED_ID);
+   UtAssert_UINT32_EQ(MQTT_TOPIC_TBL_FindName("ut/cmd/MQTT_GW", 14), 3);
+   UtAssert_UINT32_EQ(MQTT_TOPIC_TBL_FindName("ut/cmd/{app}", 12), MQTT_TOPIC_TBL_UNUSED_ID);
+
+   Entry = TopicEntry(0);
+   UtAssert_UINT32_EQ(Entry->SbRole, MQTT_TOPIC_TBL_SB_ROLE_SUB);
+   UtAssert_UINT32_EQ(Entry->Retain, 1);
+   UtAssert_UINT32_EQ(Entry->NameKey, MQTT_TOPIC_TBL_NAME_KEY_NONE);
+   UtAssert_UINT32_EQ(Entry->MuxIdx, MQTT_TOPIC_TBL_MUX_NONE);
+
+   Entry = TopicEntry(3);
+   UtAssert_UINT32_EQ(Entry->SbRole, MQTT_TOPIC_TBL_SB_ROLE_PUB);
+   UtAssert_UINT32_EQ(Entry->SbMid, 4096);
+   UtAssert_UINT32_EQ(Entry->CodecType, MQTT_TOPIC_TBL_CODEC_STUB);
+
+   Entry = TopicEntry(5);
+   UtAssert_UINT32_EQ(Entry->NameKey, MQTT_TOPIC_TBL_NAME_KEY_APID);
+   UtAssert_UINT32_EQ(Entry->DedupTime, 10);
+
+} /* End Test_MQTT_TOPIC_TBL_LoadValid() */
+
+
+/******************************************************************************
+** Function: Test_MQTT_TOPIC_TBL_LoadStream
+**
+** A table that spans several read buffers is scanned once and objects that
+** straddle a buffer boundary are loaded.
+**
+*/
+void Test_MQTT_TOPIC_TBL_LoadStream(void)
+{
+
+   size_t JsonLen;
+   uint16 i;
+   uint16 TopicCnt = 200;
+   char   Name[32];
+
+   ConstructTopicTbl();
+
+   JsonLen = snprintf(TblJson, sizeof(TblJson), "{\"topic\": [\n");
+   for (i=0; i < TopicCnt; i++)
+   {
+      JsonLen += snprintf(&TblJson[JsonLen], sizeof(TblJson) - JsonLen,
+                          "   { \"name\": \"ut/stream/%03u\", \"id\": %u, \"sb-role\": \"sub\" }%s\n",
+                          (unsigned int)i, (unsigned int)i, (i < (TopicCnt-1)) ? "," : "");
+   }
+   JsonLen += snprintf(&TblJson[JsonLen], sizeof(TblJson) - JsonLen, "]}");
+   UtAssert_True(JsonLen > (2*MQTT_TOPIC_TBL_LOAD_BUF_LEN), "Table spans %u bytes", (unsigned int)JsonLen);
+
+   UtAssert_True(LoadTbl(TblJson), "Streamed table loaded");
+   UtAssert_UINT32_EQ(MqttTopicTbl.LastLoadCnt, TopicCnt);
+   UtAssert_UINT32_EQ(MqttTopicTbl.JsonFileLen, JsonLen - 1);
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(OS_read)),
+                      (JsonLen - 1 + MQTT_TOPIC_TBL_LOAD_BUF_LEN - 1) / MQTT_TOPIC_TBL_LOAD_BUF_LEN);
+
+   for (i=0; i < TopicCnt; i++)
+   {
+      snprintf(Name, sizeof(Name), "ut/stream/%03u", (unsigned int)i);
+      UtAssert_UINT32_EQ(MQTT_TOPIC_TBL_FindName(Name, strlen(Name)), i);
+   }
+
+} /* End Test_MQTT_TOPIC_TBL_LoadStream() */
+
+
+/******************************************************************************
+** Function: Test_MQTT_TOPIC_TBL_LoadIntegers
+**
+** IDs, message IDs and dedup times must be integers in their field's range.
+**
+*/
+void Test_MQTT_TOPIC_TBL_LoadIntegers(void)
+{
+
+   char Topic[128];
+
+   ConstructTopicTbl();
+
+   snprintf(Topic, sizeof(Topic), "{\"name\": \"ut/max\", \"id\": %d, \"sb-mid\": %d, \"sb-role\": \"sub\", \"dedup\": %d}",
+            (MQTT_TOPIC_TBL_MAX_TOPICS-1), (MQTT_TOPIC_TBL_MID_INDEX_LEN-1), UINT16_MAX);
+   UtAssert_True(LoadTopics(Topic), "Largest ID, message ID and dedup time accepted");
+   UtAssert_UINT32_EQ(MQTT_TOPIC_TBL_GetTopicCnt(), MQTT_TOPIC_TBL_MAX_TOPICS);
+   UtAssert_UINT32_EQ(MQTT_TOPIC_TBL_FindMid(MQTT_TOPIC_TBL_MID_INDEX_LEN-1), MQTT_TOPIC_TBL_MAX_TOPICS-1);
+
+   snprintf(Topic, sizeof(Topic), "{\"name\": \"ut/a\", \"id\": %d, \"sb-mid\": 4096, \"sb-role\": \"sub\"}",
+            MQTT_TOPIC_TBL_MAX_TOPICS);
+   CheckRejected(Topic, "id is missing");
+   CheckRejected("{\"name\": \"ut/a\", \"sb-role\": \"sub\"}", "id is missing");
+   CheckRejected("{\"name\": \"ut/a\", \"id\": 1.5, \"sb-role\": \"sub\"}", "id is missing");
+   CheckRejected("{\"name\": \"ut/a\", \"id\": -1, \"sb-role\": \"sub\"}", "id is missing");
+   CheckRejected("{\"name\": \"ut/a\", \"id\": 1e1, \"sb-role\": \"sub\"}", "id is missing");
+   CheckRejected("{\"name\": \"ut/a\", \"id\": \"1\", \"sb-role\": \"sub\"}", "id is missing");
+   CheckRejected("{\"name\": \"ut/a\", \"id\": 4294967297, \"sb-role\": \"sub\"}", "id is missing");
+
+   snprintf(Topic, sizeof(Topic), "{\"name\": \"ut/a\", \"id\": 1, \"sb-mid\": %d, \"sb-role\": \"sub\"}",
+            MQTT_TOPIC_TBL_MID_INDEX_LEN);
+   CheckRejected(Topic, "sb-mid is not an integer");
+   CheckRejected("{\"name\": \"ut/a\", \"id\": 1, \"sb-mid\": 4096.5, \"sb-role\": \"sub\"}", "sb-mid is not an integer");
+   CheckRejected("{\"name\": \"ut/a\", \"id\": 1, \"sb-mid\": 4294971392, \"sb-role\": \"sub\"}", "sb-mid is not an integer");
+   CheckRejected("{\"name\": \"ut/a\", \"id\": 1, \"sb-mid\": \"4096\", \"sb-role\": \"sub\"}", "sb-mid is not an integer");
+
+   CheckRejected("{\"name\": \"ut/a\", \"id\": 1, \"sb-role\": \"sub\", \"dedup\": 65536}", "dedup must be");
+   CheckRejected("{\"name\": \"ut/a\", \"id\": 1, \"sb-role\": \"sub\", \"dedup\": 0.5}", "dedup must be");
+   CheckRejected("{\"name\": \"ut/a\", \"id\": 1, \"sb-role\": \"sub\", \"dedup\": 4294967306}", "dedup must be");
+   CheckRejected("{\"name\": \"ut/a\", \"id\": 1, \"sb-role\": \"pub\", \"dedup\": 10}", "dedup must be");
+
+} /* End Test_MQTT_TOPIC_TBL_LoadIntegers() */
+
+
+/******************************************************************************
+** Function: Test_MQTT_TOPIC_TBL_LoadDuplicate
+**
+** IDs, names and message IDs can only be used by one topic.
+**
+*/
+void Test_MQTT_TOPIC_TBL_LoadDuplicate(void)
+{
+
+   ConstructTopicTbl();
+
+   CheckRejected("{\"name\": \"ut/a\", \"id\": 1, \"sb-role\": \"sub\"},"
+                 "{\"name\": \"ut/b\", \"id\": 1, \"sb-mid\": 4096, \"sb-role\": \"sub\"}",
+                 "id 1 is already used by ut/a");
+   CheckRejected("{\"name\": \"ut/a\", \"id\": 1, \"sb-role\": \"sub\"},"
+                 "{\"name\": \"ut/a\", \"id\": 2, \"sb-role\": \"pub\"}",
+                 "name is already used by id 1");
+   CheckRejected("{\"name\": \"ut/a\", \"id\": 1, \"sb-mid\": 4096, \"sb-role\": \"sub\"},"
+                 "{\"name\": \"ut/b\", \"id\": 2, \"sb-mid\": 4096, \"sb-role\": \"pub\"}",
+                 "sb-mid 0x1000 is already used by ut/a");
+
+   UtAssert_True(LoadTopics("{\"name\": \"ut/a\", \"id\": 1, \"sb-mid\": 4096, \"sb-role\": \"sub\"},"
+                            "{\"name\": \"ut/b\", \"id\": 2, \"sb-mid\": 4097, \"sb-role\": \"pub\"}"),
+                 "Unique topics accepted");
+
+} /* End Test_MQTT_TOPIC_TBL_LoadDuplicate() */
+
+
+/******************************************************************************
+** Function: Test_MQTT_TOPIC_TBL_LoadReservedMid
+**
+** Topics can't use the app's own message IDs. The probe message ID is only
+** allowed for the probe codec topic.
+**
+*/
+void Test_MQTT_TOPIC_TBL_LoadReservedMid(void)
+{
+
+   char   Topic[128];
+   uint16 i;
+
+   ConstructTopicTbl();
+
+   for (i=0; i < MQTT_TOPIC_TBL_RESERVED_MID_CNT; i++)
+   {
+      snprintf(Topic, sizeof(Topic), "{\"name\": \"ut/a\", \"id\": 1, \"sb-mid\": %u, \"sb-role\": \"sub\"}",
+               (unsigned int)ReservedMid[i]);
+      CheckRejected(Topic, "is reserved for the app's own messages");
+   }
+
+   snprintf(Topic, sizeof(Topic), "{\"name\": \"ut/a\", \"id\": 1, \"sb-mid\": %d, \"sb-role\": \"sub\"}", UT_BASE_MID);
+   CheckRejected(Topic, "is reserved for the app's own messages");
+
+   snprintf(Topic, sizeof(Topic), "{\"name\": \"ut/a\", \"id\": 1, \"sb-mid\": %d, \"sb-role\": \"pub\"}", UT_PROBE_MID);
+   CheckRejected(Topic, "is reserved for the app's own messages");
+
+   snprintf(Topic, sizeof(Topic), "{\"name\": \"ut/a\", \"id\": 1, \"sb-mid\": %d, \"sb-role\": \"sub\", \"codec\": \"probe\"}",
+            UT_PROBE_MID);
+   CheckRejected(Topic, "probe codec requires");
+   CheckRejected("{\"name\": \"ut/a\", \"id\": 1, \"sb-mid\": 4096, \"sb-role\": \"pub\", \"codec\": \"probe\"}",
+                 "probe codec requires");
+
+   snprintf(Topic, sizeof(Topic), "{\"name\": \"ut/probe\", \"id\": 1, \"sb-mid\": %d, \"sb-role\": \"pub\", \"codec\": \"probe\"}",
+            UT_PROBE_MID);
+   UtAssert_True(LoadTopics(Topic), "Probe topic accepted");
+   UtAssert_UINT32_EQ(TopicEntry(1)->CodecType, MQTT_TOPIC_TBL_CODEC_PROBE);
+   UtAssert_UINT32_EQ(MQTT_TOPIC_TBL_FindMid(UT_PROBE_MID), 1);
+
+} /* End Test_MQTT_TOPIC_TBL_LoadReservedMid() */
+
+
+/******************************************************************************
+** Function: Test_MQTT_TOPIC_TBL_LoadNameTemplate
+**
+** Name templates are rendered when they're loaded and rejected if a key is
+** undefined or the rendered name doesn't fit.
+**
+*/
+void Test_MQTT_TOPIC_TBL_LoadNameTemplate(void)
+{
+
+   char   Topic[256];
+   char   Name[MQTT_TOPIC_TBL_MAX_TOPIC_LEN+1];
+   uint16 i;
+
+   ConstructTopicTbl();
+
+   CheckRejected("{\"name\": \"ut/{foo}\", \"id\": 1, \"sb-role\": \"sub\"}", "undefined {key}");
+   CheckRejected("{\"name\": \"ut/{app\", \"id\": 1, \"sb-role\": \"sub\"}", "undefined {key}");
+   CheckRejected("{\"name\": \"{apid}/{apid}\", \"id\": 1, \"sb-role\": \"sub\"}", "undefined {key}");
+   CheckRejected("{\"name\": \"\", \"id\": 1, \"sb-role\": \"sub\"}", "name is missing");
+   CheckRejected("{\"name\": \"ut/{apid}\", \"id\": 1, \"sb-role\": \"pub\"}", "per-message name keys");
+
+   /* The longest name that fits is accepted, one more character isn't */
+   memset(Name, 'n', sizeof(Name));
+   Name[MQTT_TOPIC_TBL_MAX_TOPIC_LEN-1] = '\0';
+   snprintf(Topic, sizeof(Topic), "{\"name\": \"%s\", \"id\": 1, \"sb-role\": \"sub\"}", Name);
+   UtAssert_True(LoadTopics(Topic), "%d character name accepted", MQTT_TOPIC_TBL_MAX_TOPIC_LEN-1);
+
+   Name[MQTT_TOPIC_TBL_MAX_TOPIC_LEN-1] = 'n';
+   Name[MQTT_TOPIC_TBL_MAX_TOPIC_LEN]   = '\0';
+   snprintf(Topic, sizeof(Topic), "{\"name\": \"%s\", \"id\": 1, \"sb-role\": \"sub\"}", Name);
+   CheckRejected(Topic, "longer than");
+
+   /* A short template can render a name that doesn't fit */
+   Name[0] = '\0';
+   for (i=0; (i*strlen("MQTT_GW")) < MQTT_TOPIC_TBL_MAX_TOPIC_LEN; i++)
+   {
+      strcat(Name, "{app}");
+   }
+   UtAssert_True(strlen(Name) < MQTT_TOPIC_TBL_MAX_TOPIC_LEN, "Template %s fits", Name);
+   snprintf(Topic, sizeof(Topic), "{\"name\": \"%s\", \"id\": 1, \"sb-role\": \"sub\"}", Name);
+   CheckRejected(Topic, "longer than");
+
+   UtAssert_True(LoadTopics("{\"name\": \"{app}/{scid}/{apid}\", \"id\": 1, \"sb-role\": \"sub\"}"),
+                 "Template accepted");
+   UtAssert_STRINGBUF_EQ(TopicName(1), MQTT_TOPIC_TBL_MAX_TOPIC_LEN, "MQTT_GW/42/{apid}", 18);
+   UtAssert_UINT32_EQ(TopicEntry(1)->NameKey, MQTT_TOPIC_TBL_NAME_KEY_APID);
+
+} /* End Test_MQTT_TOPIC_TBL_LoadNameTemplate() */
+
+
+/******************************************************************************
+** Function: Test_MQTT_TOPIC_TBL_LoadMuxTag
+**
+** Tagged topics with the same name and sb-role share one multiplexed topic.
+**
+*/
+void Test_MQTT_TOPIC_TBL_LoadMuxTag(void)
+{
+
+   char Topic[256];
+
+   ConstructTopicTbl();
+
+   snprintf(Topic, sizeof(Topic),
+            "{\"name\": \"ut/mux\", \"id\": 1, \"sb-role\": \"sub\", \"tag\": 0},"
+            "{\"name\": \"ut/mux\", \"id\": 2, \"sb-role\": \"sub\", \"tag\": %d}",
+            (MQTT_TOPIC_TBL_MAX_MUX_TAGS-1));
+   UtAssert_True(LoadTopics(Topic), "Multiplexed topic accepted");
+   UtAssert_UINT32_EQ(MQTT_TOPIC_TBL_GetMuxCnt(), 1);
+   UtAssert_UINT32_EQ(MQTT_TOPIC_TBL_FindTag(1, MQTT_TOPIC_TBL_MAX_MUX_TAGS-1), 2);
+   UtAssert_UINT32_EQ(MQTT_TOPIC_TBL_FindTag(2, 0), 1);
+   UtAssert_UINT32_EQ(MQTT_TOPIC_TBL_FindTag(1, 1), MQTT_TOPIC_TBL_UNUSED_ID);
+   UtAssert_UINT32_EQ(MQTT_TOPIC_TBL_FindName("ut/mux", 6), 1);
+   UtAssert_True(MQTT_TOPIC_TBL_GetName(1) == MQTT_TOPIC_TBL_GetName(2), "Members share the arena name");
+
+   snprintf(Topic, sizeof(Topic), "{\"name\": \"ut/mux\", \"id\": 1, \"sb-role\": \"sub\", \"tag\": %d}",
+            MQTT_TOPIC_TBL_MAX_MUX_TAGS);
+   CheckRejected(Topic, "tag is not an integer");
+   CheckRejected("{\"name\": \"ut/mux\", \"id\": 1, \"sb-role\": \"sub\", \"tag\": 1.5}", "tag is not an integer");
+   CheckRejected("{\"name\": \"ut/mux\", \"id\": 1, \"sb-role\": \"sub\", \"tag\": -1}", "tag is not an integer");
+   CheckRejected("{\"name\": \"ut/mux\", \"id\": 1, \"sb-role\": \"sub\", \"tag\": 4294967296}", "tag is not an integer");
+
+   CheckRejected("{\"name\": \"ut/mux\", \"id\": 1, \"sb-role\": \"sub\", \"tag\": 3},"
+                 "{\"name\": \"ut/mux\", \"id\": 2, \"sb-role\": \"sub\", \"tag\": 3}",
+                 "tag 3 is already used by id 1");
+   CheckRejected("{\"name\": \"ut/mux\", \"id\": 1, \"sb-role\": \"sub\", \"tag\": 3},"
+                 "{\"name\": \"ut/mux\", \"id\": 2, \"sb-role\": \"sub\"}",
+                 "both topics aren't tagged with the same sb-role");
+   CheckRejected("{\"name\": \"ut/mux\", \"id\": 1, \"sb-role\": \"sub\", \"tag\": 3},"
+                 "{\"name\": \"ut/mux\", \"id\": 2, \"sb-role\": \"pub\", \"tag\": 4}",
+                 "both topics aren't tagged with the same sb-role");
+
+} /* End Test_MQTT_TOPIC_TBL_LoadMuxTag() */
+
+
+/******************************************************************************
+** Function: Test_MQTT_TOPIC_TBL_LoadTruncated
+**
+** Files that end before the end of the topic array or don't have a topic
+** array are rejected.
+**
+*/
+void Test_MQTT_TOPIC_TBL_LoadTruncated(void)
+{
+
+   uint32 ReadCnt;
+
+   ConstructTopicTbl();
+
+   CheckRejectedTbl("{\"topic\": [ {\"name\": \"ut/a\", \"id\": 1, \"sb-role\": \"sub\"}",
+                    "ended before the end of the topic array");
+   CheckRejectedTbl("{\"topic\": [ {\"name\": \"ut/a\", \"id\": 1, \"sb-ro",
+                    "ended before the end of the topic array");
+   CheckRejectedTbl("{\"title\": \"no topics\", \"doc\": {\"topic\": []}}",
+                    "ended before the end of the topic array");
+   CheckRejectedTbl("", "ended before the end of the topic array");
+   CheckRejectedTbl("{\"topic\": {}}", "is not an array");
+   CheckRejectedTbl("{\"topic\": [ 1 ]}", "is not an object");
+   CheckRejectedTbl("{\"topic\": [ ]}", "does not define any topics");
+
+   ReadCnt = UT_GetStubCount(UT_KEY(OS_read));
+   UT_SetDefaultReturnValue(UT_KEY(OS_OpenCreate), OS_ERROR);
+   CheckRejectedTbl(ValidTbl, "Error opening table file");
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(OS_read)), ReadCnt);
+
+} /* End Test_MQTT_TOPIC_TBL_LoadTruncated() */
+
+
+/******************************************************************************
+** Function: Test_MQTT_TOPIC_TBL_LoadNested
+**
+** Only a topic object's own keys are loaded and brackets in strings and
+** nested values don't end the object.
+**
+*/
+void Test_MQTT_TOPIC_TBL_LoadNested(void)
+{
+
+   char Topic[MQTT_TOPIC_TBL_OBJ_MAX_CHAR+64];
+   char Pad[MQTT_TOPIC_TBL_OBJ_MAX_CHAR];
+
+   ConstructTopicTbl();
+
+   UtAssert_True(LoadTopics("{\"name\": \"ut/]}\", \"meta\": {\"id\": 7, \"name\": \"ut/b\", \"list\": [\"}\"]},"
+                            " \"sb-role\": \"sub\", \"id\": 1}"),
+                 "Topic with a nested object accepted");
+   UtAssert_UINT32_EQ(MqttTopicTbl.LastLoadCnt, 1);
+   UtAssert_STRINGBUF_EQ(TopicName(1), MQTT_TOPIC_TBL_MAX_TOPIC_LEN, "ut/]}", 6);
+   UtAssert_True(MQTT_TOPIC_TBL_GetEntry(7) == NULL, "Nested id not loaded");
+
+   CheckRejected("{\"name\": \"ut/a\", \"meta\": {\"id\": 7}, \"sb-role\": \"sub\"}", "id is missing");
+
+   memset(Pad, 'x', sizeof(Pad) - 1);
+   Pad[sizeof(Pad) - 1] = '\0';
+   snprintf(Topic, sizeof(Topic), "{\"name\": \"ut/a\", \"id\": 1, \"sb-role\": \"sub\", \"pad\": \"%s\"}", Pad);
+   CheckRejected(Topic, "object exceeds");
+
+} /* End Test_MQTT_TOPIC_TBL_LoadNested() */
+
+
+/******************************************************************************
+** Function: Test_MQTT_TOPIC_TBL_GraceNoReaders
+**
+** Readers that have never been online don't delay a load.
+**
+*/
+void Test_MQTT_TOPIC_TBL_GraceNoReaders(void)
+{
+
+   ConstructTopicTbl();
+
+   UtAssert_UINT32_EQ(MqttTopicTbl.GracePeriod, 1);
+   UtAssert_True(MQTT_TOPIC_TBL_GetData() == &MqttTopicTbl.Buf[0], "Constructor publishes the first snapshot buffer");
+
+   UtAssert_True(LoadTbl(ValidTbl), "Load not delayed");
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(OS_TaskDelay)), 0);
+   UtAssert_True(LoadTbl(ValidTbl), "Load not delayed");
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(OS_TaskDelay)), 0);
+   UtAssert_True(MQTT_TOPIC_TBL_GetData() == &MqttTopicTbl.Buf[0], "Loads alternate snapshot buffers");
+   UtAssert_UINT32_EQ(MqttTopicTbl.GracePeriod, 3);
+
+} /* End Test_MQTT_TOPIC_TBL_GraceNoReaders() */
+
+
+/******************************************************************************
+** Function: Test_MQTT_TOPIC_TBL_GraceCurrentReaders
+**
+** Readers that have been quiescent in the current period or are offline
+** don't delay a load.
+**
+*/
+void Test_MQTT_TOPIC_TBL_GraceCurrentReaders(void)
+{
+
+   ConstructTopicTbl();
+
+   MQTT_TOPIC_TBL_ReaderQuiescent(MQTT_TOPIC_TBL_READER_MQTT_CHILD);
+   MQTT_TOPIC_TBL_ReaderQuiescent(MQTT_TOPIC_TBL_READER_DECODE);
+   PublishSnapshot();
+   MQTT_TOPIC_TBL_ReaderQuiescent(MQTT_TOPIC_TBL_READER_MQTT_CHILD);
+   MQTT_TOPIC_TBL_ReaderOffline(MQTT_TOPIC_TBL_READER_DECODE);
+
+   UtAssert_True(LoadTbl(ValidTbl), "Load not delayed");
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(OS_TaskDelay)), 0);
+
+} /* End Test_MQTT_TOPIC_TBL_GraceCurrentReaders() */
+
+
+/******************************************************************************
+** Function: Test_MQTT_TOPIC_TBL_GraceTimeout
+**
+** A reader that hasn't been quiescent since the last snapshot was
+** published holds off a load until the grace period timeout and the load
+** is rejected without touching the inactive buffer.
+**
+*/
+void Test_MQTT_TOPIC_TBL_GraceTimeout(void)
+{
+
+   uint32 Generation;
+
+   ConstructTopicTbl();
+
+   MQTT_TOPIC_TBL_ReaderQuiescent(MQTT_TOPIC_TBL_READER_LAST_VALUE);
+   PublishSnapshot();
+   Generation = MqttTopicTbl.Buf[0].Generation;
+
+   CheckRejectedTbl(ValidTbl, "did not reach a quiescent point");
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(OS_TaskDelay)), GRACE_POLL_CNT);
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(OS_OpenCreate)), 1);
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(CFE_EVS_SendEvent)), 1);
+   UtAssert_True(MQTT_TOPIC_TBL_GetData() == &MqttTopicTbl.Buf[1], "Active snapshot unchanged");
+   UtAssert_UINT32_EQ(MqttTopicTbl.Buf[0].Generation, Generation);
+
+} /* End Test_MQTT_TOPIC_TBL_GraceTimeout() */
+
+
+/******************************************************************************
+** Function: Test_MQTT_TOPIC_TBL_GraceReaderQuiescent
+**
+** A load waits for a reader from an old period to pass a quiescent state.
+**
+*/
+void Test_MQTT_TOPIC_TBL_GraceReaderQuiescent(void)
+{
+
+   ConstructTopicTbl();
+
+   MQTT_TOPIC_TBL_ReaderQuiescent(MQTT_TOPIC_TBL_READER_LOAD_GEN);
+   MQTT_TOPIC_TBL_ReaderQuiescent(MQTT_TOPIC_TBL_READER_MQTT_CHILD);
+   PublishSnapshot();
+   MQTT_TOPIC_TBL_ReaderQuiescent(MQTT_TOPIC_TBL_READER_MQTT_CHILD);
+
+   DelayReader.Reader  = MQTT_TOPIC_TBL_READER_LOAD_GEN;
+   DelayReader.CallCnt = 3;
+   DelayReader.Offline = false;
+   UT_SetHookFunction(UT_KEY(OS_TaskDelay), DelayReaderHook, NULL);
+
+   UtAssert_True(LoadTbl(ValidTbl), "Load after the reader is quiescent");
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(OS_TaskDelay)), 3);
+
+} /* End Test_MQTT_TOPIC_TBL_GraceReaderQuiescent() */
+
+
+/******************************************************************************
+** Function: Test_MQTT_TOPIC_TBL_GraceReaderOffline
+**
+** A load waits for a reader from an old period to go offline.
+**
+*/
+void Test_MQTT_TOPIC_TBL_GraceReaderOffline(void)
+{
+
+   ConstructTopicTbl();
+
+   MQTT_TOPIC_TBL_ReaderQuiescent(MQTT_TOPIC_TBL_READER_DECODE + DECODE_POOL_MAX_WORKERS - 1);
+   PublishSnapshot();
+
+   DelayReader.Reader  = MQTT_TOPIC_TBL_READER_DECODE + DECODE_POOL_MAX_WORKERS - 1;
+   DelayReader.CallCnt = 1;
+   DelayReader.Offline = true;
+   UT_SetHookFunction(UT_KEY(OS_TaskDelay), DelayReaderHook, NULL);
+
+   UtAssert_True(LoadTbl(ValidTbl), "Load after the reader goes offline");
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(OS_TaskDelay)), 1);
+
+} /* End Test_MQTT_TOPIC_TBL_GraceReaderOffline() */
+
+
+/******************************************************************************
+** Function: UtTest_Setup
+**
+*/
+void UtTest_Setup(void)
+{
+
+   ADD_TEST(MQTT_TOPIC_TBL_LoadValid);
+   ADD_TEST(MQTT_TOPIC_TBL_LoadStream);
+   ADD_TEST(MQTT_TOPIC_TBL_LoadIntegers);
+   ADD_TEST(MQTT_TOPIC_TBL_LoadDuplicate);
+   ADD_TEST(MQTT_TOPIC_TBL_LoadReservedMid);
+   ADD_TEST(MQTT_TOPIC_TBL_LoadNameTemplate);
+   ADD_TEST(MQTT_TOPIC_TBL_LoadMuxTag);
+   ADD_TEST(MQTT_TOPIC_TBL_LoadTruncated);
+   ADD_TEST(MQTT_TOPIC_TBL_LoadNested);
+   ADD_TEST(MQTT_TOPIC_TBL_GraceNoReaders);
+   ADD_TEST(MQTT_TOPIC_TBL_GraceCurrentReaders);
+   ADD_TEST(MQTT_TOPIC_TBL_GraceTimeout);
+   ADD_TEST(MQTT_TOPIC_TBL_GraceReaderQuiescent);
+   ADD_TEST(MQTT_TOPIC_TBL_GraceReaderOffline);
+
+} /* End UtTest_Setup() */
@@ -0,0 +1,303 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Unit test SHM_RING's writer with the public shared memory reader
+**
+** Notes:
+**   1. The ring is a real POSIX shared memory object so the tests only
+**      run on Linux. The object is removed after each test.
+**   2. A writer that is still writing a slot is simulated by clearing the
+**      slot's sequence number as SHM_RING_Write() does before it writes.
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+
+/*
+** Includes
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+#include "mqtt_gw_coveragetest_common.h"
+#include "shm_ring.h"
+#include "mqtt_gw_shm_reader.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define UT_SHM_NAME  "/mqtt_gw_ut"
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static SHM_RING_Class_t  ShmRing;
+static INITBL_Class_t    IniTbl;
+
+static MQTT_GW_SHM_Reader_t  Reader;
+static MQTT_GW_SHM_Msg_t     Msg;
+static uint64_t              ReadBuf[SHM_RING_SLOT_LEN/sizeof(uint64_t)];
+
+
+/******************************************************************************
+** Function: ConstructShmRing
+**
+** Create the ring and open it with the reader.
+**
+*/
+static void ConstructShmRing(void)
+{
+
+   memset(&ShmRing, 0, sizeof(ShmRing));
+
+   UT_MqttGw.StrConfig[CFG_SHM_RING_NAME] = UT_SHM_NAME;
+   SHM_RING_Constructor(&ShmRing, &IniTbl);
+
+   UtAssert_True(ShmRing.Hdr != NULL, "Shared memory ring %s created", UT_SHM_NAME);
+   UtAssert_INT32_EQ(MQTT_GW_SHM_Open(&Reader, UT_SHM_NAME), 0);
+
+} /* End ConstructShmRing() */
+
+
+/******************************************************************************
+** Function: WriteMsgs
+**
+** Write MsgCnt messages whose payloads are their write number.
+**
+*/
+static void WriteMsgs(uint32 MsgCnt)
+{
+
+   char   Payload[16];
+   uint32 i;
+
+   for (i=0; i < MsgCnt; i++)
+   {
+      snprintf(Payload, sizeof(Payload), "%u", (unsigned int)(ShmRing.WriteCnt + 1));
+      SHM_RING_Write(7, "ut/shm", Payload, strlen(Payload));
+   }
+
+} /* End WriteMsgs() */
+
+
+/******************************************************************************
+** Function: ShmRingTearDown
+**
+*/
+static void ShmRingTearDown(void)
+{
+
+   MQTT_GW_SHM_Close(&Reader);
+   if (ShmRing.Hdr != NULL)
+   {
+      munmap(ShmRing.Hdr, ShmRing.MapLen);
+   }
+   shm_unlink(UT_SHM_NAME);
+
+   UT_MqttGw_TearDown();
+
+} /* End ShmRingTearDown() */
+
+
+/******************************************************************************
+** Function: Test_SHM_RING_Disabled
+**
+*/
+void Test_SHM_RING_Disabled(void)
+{
+
+   memset(&ShmRing, 0, sizeof(ShmRing));
+   SHM_RING_Constructor(&ShmRing, &IniTbl);
+
+   UtAssert_True(ShmRing.Hdr == NULL, "Ring disabled");
+   SHM_RING_Write(1, "ut/shm", "{}", 2);
+   UtAssert_UINT32_EQ(ShmRing.WriteCnt, 0);
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(OS_MutSemTake)), 0);
+
+} /* End Test_SHM_RING_Disabled() */
+
+
+/******************************************************************************
+** Function: Test_SHM_RING_WriteRead
+**
+** A reader reads each message once in the order it was written.
+**
+*/
+void Test_SHM_RING_WriteRead(void)
+{
+
+   ConstructShmRing();
+
+   UtAssert_INT32_EQ(MQTT_GW_SHM_Read(&Reader, ReadBuf, sizeof(ReadBuf), &Msg), 0);
+
+   WriteMsgs(2);
+   UtAssert_UINT32_EQ(ShmRing.Hdr->WriteSeq, 2);
+   UtAssert_UINT32_EQ(UT_GetStubCount(UT_KEY(OS_MutSemGive)), 2);
+
+   UtAssert_INT32_EQ(MQTT_GW_SHM_Read(&Reader, ReadBuf, sizeof(ReadBuf), &Msg), 1);
+   UtAssert_UINT32_EQ(Msg.Seq, 1);
+   UtAssert_UINT32_EQ(Msg.TopicId, 7);
+   UtAssert_STRINGBUF_EQ(Msg.Topic, Msg.TopicLen + 1, "ut/shm", 6);
+   UtAssert_STRINGBUF_EQ(Msg.Payload, Msg.PayloadLen + 1, "1", 1);
+
+   UtAssert_INT32_EQ(MQTT_GW_SHM_Read(&Reader, ReadBuf, sizeof(ReadBuf), &Msg), 1);
+   UtAssert_UINT32_EQ(Msg.Seq, 2);
+   UtAssert_STRINGBUF_EQ(Msg.Payload, Msg.PayloadLen + 1, "2", 1);
+
+   UtAssert_INT32_EQ(MQTT_GW_SHM_Read(&Reader, ReadBuf, sizeof(ReadBuf), &Msg), 0);
+   UtAssert_UINT32_EQ(Reader.LostCnt, 0);
+
+   /* A buffer shorter than a slot isn't used */
+   WriteMsgs(1);
+   UtAssert_INT32_EQ(MQTT_GW_SHM_Read(&Reader, ReadBuf, SHM_RING_SLOT_LEN - 1, &Msg), 0);
+   UtAssert_INT32_EQ(MQTT_GW_SHM_Read(&Reader, ReadBuf, sizeof(ReadBuf), &Msg), 1);
+   UtAssert_UINT32_EQ(Msg.Seq, 3);
+
+} /* End Test_SHM_RING_WriteRead() */
+
+
+/******************************************************************************
+** Function: Test_SHM_RING_SlotBeingWritten
+**
+** A slot the writer is overwriting is skipped and counted as lost.
+**
+*/
+void Test_SHM_RING_SlotBeingWritten(void)
+{
+
+   ConstructShmRing();
+
+   WriteMsgs(SHM_RING_SLOT_CNT);
+
+   /* The writer has started to overwrite message 1 with message SLOT_CNT+1 */
+   MQTT_GW_SHM_SLOT(ShmRing.Hdr, 1)->Seq = 0;
+
+   UtAssert_INT32_EQ(MQTT_GW_SHM_Read(&Reader, ReadBuf, sizeof(ReadBuf), &Msg), 1);
+   UtAssert_UINT32_EQ(Msg.Seq, 2);
+   UtAssert_STRINGBUF_EQ(Msg.Payload, Msg.PayloadLen + 1, "2", 1);
+   UtAssert_UINT32_EQ(Reader.LostCnt, 1);
+
+} /* End Test_SHM_RING_SlotBeingWritten() */
+
+
+/******************************************************************************
+** Function: Test_SHM_RING_Overrun
+**
+** A reader that falls more than a ring behind skips to the oldest message.
+**
+*/
+void Test_SHM_RING_Overrun(void)
+{
+
+   char Payload[16];
+
+   ConstructShmRing();
+
+   WriteMsgs(SHM_RING_SLOT_CNT + 3);
+
+   UtAssert_INT32_EQ(MQTT_GW_SHM_Read(&Reader, ReadBuf, sizeof(ReadBuf), &Msg), 1);
+   UtAssert_UINT32_EQ(Msg.Seq, 4);
+   UtAssert_STRINGBUF_EQ(Msg.Payload, Msg.PayloadLen + 1, "4", 1);
+   UtAssert_UINT32_EQ(Reader.LostCnt, 3);
+
+   while (MQTT_GW_SHM_Read(&Reader, ReadBuf, sizeof(ReadBuf), &Msg))
+   {
+   }
+   snprintf(Payload, sizeof(Payload), "%u", SHM_RING_SLOT_CNT + 3);
+   UtAssert_STRINGBUF_EQ(Msg.Payload, Msg.PayloadLen + 1, Payload, sizeof(Payload));
+   UtAssert_UINT32_EQ(Reader.LostCnt, 3);
+
+} /* End Test_SHM_RING_Overrun() */
+
+
+/******************************************************************************
+** Function: Test_SHM_RING_OversizeMsg
+**
+*/
+void Test_SHM_RING_OversizeMsg(void)
+{
+
+   static char LongPayload[SHM_RING_SLOT_LEN];
+
+   ConstructShmRing();
+
+   memset(LongPayload, 'x', sizeof(LongPayload) - 1);
+   SHM_RING_Write(7, "ut/shm", LongPayload, strlen(LongPayload));
+
+   UtAssert_UINT32_EQ(ShmRing.SkipCnt, 1);
+   UtAssert_UINT32_EQ(ShmRing.Hdr->WriteSeq, 0);
+   UtAssert_INT32_EQ(MQTT_GW_SHM_Read(&Reader, ReadBuf, sizeof(ReadBuf), &Msg), 0);
+
+   SHM_RING_ResetStatus();
+   UtAssert_UINT32_EQ(ShmRing.SkipCnt, 0);
+
+} /* End Test_SHM_RING_OversizeMsg() */
+
+
+/******************************************************************************
+** Function: Test_SHM_RING_WriterRestart
+**
+** A reader continues with the new ring's messages after a writer restart.
+**
+*/
+void Test_SHM_RING_WriterRestart(void)
+{
+
+   uint32 Epoch;
+
+   ConstructShmRing();
+   Epoch = ShmRing.Hdr->Epoch;
+
+   WriteMsgs(5);
+   munmap(ShmRing.Hdr, ShmRing.MapLen);
+
+   memset(&ShmRing, 0, sizeof(ShmRing));
+   SHM_RING_Constructor(&ShmRing, &IniTbl);
+   UtAssert_UINT32_EQ(ShmRing.Hdr->Epoch, Epoch + 1);
+   UtAssert_UINT32_EQ(ShmRing.Hdr->WriteSeq, 0);
+
+   UtAssert_INT32_EQ(MQTT_GW_SHM_Read(&Reader, ReadBuf, sizeof(ReadBuf), &Msg), 0);
+
+   WriteMsgs(1);
+   UtAssert_INT32_EQ(MQTT_GW_SHM_Read(&Reader, ReadBuf, sizeof(ReadBuf), &Msg), 1);
+   UtAssert_UINT32_EQ(Msg.Seq, 1);
+   UtAssert_UINT32_EQ(Reader.LostCnt, 0);
+
+} /* End Test_SHM_RING_WriterRestart() */
+
+
+/******************************************************************************
+** Function: UtTest_Setup
+**
+*/
+void UtTest_Setup(void)
+{
+
+   UtTest_Add(Test_SHM_RING_Disabled, UT_MqttGw_Setup, ShmRingTearDown, "SHM_RING_Disabled");
+   UtTest_Add(Test_SHM_RING_WriteRead, UT_MqttGw_Setup, ShmRingTearDown, "SHM_RING_WriteRead");
+   UtTest_Add(Test_SHM_RING_SlotBeingWritten, UT_MqttGw_Setup, ShmRingTearDown, "SHM_RING_SlotBeingWritten");
+   UtTest_Add(Test_SHM_RING_Overrun, UT_MqttGw_Setup, ShmRingTearDown, "SHM_RING_Overrun");
+   UtTest_Add(Test_SHM_RING_OversizeMsg, UT_MqttGw_Setup, ShmRingTearDown, "SHM_RING_OversizeMsg");
+   UtTest_Add(Test_SHM_RING_WriterRestart, UT_MqttGw_Setup, ShmRingTearDown, "SHM_RING_WriterRestart");
+
+} /* End UtTest_Setup() */
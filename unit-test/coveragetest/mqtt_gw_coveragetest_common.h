@@ -0,0 +1,51 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Define common definitions for the MQTT_GW coverage tests
+**
+** Notes:
+**   1. Each coverage test links one app object with the stubs of the
+**      objects it uses. See ut_mqtt_gw_stubs.h.
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+#ifndef _mqtt_gw_coveragetest_common_
+#define _mqtt_gw_coveragetest_common_
+
+/*
+** Includes
+*/
+
+#include <string.h>
+
+#include "utassert.h"
+#include "uttest.h"
+#include "utstubs.h"
+
+#include "app_cfg.h"
+#include "ut_mqtt_gw_stubs.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define ADD_TEST(test) UtTest_Add((Test_##test), UT_MqttGw_Setup, UT_MqttGw_TearDown, #test)
+
+
+#endif /* _mqtt_gw_coveragetest_common_ */
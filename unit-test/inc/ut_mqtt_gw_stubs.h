@@ -0,0 +1,134 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Define the state shared by the MQTT_GW unit test stubs and test cases
+**
+** Notes:
+**   1. Every stub counts its calls with UT_DEFAULT_IMPL so test cases can
+**      use UT_GetStubCount() and UT_SetDefaultReturnValue(). Values the
+**      UT framework can't return, such as pointers and strings, are taken
+**      from UT_MqttGw.
+**   2. UT_MqttGw is cleared before each test case by UT_MqttGw_Setup().
+**
+** References:
+**   1. OpenSatKit Object-based Application Developer's Guide
+**   2. cFS Application Developer's Guide
+**
+*/
+#ifndef _ut_mqtt_gw_stubs_
+#define _ut_mqtt_gw_stubs_
+
+/*
+** Includes
+*/
+
+#include "utassert.h"
+#include "utstubs.h"
+#include "uttest.h"
+
+#include "mqtt_topic_tbl.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define UT_MQTT_GW_DECODE_CNT  (2*DECODE_POOL_QUEUE_LEN)   /* Decodes recorded per test */
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+/*
+** MSG_TRANS_DecodeMqttMsg() call
+*/
+typedef struct
+{
+
+   uint16  TopicId;
+   uint16  PayloadLen;
+   uint32  Generation;
+   char    Payload[DECODE_POOL_PAYLOAD_LEN+1];
+
+} UT_MqttGw_Decode_t;
+
+
+typedef struct
+{
+
+   /*
+   ** INITBL_GetIntConfig() and INITBL_GetStrConfig() values. A NULL
+   ** string returns "UNDEF".
+   */
+
+   uint32      IntConfig[Config_ENUM_LAST];
+   const char *StrConfig[Config_ENUM_LAST];
+
+   /*
+   ** JSON_SearchConst() searches the top level keys of a JSON object when
+   ** JsonSearch is true
+   */
+
+   bool  JsonSearch;
+
+   /*
+   ** MQTT_TOPIC_TBL: GetData() returns TopicTblData, GetTopicCnt() returns
+   ** TopicCnt and GetEntry() returns TopicEntry for IDs less than TopicCnt.
+   */
+
+   const MQTT_TOPIC_TBL_Data_t  *TopicTblData;
+   const MQTT_TOPIC_TBL_Entry_t *TopicEntry;
+   uint16  TopicCnt;
+
+   /*
+   ** MSG_TRANS_DecodeMqttMsg() calls in call order
+   */
+
+   uint16  DecodeCnt;
+   UT_MqttGw_Decode_t  Decode[UT_MQTT_GW_DECODE_CNT];
+
+} UT_MqttGw_Stubs_t;
+
+
+/************************/
+/** Exported Data      **/
+/************************/
+
+extern UT_MqttGw_Stubs_t UT_MqttGw;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: UT_MqttGw_Setup
+**
+** Reset the UT framework and the stub state before a test case.
+**
+*/
+void UT_MqttGw_Setup(void);
+
+
+/******************************************************************************
+** Function: UT_MqttGw_TearDown
+**
+*/
+void UT_MqttGw_TearDown(void);
+
+
+#endif /* _ut_mqtt_gw_stubs_ */
@@ -0,0 +1,41 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Unit test stubs for LOCAL_BROKER
+**
+** Notes:
+**   1. See ut_mqtt_gw_stubs.h
+**
+*/
+
+/*
+** Includes
+*/
+
+#include "local_broker.h"
+#include "ut_mqtt_gw_stubs.h"
+
+
+/******************************************************************************
+** Function: LOCAL_BROKER_Publish
+**
+*/
+void LOCAL_BROKER_Publish(uint16 TopicId, const char *Topic, const char *Payload,
+                          uint32 PayloadLen)
+{
+
+   UT_DEFAULT_IMPL(LOCAL_BROKER_Publish);
+
+} /* End LOCAL_BROKER_Publish() */
@@ -0,0 +1,52 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Unit test stubs for MQTT_CLIENT
+**
+** Notes:
+**   1. See ut_mqtt_gw_stubs.h
+**
+*/
+
+/*
+** Includes
+*/
+
+#include "mqtt_client.h"
+#include "ut_mqtt_gw_stubs.h"
+
+
+/******************************************************************************
+** Function: MQTT_CLIENT_IsConnected
+**
+*/
+bool MQTT_CLIENT_IsConnected(void)
+{
+
+   return (UT_DEFAULT_IMPL_RC(MQTT_CLIENT_IsConnected, true) != 0);
+
+} /* End MQTT_CLIENT_IsConnected() */
+
+
+/******************************************************************************
+** Function: MQTT_CLIENT_Publish
+**
+*/
+bool MQTT_CLIENT_Publish(const char *Topic, const char *Payload, bool Retain)
+{
+
+   return (UT_DEFAULT_IMPL_RC(MQTT_CLIENT_Publish, true) != 0);
+
+} /* End MQTT_CLIENT_Publish() */
@@ -0,0 +1,82 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Unit test stubs for MQTT_TOPIC_RATE
+**
+** Notes:
+**   1. See ut_mqtt_gw_stubs.h
+**
+*/
+
+/*
+** Includes
+*/
+
+#include "mqtt_topic_rate.h"
+#include "ut_mqtt_gw_stubs.h"
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_RATE_Constructor
+**
+*/
+void MQTT_TOPIC_RATE_Constructor(MQTT_TOPIC_RATE_Class_t *MqttTopicRate,
+                                 CFE_SB_MsgId_t TlmMsgMid)
+{
+
+   UT_DEFAULT_IMPL(MQTT_TOPIC_RATE_Constructor);
+
+} /* End MQTT_TOPIC_RATE_Constructor() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_RATE_CfeToJson
+**
+*/
+bool MQTT_TOPIC_RATE_CfeToJson(void *Codec, const char **JsonMsgPayload,
+                               const CFE_MSG_Message_t *CfeMsg)
+{
+
+   return (UT_DEFAULT_IMPL(MQTT_TOPIC_RATE_CfeToJson) != 0);
+
+} /* End MQTT_TOPIC_RATE_CfeToJson() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_RATE_JsonToCfe
+**
+*/
+bool MQTT_TOPIC_RATE_JsonToCfe(void *Codec, CFE_MSG_Message_t **CfeMsg,
+                               const char *JsonMsgPayload, uint16 PayloadLen)
+{
+
+   *CfeMsg = NULL;
+
+   return (UT_DEFAULT_IMPL(MQTT_TOPIC_RATE_JsonToCfe) != 0);
+
+} /* End MQTT_TOPIC_RATE_JsonToCfe() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_RATE_SbMsgFill
+**
+*/
+void MQTT_TOPIC_RATE_SbMsgFill(void *Codec, CFE_MSG_Message_t *SbMsg, CFE_MSG_Size_t MsgSize,
+                               uint32 Seq, int16 Param)
+{
+
+   UT_DEFAULT_IMPL(MQTT_TOPIC_RATE_SbMsgFill);
+
+} /* End MQTT_TOPIC_RATE_SbMsgFill() */
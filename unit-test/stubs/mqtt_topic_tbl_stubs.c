@@ -0,0 +1,106 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Unit test stubs for MQTT_TOPIC_TBL
+**
+** Notes:
+**   1. See ut_mqtt_gw_stubs.h
+**
+*/
+
+/*
+** Includes
+*/
+
+#include "mqtt_topic_tbl.h"
+#include "ut_mqtt_gw_stubs.h"
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_FindName
+**
+*/
+uint16 MQTT_TOPIC_TBL_FindName(const char *Name, uint16 NameLen)
+{
+
+   return (uint16)UT_DEFAULT_IMPL_RC(MQTT_TOPIC_TBL_FindName, MQTT_TOPIC_TBL_UNUSED_ID);
+
+} /* End MQTT_TOPIC_TBL_FindName() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_GetData
+**
+*/
+const MQTT_TOPIC_TBL_Data_t *MQTT_TOPIC_TBL_GetData(void)
+{
+
+   UT_DEFAULT_IMPL(MQTT_TOPIC_TBL_GetData);
+
+   return UT_MqttGw.TopicTblData;
+
+} /* End MQTT_TOPIC_TBL_GetData() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_GetEntry
+**
+*/
+const MQTT_TOPIC_TBL_Entry_t *MQTT_TOPIC_TBL_GetEntry(uint16 Idx)
+{
+
+   UT_DEFAULT_IMPL(MQTT_TOPIC_TBL_GetEntry);
+
+   return (Idx < UT_MqttGw.TopicCnt) ? UT_MqttGw.TopicEntry : NULL;
+
+} /* End MQTT_TOPIC_TBL_GetEntry() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_GetTopicCnt
+**
+*/
+uint16 MQTT_TOPIC_TBL_GetTopicCnt(void)
+{
+
+   UT_DEFAULT_IMPL(MQTT_TOPIC_TBL_GetTopicCnt);
+
+   return UT_MqttGw.TopicCnt;
+
+} /* End MQTT_TOPIC_TBL_GetTopicCnt() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_ReaderOffline
+**
+*/
+void MQTT_TOPIC_TBL_ReaderOffline(MQTT_TOPIC_TBL_Reader_t Reader)
+{
+
+   UT_DEFAULT_IMPL(MQTT_TOPIC_TBL_ReaderOffline);
+
+} /* End MQTT_TOPIC_TBL_ReaderOffline() */
+
+
+/******************************************************************************
+** Function: MQTT_TOPIC_TBL_ReaderQuiescent
+**
+*/
+void MQTT_TOPIC_TBL_ReaderQuiescent(MQTT_TOPIC_TBL_Reader_t Reader)
+{
+
+   UT_DEFAULT_IMPL(MQTT_TOPIC_TBL_ReaderQuiescent);
+
+} /* End MQTT_TOPIC_TBL_ReaderQuiescent() */
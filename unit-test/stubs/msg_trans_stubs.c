@@ -0,0 +1,94 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Unit test stubs for MSG_TRANS
+**
+** Notes:
+**   1. See ut_mqtt_gw_stubs.h
+**
+*/
+
+/*
+** Includes
+*/
+
+#include <string.h>
+
+#include "msg_trans.h"
+#include "ut_mqtt_gw_stubs.h"
+
+
+/******************************************************************************
+** Function: MSG_TRANS_DecodeMqttMsg
+**
+** Notes:
+**   1. The call is recorded in UT_MqttGw.Decode
+**
+*/
+bool MSG_TRANS_DecodeMqttMsg(uint16 TopicId, uint32 Generation, const char *Payload,
+                             uint16 PayloadLen, uint32 RcvTime)
+{
+
+   UT_MqttGw_Decode_t *Decode;
+
+   if (UT_MqttGw.DecodeCnt < UT_MQTT_GW_DECODE_CNT && PayloadLen <= DECODE_POOL_PAYLOAD_LEN)
+   {
+      Decode = &UT_MqttGw.Decode[UT_MqttGw.DecodeCnt++];
+      Decode->TopicId    = TopicId;
+      Decode->Generation = Generation;
+      Decode->PayloadLen = PayloadLen;
+      memcpy(Decode->Payload, Payload, PayloadLen);
+      Decode->Payload[PayloadLen] = '\0';
+   }
+
+   return (UT_DEFAULT_IMPL_RC(MSG_TRANS_DecodeMqttMsg, true) != 0);
+
+} /* End MSG_TRANS_DecodeMqttMsg() */
+
+
+/******************************************************************************
+** Function: MSG_TRANS_DemuxMqttMsg
+**
+*/
+uint16 MSG_TRANS_DemuxMqttMsg(uint16 TopicId, const char *Payload, uint16 PayloadLen)
+{
+
+   return (uint16)UT_DEFAULT_IMPL_RC(MSG_TRANS_DemuxMqttMsg, TopicId);
+
+} /* End MSG_TRANS_DemuxMqttMsg() */
+
+
+/******************************************************************************
+** Function: MSG_TRANS_FindMqttTopic
+**
+*/
+uint16 MSG_TRANS_FindMqttTopic(const MessageData* MsgData)
+{
+
+   return (uint16)UT_DEFAULT_IMPL_RC(MSG_TRANS_FindMqttTopic, MQTT_TOPIC_TBL_UNUSED_ID);
+
+} /* End MSG_TRANS_FindMqttTopic() */
+
+
+/******************************************************************************
+** Function: MSG_TRANS_ProcessMqttMsg
+**
+*/
+void MSG_TRANS_ProcessMqttMsg(MessageData* MsgData)
+{
+
+   UT_DEFAULT_IMPL(MSG_TRANS_ProcessMqttMsg);
+
+} /* End MSG_TRANS_ProcessMqttMsg() */
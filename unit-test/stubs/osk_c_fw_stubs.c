@@ -0,0 +1,358 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Unit test stubs for the OSK C framework and its coreJSON library
+**
+** Notes:
+**   1. See ut_mqtt_gw_stubs.h
+**   2. JSON_SearchConst() can search a flat JSON object so app objects
+**      that parse JSON can be tested with real JSON text. It is not a
+**      full coreJSON and only handles the top level keys of one object.
+**
+*/
+
+/*
+** Includes
+*/
+
+#include <string.h>
+
+#include "app_cfg.h"
+#include "ut_mqtt_gw_stubs.h"
+
+
+/************************************/
+/** Local File Function Prototypes **/
+/************************************/
+
+static JSONStatus_t SearchObj(const char *Buf, size_t BufLen, const char *Key, size_t KeyLen,
+                              const char **Value, size_t *ValueLen, JSONTypes_t *ValueType);
+static size_t SkipSpace(const char *Buf, size_t BufLen, size_t i);
+static size_t SkipString(const char *Buf, size_t BufLen, size_t i);
+static size_t SkipValue(const char *Buf, size_t BufLen, size_t i, JSONTypes_t *ValueType);
+
+
+/******************************************************************************
+** Function: ChildMgr_TaskMainCallback
+**
+*/
+void ChildMgr_TaskMainCallback(void)
+{
+
+   UT_DEFAULT_IMPL(ChildMgr_TaskMainCallback);
+
+} /* End ChildMgr_TaskMainCallback() */
+
+
+/******************************************************************************
+** Function: CHILDMGR_Constructor
+**
+** Notes:
+**   1. The child task is not created
+**
+*/
+int32 CHILDMGR_Constructor(CHILDMGR_Class_t *ChildMgr, void (*ChildTaskMainFunc)(void),
+                           CHILDMGR_TaskCallback_t AppMainFunc, CHILDMGR_TaskInit_t *TaskInit)
+{
+
+   return UT_DEFAULT_IMPL(CHILDMGR_Constructor);
+
+} /* End CHILDMGR_Constructor() */
+
+
+/******************************************************************************
+** Function: INITBL_GetIntConfig
+**
+*/
+uint32 INITBL_GetIntConfig(const INITBL_Class_t *IniTbl, uint16 Param)
+{
+
+   UT_DEFAULT_IMPL(INITBL_GetIntConfig);
+
+   return (Param < Config_ENUM_LAST) ? UT_MqttGw.IntConfig[Param] : 0;
+
+} /* End INITBL_GetIntConfig() */
+
+
+/******************************************************************************
+** Function: INITBL_GetStrConfig
+**
+*/
+const char *INITBL_GetStrConfig(const INITBL_Class_t *IniTbl, uint16 Param)
+{
+
+   const char *StrConfig = "UNDEF";
+
+   UT_DEFAULT_IMPL(INITBL_GetStrConfig);
+
+   if (Param < Config_ENUM_LAST && UT_MqttGw.StrConfig[Param] != NULL)
+   {
+      StrConfig = UT_MqttGw.StrConfig[Param];
+   }
+
+   return StrConfig;
+
+} /* End INITBL_GetStrConfig() */
+
+
+/******************************************************************************
+** Function: JSON_SearchConst
+**
+** Notes:
+**   1. The query is searched for in the object's top level keys when
+**      UT_MqttGw.JsonSearch is set, otherwise the stub return code is
+**      returned.
+**
+*/
+JSONStatus_t JSON_SearchConst(const char *buf, size_t max, const char *query, size_t queryLength,
+                              const char **outValue, size_t *outValueLength, JSONTypes_t *outType)
+{
+
+   JSONStatus_t Status = (JSONStatus_t)UT_DEFAULT_IMPL_RC(JSON_SearchConst, JSONNotFound);
+
+   if (UT_MqttGw.JsonSearch)
+   {
+      Status = SearchObj(buf, max, query, queryLength, outValue, outValueLength, outType);
+   }
+
+   return Status;
+
+} /* End JSON_SearchConst() */
+
+
+/******************************************************************************
+** Function: SearchObj
+**
+** Search an object's top level keys for 'Key' and return its value like
+** coreJSON does: strings without their quotes and other types as they are
+** written.
+**
+*/
+static JSONStatus_t SearchObj(const char *Buf, size_t BufLen, const char *Key, size_t KeyLen,
+                              const char **Value, size_t *ValueLen, JSONTypes_t *ValueType)
+{
+
+   JSONStatus_t Status = JSONIllegalDocument;
+   bool         Member  = true;
+   size_t       i;
+   size_t       KeyStart;
+   size_t       MemberKeyLen;
+   size_t       ValueStart;
+   JSONTypes_t  MemberType;
+
+   i = SkipSpace(Buf, BufLen, 0);
+
+   if (i < BufLen && Buf[i] == '{')
+   {
+
+      Status = JSONNotFound;
+      i = SkipSpace(Buf, BufLen, i + 1);
+      if (i < BufLen && Buf[i] == '}')
+      {
+         Member = false;
+      }
+
+      while (Member && Status == JSONNotFound)
+      {
+
+         Member = false;
+         KeyStart = i + 1;
+         i = SkipString(Buf, BufLen, i);
+         if (i > 0)
+         {
+            MemberKeyLen = i - KeyStart - 1;
+            i = SkipSpace(Buf, BufLen, i);
+            if (i < BufLen && Buf[i] == ':')
+            {
+               ValueStart = SkipSpace(Buf, BufLen, i + 1);
+               i = SkipValue(Buf, BufLen, ValueStart, &MemberType);
+               if (MemberType == JSONInvalid)
+               {
+                  Status = JSONIllegalDocument;
+               }
+               else if (MemberKeyLen == KeyLen && strncmp(&Buf[KeyStart], Key, KeyLen) == 0)
+               {
+                  *ValueType = MemberType;
+                  *Value     = &Buf[ValueStart];
+                  *ValueLen  = i - ValueStart;
+                  if (MemberType == JSONString)
+                  {
+                     *Value    += 1;
+                     *ValueLen -= 2;
+                  }
+                  Status = JSONValid;
+               }
+               else
+               {
+                  i = SkipSpace(Buf, BufLen, i);
+                  if (i < BufLen && Buf[i] == ',')
+                  {
+                     i = SkipSpace(Buf, BufLen, i + 1);
+                     Member = true;
+                  }
+               }
+            }
+         } /* End if key */
+
+      } /* End member loop */
+   } /* End if object */
+
+   return Status;
+
+} /* End SearchObj() */
+
+
+/******************************************************************************
+** Function: SkipSpace
+**
+** Return the index of the first non-whitespace character at or after 'i'.
+**
+*/
+static size_t SkipSpace(const char *Buf, size_t BufLen, size_t i)
+{
+
+   while (i < BufLen && (Buf[i] == ' ' || Buf[i] == '\t' || Buf[i] == '\n' || Buf[i] == '\r'))
+   {
+      i++;
+   }
+
+   return i;
+
+} /* End SkipSpace() */
+
+
+/******************************************************************************
+** Function: SkipString
+**
+** Return the index after the closing quote of the string that starts at 'i'
+** or 0 if there isn't a terminated string at 'i'.
+**
+*/
+static size_t SkipString(const char *Buf, size_t BufLen, size_t i)
+{
+
+   size_t End    = 0;
+   bool   Escape = false;
+
+   if (i < BufLen && Buf[i] == '"')
+   {
+      for (i++; End == 0 && i < BufLen; i++)
+      {
+         if (Escape)
+         {
+            Escape = false;
+         }
+         else if (Buf[i] == '\\')
+         {
+            Escape = true;
+         }
+         else if (Buf[i] == '"')
+         {
+            End = i + 1;
+         }
+      }
+   }
+
+   return End;
+
+} /* End SkipString() */
+
+
+/******************************************************************************
+** Function: SkipValue
+**
+** Return the index after the value that starts at 'i' and its type.
+** Objects and arrays are skipped as a whole.
+**
+*/
+static size_t SkipValue(const char *Buf, size_t BufLen, size_t i, JSONTypes_t *ValueType)
+{
+
+   size_t Start  = i;
+   size_t NumChars = 0;
+   uint16 Depth  = 0;
+
+   *ValueType = JSONInvalid;
+
+   if (i < BufLen && Buf[i] == '"')
+   {
+      i = SkipString(Buf, BufLen, i);
+      if (i > 0)
+      {
+         *ValueType = JSONString;
+      }
+   }
+   else if (i < BufLen && (Buf[i] == '{' || Buf[i] == '['))
+   {
+      *ValueType = (Buf[i] == '{') ? JSONObject : JSONArray;
+      do
+      {
+         if (Buf[i] == '"')
+         {
+            i = SkipString(Buf, BufLen, i);
+         }
+         else
+         {
+            if (Buf[i] == '{' || Buf[i] == '[')
+            {
+               Depth++;
+            }
+            else if (Buf[i] == '}' || Buf[i] == ']')
+            {
+               Depth--;
+            }
+            i++;
+         }
+      } while (i > 0 && i < BufLen && Depth > 0);
+      if (i == 0 || Depth > 0)
+      {
+         *ValueType = JSONInvalid;
+      }
+   }
+   else
+   {
+      while (i < BufLen && strchr(",}] \t\n\r", Buf[i]) == NULL)
+      {
+         if (strchr("-+.eE0123456789", Buf[i]) != NULL)
+         {
+            NumChars++;
+         }
+         i++;
+      }
+      if (i == Start)
+      {
+         *ValueType = JSONInvalid;
+      }
+      else if ((i - Start) == 4 && strncmp(&Buf[Start], "true", 4) == 0)
+      {
+         *ValueType = JSONTrue;
+      }
+      else if ((i - Start) == 5 && strncmp(&Buf[Start], "false", 5) == 0)
+      {
+         *ValueType = JSONFalse;
+      }
+      else if ((i - Start) == 4 && strncmp(&Buf[Start], "null", 4) == 0)
+      {
+         *ValueType = JSONNull;
+      }
+      else if (NumChars == (i - Start))
+      {
+         *ValueType = JSONNumber;
+      }
+   }
+
+   return i;
+
+} /* End SkipValue() */
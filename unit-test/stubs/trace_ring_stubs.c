@@ -0,0 +1,41 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Unit test stubs for TRACE_RING
+**
+** Notes:
+**   1. See ut_mqtt_gw_stubs.h
+**
+*/
+
+/*
+** Includes
+*/
+
+#include "trace_ring.h"
+#include "ut_mqtt_gw_stubs.h"
+
+
+/******************************************************************************
+** Function: TRACE_RING_Write
+**
+*/
+void TRACE_RING_Write(TRACE_RING_Module_t Module, TRACE_RING_Level_t Level, uint16 Id,
+                      uint32 Param1, uint32 Param2, const char *Text, uint16 TextLen)
+{
+
+   UT_DEFAULT_IMPL(TRACE_RING_Write);
+
+} /* End TRACE_RING_Write() */
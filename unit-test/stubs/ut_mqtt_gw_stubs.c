@@ -0,0 +1,59 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Define the state shared by the MQTT_GW unit test stubs and test cases
+**
+** Notes:
+**   1. See ut_mqtt_gw_stubs.h
+**
+*/
+
+/*
+** Includes
+*/
+
+#include <string.h>
+
+#include "ut_mqtt_gw_stubs.h"
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+UT_MqttGw_Stubs_t UT_MqttGw;
+
+
+/******************************************************************************
+** Function: UT_MqttGw_Setup
+**
+*/
+void UT_MqttGw_Setup(void)
+{
+
+   UT_ResetState(0);
+   memset(&UT_MqttGw, 0, sizeof(UT_MqttGw_Stubs_t));
+
+} /* End UT_MqttGw_Setup() */
+
+
+/******************************************************************************
+** Function: UT_MqttGw_TearDown
+**
+*/
+void UT_MqttGw_TearDown(void)
+{
+
+} /* End UT_MqttGw_TearDown() */